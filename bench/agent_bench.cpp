@@ -0,0 +1,604 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Agent runtime benchmarks: the threads held by concurrent sessions of
+// nested agents, event queues and forwarding, and the schedulers, limiters
+// and prompt handling around model calls. Models are stand-ins that answer
+// after a latency, so these cases need no compose runtime
+
+#include "cases.h"
+#include "eino/adk/agent_executor.h"
+#include "eino/adk/async_iterator.h"
+#include "eino/adk/hedging.h"
+#include "eino/adk/model_rate_limiter.h"
+#include "eino/adk/prebuilt/plan_steps.h"
+#include "eino/adk/prompt_assembler.h"
+#include "eino/adk/session_host.h"
+#include "eino/adk/task_dispatch.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+// Each session is a ChatModelAgent run wrapped in depth forwarding layers,
+// the shape of Runner -> transfer wrapper -> workflow -> ChatModelAgent.
+// The run body does what ChatModelAgent::Run does: it is a task on the
+// executor that calls a synchronous model inside a BlockingScope, so it
+// holds a worker for the model's latency. What differs is how the layers
+// above it wait: pump continuations, or the former thread per layer
+void RegisterExecutorCase(Registry* registry, int sessions, int depth, bool pump) {
+    constexpr int kEventsPerReply = 4;
+    std::string name = "adk/executor/" + std::string(pump ? "pump" : "thread") +
+                       "/sessions=" + std::to_string(sessions) +
+                       "/depth=" + std::to_string(depth);
+    registry->Add(name, [sessions, depth, pump](State& state) {
+        using Events = std::shared_ptr<adk::AsyncIterator<int>>;
+        auto latency = std::chrono::microseconds(
+            std::max<int64_t>(state.options().latency_us, 500));
+        adk::AgentExecutor executor;
+        size_t peak_threads = 0;
+
+        while (state.KeepRunning()) {
+            std::vector<Events> outputs;
+            std::vector<std::thread> threads;
+            for (int s = 0; s < sessions; ++s) {
+                auto run = adk::NewAsyncIteratorPair<int>();
+                auto run_gen = run.second;
+                auto body = [run_gen, latency]() {
+                    adk::AgentExecutor::BlockingScope blocking;
+                    // The synchronous model call
+                    std::this_thread::sleep_for(latency);
+                    for (int i = 0; i < kEventsPerReply; ++i) {
+                        run_gen->Send(i);
+                    }
+                    run_gen->Close();
+                };
+                if (pump) {
+                    executor.Submit(body);
+                } else {
+                    threads.emplace_back(body);
+                }
+                Events upstream = run.first;
+                for (int d = 0; d < depth; ++d) {
+                    auto layer = adk::NewAsyncIteratorPair<int>();
+                    auto gen = layer.second;
+                    if (pump) {
+                        adk::PumpAsync<int>(
+                            upstream,
+                            [gen](int& v) {
+                                gen->Send(v);
+                                return true;
+                            },
+                            [gen]() { gen->Close(); },
+                            executor);
+                    } else {
+                        // The former detached thread per Run, joined here
+                        threads.emplace_back([upstream, gen]() {
+                            int v;
+                            while (upstream->Next(v)) {
+                                gen->Send(v);
+                            }
+                            gen->Close();
+                        });
+                    }
+                    upstream = layer.first;
+                }
+                outputs.push_back(upstream);
+            }
+
+            int v;
+            for (auto& out : outputs) {
+                while (out->Next(v)) {
+                    DoNotOptimize(v);
+                }
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            peak_threads = std::max(peak_threads, pump ? executor.PeakThreads()
+                                                       : threads.size());
+        }
+        state.SetItemsProcessed(state.iterations() * sessions * kEventsPerReply);
+        state.SetCounter("threads_per_session",
+                         static_cast<double>(peak_threads) / sessions);
+    });
+}
+
+// A streaming producer thread feeding one consumer, the path between a
+// model emitting chunks and a writer flushing them to a socket. batch reads
+// with NextBatch; capacity bounds the buffer, and ring uses the
+// single-producer fast path
+void RegisterEventQueueCase(Registry* registry, size_t capacity, bool ring, size_t batch) {
+    constexpr int kEvents = 1 << 16;
+    std::string name = "adk/async_iterator/" +
+                       (capacity == 0 ? std::string("unbounded")
+                                      : std::string(ring ? "ring" : "locked") +
+                                            "/capacity=" + std::to_string(capacity)) +
+                       "/batch=" + std::to_string(batch);
+    registry->Add(name, [capacity, ring, batch](State& state) {
+        adk::AsyncQueueOptions options;
+        options.capacity = capacity;
+        options.single_producer = ring;
+        while (state.KeepRunning()) {
+            auto pair = adk::NewAsyncIteratorPair<int>(options);
+            std::thread producer([gen = pair.second]() {
+                for (int i = 0; i < kEvents; ++i) {
+                    gen->Send(i);
+                }
+                gen->Close();
+            });
+            int64_t sum = 0;
+            if (batch <= 1) {
+                int v;
+                while (pair.first->Next(v)) {
+                    sum += v;
+                }
+            } else {
+                std::vector<int> out;
+                out.reserve(batch);
+                while (pair.first->HasNext()) {
+                    out.clear();
+                    pair.first->NextBatch(&out, batch, std::chrono::milliseconds(10));
+                    for (int v : out) {
+                        sum += v;
+                    }
+                }
+            }
+            producer.join();
+            DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * kEvents);
+    });
+}
+
+// Events crossing depth forwarding layers, as from an inner agent through
+// flow, transfer and runner wrappers: a pump per layer, or layers spliced
+// with ForwardInline so the producer writes into the outermost queue
+void RegisterForwardCase(Registry* registry, int depth, bool splice) {
+    constexpr int kEvents = 1 << 14;
+    std::string name = "adk/forward/" + std::string(splice ? "inline" : "pump") +
+                       "/depth=" + std::to_string(depth);
+    registry->Add(name, [depth, splice](State& state) {
+        adk::AgentExecutor executor;
+        while (state.KeepRunning()) {
+            auto source = adk::NewAsyncIteratorPair<int>();
+            auto upstream = source.first;
+            for (int d = 0; d < depth; ++d) {
+                auto layer = adk::NewAsyncIteratorPair<int>();
+                auto gen = layer.second;
+                std::function<bool(int&)> transform = [](int& v) {
+                    ++v;
+                    return true;
+                };
+                if (splice) {
+                    adk::ForwardInline<int>(upstream, gen, transform,
+                                            [gen]() { gen->Close(); }, executor);
+                } else {
+                    adk::PumpAsync<int>(
+                        upstream,
+                        [gen, transform](int& v) {
+                            transform(v);
+                            return gen->Send(v);
+                        },
+                        [gen]() { gen->Close(); },
+                        executor);
+                }
+                upstream = layer.first;
+            }
+            std::thread producer([gen = source.second]() {
+                for (int i = 0; i < kEvents; ++i) {
+                    gen->Send(i);
+                }
+                gen->Close();
+            });
+            int64_t sum = 0;
+            int v;
+            while (upstream->Next(v)) {
+                sum += v;
+            }
+            producer.join();
+            DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * kEvents);
+    });
+}
+
+// A burst of sessions against a fake model backend that serves a fixed
+// number of calls at once, each taking latency_us (500us minimum). With
+// every session admitted (active=all) they share the backend and finish
+// together; a bounded active set finishes most sessions much sooner
+void RegisterSessionHostCase(Registry* registry, int sessions, int max_active) {
+    constexpr int kTurns = 3;
+    constexpr size_t kModelSlots = 32;
+    std::string name = "adk/session_host/sessions=" + std::to_string(sessions) + "/active=" +
+                       (max_active > 0 ? std::to_string(max_active) : std::string("all"));
+    registry->Add(name, [sessions, max_active](State& state) {
+        auto latency = std::chrono::microseconds(
+            std::max<int64_t>(state.options().latency_us, 500));
+        adk::AgentExecutor::Options model_options;
+        model_options.core_threads = kModelSlots;
+        model_options.max_threads = kModelSlots;
+        adk::AgentExecutor model(model_options);
+
+        // Each session makes kTurns model calls in a row, then closes
+        using Gen = std::shared_ptr<adk::AsyncGenerator<std::shared_ptr<adk::AgentEvent>>>;
+        std::function<void(Gen, int)> turn = [&model, &turn, latency](Gen gen, int left) {
+            if (left == 0) {
+                gen->Close();
+                return;
+            }
+            model.Submit([gen, left, latency, &turn]() {
+                std::this_thread::sleep_for(latency);
+                gen->Send(std::make_shared<adk::AgentEvent>());
+                turn(gen, left - 1);
+            });
+        };
+
+        adk::SessionHostConfig config;
+        config.max_active = max_active > 0 ? max_active : sessions;
+        std::vector<double> latencies_ms;
+        while (state.KeepRunning()) {
+            auto host = std::make_shared<adk::SessionHost>(
+                [&turn](const adk::SessionRequest&) {
+                    auto pair = adk::NewAsyncIteratorPair<std::shared_ptr<adk::AgentEvent>>();
+                    turn(pair.second, kTurns);
+                    return pair.first;
+                },
+                config);
+
+            // Sessions finish out of order; a reader per session times each
+            auto start = std::chrono::steady_clock::now();
+            std::mutex mu;
+            std::vector<std::thread> readers;
+            for (int s = 0; s < sessions; ++s) {
+                adk::SessionRequest request;
+                request.tenant = "t" + std::to_string(s % 8);
+                auto events = host->Submit(request);
+                readers.emplace_back([events, start, &mu, &latencies_ms]() {
+                    std::shared_ptr<adk::AgentEvent> event;
+                    while (events->Next(event)) {
+                        DoNotOptimize(event);
+                    }
+                    std::chrono::duration<double, std::milli> took =
+                        std::chrono::steady_clock::now() - start;
+                    std::lock_guard<std::mutex> lock(mu);
+                    latencies_ms.push_back(took.count());
+                });
+            }
+            for (auto& t : readers) {
+                t.join();
+            }
+        }
+        std::sort(latencies_ms.begin(), latencies_ms.end());
+        state.SetItemsProcessed(state.iterations() * sessions);
+        state.SetCounter("session_p50_ms", Percentile(latencies_ms, 50));
+        state.SetCounter("session_p99_ms", Percentile(latencies_ms, 99));
+    });
+}
+
+// A plan of width independent steps and a final step that needs them all,
+// each step one fake model call of latency_us (2ms minimum). Run one step
+// at a time the plan costs width + 1 calls; with parallel >= width it costs
+// two, the length of its critical path
+void RegisterPlanStepsCase(Registry* registry, int width, int parallel) {
+    std::string name = "adk/plan_steps/width=" + std::to_string(width) +
+                       "/parallel=" + std::to_string(parallel);
+    registry->Add(name, [width, parallel](State& state) {
+        auto latency = std::chrono::microseconds(
+            std::max<int64_t>(state.options().latency_us, 2000));
+        adk::AgentExecutor::Options model_options;
+        model_options.core_threads = width;
+        model_options.max_threads = width;
+        adk::AgentExecutor model(model_options);
+
+        std::vector<adk::prebuilt::PlanStep> steps;
+        std::vector<size_t> all;
+        for (int i = 0; i < width; ++i) {
+            steps.push_back({"step " + std::to_string(i), {}});
+            all.push_back(i);
+        }
+        steps.push_back({"summarize", all});
+        adk::prebuilt::StepRunner runner = [&model, latency](
+                                               size_t, const adk::prebuilt::PlanStep&,
+                                               const std::vector<adk::prebuilt::ExecutedStep>&) {
+            auto pair = adk::NewAsyncIteratorPair<std::shared_ptr<adk::AgentEvent>>();
+            model.Submit([gen = pair.second, latency]() {
+                std::this_thread::sleep_for(latency);
+                gen->Send(std::make_shared<adk::AgentEvent>());
+                gen->Close();
+            });
+            return pair.first;
+        };
+
+        std::vector<double> plans_ms;
+        while (state.KeepRunning()) {
+            auto start = std::chrono::steady_clock::now();
+            auto pair = adk::NewAsyncIteratorPair<std::shared_ptr<adk::AgentEvent>>();
+            auto gen = pair.second;
+            adk::prebuilt::RunPlanSteps(steps, runner, parallel, gen,
+                                        [gen](adk::prebuilt::PlanStepsResult) { gen->Close(); });
+            std::shared_ptr<adk::AgentEvent> event;
+            while (pair.first->Next(event)) {
+                DoNotOptimize(event);
+            }
+            std::chrono::duration<double, std::milli> took =
+                std::chrono::steady_clock::now() - start;
+            plans_ms.push_back(took.count());
+        }
+        std::sort(plans_ms.begin(), plans_ms.end());
+        state.SetItemsProcessed(state.iterations() * (width + 1));
+        state.SetCounter("plan_p50_ms", Percentile(plans_ms, 50));
+    });
+}
+
+// One orchestrator turn asking for `tasks` sub-agent tasks, each a fake
+// model call of latency_us (2ms minimum) over the parent's 256-message
+// history. limit=1 is the old one-call-at-a-time behaviour; first_result
+// is when the orchestrator gets its first answer back
+void RegisterTaskDispatchCase(Registry* registry, int tasks, int limit) {
+    std::string name = "adk/task_dispatch/tasks=" + std::to_string(tasks) +
+                       "/limit=" + std::to_string(limit);
+    registry->Add(name, [tasks, limit](State& state) {
+        auto latency = std::chrono::microseconds(
+            std::max<int64_t>(state.options().latency_us, 2000));
+        adk::AgentExecutor::Options model_options;
+        model_options.core_threads = tasks;
+        model_options.max_threads = tasks;
+        adk::AgentExecutor model(model_options);
+
+        std::vector<schema::Message> parent;
+        for (int i = 0; i < 256; ++i) {
+            parent.push_back(schema::UserMessage("turn " + std::to_string(i)));
+        }
+        auto history = schema::MessageHistory::FromMessages(parent);
+        std::vector<adk::SubAgentTask> batch;
+        for (int i = 0; i < tasks; ++i) {
+            batch.push_back({"call" + std::to_string(i), "worker", "task " + std::to_string(i)});
+        }
+        adk::TaskDispatchConfig config;
+        config.max_concurrent_tasks = limit;
+        config.inherit_history = true;
+        adk::SubAgentStarter starter = [&model, latency](
+                                           void*, const std::shared_ptr<adk::SubAgentContext>& c) {
+            auto pair = adk::NewAsyncIteratorPair<std::shared_ptr<adk::AgentEvent>>();
+            model.Submit([gen = pair.second, c, latency]() {
+                DoNotOptimize(c->Messages().size());
+                std::this_thread::sleep_for(latency);
+                gen->Send(std::make_shared<adk::AgentEvent>());
+                gen->Close();
+            });
+            return pair.first;
+        };
+
+        std::vector<double> turns_ms;
+        std::vector<double> first_ms;
+        while (state.KeepRunning()) {
+            auto start = std::chrono::steady_clock::now();
+            auto results = adk::DispatchTasks(nullptr, batch, starter, history, config);
+            adk::SubAgentResult result;
+            bool first = true;
+            while (results->Next(result)) {
+                if (first) {
+                    std::chrono::duration<double, std::milli> took =
+                        std::chrono::steady_clock::now() - start;
+                    first_ms.push_back(took.count());
+                    first = false;
+                }
+            }
+            std::chrono::duration<double, std::milli> took =
+                std::chrono::steady_clock::now() - start;
+            turns_ms.push_back(took.count());
+        }
+        std::sort(turns_ms.begin(), turns_ms.end());
+        std::sort(first_ms.begin(), first_ms.end());
+        state.SetItemsProcessed(state.iterations() * tasks);
+        state.SetCounter("turn_p50_ms", Percentile(turns_ms, 50));
+        state.SetCounter("first_result_p50_ms", Percentile(first_ms, 50));
+    });
+}
+
+// `callers` agents make 4 model calls each against a provider that takes
+// 8 calls at a time and answers the rest with a 429. Fixed concurrency
+// lets every caller in and retries blindly; adaptive concurrency backs off
+// after the first refusals
+void RegisterModelRateLimitCase(Registry* registry, int callers, bool adaptive) {
+    std::string name = "adk/model_rate_limit/callers=" + std::to_string(callers) +
+                       (adaptive ? "/adaptive" : "/fixed");
+    registry->Add(name, [callers, adaptive](State& state) {
+        auto latency = std::chrono::microseconds(
+            std::max<int64_t>(state.options().latency_us, 2000));
+        const int provider_slots = 8;
+        const int calls_per_caller = 4;
+        std::atomic<int> provider_busy{0};
+        std::atomic<int64_t> refusals{0};
+
+        adk::ModelRateLimits limits;
+        limits.max_concurrency = callers;
+        limits.min_concurrency = adaptive ? 1 : callers;
+        adk::ModelCallConfig config;
+        config.limiter = std::make_shared<adk::ModelRateLimiter>(limits);
+        config.retry.max_retries = 1000;
+        // The default jittered backoff, scaled down to the fake latency
+        config.retry.backoff_func = [](int attempt) { return adk::DefaultBackoff(attempt) / 10; };
+        auto call = [&](adk::ModelRateLimiter::Permit& permit) {
+            if (provider_busy.fetch_add(1) >= provider_slots) {
+                provider_busy.fetch_sub(1);
+                refusals.fetch_add(1);
+                throw adk::ModelCallError(429, "HTTP 429: Too Many Requests");
+            }
+            std::this_thread::sleep_for(latency);
+            provider_busy.fetch_sub(1);
+            permit.Release(adk::ModelCallOutcome::kSucceeded);
+        };
+
+        std::vector<double> batches_ms;
+        while (state.KeepRunning()) {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (int i = 0; i < callers; ++i) {
+                threads.emplace_back([&]() {
+                    for (int j = 0; j < calls_per_caller; ++j) {
+                        adk::CallWithLimits(config, 0, call);
+                    }
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            std::chrono::duration<double, std::milli> took =
+                std::chrono::steady_clock::now() - start;
+            batches_ms.push_back(took.count());
+        }
+        std::sort(batches_ms.begin(), batches_ms.end());
+        int64_t calls = state.iterations() * callers * calls_per_caller;
+        state.SetItemsProcessed(calls);
+        state.SetCounter("batch_p50_ms", Percentile(batches_ms, 50));
+        state.SetCounter("refusals_per_call",
+                         static_cast<double>(refusals.load()) / static_cast<double>(calls));
+    });
+}
+
+// RegisterHedgingCase times calls that usually take the fake latency but
+// one in twenty stall for twenty times as long, with and without a hedger
+void RegisterHedgingCase(Registry* registry, bool hedged) {
+    std::string name = std::string("adk/hedging/") + (hedged ? "hedged" : "unhedged");
+    registry->Add(name, [hedged](State& state) {
+        auto latency = std::chrono::microseconds(
+            std::max<int64_t>(state.options().latency_us, 2000));
+        const int calls_per_iteration = 100;
+        std::atomic<int> next{0};
+        auto attempt = [latency, &next](const adk::HedgeAttempt& a) {
+            auto wait = next.fetch_add(1) % 20 == 7 ? latency * 20 : latency;
+            auto deadline = std::chrono::steady_clock::now() + wait;
+            while (!a.Cancelled() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            return a.Index();
+        };
+
+        adk::HedgePolicy policy;
+        policy.initial_delay = std::chrono::duration_cast<std::chrono::milliseconds>(latency * 2);
+        policy.max_hedge_ratio = 0.1;
+        auto hedger = std::make_shared<adk::Hedger>(policy);
+
+        std::vector<double> calls_ms;
+        while (state.KeepRunning()) {
+            for (int i = 0; i < calls_per_iteration; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                if (hedged) {
+                    hedger->Run<int>(attempt);
+                } else {
+                    attempt(adk::HedgeAttempt(
+                        0, std::make_shared<const std::atomic<bool>>(false)));
+                }
+                std::chrono::duration<double, std::milli> took =
+                    std::chrono::steady_clock::now() - start;
+                calls_ms.push_back(took.count());
+            }
+        }
+        std::sort(calls_ms.begin(), calls_ms.end());
+        state.SetItemsProcessed(state.iterations() * calls_per_iteration);
+        state.SetCounter("call_p50_ms", Percentile(calls_ms, 50));
+        state.SetCounter("call_p99_ms", Percentile(calls_ms, 99));
+        adk::HedgeStats stats = hedger->Stats();
+        state.SetCounter("hedges_per_call",
+                         stats.calls ? static_cast<double>(stats.hedges) /
+                                           static_cast<double>(stats.calls)
+                                     : 0);
+    });
+}
+
+// RegisterPromptAssemblyCase assembles the prompts of a conversation that
+// grows by a tool round trip per turn, reporting the cost per turn and the
+// share of each prompt the provider could serve from its prefix cache
+void RegisterPromptAssemblyCase(Registry* registry, int turns) {
+    std::string name = "adk/prompt_assembly/turns=" + std::to_string(turns);
+    registry->Add(name, [turns](State& state) {
+        std::vector<schema::ToolInfo> tools;
+        for (const char* tool : {"search", "fetch", "calculator", "calendar"}) {
+            schema::ToolInfo info;
+            info.name = tool;
+            info.description = std::string("the ") + tool + " tool";
+            tools.push_back(info);
+        }
+        uint64_t bytes = 0;
+        uint64_t reused = 0;
+        while (state.KeepRunning()) {
+            adk::PromptAssembler assembler;
+            std::vector<schema::Message> history;
+            history.emplace_back(schema::RoleType::kSystem, std::string(2000, 's'));
+            for (int turn = 0; turn < turns; ++turn) {
+                history.emplace_back(schema::RoleType::kUser, std::string(200, 'q'));
+                schema::ToolCall call;
+                call.id = "call_" + std::to_string(turn);
+                call.function.name = "search";
+                call.function.arguments = "{\"query\":\"weather\"}";
+                history.emplace_back(schema::RoleType::kAssistant, "",
+                                     std::vector<schema::ToolCall>{call});
+                history.emplace_back(schema::RoleType::kTool, std::string(1000, 'r'));
+                adk::AssembledPrompt prompt = assembler.Assemble(tools, history);
+                bytes += prompt.bytes;
+                reused += prompt.reused_bytes;
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * turns);
+        state.SetCounter("reuse_pct",
+                         bytes ? 100.0 * static_cast<double>(reused) / static_cast<double>(bytes)
+                               : 0);
+    });
+}
+
+} // namespace
+
+void RegisterAgentBenchmarks(Registry* registry) {
+    for (int sessions : {16, 256}) {
+        RegisterExecutorCase(registry, sessions, 3, true);
+        RegisterExecutorCase(registry, sessions, 3, false);
+    }
+    RegisterEventQueueCase(registry, 0, false, 1);
+    RegisterEventQueueCase(registry, 256, false, 1);
+    RegisterEventQueueCase(registry, 256, false, 64);
+    RegisterEventQueueCase(registry, 256, true, 1);
+    RegisterEventQueueCase(registry, 256, true, 64);
+    for (int depth : {1, 4}) {
+        RegisterForwardCase(registry, depth, false);
+        RegisterForwardCase(registry, depth, true);
+    }
+    RegisterSessionHostCase(registry, 512, 0);
+    RegisterSessionHostCase(registry, 512, 32);
+    RegisterPlanStepsCase(registry, 8, 1);
+    RegisterPlanStepsCase(registry, 8, 8);
+    RegisterTaskDispatchCase(registry, 8, 1);
+    RegisterTaskDispatchCase(registry, 8, 8);
+    RegisterModelRateLimitCase(registry, 32, false);
+    RegisterModelRateLimitCase(registry, 32, true);
+    RegisterHedgingCase(registry, false);
+    RegisterHedgingCase(registry, true);
+    RegisterPromptAssemblyCase(registry, 32);
+}
+
+} // namespace bench
+} // namespace eino
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Branch benchmarks: the compiled conditions BranchNode evaluates, run
+// through CompileBranchClauses and SelectBranch without the compose runtime
+
+#include "cases.h"
+#include "eino/compose/branch_predicate.h"
+#include <any>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+// RegisterBranchCase evaluates `branches` contain checks against a list of
+// `size` strings, none matching, so every branch is checked. "literal"
+// looks the value up in the list hashed at compile time; "reference" scans
+// a node output in place; "copy" is the pre-compile behaviour of copying
+// the operands into a Clause per evaluation
+void RegisterBranchCase(Registry* registry, int size, int branches) {
+    using AnyMap = std::map<std::string, std::any>;
+
+    auto make_list = [size]() {
+        std::vector<std::any> list;
+        list.reserve(size);
+        for (int i = 0; i < size; ++i) {
+            list.push_back(std::string("member_") + std::to_string(i));
+        }
+        return list;
+    };
+    const std::string params =
+        "/size=" + std::to_string(size) + "/branches=" + std::to_string(branches);
+
+    registry->Add("compose/branch/contain/literal" + params,
+                  [make_list, branches](State& state) {
+        const std::vector<std::any> list = make_list();
+        compose::BranchNodeConfig config;
+        for (int b = 0; b < branches; ++b) {
+            config.AddConditionWithOperands(
+                compose::BranchOperator::Contain,
+                compose::OperandConfig::FromLiteral(list),
+                compose::OperandConfig::FromNode("user", {"role"}));
+        }
+        const auto clauses = compose::CompileBranchClauses(config, true);
+        const AnyMap input = {{"user", AnyMap{{"role", std::string("guest")}}}};
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(compose::SelectBranch(clauses, input));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(branches));
+    });
+
+    registry->Add("compose/branch/contain/reference" + params,
+                  [make_list, branches](State& state) {
+        compose::BranchNodeConfig config;
+        for (int b = 0; b < branches; ++b) {
+            config.AddConditionWithOperands(
+                compose::BranchOperator::Contain,
+                compose::OperandConfig::FromNode("acl", {"roles"}),
+                compose::OperandConfig::FromNode("user", {"role"}));
+        }
+        const auto clauses = compose::CompileBranchClauses(config, true);
+        const AnyMap input = {{"acl", AnyMap{{"roles", make_list()}}},
+                              {"user", AnyMap{{"role", std::string("guest")}}}};
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(compose::SelectBranch(clauses, input));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(branches));
+    });
+
+    registry->Add("compose/branch/contain/copy" + params,
+                  [make_list, branches](State& state) {
+        const AnyMap acl = {{"roles", make_list()}};
+        const std::any role = std::string("guest");
+
+        while (state.KeepRunning()) {
+            int64_t selected = branches;
+            for (int b = 0; b < branches; ++b) {
+                compose::Clause clause(acl.at("roles"), compose::BranchOperator::Contain, role);
+                if (clause.Resolve()) {
+                    selected = b;
+                    break;
+                }
+            }
+            DoNotOptimize(selected);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(branches));
+    });
+}
+
+} // namespace
+
+void RegisterBranchBenchmarks(Registry* registry) {
+    // Branch conditions over large list operands
+    for (int size : {100, 10000}) {
+        RegisterBranchCase(registry, size, 8);
+    }
+}
+
+} // namespace bench
+} // namespace eino
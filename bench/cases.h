@@ -0,0 +1,64 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_BENCH_CASES_H_
+#define EINO_CPP_BENCH_CASES_H_
+
+#include "harness.h"
+
+namespace eino {
+namespace bench {
+
+// Each benchmark translation unit registers its cases through one of these
+// Case names are "<module>/<subject>/<params>" so --filter can select groups
+//
+// The graph, chain, checkpoint and prompt cases run on the compose runtime
+// (compose/runnable.h), which does not build yet, and are built only with
+// EINO_BENCH_COMPOSE
+
+// GraphRunner DAG/Pregel at varying width and depth, Chain overhead,
+// superstep scans
+void RegisterComposeBenchmarks(Registry* registry);
+
+// Compiled branch conditions over large list operands
+void RegisterBranchBenchmarks(Registry* registry);
+
+// Checkpoint save/restore through CheckPointer
+void RegisterCheckpointBenchmarks(Registry* registry);
+
+// schema::Pipe throughput and ParentStreamReader fan-out
+void RegisterStreamBenchmarks(Registry* registry);
+
+// Streaming message concat, message JSON encoding and, with
+// EINO_BENCH_COMPOSE, prompt formatting
+void RegisterMessageBenchmarks(Registry* registry);
+
+// Mocked ReAct agent loop
+void RegisterFlowBenchmarks(Registry* registry);
+
+// Threads held by nested agent sessions, agent event queue throughput, event forwarding through nested layers, session
+// admission under a burst, plan steps run by dependency, sub-agent task
+// dispatch, model calls against a rate-limited provider, hedged calls
+// with a slow tail and prompt prefix reuse across turns
+void RegisterAgentBenchmarks(Registry* registry);
+
+// Runtime metrics recording cost
+void RegisterMetricsBenchmarks(Registry* registry);
+
+} // namespace bench
+} // namespace eino
+
+#endif // EINO_CPP_BENCH_CASES_H_
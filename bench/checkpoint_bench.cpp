@@ -0,0 +1,142 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checkpoint benchmarks: CheckPointer save (serialize + store) and restore
+// (load + deserialize) for checkpoints of increasing size
+
+#include "cases.h"
+#include "fakes.h"
+#include "eino/compose/checkpoint.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+// MemoryStore is a CheckPointStore with optional fake latency per call
+class MemoryStore : public compose::CheckPointStore {
+public:
+    explicit MemoryStore(FakeLatency latency) : latency_(latency) {}
+
+    std::tuple<bool, std::string> Get(
+        std::shared_ptr<compose::Context> ctx,
+        const std::string& checkpoint_id,
+        std::vector<uint8_t>& data) override {
+        latency_.Wait();
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = data_.find(checkpoint_id);
+        if (it == data_.end()) {
+            return std::make_tuple(false, std::string());
+        }
+        data = it->second;
+        return std::make_tuple(true, std::string());
+    }
+
+    std::string Set(
+        std::shared_ptr<compose::Context> ctx,
+        const std::string& checkpoint_id,
+        const std::vector<uint8_t>& checkpoint) override {
+        latency_.Wait();
+        std::lock_guard<std::mutex> lock(mu_);
+        data_[checkpoint_id] = checkpoint;
+        return "";
+    }
+
+    size_t Size(const std::string& checkpoint_id) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = data_.find(checkpoint_id);
+        return it == data_.end() ? 0 : it->second.size();
+    }
+
+private:
+    FakeLatency latency_;
+    std::mutex mu_;
+    std::map<std::string, std::vector<uint8_t>> data_;
+};
+
+// MakeCheckPoint builds a checkpoint with `nodes` pending node inputs of
+// `value_bytes` each and a state object of the same shape
+std::shared_ptr<compose::CheckPoint> MakeCheckPoint(int nodes, size_t value_bytes) {
+    auto cp = std::make_shared<compose::CheckPoint>();
+    compose::json state = compose::json::object();
+    for (int i = 0; i < nodes; ++i) {
+        std::string key = "node_" + std::to_string(i);
+        cp->inputs[key] = std::string(value_bytes, 'x');
+        cp->skip_pre_handler[key] = (i % 2) == 0;
+        state[key] = std::string(value_bytes, 's');
+    }
+    cp->state = state;
+    cp->rerun_nodes.push_back("node_0");
+    return cp;
+}
+
+void RegisterCheckpointCase(Registry* registry, int nodes, size_t value_bytes) {
+    std::string params = "/nodes=" + std::to_string(nodes) +
+                         "/value_bytes=" + std::to_string(value_bytes);
+
+    registry->Add("compose/checkpoint/save" + params, [nodes, value_bytes](State& state) {
+        auto ctx = compose::Context::Background();
+        auto store = std::make_shared<MemoryStore>(FakeLatency(state.options()));
+        compose::CheckPointer pointer(store);
+        auto cp = MakeCheckPoint(nodes, value_bytes);
+
+        while (state.KeepRunning()) {
+            auto err = pointer.Set(ctx, "bench", cp);
+            if (!err.empty()) {
+                throw std::runtime_error("checkpoint save failed: " + err);
+            }
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * store->Size("bench"));
+    });
+
+    registry->Add("compose/checkpoint/restore" + params, [nodes, value_bytes](State& state) {
+        auto ctx = compose::Context::Background();
+        auto store = std::make_shared<MemoryStore>(FakeLatency(state.options()));
+        compose::CheckPointer pointer(store);
+        auto err = pointer.Set(ctx, "bench", MakeCheckPoint(nodes, value_bytes));
+        if (!err.empty()) {
+            throw std::runtime_error("checkpoint save failed: " + err);
+        }
+
+        while (state.KeepRunning()) {
+            auto result = pointer.Get(ctx, "bench");
+            if (!std::get<1>(result)) {
+                throw std::runtime_error("checkpoint restore failed: " + std::get<2>(result));
+            }
+            DoNotOptimize(std::get<0>(result));
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * store->Size("bench"));
+    });
+}
+
+} // namespace
+
+void RegisterCheckpointBenchmarks(Registry* registry) {
+    RegisterCheckpointCase(registry, 4, 64);
+    RegisterCheckpointCase(registry, 64, 256);
+    RegisterCheckpointCase(registry, 256, 4096);
+}
+
+} // namespace bench
+} // namespace eino
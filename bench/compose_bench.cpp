@@ -0,0 +1,344 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compose benchmarks: GraphRunner supersteps and Chain invocation overhead
+
+#include "cases.h"
+#include "fakes.h"
+#include "eino/compose/chain.h"
+#include "eino/compose/graph.h"
+#include "eino/compose/graph_manager.h"
+#include "eino/compose/graph_plan.h"
+#include "eino/compose/graph_run.h"
+#include "eino/compose/values_merge.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+using StringGraph = compose::Graph<std::string, std::string>;
+
+// FakeNode is a string -> string node that waits and passes its input on
+class FakeNode : public compose::ComposableRunnable<std::string, std::string> {
+public:
+    explicit FakeNode(FakeLatency latency = FakeLatency()) : latency_(latency) {}
+
+    std::string Invoke(
+        std::shared_ptr<compose::Context> ctx,
+        const std::string& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override {
+        latency_.Wait();
+        calls_.fetch_add(1, std::memory_order_relaxed);
+        return input;
+    }
+
+    std::shared_ptr<compose::StreamReader<std::string>> Stream(
+        std::shared_ptr<compose::Context> ctx,
+        const std::string& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override {
+        std::vector<std::string> out{Invoke(ctx, input, opts)};
+        return std::make_shared<compose::SimpleStreamReader<std::string>>(out);
+    }
+
+    std::string Collect(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::string>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override {
+        std::string all;
+        std::string chunk;
+        while (input && input->Read(chunk)) {
+            all += chunk;
+        }
+        return Invoke(ctx, all, opts);
+    }
+
+    std::shared_ptr<compose::StreamReader<std::string>> Transform(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::string>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override {
+        auto out = std::make_shared<compose::SimpleStreamReader<std::string>>();
+        std::string chunk;
+        while (input && input->Read(chunk)) {
+            out->Add(Invoke(ctx, chunk, opts));
+        }
+        return out;
+    }
+
+    const std::type_info& GetInputType() const override { return typeid(std::string); }
+    const std::type_info& GetOutputType() const override { return typeid(std::string); }
+    std::string GetComponentType() const override { return "FakeNode"; }
+
+    uint64_t Calls() const { return calls_.load(std::memory_order_relaxed); }
+
+private:
+    FakeLatency latency_;
+    std::atomic<uint64_t> calls_{0};
+};
+
+// BuildLaneGraph builds `width` independent lanes of `depth` fake nodes each;
+// every lane starts at START and all lanes fan in to a join node before END,
+// so one run executes depth+1 supersteps of `width` tasks
+std::shared_ptr<StringGraph> BuildLaneGraph(int width, int depth, FakeLatency latency) {
+    auto graph = std::make_shared<StringGraph>();
+    for (int w = 0; w < width; ++w) {
+        std::string prev = StringGraph::START_NODE;
+        for (int d = 0; d < depth; ++d) {
+            std::string key = "n_" + std::to_string(w) + "_" + std::to_string(d);
+            graph->AddNode(key, std::make_shared<FakeNode>(latency));
+            graph->AddEdge(prev, key);
+            prev = key;
+        }
+        if (width > 1) {
+            if (w == 0) {
+                graph->AddNode("join", std::make_shared<FakeNode>(latency));
+                graph->AddEdge("join", StringGraph::END_NODE);
+            }
+            graph->AddEdge(prev, "join");
+        } else {
+            graph->AddEdge(prev, StringGraph::END_NODE);
+        }
+    }
+    graph->Compile();
+    return graph;
+}
+
+void RegisterGraphCase(Registry* registry, compose::GraphRunType run_type,
+                       int width, int depth) {
+    std::string mode = run_type == compose::GraphRunType::DAG ? "dag" : "pregel";
+    std::string name = "compose/graph/" + mode + "/width=" + std::to_string(width) +
+                       "/depth=" + std::to_string(depth);
+    registry->Add(name, [run_type, width, depth](State& state) {
+        auto graph = BuildLaneGraph(width, depth, FakeLatency(state.options()));
+        compose::GraphRunOptions opts;
+        opts.run_type = run_type;
+        // DAG runs reject a step limit
+        opts.max_run_steps = run_type == compose::GraphRunType::DAG ? 0 : depth + 10;
+        auto runner = compose::NewGraphRunner(graph, opts);
+        auto ctx = compose::Context::Background();
+        const std::string input = "payload";
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(runner->Run(ctx, input));
+        }
+        int nodes = width * depth + (width > 1 ? 1 : 0);
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(nodes));
+        state.SetCounter("nodes", nodes);
+        state.SetCounter("supersteps", runner->GetStepCount());
+        // Pooled run state: stays at 1 for back-to-back runs
+        state.SetCounter("run_states", runner->GetRunStateCount());
+    });
+}
+
+// RegisterSkewedCase runs two lanes of `depth` sleeping nodes whose slow
+// steps alternate (lane 0 is slow on even levels, lane 1 on odd ones), so
+// superstep execution pays depth * slow while eager dataflow only pays the
+// critical path, about depth * (slow + fast) / 2
+void RegisterSkewedCase(Registry* registry, bool eager, int depth) {
+    std::string name = std::string("compose/graph/skewed/") +
+                       (eager ? "eager" : "superstep") + "/depth=" + std::to_string(depth);
+    registry->Add(name, [eager, depth](State& state) {
+        int64_t slow_us = state.options().latency_us > 0 ? state.options().latency_us : 1000;
+        FakeLatency slow(slow_us, false);
+        FakeLatency fast(slow_us / 10, false);
+
+        auto graph = std::make_shared<StringGraph>();
+        graph->AddNode("join", std::make_shared<FakeNode>(fast));
+        graph->AddEdge("join", StringGraph::END_NODE);
+        for (int lane = 0; lane < 2; ++lane) {
+            std::string prev = StringGraph::START_NODE;
+            for (int d = 0; d < depth; ++d) {
+                std::string key = "n_" + std::to_string(lane) + "_" + std::to_string(d);
+                bool is_slow = (d % 2) == lane;
+                graph->AddNode(key, std::make_shared<FakeNode>(is_slow ? slow : fast));
+                graph->AddEdge(prev, key);
+                prev = key;
+            }
+            graph->AddEdge(prev, "join");
+        }
+        graph->Compile();
+
+        compose::GraphRunOptions opts;
+        opts.run_type = compose::GraphRunType::DAG;
+        opts.max_run_steps = 0;
+        opts.eager_execution = eager;
+        auto runner = compose::NewGraphRunner(graph, opts);
+        auto ctx = compose::Context::Background();
+        const std::string input = "payload";
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(runner->Run(ctx, input));
+        }
+        state.SetCounter("slow_us", static_cast<double>(slow_us));
+        state.SetCounter("critical_path_us",
+                         static_cast<double>(depth * (slow_us + slow_us / 10) / 2 + slow_us / 10));
+    });
+}
+
+// RegisterSuperstepCase measures one ChannelManager superstep on a plan-backed
+// chain of `nodes` nodes: a single write followed by the ready-channel scan.
+// With the dirty-set scheduler the cost should not grow with `nodes`
+void RegisterSuperstepCase(Registry* registry, int nodes) {
+    registry->Add("compose/superstep/pregel/nodes=" + std::to_string(nodes),
+                  [nodes](State& state) {
+        std::vector<compose::ExecutionPlan::NodeSpec> specs;
+        std::vector<compose::PlanEdge> edges;
+        std::string prev = StringGraph::START_NODE;
+        for (int i = 0; i < nodes; ++i) {
+            compose::ExecutionPlan::NodeSpec spec;
+            spec.name = "n_" + std::to_string(i);
+            specs.push_back(spec);
+            compose::PlanEdge edge;
+            edge.from = prev;
+            edge.to = spec.name;
+            edges.push_back(edge);
+            prev = spec.name;
+        }
+        compose::PlanEdge last;
+        last.from = prev;
+        last.to = StringGraph::END_NODE;
+        edges.push_back(last);
+        auto plan = compose::ExecutionPlan::Build(specs, edges, StringGraph::START_NODE,
+                                                  StringGraph::END_NODE);
+
+        std::vector<std::shared_ptr<compose::Channel>> channels(plan->NodeCount());
+        for (size_t id = 0; id < channels.size(); ++id) {
+            if (static_cast<int>(id) != plan->StartId()) {
+                channels[id] = compose::CreatePregelChannel();
+            }
+        }
+        compose::ChannelManager manager(false, plan, channels);
+        auto value = std::make_shared<std::string>("payload");
+        const std::map<std::string, std::vector<std::string>> no_deps;
+
+        int step = 0;
+        while (state.KeepRunning()) {
+            const std::string& from = specs[step].name;
+            const std::string& to = specs[(step + 1) % nodes].name;
+            std::map<std::string, std::map<std::string, std::shared_ptr<void>>> values;
+            values[to][from] = value;
+            DoNotOptimize(manager.UpdateAndGet(values, no_deps));
+            step = (step + 1) % nodes;
+        }
+        state.SetCounter("nodes", nodes);
+    });
+}
+
+void RegisterChainCase(Registry* registry, int length) {
+    registry->Add("compose/chain/invoke/length=" + std::to_string(length),
+                  [length](State& state) {
+        auto ctx = compose::Context::Background();
+        auto chain = compose::NewChain<std::string, std::string>();
+        for (int i = 0; i < length; ++i) {
+            chain->AppendLambda<std::string>(
+                std::make_shared<FakeNode>(FakeLatency(state.options())));
+        }
+        chain->Compile(ctx);
+        const std::string input = "payload";
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(chain->Invoke(ctx, input));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(length));
+    });
+
+    // Fused: the whole run of lambdas becomes one graph node
+    registry->Add("compose/chain/fused/length=" + std::to_string(length),
+                  [length](State& state) {
+        auto ctx = compose::Context::Background();
+        auto chain = compose::NewChain<std::string, std::string>();
+        for (int i = 0; i < length; ++i) {
+            chain->AppendLambda<std::string>(
+                std::make_shared<FakeNode>(FakeLatency(state.options())));
+        }
+        compose::ChainCompileOptions options;
+        options.enable_fusion = true;
+        chain->Compile(ctx, options);
+        const std::string input = "payload";
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(chain->Invoke(ctx, input));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(length));
+    });
+
+    // Baseline: the same nodes called back to back, without the framework
+    registry->Add("compose/chain/direct/length=" + std::to_string(length),
+                  [length](State& state) {
+        auto ctx = compose::Context::Background();
+        std::vector<std::shared_ptr<FakeNode>> nodes;
+        for (int i = 0; i < length; ++i) {
+            nodes.push_back(std::make_shared<FakeNode>(FakeLatency(state.options())));
+        }
+        const std::string input = "payload";
+
+        while (state.KeepRunning()) {
+            std::string value = input;
+            for (auto& node : nodes) {
+                value = node->Invoke(ctx, value);
+            }
+            DoNotOptimize(value);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(length));
+    });
+}
+
+} // namespace
+
+void RegisterComposeBenchmarks(Registry* registry) {
+    // Fan-in at the join node concatenates lane outputs
+    compose::RegisterValuesMergeFunc<std::string>(
+        [](const std::vector<std::string>& values) {
+            std::string merged;
+            for (const auto& v : values) {
+                merged += v;
+            }
+            return merged;
+        });
+
+    const int shapes[][2] = {{1, 1}, {1, 8}, {1, 32}, {8, 1}, {8, 8}, {32, 4}, {64, 2}};
+    for (const auto& shape : shapes) {
+        RegisterGraphCase(registry, compose::GraphRunType::DAG, shape[0], shape[1]);
+    }
+    for (const auto& shape : shapes) {
+        RegisterGraphCase(registry, compose::GraphRunType::Pregel, shape[0], shape[1]);
+    }
+
+    // Wide graphs: superstep cost should track the tasks that ran, not the
+    // total node count
+    RegisterGraphCase(registry, compose::GraphRunType::DAG, 1000, 1);
+    RegisterGraphCase(registry, compose::GraphRunType::Pregel, 1000, 1);
+    for (int nodes : {16, 1024}) {
+        RegisterSuperstepCase(registry, nodes);
+    }
+
+    // Skewed latencies: eager dataflow vs strict supersteps
+    for (bool eager : {false, true}) {
+        RegisterSkewedCase(registry, eager, 8);
+    }
+
+    for (int length : {1, 4, 16, 20}) {
+        RegisterChainCase(registry, length);
+    }
+}
+
+} // namespace bench
+} // namespace eino
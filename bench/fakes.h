@@ -0,0 +1,133 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_BENCH_FAKES_H_
+#define EINO_CPP_BENCH_FAKES_H_
+
+// Fake components with tunable latency used by the benchmark cases
+// Latency is injected by spinning (default) or sleeping, so a case measures
+// framework overhead plus a known, reproducible component cost. They depend
+// on schema only, so they build without the compose runtime
+
+#include "harness.h"
+#include "eino/schema/types.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+// FakeLatency burns a fixed amount of wall time per call
+struct FakeLatency {
+    int64_t us = 0;
+    bool spin = true;
+
+    FakeLatency() = default;
+    FakeLatency(int64_t latency_us, bool spin_wait) : us(latency_us), spin(spin_wait) {}
+    explicit FakeLatency(const HarnessOptions& options)
+        : us(options.latency_us), spin(options.spin) {}
+
+    void Wait() const {
+        if (us <= 0) {
+            return;
+        }
+        if (!spin) {
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+            return;
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+        while (std::chrono::steady_clock::now() < deadline) {
+        }
+    }
+};
+
+// FakeChatModel answers with a tool call for the first tool_turns calls of a
+// conversation (counted from the tool messages in the input) and then with a
+// final answer; Stream splits the answer into chunk_count chunks. It takes
+// the history as a model component does, without the component interface
+class FakeChatModel {
+public:
+    FakeChatModel(FakeLatency latency, int tool_turns, std::string tool_name,
+                  int chunk_count = 8)
+        : latency_(latency), tool_turns_(tool_turns),
+          tool_name_(std::move(tool_name)), chunk_count_(chunk_count) {}
+
+    schema::Message Generate(const std::vector<schema::Message>& input) const {
+        latency_.Wait();
+        int tool_results = 0;
+        for (const auto& msg : input) {
+            if (msg.role == schema::RoleType::kTool) {
+                ++tool_results;
+            }
+        }
+        if (tool_results < tool_turns_) {
+            schema::ToolCall call;
+            call.id = "call_" + std::to_string(tool_results);
+            call.type = "function";
+            call.function.name = tool_name_;
+            call.function.arguments = "{\"query\":\"step " + std::to_string(tool_results) + "\"}";
+            return schema::Message(schema::RoleType::kAssistant, "", {call});
+        }
+        return schema::AssistantMessage("final answer after " + std::to_string(tool_results) + " tool calls");
+    }
+
+    std::vector<schema::Message> Stream(const std::vector<schema::Message>& input) const {
+        auto full = Generate(input);
+        std::vector<schema::Message> out;
+        if (!full.tool_calls.empty() || chunk_count_ <= 1) {
+            out.push_back(full);
+            return out;
+        }
+        size_t step = (full.content.size() + chunk_count_ - 1) / chunk_count_;
+        for (size_t pos = 0; pos < full.content.size(); pos += step) {
+            out.push_back(schema::AssistantMessage(full.content.substr(pos, step)));
+        }
+        return out;
+    }
+
+private:
+    FakeLatency latency_;
+    int tool_turns_;
+    std::string tool_name_;
+    int chunk_count_;
+};
+
+// FakeTool waits and echoes a fixed-size result
+class FakeTool {
+public:
+    FakeTool(std::string name, FakeLatency latency, size_t result_bytes = 256)
+        : name_(std::move(name)), latency_(latency), result_(result_bytes, 'r') {}
+
+    const std::string& Name() const { return name_; }
+
+    std::string Run(const std::string& arguments_in_json) const {
+        latency_.Wait();
+        return result_;
+    }
+
+private:
+    std::string name_;
+    FakeLatency latency_;
+    std::string result_;
+};
+
+} // namespace bench
+} // namespace eino
+
+#endif // EINO_CPP_BENCH_FAKES_H_
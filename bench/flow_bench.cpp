@@ -0,0 +1,116 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Flow benchmarks: a mocked ReAct loop (model -> tools -> model ...) over
+// fake components, measuring per-turn history handling and dispatch cost
+
+#include "cases.h"
+#include "fakes.h"
+#include "eino/schema/message_concat.h"
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+const char* const kToolName = "search";
+
+// ReActLoop mirrors the ReAct agent graph: call the model with the history,
+// stop on a plain answer, otherwise run every requested tool and append the
+// tool messages. When stream is set the model is streamed and the chunks
+// are concatenated, as the agent does for its streaming output
+schema::Message ReActLoop(
+    const FakeChatModel& model,
+    const std::map<std::string, std::shared_ptr<FakeTool>>& tools,
+    std::vector<schema::Message> history,
+    int max_steps,
+    bool stream) {
+    for (int step = 0; step < max_steps; ++step) {
+        schema::Message reply;
+        if (stream) {
+            std::vector<schema::Message> chunks = model.Stream(history);
+            std::vector<schema::Message*> ptrs;
+            ptrs.reserve(chunks.size());
+            for (auto& c : chunks) {
+                ptrs.push_back(&c);
+            }
+            reply = chunks.size() == 1 ? chunks[0] : schema::ConcatMessages(ptrs);
+        } else {
+            reply = model.Generate(history);
+        }
+        history.push_back(reply);
+
+        if (reply.tool_calls.empty()) {
+            return reply;
+        }
+        for (const auto& call : reply.tool_calls) {
+            auto it = tools.find(call.function.name);
+            if (it == tools.end()) {
+                throw std::runtime_error("unknown tool: " + call.function.name);
+            }
+            schema::Message result = schema::ToolMessage(it->second->Run(call.function.arguments));
+            result.tool_call_id = call.id;
+            result.tool_name = call.function.name;
+            history.push_back(result);
+        }
+    }
+    throw std::runtime_error("ReAct loop exceeded max steps");
+}
+
+void RegisterReActCase(Registry* registry, int tool_turns, int prior_messages, bool stream) {
+    std::string name = "flow/react/" + std::string(stream ? "stream" : "generate") +
+                       "/tool_turns=" + std::to_string(tool_turns) +
+                       "/history=" + std::to_string(prior_messages);
+    registry->Add(name, [tool_turns, prior_messages, stream](State& state) {
+        FakeLatency latency(state.options());
+        FakeChatModel model(latency, tool_turns, kToolName);
+        std::map<std::string, std::shared_ptr<FakeTool>> tools;
+        tools[kToolName] = std::make_shared<FakeTool>(kToolName, latency);
+
+        std::vector<schema::Message> input;
+        input.push_back(schema::SystemMessage(std::string(512, 's')));
+        for (int i = 0; i < prior_messages; ++i) {
+            input.push_back(i % 2 == 0 ? schema::UserMessage(std::string(128, 'u'))
+                                       : schema::AssistantMessage(std::string(128, 'a')));
+        }
+        input.push_back(schema::UserMessage("question"));
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(ReActLoop(model, tools, input, tool_turns + 2, stream));
+        }
+        // One model call per tool turn plus the final answer
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(tool_turns + 1));
+        state.SetCounter("model_calls_per_run", tool_turns + 1);
+    });
+}
+
+} // namespace
+
+void RegisterFlowBenchmarks(Registry* registry) {
+    for (int tool_turns : {0, 2, 8}) {
+        RegisterReActCase(registry, tool_turns, 8, false);
+    }
+    RegisterReActCase(registry, 4, 64, false);
+    RegisterReActCase(registry, 4, 8, true);
+}
+
+} // namespace bench
+} // namespace eino
@@ -0,0 +1,355 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "harness.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+// RunOnce runs one repetition of fn with a fixed iteration count
+State RunOnce(const CaseFunc& fn, const HarnessOptions& options, uint64_t iterations) {
+    State state(options, iterations);
+    fn(state);
+    // A body that never looped (or returned early) is still finished here
+    while (state.KeepRunning()) {
+    }
+    return state;
+}
+
+// Calibrate grows the iteration count until one repetition lasts at least
+// min_rep_ms; the runs double as warmup
+uint64_t Calibrate(const CaseFunc& fn, const HarnessOptions& options) {
+    double target_ns = options.min_rep_ms * 1e6;
+    uint64_t iterations = 1;
+    while (true) {
+        State state = RunOnce(fn, options, iterations);
+        double elapsed = state.ElapsedNs();
+        if (elapsed >= target_ns || iterations >= options.max_iterations) {
+            return iterations;
+        }
+        double grow = elapsed > 0.0 ? 1.4 * target_ns / elapsed : 10.0;
+        grow = std::min(std::max(grow, 2.0), 10.0);
+        uint64_t next = static_cast<uint64_t>(static_cast<double>(iterations) * grow);
+        iterations = std::min(std::max(next, iterations + 1), options.max_iterations);
+    }
+}
+
+std::string JsonEscape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size() + 2);
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+std::string JsonNumber(double v) {
+    if (!std::isfinite(v)) {
+        return "null";
+    }
+    std::ostringstream os;
+    os << std::setprecision(6) << std::fixed << v;
+    std::string s = os.str();
+    // Trim trailing zeros for readability
+    s.erase(s.find_last_not_of('0') + 1);
+    if (!s.empty() && s.back() == '.') {
+        s.pop_back();
+    }
+    return s;
+}
+
+bool ParseInt64(const std::string& s, int64_t* out) {
+    if (s.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    long long v = std::strtoll(s.c_str(), &end, 10);
+    if (*end != '\0') {
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+bool ParseDouble(const std::string& s, double* out) {
+    if (s.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    double v = std::strtod(s.c_str(), &end);
+    if (*end != '\0') {
+        return false;
+    }
+    *out = v;
+    return true;
+}
+
+} // namespace
+
+double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    if (sorted.size() == 1) {
+        return sorted[0];
+    }
+    double rank = std::min(std::max(p, 0.0), 100.0) / 100.0 * static_cast<double>(sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(rank));
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    double frac = rank - static_cast<double>(lo);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+void Registry::Add(const std::string& name, CaseFunc fn) {
+    for (const auto& c : cases_) {
+        if (c.name == name) {
+            throw std::invalid_argument("duplicate benchmark case: " + name);
+        }
+    }
+    cases_.push_back(Case{name, std::move(fn)});
+}
+
+std::vector<std::string> Registry::Names() const {
+    std::vector<std::string> names;
+    names.reserve(cases_.size());
+    for (const auto& c : cases_) {
+        names.push_back(c.name);
+    }
+    return names;
+}
+
+std::vector<CaseResult> Registry::Run(const HarnessOptions& options, std::ostream& log) const {
+    std::vector<CaseResult> results;
+
+    log << std::left << std::setw(48) << "case"
+        << std::right << std::setw(12) << "iters"
+        << std::setw(14) << "p50(ns)"
+        << std::setw(14) << "p90(ns)"
+        << std::setw(14) << "p99(ns)"
+        << std::setw(16) << "items/s" << "\n";
+
+    for (const auto& c : cases_) {
+        if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        CaseResult result;
+        result.name = c.name;
+        try {
+            uint64_t iterations = Calibrate(c.fn, options);
+            for (int i = 0; i < options.warmup; ++i) {
+                RunOnce(c.fn, options, iterations);
+            }
+
+            std::vector<double> samples;
+            samples.reserve(static_cast<size_t>(std::max(options.repetitions, 1)));
+            double items = 0.0;
+            double bytes = 0.0;
+            double total_ns = 0.0;
+            for (int i = 0; i < std::max(options.repetitions, 1); ++i) {
+                State state = RunOnce(c.fn, options, iterations);
+                double elapsed = state.ElapsedNs();
+                samples.push_back(elapsed / static_cast<double>(iterations));
+                items += static_cast<double>(state.items());
+                bytes += static_cast<double>(state.bytes());
+                total_ns += elapsed;
+                result.counters = state.counters();
+            }
+
+            std::vector<double> sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (double s : samples) {
+                sum += s;
+            }
+            double mean = sum / static_cast<double>(samples.size());
+            double var = 0.0;
+            for (double s : samples) {
+                var += (s - mean) * (s - mean);
+            }
+
+            result.iterations = iterations;
+            result.repetitions = static_cast<int>(samples.size());
+            result.mean_ns = mean;
+            result.stddev_ns = std::sqrt(var / static_cast<double>(samples.size()));
+            result.min_ns = sorted.front();
+            result.p50_ns = Percentile(sorted, 50.0);
+            result.p90_ns = Percentile(sorted, 90.0);
+            result.p99_ns = Percentile(sorted, 99.0);
+            result.max_ns = sorted.back();
+            if (total_ns > 0.0) {
+                result.items_per_second = items * 1e9 / total_ns;
+                result.bytes_per_second = bytes * 1e9 / total_ns;
+            }
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+
+        log << std::left << std::setw(48) << result.name << std::right;
+        if (!result.error.empty()) {
+            log << "  error: " << result.error << "\n";
+        } else {
+            log << std::setw(12) << result.iterations
+                << std::setw(14) << std::fixed << std::setprecision(1) << result.p50_ns
+                << std::setw(14) << result.p90_ns
+                << std::setw(14) << result.p99_ns
+                << std::setw(16) << std::setprecision(0) << result.items_per_second << "\n";
+        }
+        log.flush();
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+bool ParseArgs(int argc, char** argv, HarnessOptions* options, std::string* error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string key = arg;
+        std::string value;
+        bool has_value = false;
+        auto eq = arg.find('=');
+        if (eq != std::string::npos) {
+            key = arg.substr(0, eq);
+            value = arg.substr(eq + 1);
+            has_value = true;
+        }
+
+        int64_t n = 0;
+        double d = 0.0;
+        if (key == "--list") {
+            options->list_only = true;
+        } else if (key == "--sleep") {
+            options->spin = false;
+        } else if (!has_value) {
+            *error = "missing value for " + key;
+            return false;
+        } else if (key == "--filter") {
+            options->filter = value;
+        } else if (key == "--json") {
+            options->json_path = value;
+        } else if (key == "--warmup" && ParseInt64(value, &n) && n >= 0) {
+            options->warmup = static_cast<int>(n);
+        } else if (key == "--repetitions" && ParseInt64(value, &n) && n > 0) {
+            options->repetitions = static_cast<int>(n);
+        } else if (key == "--min_rep_ms" && ParseDouble(value, &d) && d >= 0.0) {
+            options->min_rep_ms = d;
+        } else if (key == "--max_iterations" && ParseInt64(value, &n) && n > 0) {
+            options->max_iterations = static_cast<uint64_t>(n);
+        } else if (key == "--latency_us" && ParseInt64(value, &n) && n >= 0) {
+            options->latency_us = n;
+        } else {
+            *error = "invalid flag: " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string Usage(const char* argv0) {
+    std::ostringstream os;
+    os << "usage: " << argv0 << " [flags]\n"
+       << "  --filter=SUBSTR        run only cases whose name contains SUBSTR\n"
+       << "  --list                 list case names and exit\n"
+       << "  --warmup=N             warmup repetitions (default 2)\n"
+       << "  --repetitions=N        measured repetitions (default 15)\n"
+       << "  --min_rep_ms=MS        minimum time per repetition (default 20)\n"
+       << "  --max_iterations=N     cap on iterations per repetition\n"
+       << "  --latency_us=US        latency of fake components (default 0)\n"
+       << "  --sleep                fake components sleep instead of spinning\n"
+       << "  --json=PATH            write a JSON report to PATH ('-' = stdout)\n";
+    return os.str();
+}
+
+void WriteJSON(std::ostream& out, const HarnessOptions& options,
+               const std::vector<CaseResult>& results) {
+    std::time_t now = std::time(nullptr);
+    char date[32] = {0};
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"warmup\": " << options.warmup << ",\n";
+    out << "    \"repetitions\": " << options.repetitions << ",\n";
+    out << "    \"min_rep_ms\": " << JsonNumber(options.min_rep_ms) << ",\n";
+    out << "    \"latency_us\": " << options.latency_us << ",\n";
+    out << "    \"latency_mode\": \"" << (options.spin ? "spin" : "sleep") << "\"\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << JsonEscape(r.name) << "\",\n";
+        if (!r.error.empty()) {
+            out << "      \"error\": \"" << JsonEscape(r.error) << "\"\n";
+            out << "    }";
+            continue;
+        }
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"repetitions\": " << r.repetitions << ",\n";
+        out << "      \"time_unit\": \"ns\",\n";
+        out << "      \"mean\": " << JsonNumber(r.mean_ns) << ",\n";
+        out << "      \"stddev\": " << JsonNumber(r.stddev_ns) << ",\n";
+        out << "      \"min\": " << JsonNumber(r.min_ns) << ",\n";
+        out << "      \"p50\": " << JsonNumber(r.p50_ns) << ",\n";
+        out << "      \"p90\": " << JsonNumber(r.p90_ns) << ",\n";
+        out << "      \"p99\": " << JsonNumber(r.p99_ns) << ",\n";
+        out << "      \"max\": " << JsonNumber(r.max_ns) << ",\n";
+        out << "      \"items_per_second\": " << JsonNumber(r.items_per_second) << ",\n";
+        out << "      \"bytes_per_second\": " << JsonNumber(r.bytes_per_second) << ",\n";
+        out << "      \"counters\": {";
+        size_t k = 0;
+        for (const auto& kv : r.counters) {
+            out << (k++ == 0 ? "" : ", ") << "\"" << JsonEscape(kv.first) << "\": "
+                << JsonNumber(kv.second);
+        }
+        out << "}\n";
+        out << "    }";
+    }
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+} // namespace bench
+} // namespace eino
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_BENCH_HARNESS_H_
+#define EINO_CPP_BENCH_HARNESS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+// HarnessOptions controls how every case is measured
+struct HarnessOptions {
+    // Warmup repetitions run before measuring; their samples are discarded
+    int warmup = 2;
+
+    // Repetitions are measured samples; percentiles are taken over them
+    int repetitions = 15;
+
+    // MinRepMs is the minimum wall time of one repetition; the number of
+    // iterations per repetition is calibrated to reach it
+    double min_rep_ms = 20.0;
+
+    // MaxIterations caps the calibrated iterations per repetition
+    uint64_t max_iterations = uint64_t(1) << 24;
+
+    // Filter runs only cases whose name contains this substring
+    std::string filter;
+
+    // JsonPath receives the JSON report ("-" for stdout, empty for none)
+    std::string json_path;
+
+    // LatencyUs is the latency injected by fake components
+    int64_t latency_us = 0;
+
+    // Spin makes fake components busy-wait instead of sleeping, which keeps
+    // results reproducible at microsecond latencies
+    bool spin = true;
+
+    // ListOnly prints case names without running them
+    bool list_only = false;
+};
+
+// State is handed to a case body; the body does its setup and then loops
+// while KeepRunning() returns true. Only the loop is timed
+//
+// Example:
+//   registry.Add("schema/pipe", [](State& state) {
+//       auto payload = MakePayload();
+//       while (state.KeepRunning()) {
+//           RunOnce(payload);
+//       }
+//       state.SetItemsProcessed(state.iterations());
+//   });
+class State {
+public:
+    State(const HarnessOptions& options, uint64_t iterations)
+        : options_(options), iterations_(iterations) {}
+
+    // KeepRunning starts the timer on the first call and stops it once the
+    // requested number of iterations has run
+    bool KeepRunning() {
+        if (!started_) {
+            started_ = true;
+            start_ = Clock::now();
+        }
+        if (count_ < iterations_) {
+            ++count_;
+            return true;
+        }
+        if (!finished_) {
+            finished_ = true;
+            elapsed_ += Clock::now() - start_;
+        }
+        return false;
+    }
+
+    // PauseTiming and ResumeTiming exclude per-iteration setup from the sample
+    void PauseTiming() {
+        elapsed_ += Clock::now() - start_;
+    }
+
+    void ResumeTiming() {
+        start_ = Clock::now();
+    }
+
+    uint64_t iterations() const { return iterations_; }
+    const HarnessOptions& options() const { return options_; }
+
+    // SetItemsProcessed reports the logical items handled by the whole loop
+    // (messages, chunks, nodes); it is turned into items/s
+    void SetItemsProcessed(uint64_t items) { items_ = items; }
+
+    // SetBytesProcessed reports payload bytes handled by the whole loop
+    void SetBytesProcessed(uint64_t bytes) { bytes_ = bytes; }
+
+    // SetCounter attaches a case-specific value to the report (last rep wins)
+    void SetCounter(const std::string& name, double value) { counters_[name] = value; }
+
+    double ElapsedNs() const {
+        return std::chrono::duration<double, std::nano>(elapsed_).count();
+    }
+
+    uint64_t items() const { return items_; }
+    uint64_t bytes() const { return bytes_; }
+    const std::map<std::string, double>& counters() const { return counters_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const HarnessOptions& options_;
+    uint64_t iterations_;
+    uint64_t count_ = 0;
+    bool started_ = false;
+    bool finished_ = false;
+    Clock::time_point start_;
+    Clock::duration elapsed_ = Clock::duration::zero();
+    uint64_t items_ = 0;
+    uint64_t bytes_ = 0;
+    std::map<std::string, double> counters_;
+};
+
+using CaseFunc = std::function<void(State&)>;
+
+// CaseResult is the summary of one case; latencies are ns per iteration
+struct CaseResult {
+    std::string name;
+    uint64_t iterations = 0;  // per repetition
+    int repetitions = 0;
+    double mean_ns = 0.0;
+    double stddev_ns = 0.0;
+    double min_ns = 0.0;
+    double p50_ns = 0.0;
+    double p90_ns = 0.0;
+    double p99_ns = 0.0;
+    double max_ns = 0.0;
+    double items_per_second = 0.0;
+    double bytes_per_second = 0.0;
+    std::map<std::string, double> counters;
+    std::string error;  // non-empty when the case threw
+};
+
+// Percentile returns the p-th percentile (0..100) of sorted samples using
+// linear interpolation between closest ranks
+double Percentile(const std::vector<double>& sorted, double p);
+
+// Registry holds the benchmark cases in registration order
+class Registry {
+public:
+    void Add(const std::string& name, CaseFunc fn);
+
+    // Run measures every case matching options.filter, logging a table row
+    // per case to log
+    std::vector<CaseResult> Run(const HarnessOptions& options, std::ostream& log) const;
+
+    // Names returns the registered case names
+    std::vector<std::string> Names() const;
+
+private:
+    struct Case {
+        std::string name;
+        CaseFunc fn;
+    };
+    std::vector<Case> cases_;
+};
+
+// ParseArgs fills options from the command line; returns false with error
+// set on unknown or malformed flags
+bool ParseArgs(int argc, char** argv, HarnessOptions* options, std::string* error);
+
+// Usage returns the command line help text
+std::string Usage(const char* argv0);
+
+// WriteJSON writes the report for results
+void WriteJSON(std::ostream& out, const HarnessOptions& options,
+               const std::vector<CaseResult>& results);
+
+// DoNotOptimize keeps value observable so the loop body is not elided
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+} // namespace eino
+
+#endif // EINO_CPP_BENCH_HARNESS_H_
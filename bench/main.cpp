@@ -0,0 +1,82 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// eino_bench: throughput/latency benchmarks for graphs, streams and agents
+//
+// Usage:
+//   eino_bench                                  # run everything
+//   eino_bench --filter=adk/executor --json=out.json
+//   eino_bench --latency_us=50 --filter=adk/hedging
+
+#include "cases.h"
+#include "harness.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    using namespace eino::bench;
+
+    HarnessOptions options;
+    std::string error;
+    if (!ParseArgs(argc, argv, &options, &error)) {
+        std::cerr << error << "\n" << Usage(argv[0]);
+        return 2;
+    }
+
+    Registry registry;
+#ifdef EINO_BENCH_COMPOSE
+    RegisterComposeBenchmarks(&registry);
+    RegisterCheckpointBenchmarks(&registry);
+#endif
+    RegisterBranchBenchmarks(&registry);
+    RegisterMessageBenchmarks(&registry);
+    RegisterFlowBenchmarks(&registry);
+    RegisterStreamBenchmarks(&registry);
+    RegisterAgentBenchmarks(&registry);
+    RegisterMetricsBenchmarks(&registry);
+
+    if (options.list_only) {
+        for (const auto& name : registry.Names()) {
+            std::cout << name << "\n";
+        }
+        return 0;
+    }
+
+    // Keep the table off stdout when the JSON report goes there
+    std::ostream& log = options.json_path == "-" ? std::cerr : std::cout;
+    auto results = registry.Run(options, log);
+
+    if (!options.json_path.empty()) {
+        if (options.json_path == "-") {
+            WriteJSON(std::cout, options, results);
+        } else {
+            std::ofstream out(options.json_path);
+            if (!out) {
+                std::cerr << "cannot write " << options.json_path << "\n";
+                return 1;
+            }
+            WriteJSON(out, options, results);
+        }
+    }
+
+    for (const auto& r : results) {
+        if (!r.error.empty()) {
+            return 1;
+        }
+    }
+    return 0;
+}
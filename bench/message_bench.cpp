@@ -0,0 +1,252 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Message benchmarks: streaming message concatenation, JSON encoding and
+// prompt formatting
+
+#include "cases.h"
+#include "eino/schema/fast_json.h"
+#include "eino/schema/message_concat.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef EINO_BENCH_COMPOSE
+#include "eino/components/prompt.h"
+#endif
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+// Chunk payload of one streamed message delta
+const size_t kChunkBytes = 16;
+
+void RegisterConcatCase(Registry* registry, int chunks, bool with_tool_calls) {
+    std::string name = "schema/concat_messages/chunks=" + std::to_string(chunks);
+    if (with_tool_calls) {
+        name += "/tool_calls";
+    }
+    registry->Add(name, [chunks, with_tool_calls](State& state) {
+        // Indices live as long as the messages that point at them
+        std::vector<int> indices(static_cast<size_t>(chunks));
+        std::vector<schema::Message> messages;
+        messages.reserve(static_cast<size_t>(chunks));
+        for (int i = 0; i < chunks; ++i) {
+            schema::Message msg = schema::AssistantMessage(std::string(kChunkBytes, 'a'));
+            if (with_tool_calls) {
+                indices[static_cast<size_t>(i)] = i % 2;
+                schema::ToolCall call;
+                call.index = &indices[static_cast<size_t>(i)];
+                if (i < 2) {
+                    call.id = "call_" + std::to_string(i);
+                    call.function.name = "search";
+                }
+                call.function.arguments = "{\"q\":1}";
+                msg.tool_calls.push_back(call);
+            }
+            messages.push_back(msg);
+        }
+        std::vector<schema::Message*> ptrs;
+        for (auto& m : messages) {
+            ptrs.push_back(&m);
+        }
+
+        while (state.KeepRunning()) {
+            DoNotOptimize(schema::ConcatMessages(ptrs));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(chunks));
+        state.SetBytesProcessed(state.iterations() * static_cast<uint64_t>(chunks) * kChunkBytes);
+    });
+}
+
+// RegisterIncrementalConcatCase feeds chunks to a MessageConcatenator one
+// at a time, taking a snapshot every `snapshot_every` chunks as streaming
+// callbacks and checkpoints do
+void RegisterIncrementalConcatCase(Registry* registry, int chunks, int snapshot_every) {
+    registry->Add("schema/concat_messages/incremental/chunks=" + std::to_string(chunks) +
+                      "/snapshot_every=" + std::to_string(snapshot_every),
+                  [chunks, snapshot_every](State& state) {
+        std::vector<schema::Message> messages(
+            static_cast<size_t>(chunks), schema::AssistantMessage(std::string(kChunkBytes, 'a')));
+
+        while (state.KeepRunning()) {
+            schema::MessageConcatenator concat;
+            for (int i = 0; i < chunks; ++i) {
+                concat.Add(messages[static_cast<size_t>(i)]);
+                if ((i + 1) % snapshot_every == 0) {
+                    DoNotOptimize(concat.Snapshot());
+                }
+            }
+            DoNotOptimize(concat.Finish());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(chunks));
+        state.SetBytesProcessed(state.iterations() * static_cast<uint64_t>(chunks) * kChunkBytes);
+    });
+}
+
+// JsonConversation is a chat history shaped like a model request: text
+// turns with a few escapes, and assistant turns that call a tool
+std::vector<schema::Message> JsonConversation(int turns, size_t content_bytes) {
+    std::string text;
+    while (text.size() < content_bytes) {
+        text += "Summarize the \"quarterly\" report for region ";
+        text += std::to_string(text.size());
+        text += ".\n";
+    }
+    std::vector<schema::Message> messages;
+    for (int i = 0; i < turns; ++i) {
+        if (i % 4 == 3) {
+            schema::Message msg(schema::RoleType::kAssistant, "");
+            schema::ToolCall call;
+            call.id = "call_" + std::to_string(i);
+            call.type = "function";
+            call.function.name = "search";
+            call.function.arguments = "{\"query\":\"" + text.substr(0, 64) + "\"}";
+            msg.tool_calls.push_back(call);
+            messages.push_back(msg);
+        } else {
+            messages.push_back(schema::UserMessage(text));
+        }
+    }
+    return messages;
+}
+
+// EncodeWithDOM builds the request the way BuildRequestJSON does, one
+// nlohmann node per field, then dumps it
+std::string EncodeWithDOM(const std::vector<schema::Message>& messages) {
+    using Object = std::map<std::string, schema::json>;
+    std::vector<schema::json> items;
+    for (const auto& msg : messages) {
+        Object obj{{"role", schema::RoleTypeToString(msg.role)}, {"content", msg.content}};
+        if (!msg.tool_calls.empty()) {
+            std::vector<schema::json> calls;
+            for (const auto& tc : msg.tool_calls) {
+                calls.push_back(schema::json(Object{
+                    {"id", tc.id},
+                    {"type", tc.type},
+                    {"function", schema::json(Object{{"name", tc.function.name},
+                                                     {"arguments", tc.function.arguments}})},
+                }));
+            }
+            obj["tool_calls"] = schema::json(calls);
+        }
+        items.push_back(schema::json(obj));
+    }
+    return schema::json(items).dump();
+}
+
+// RegisterJsonEncodeCase serializes a conversation per iteration, either
+// through the nlohmann DOM or the streaming writer with a reused buffer
+void RegisterJsonEncodeCase(Registry* registry, int turns, bool fast) {
+    registry->Add(std::string("schema/json/encode/") + (fast ? "fast" : "nlohmann") +
+                      "/turns=" + std::to_string(turns),
+                  [turns, fast](State& state) {
+        auto messages = JsonConversation(turns, 512);
+        schema::JsonWriter writer;
+        size_t bytes = 0;
+        while (state.KeepRunning()) {
+            if (fast) {
+                writer.Clear();
+                schema::WriteMessages(writer, messages);
+                bytes = writer.size();
+                DoNotOptimize(writer.str());
+            } else {
+                std::string out = EncodeWithDOM(messages);
+                bytes = out.size();
+                DoNotOptimize(out);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(turns));
+        state.SetBytesProcessed(state.iterations() * bytes);
+    });
+}
+
+// RegisterJsonDecodeCase parses a conversation straight into Messages. The
+// bundled nlohmann header has no parser, so there is no DOM counterpart
+void RegisterJsonDecodeCase(Registry* registry, int turns) {
+    registry->Add("schema/json/decode/fast/turns=" + std::to_string(turns),
+                  [turns](State& state) {
+        schema::JsonWriter writer;
+        schema::WriteMessages(writer, JsonConversation(turns, 512));
+        const std::string text = writer.Take();
+        while (state.KeepRunning()) {
+            DoNotOptimize(schema::ParseMessages(text));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(turns));
+        state.SetBytesProcessed(state.iterations() * text.size());
+    });
+}
+
+#ifdef EINO_BENCH_COMPOSE
+// RegisterPromptCase formats `templates` messages, each referencing every
+// one of `variables` placeholders around a fixed block of instructions
+void RegisterPromptCase(Registry* registry, int templates, int variables) {
+    registry->Add("components/prompt/format/templates=" + std::to_string(templates) +
+                      "/variables=" + std::to_string(variables),
+                  [templates, variables](State& state) {
+        auto ctx = compose::Context::Background();
+        std::string body = std::string(256, 'p') + "\n";
+        std::map<std::string, components::json> vars;
+        for (int v = 0; v < variables; ++v) {
+            std::string key = "var_" + std::to_string(v);
+            body += "{" + key + "} ";
+            vars[key] = "value_" + std::to_string(v);
+        }
+        std::vector<std::string> bodies(static_cast<size_t>(templates), body);
+        components::PromptTemplate prompt(bodies);
+
+        size_t bytes = 0;
+        while (state.KeepRunning()) {
+            auto messages = prompt.Format(ctx, vars);
+            bytes = 0;
+            for (const auto& m : messages) {
+                bytes += m.content.size();
+            }
+            DoNotOptimize(messages);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(templates));
+        state.SetBytesProcessed(state.iterations() * bytes);
+    });
+}
+#endif
+
+} // namespace
+
+void RegisterMessageBenchmarks(Registry* registry) {
+    for (int chunks : {16, 256, 4096}) {
+        RegisterConcatCase(registry, chunks, false);
+    }
+    RegisterConcatCase(registry, 256, true);
+    RegisterIncrementalConcatCase(registry, 4096, 64);
+
+    for (int turns : {8, 128}) {
+        RegisterJsonEncodeCase(registry, turns, false);
+        RegisterJsonEncodeCase(registry, turns, true);
+        RegisterJsonDecodeCase(registry, turns);
+    }
+
+#ifdef EINO_BENCH_COMPOSE
+    RegisterPromptCase(registry, 1, 4);
+    RegisterPromptCase(registry, 4, 16);
+    RegisterPromptCase(registry, 16, 64);
+#endif
+}
+
+} // namespace bench
+} // namespace eino
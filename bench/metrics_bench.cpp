@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Metrics benchmarks: per-event cost of the runtime counters and histograms
+// recorded on the graph/stream/tool hot paths (budget: < 50 ns per event)
+
+#include "cases.h"
+#include "eino/internal/metrics.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+namespace metrics = internal::metrics;
+
+void RegisterRecordCases(Registry* registry, int threads) {
+    std::string suffix = "/threads=" + std::to_string(threads);
+
+    registry->Add("internal/metrics/counter_inc" + suffix, [threads](State& state) {
+        auto counter = metrics::Registry::Global().GetCounter(
+            "bench_counter_total", "benchmark counter");
+        // Background writers share no cache lines with the measured thread
+        std::vector<std::thread> others;
+        std::atomic<bool> stop{false};
+        for (int i = 1; i < threads; ++i) {
+            others.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    counter.Inc();
+                }
+            });
+        }
+        while (state.KeepRunning()) {
+            counter.Inc();
+        }
+        stop = true;
+        for (auto& t : others) {
+            t.join();
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    registry->Add("internal/metrics/histogram_record" + suffix, [threads](State& state) {
+        auto hist = metrics::Registry::Global().GetHistogram(
+            "bench_latency_ns", "benchmark histogram");
+        std::vector<std::thread> others;
+        std::atomic<bool> stop{false};
+        for (int i = 1; i < threads; ++i) {
+            others.emplace_back([&] {
+                uint64_t v = 1;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    hist.Record(v++ & 0xfffff);
+                }
+            });
+        }
+        uint64_t v = 12345;
+        while (state.KeepRunning()) {
+            hist.Record(v);
+            v = v * 6364136223846793005ULL + 1442695040888963407ULL;
+            v >>= 40;
+        }
+        stop = true;
+        for (auto& t : others) {
+            t.join();
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+} // namespace
+
+void RegisterMetricsBenchmarks(Registry* registry) {
+    RegisterRecordCases(registry, 1);
+    RegisterRecordCases(registry, 4);
+
+    // What TaskManager::Execute pays per task: family lookup + two clock reads
+    registry->Add("internal/metrics/labeled_timer", [](State& state) {
+        metrics::HistogramFamily family("bench_node_ns", "benchmark family", "node");
+        const std::string node = "chat_model_node";
+        while (state.KeepRunning()) {
+            metrics::ScopedTimer timer(family.WithLabel(node));
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    registry->Add("internal/metrics/snapshot_prometheus", [](State& state) {
+        while (state.KeepRunning()) {
+            DoNotOptimize(metrics::Registry::Global().Snapshot().ToPrometheus());
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+} // namespace bench
+} // namespace eino
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Stream benchmarks: schema::Pipe throughput and ParentStreamReader fan-out
+
+#include "cases.h"
+#include "eino/schema/stream.h"
+#include "eino/schema/stream_copy.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eino {
+namespace bench {
+
+namespace {
+
+// Chunk payload sent through the streams: the size of a typical LLM delta
+const size_t kChunkBytes = 16;
+
+void RegisterPipeCase(Registry* registry, int capacity, int chunks) {
+    registry->Add("schema/pipe/capacity=" + std::to_string(capacity) +
+                      "/chunks=" + std::to_string(chunks),
+                  [capacity, chunks](State& state) {
+        const std::string chunk(kChunkBytes, 'c');
+
+        while (state.KeepRunning()) {
+            auto pipe = schema::Pipe<std::string>(capacity);
+            auto reader = pipe.first;
+            auto writer = pipe.second;
+            std::thread producer([&writer, &chunk, chunks]() {
+                for (int i = 0; i < chunks; ++i) {
+                    if (writer->Send(chunk)) {
+                        break;
+                    }
+                }
+                writer->Close();
+            });
+            std::string value;
+            size_t received = 0;
+            while (reader->Recv(value)) {
+                received += value.size();
+            }
+            producer.join();
+            DoNotOptimize(received);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(chunks));
+        state.SetBytesProcessed(state.iterations() * static_cast<uint64_t>(chunks) * kChunkBytes);
+    });
+}
+
+void RegisterFanOutCase(Registry* registry, int copies, int chunks) {
+    registry->Add("schema/stream_copy/copies=" + std::to_string(copies) +
+                      "/chunks=" + std::to_string(chunks),
+                  [copies, chunks](State& state) {
+        const std::string chunk(kChunkBytes, 'c');
+
+        while (state.KeepRunning()) {
+            auto pipe = schema::Pipe<std::string>(chunks);
+            for (int i = 0; i < chunks; ++i) {
+                pipe.second->Send(chunk);
+            }
+            pipe.second->Close();
+
+            auto children = schema::CopyStreamReader<std::string>(pipe.first, copies);
+            std::vector<std::thread> consumers;
+            consumers.reserve(children.size());
+            for (auto& child : children) {
+                consumers.emplace_back([child]() {
+                    std::string value;
+                    size_t received = 0;
+                    while (child->Recv(value)) {
+                        received += value.size();
+                    }
+                    child->Close();
+                    DoNotOptimize(received);
+                });
+            }
+            for (auto& t : consumers) {
+                t.join();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<uint64_t>(chunks) *
+                                static_cast<uint64_t>(copies));
+    });
+}
+
+} // namespace
+
+void RegisterStreamBenchmarks(Registry* registry) {
+    for (int capacity : {1, 16, 256}) {
+        RegisterPipeCase(registry, capacity, 4096);
+    }
+    for (int copies : {2, 4, 16}) {
+        RegisterFanOutCase(registry, copies, 1024);
+    }
+}
+
+} // namespace bench
+} // namespace eino
@@ -37,7 +37,6 @@
 #include "async_iterator.h"
 #include <memory>
 #include <string>
-#include <thread>
 
 namespace eino {
 namespace adk {
@@ -72,8 +71,10 @@ public:
         
         auto pair = NewAsyncIteratorPair<std::shared_ptr<AgentEvent>>();
         
-        // Process stream in background thread
-        std::thread([stream, converter, generator = pair.second]() {
+        // Process stream on the agent executor
+        AgentExecutor::Default().Submit([stream, converter, generator = pair.second]() {
+            // StreamReader::Read waits without telling the executor
+            AgentExecutor::BlockingScope blocking;
             try {
                 OutputType output;
                 while (stream->Read(output)) {
@@ -93,7 +94,7 @@ public:
             if (generator) {
                 generator->Close();
             }
-        }).detach();
+        });
         
         return pair.first;
     }
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_AGENT_CORO_H_
+#define EINO_CPP_ADK_AGENT_CORO_H_
+
+// C++20 coroutine front end for the agent executor
+//
+// Built only with -DEINO_ADK_COROUTINES=ON, which raises the standard to
+// C++20. AgentTask bodies run on AgentExecutor; co_await NextValue(iter)
+// suspends the task until the iterator has a value or closes, without
+// holding a thread, the same way PumpAsync does for C++14 callers.
+//
+// Example:
+//   AgentTask Forward(std::shared_ptr<AsyncIterator<EventPtr>> in,
+//                     std::shared_ptr<AsyncGenerator<EventPtr>> out) {
+//       EventPtr event;
+//       while (co_await NextValue(in, &event)) {
+//           out->Send(event);
+//       }
+//       out->Close();
+//   }
+
+#if defined(EINO_CPP_ADK_COROUTINES) && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+
+#include "agent_executor.h"
+#include "async_iterator.h"
+
+namespace eino {
+namespace adk {
+
+// AgentTask is a fire-and-forget coroutine started on the agent executor.
+// Uncaught exceptions are dropped, as with Submit
+class AgentTask {
+public:
+    struct promise_type {
+        AgentTask get_return_object() { return {}; }
+
+        // Start on a worker rather than on the caller's thread
+        auto initial_suspend() noexcept {
+            struct Schedule {
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> h) const {
+                    AgentExecutor::Default().Submit([h]() { h.resume(); });
+                }
+                void await_resume() const noexcept {}
+            };
+            return Schedule{};
+        }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+    };
+};
+
+// NextValueAwaiter resumes with true and a value in *out, or with false
+// once the iterator is closed and drained
+template <typename T>
+class NextValueAwaiter {
+public:
+    NextValueAwaiter(std::shared_ptr<AsyncIterator<T>> iter, T* out)
+        : iter_(std::move(iter)), out_(out) {}
+
+    bool await_ready() { return Poll(); }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        while (true) {
+            // Once registered, the task may resume on another worker
+            // before this returns, so touch nothing after it
+            if (iter_->NotifyWhenReady([h]() {
+                    AgentExecutor::Default().Submit([h]() { h.resume(); });
+                })) {
+                return true;
+            }
+            // A value or Close slipped in meanwhile; resume at once
+            if (Poll()) {
+                return false;
+            }
+        }
+    }
+
+    bool await_resume() {
+        // Woken by the generator: with a single consumer this settles
+        if (!done_) {
+            Poll();
+        }
+        return has_value_;
+    }
+
+private:
+    // Poll tries to take a value; it returns true when the await is settled
+    bool Poll() {
+        bool closed = false;
+        has_value_ = iter_->TryNext(*out_, &closed);
+        done_ = has_value_ || closed;
+        return done_;
+    }
+
+    std::shared_ptr<AsyncIterator<T>> iter_;
+    T* out_;
+    bool has_value_ = false;
+    bool done_ = false;
+};
+
+template <typename T>
+NextValueAwaiter<T> NextValue(std::shared_ptr<AsyncIterator<T>> iter, T* out) {
+    return NextValueAwaiter<T>(std::move(iter), out);
+}
+
+} // namespace adk
+} // namespace eino
+
+#endif // EINO_CPP_ADK_COROUTINES && __cpp_impl_coroutine
+
+#endif // EINO_CPP_ADK_AGENT_CORO_H_
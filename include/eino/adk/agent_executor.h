@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_AGENT_EXECUTOR_H_
+#define EINO_CPP_ADK_AGENT_EXECUTOR_H_
+
+// Shared executor for agent runs
+//
+// Agent Run/Resume bodies and event pumps are tasks on one process-wide
+// pool instead of a detached thread each. Pumps are continuations: they
+// hold no thread while the upstream agent is busy, see PumpAsync in
+// async_iterator.h. Layers that only forward events (runner checkpointing,
+// transfer wrappers, flow orchestration) splice the inner agent into their
+// own generator with ForwardInline instead, and run no task per event.
+//
+// Bodies that still block (a synchronous model call, AsyncIterator::Next)
+// mark the wait with BlockingScope; the pool then starts a replacement
+// worker so queued continuations keep running, and retires spare workers
+// once they idle. Threads track the number of concurrent blocking waits,
+// not the depth of agent nesting.
+//
+// Model and tool calls are synchronous in this tree, so a ChatModelAgent
+// run holds one worker for its whole body. Threads therefore still grow
+// with the sessions that have a model or tool call in flight; the pool
+// only removes the extra thread per nesting layer and per pump. The bound
+// is max_threads: at the cap a blocked body gets no replacement and queued
+// tasks wait for a worker. Lower it to bound threads at the cost of
+// queueing.
+//
+// Example:
+//   AgentExecutor::Default().Submit([gen]() {
+//       gen->Send(Work());
+//       gen->Close();
+//   });
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace eino {
+namespace adk {
+
+class AgentExecutor {
+public:
+    struct Options {
+        // Workers kept busy with runnable tasks; 0 means hardware threads
+        size_t core_threads = 0;
+        // Hard cap including replacements for blocked workers; the only
+        // bound on threads held by concurrent agent runs
+        size_t max_threads = 4096;
+        // Spare workers exit after idling this long
+        std::chrono::milliseconds idle_timeout{2000};
+        // Called on the worker with any exception escaping a task; when
+        // unset the error is written to stderr
+        std::function<void(std::exception_ptr)> on_task_error;
+    };
+
+    AgentExecutor() : AgentExecutor(Options()) {}
+    explicit AgentExecutor(const Options& options);
+
+    // Waits for queued tasks to finish and for every worker to exit
+    ~AgentExecutor();
+
+    AgentExecutor(const AgentExecutor&) = delete;
+    AgentExecutor& operator=(const AgentExecutor&) = delete;
+
+    // Default is the process-wide executor used by the ADK agents
+    static AgentExecutor& Default();
+
+    // Submit queues a task. Tasks report errors through their own
+    // generator; an exception escaping one goes to Options::on_task_error
+    void Submit(std::function<void()> task);
+
+    // Threads is the number of live workers, PeakThreads the most seen at
+    // once, Blocked the workers inside a BlockingScope
+    size_t Threads() const;
+    size_t PeakThreads() const;
+    size_t Blocked() const;
+
+    // BlockingScope marks the calling worker as waiting on something other
+    // than the pool; outside a worker it does nothing
+    class BlockingScope {
+    public:
+        BlockingScope();
+        ~BlockingScope();
+        BlockingScope(const BlockingScope&) = delete;
+        BlockingScope& operator=(const BlockingScope&) = delete;
+
+    private:
+        AgentExecutor* executor_;
+    };
+
+private:
+    void WorkerLoop();
+    void ReportTaskError(std::exception_ptr error) const;
+    // MaybeSpawnLocked starts a worker when queued work has nobody to run it
+    void MaybeSpawnLocked();
+    size_t RunnableLocked() const { return threads_ - blocked_; }
+
+    Options options_;
+    mutable std::mutex mu_;
+    std::condition_variable work_cv_;
+    std::condition_variable exit_cv_;
+    std::deque<std::function<void()>> queue_;
+    size_t threads_ = 0;
+    size_t peak_threads_ = 0;
+    size_t idle_ = 0;
+    size_t blocked_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace adk
+} // namespace eino
+
+#endif // EINO_CPP_ADK_AGENT_EXECUTOR_H_
@@ -17,11 +17,21 @@
 #ifndef EINO_CPP_ADK_ASYNC_ITERATOR_H_
 #define EINO_CPP_ADK_ASYNC_ITERATOR_H_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <memory>
-#include <queue>
 #include <mutex>
-#include <condition_variable>
-#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "agent_executor.h"
 
 namespace eino {
 namespace adk {
@@ -29,61 +39,606 @@ namespace adk {
 // Forward declarations
 template <typename T> class AsyncIterator;
 
+// AsyncQueueOptions configures the buffer between a generator and its
+// iterator. The default is unbounded, as before
+struct AsyncQueueOptions {
+    // Values buffered before Send waits for the consumer; 0 is unbounded
+    size_t capacity = 0;
+    // Only one thread at a time ever sends or closes. With a capacity this
+    // selects a lock-free ring; the mutex is then taken only to sleep
+    bool single_producer = false;
+};
+
 // AsyncGenerator is used to send values to AsyncIterator
+//
+// A bounded generator applies backpressure: Send waits (as a blocking wait
+// on the agent executor) and SendAsync parks as a continuation until the
+// consumer makes room. A consumer that goes away calls Cancel, or just
+// drops its iterator; Send then returns false and OnCancel hooks run so
+// the producing agent can stop
+//
+// A generator whose iterator was spliced with ForwardInline keeps no
+// buffer: Send runs the splice's transform and hands the value straight to
+// the target generator on the sending thread
 template <typename T>
 class AsyncGenerator {
 public:
-    void Send(T value) {
-        {
+    AsyncGenerator() : AsyncGenerator(AsyncQueueOptions()) {}
+
+    explicit AsyncGenerator(const AsyncQueueOptions& options)
+        : capacity_(options.capacity) {
+        if (options.single_producer && capacity_ > 0) {
+            size_t slots = 1;
+            while (slots < capacity_) {
+                slots <<= 1;
+            }
+            ring_.resize(slots);
+            ring_mask_ = slots - 1;
+        }
+    }
+
+    // Send queues value, waiting while the buffer is full. It returns false
+    // and drops value once the consumer has cancelled
+    bool Send(T value) {
+        if (spliced_.load()) {
+            return Forward(value);
+        }
+        if (TrySend(value)) {
+            return true;
+        }
+        if (cancelled_.load()) {
+            return false;
+        }
+        AgentExecutor::BlockingScope blocking;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                producer_waiters_.fetch_add(1);
+                not_full_cv_.wait(lock, [this]() { return Writable() || cancelled_.load(); });
+                producer_waiters_.fetch_sub(1);
+            }
+            if (TrySend(value)) {
+                return true;
+            }
+            if (cancelled_.load()) {
+                return false;
+            }
+        }
+    }
+
+    // TrySend queues value if there is room. On false value is left as it
+    // was: the buffer is full, or the consumer cancelled. Once spliced it
+    // forwards like Send, waiting on the target's buffer if that is full
+    bool TrySend(T& value) {
+        if (cancelled_.load()) {
+            return false;
+        }
+        if (spliced_.load()) {
+            return Forward(value);
+        }
+        if (Ring()) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) >= capacity_) {
+                return false;
+            }
+            ring_[tail & ring_mask_] = std::move(value);
+            tail_.store(tail + 1);
+        } else {
             std::unique_lock<std::mutex> lock(mutex_);
-            queue_.push(value);
+            // Spliced while this sender waited for the lock
+            if (splice_) {
+                lock.unlock();
+                return Forward(value);
+            }
+            if (capacity_ > 0 && queue_.size() >= capacity_) {
+                return false;
+            }
+            queue_.push_back(std::move(value));
         }
-        cv_.notify_one();
+        WakeConsumer();
+        return true;
+    }
+
+    // SendAsync queues value without holding a thread while the buffer is
+    // full, then runs on_sent(true), or on_sent(false) if the consumer
+    // cancelled. A producer must chain its next send from on_sent and keep
+    // the generator alive until then
+    void SendAsync(T value, std::function<void(bool)> on_sent,
+                   AgentExecutor& executor = AgentExecutor::Default()) {
+        if (spliced_.load() && !cancelled_.load()) {
+            if (splice_->transform && !splice_->transform(value)) {
+                on_sent(true);
+                return;
+            }
+            splice_->target->SendAsync(std::move(value), std::move(on_sent), executor);
+            return;
+        }
+        struct Pending : std::enable_shared_from_this<Pending> {
+            AsyncGenerator* gen;
+            T value;
+            std::function<void(bool)> on_sent;
+            AgentExecutor* executor;
+
+            void Step() {
+                while (true) {
+                    if (gen->TrySend(value)) {
+                        on_sent(true);
+                        return;
+                    }
+                    if (gen->cancelled_.load()) {
+                        on_sent(false);
+                        return;
+                    }
+                    auto self = this->shared_from_this();
+                    if (gen->NotifyWhenWritable([self]() {
+                            self->executor->Submit([self]() { self->Step(); });
+                        })) {
+                        return;
+                    }
+                }
+            }
+        };
+        auto pending = std::make_shared<Pending>();
+        pending->gen = this;
+        pending->value = std::move(value);
+        pending->on_sent = std::move(on_sent);
+        pending->executor = &executor;
+        pending->Step();
     }
 
     void Close() {
+        closed_.store(true);
+        std::function<void()> ready;
+        std::shared_ptr<Splice> splice;
         {
-            std::unique_lock<std::mutex> lock(mutex_);
-            closed_ = true;
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready.swap(on_ready_);
+            splice = splice_;
+        }
+        cv_.notify_all();
+        if (ready) {
+            ready();
+        }
+        if (splice) {
+            splice->Finish();
+        }
+    }
+
+    // OnCancel registers hook to run once the consumer cancels; at once if
+    // it already has. Hooks run on the consumer's thread
+    void OnCancel(std::function<void()> hook) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!cancelled_.load()) {
+                cancel_hooks_.push_back(std::move(hook));
+                return;
+            }
         }
-        cv_.notify_one();
+        hook();
     }
 
+    bool Cancelled() const { return cancelled_.load(); }
+    size_t Capacity() const { return capacity_; }
+
     friend class AsyncIterator<T>;
 
 private:
-    std::queue<T> queue_;
-    std::mutex mutex_;
+    // Splice redirects this generator into target; see ForwardInline
+    struct Splice {
+        std::shared_ptr<AsyncGenerator> target;
+        std::function<bool(T&)> transform;
+        std::function<void()> on_done;
+        std::atomic<bool> finished{false};
+
+        // Close and the splice itself race to report the end; one wins
+        void Finish() {
+            if (!finished.exchange(true) && on_done) {
+                on_done();
+            }
+        }
+    };
+
+    bool Ring() const { return !ring_.empty(); }
+
+    // Forward passes a value of a spliced generator on to its target
+    bool Forward(T& value) {
+        if (cancelled_.load()) {
+            return false;
+        }
+        if (splice_->transform && !splice_->transform(value)) {
+            return true;
+        }
+        return splice_->target->Send(std::move(value));
+    }
+
+    // Readable and Writable are exact under mutex_ in locked mode and
+    // conservative from the matching side in ring mode
+    bool Readable() const {
+        if (Ring()) {
+            return tail_.load() != head_.load();
+        }
+        return !queue_.empty();
+    }
+    bool Writable() const {
+        if (Ring()) {
+            return tail_.load() - head_.load() < capacity_;
+        }
+        return capacity_ == 0 || queue_.size() < capacity_;
+    }
+
+    // TryPop takes one value; consumer side only
+    bool TryPop(T& value) {
+        if (Ring()) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            T& slot = ring_[head & ring_mask_];
+            value = std::move(slot);
+            slot = T();
+            head_.store(head + 1);
+            MaybeWakeProducers(tail_.load() - head - 1);
+        } else {
+            size_t left;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (queue_.empty()) {
+                    return false;
+                }
+                value = std::move(queue_.front());
+                queue_.pop_front();
+                left = queue_.size();
+            }
+            MaybeWakeProducers(left);
+        }
+        return true;
+    }
+
+    // TryPopBatch appends up to max_n values to out under one lock
+    size_t TryPopBatch(std::vector<T>* out, size_t max_n) {
+        size_t n = 0;
+        if (Ring()) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t tail = tail_.load(std::memory_order_acquire);
+            n = std::min(max_n, tail - head);
+            for (size_t i = 0; i < n; ++i) {
+                T& slot = ring_[(head + i) & ring_mask_];
+                out->push_back(std::move(slot));
+                slot = T();
+            }
+            head_.store(head + n);
+            if (n > 0) {
+                MaybeWakeProducers(tail_.load() - head - n);
+            }
+        } else {
+            size_t left;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                n = std::min(max_n, queue_.size());
+                for (size_t i = 0; i < n; ++i) {
+                    out->push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+                left = queue_.size();
+            }
+            if (n > 0) {
+                MaybeWakeProducers(left);
+            }
+        }
+        return n;
+    }
+
+    // SpinUntilReadable polls a ring briefly before the consumer sleeps;
+    // a producer a few hundred nanoseconds behind then needs no wakeup
+    bool SpinUntilReadable() const {
+        // On one core the producer cannot run while this spins
+        static const bool can_spin = std::thread::hardware_concurrency() > 1;
+        if (!Ring() || !can_spin) {
+            return false;
+        }
+        for (int i = 0; i < kSpinPolls; ++i) {
+            if (tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed) ||
+                closed_.load(std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // WaitReadable sleeps until a value or Close arrives, or until deadline
+    // when one is given; returns whether the iterator can make progress
+    bool WaitReadable(const std::chrono::steady_clock::time_point* deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // Raise the flag before every check: a producer may have cleared
+        // it waking an earlier wait
+        auto ready = [this]() {
+            consumer_waiting_.store(true);
+            return Readable() || closed_.load();
+        };
+        bool ok = true;
+        if (deadline) {
+            ok = cv_.wait_until(lock, *deadline, ready);
+        } else {
+            cv_.wait(lock, ready);
+        }
+        consumer_waiting_.store(false);
+        return ok;
+    }
+
+    // The consumer flags itself before its final check, the producer
+    // publishes before reading the flag, so one always sees the other.
+    // Only the first send after the consumer slept pays for the wakeup
+    void WakeConsumer() {
+        if (!consumer_waiting_.exchange(false)) {
+            return;
+        }
+        std::function<void()> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready.swap(on_ready_);
+        }
+        cv_.notify_all();
+        if (ready) {
+            ready();
+        }
+    }
+
+    // MaybeWakeProducers wakes waiting producers once the buffer is down
+    // to half, so a full queue costs one wakeup per half-buffer, not per pop
+    void MaybeWakeProducers(size_t left) {
+        if (producer_waiters_.load() == 0 || left > capacity_ / 2) {
+            return;
+        }
+        std::vector<std::function<void()>> writable;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writable.swap(on_writable_);
+            producer_waiters_.fetch_sub(static_cast<int>(writable.size()));
+        }
+        not_full_cv_.notify_all();
+        for (auto& cb : writable) {
+            cb();
+        }
+    }
+
+    // NotifyWhenWritable parks a continuation until there is room; false
+    // if there already is, or the consumer cancelled
+    bool NotifyWhenWritable(std::function<void()> writable) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        producer_waiters_.fetch_add(1);
+        if (Writable() || cancelled_.load()) {
+            producer_waiters_.fetch_sub(1);
+            return false;
+        }
+        on_writable_.push_back(std::move(writable));
+        return true;
+    }
+
+    void Cancel() {
+        std::vector<std::function<void()>> hooks;
+        std::vector<std::function<void()>> writable;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cancelled_.exchange(true)) {
+                return;
+            }
+            hooks.swap(cancel_hooks_);
+            writable.swap(on_writable_);
+            producer_waiters_.fetch_sub(static_cast<int>(writable.size()));
+        }
+        // Release what nobody will read. A ring is left to the destructor,
+        // as its consumer may be mid-pop on another thread
+        if (!Ring()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.clear();
+        }
+        not_full_cv_.notify_all();
+        for (auto& cb : writable) {
+            cb();
+        }
+        for (auto& hook : hooks) {
+            hook();
+        }
+    }
+
+    static constexpr int kSpinPolls = 256;
+
+    const size_t capacity_;
+
+    // Locked mode
+    std::deque<T> queue_;
+
+    // Ring mode: the producer owns tail_, the consumer head_
+    std::vector<T> ring_;
+    size_t ring_mask_ = 0;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+
+    mutable std::mutex mutex_;
     std::condition_variable cv_;
-    bool closed_ = false;
+    std::condition_variable not_full_cv_;
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<bool> consumer_waiting_{false};
+    std::atomic<int> producer_waiters_{0};
+    // One-shot continuation of a consumer waiting without a thread
+    std::function<void()> on_ready_;
+    // Continuations of producers waiting for room
+    std::vector<std::function<void()>> on_writable_;
+    std::vector<std::function<void()>> cancel_hooks_;
+    // Written once under mutex_ before spliced_ is raised, then read-only
+    std::shared_ptr<Splice> splice_;
+    std::atomic<bool> spliced_{false};
 };
 
-// AsyncIterator is used to receive values from AsyncGenerator
+// AsyncIterator is used to receive values from AsyncGenerator. It has a
+// single consumer; dropping it before the end cancels the generator
 template <typename T>
 class AsyncIterator {
 public:
     explicit AsyncIterator(std::shared_ptr<AsyncGenerator<T>> generator)
         : generator_(generator) {}
 
+    ~AsyncIterator() {
+        // A spliced generator belongs to its target from then on
+        if (!generator_->closed_.load() && !generator_->spliced_.load()) {
+            generator_->Cancel();
+        }
+    }
+
+    AsyncIterator(const AsyncIterator&) = delete;
+    AsyncIterator& operator=(const AsyncIterator&) = delete;
+
     bool Next(T& value) {
-        std::unique_lock<std::mutex> lock(generator_->mutex_);
+        while (true) {
+            if (generator_->TryPop(value)) {
+                return true;
+            }
+            if (generator_->closed_.load()) {
+                // Close follows the last Send; look once more
+                return generator_->TryPop(value);
+            }
+            if (generator_->SpinUntilReadable()) {
+                continue;
+            }
+            // Let the agent executor cover for this worker while it waits
+            AgentExecutor::BlockingScope blocking;
+            generator_->WaitReadable(nullptr);
+        }
+    }
 
-        while (generator_->queue_.empty() && !generator_->closed_) {
-            generator_->cv_.wait(lock);
+    // NextBatch appends up to max_n values to out, waiting at most timeout
+    // for the first. It returns the number appended: 0 on timeout, or at
+    // the end, which HasNext then reports
+    size_t NextBatch(std::vector<T>* out, size_t max_n, std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            size_t n = generator_->TryPopBatch(out, max_n);
+            if (n > 0 || max_n == 0) {
+                return n;
+            }
+            if (generator_->closed_.load()) {
+                return generator_->TryPopBatch(out, max_n);
+            }
+            if (generator_->SpinUntilReadable()) {
+                continue;
+            }
+            AgentExecutor::BlockingScope blocking;
+            if (!generator_->WaitReadable(&deadline)) {
+                return 0;
+            }
         }
+    }
 
-        if (generator_->queue_.empty()) {
+    // TryNext takes a value without waiting. It returns false when none is
+    // queued; *closed then tells whether more may still arrive
+    bool TryNext(T& value, bool* closed) {
+        *closed = false;
+        if (generator_->TryPop(value)) {
+            return true;
+        }
+        if (!generator_->closed_.load()) {
             return false;
         }
+        // Close follows the last Send; look once more
+        if (generator_->TryPop(value)) {
+            return true;
+        }
+        *closed = true;
+        return false;
+    }
 
-        value = generator_->queue_.front();
-        generator_->queue_.pop();
+    // NotifyWhenReady arranges for ready to run once a value or Close
+    // arrives, on the thread that sends it. It returns false, without
+    // keeping ready, if one is already there
+    bool NotifyWhenReady(std::function<void()> ready) {
+        std::lock_guard<std::mutex> lock(generator_->mutex_);
+        generator_->consumer_waiting_.store(true);
+        if (generator_->Readable() || generator_->closed_.load()) {
+            generator_->consumer_waiting_.store(false);
+            return false;
+        }
+        generator_->on_ready_ = std::move(ready);
         return true;
     }
 
     bool HasNext() {
-        std::unique_lock<std::mutex> lock(generator_->mutex_);
-        return !generator_->queue_.empty() || !generator_->closed_;
+        if (!generator_->closed_.load()) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(generator_->mutex_);
+        return generator_->Readable();
+    }
+
+    // Cancel tells the producer nobody is listening: pending and later
+    // values are dropped, blocked senders return false and OnCancel hooks run
+    void Cancel() { generator_->Cancel(); }
+
+    // Splice hands the generator over to target, see ForwardInline. It
+    // returns false, changing nothing, for a ring buffer, whose lock-free
+    // sends cannot be redirected. The iterator must not be read afterwards
+    bool Splice(std::shared_ptr<AsyncGenerator<T>> target,
+                std::function<bool(T&)> transform,
+                std::function<void()> on_done) {
+        auto gen = generator_;
+        if (gen->Ring()) {
+            return false;
+        }
+        auto splice = std::make_shared<typename AsyncGenerator<T>::Splice>();
+        splice->target = target;
+        splice->transform = std::move(transform);
+        splice->on_done = std::move(on_done);
+        bool closed;
+        bool target_open = true;
+        while (true) {
+            // Values already queued go first, in order. They are taken under
+            // the lock and forwarded outside it; senders meanwhile keep
+            // queueing until the queue is found empty and the splice is set
+            std::deque<T> backlog;
+            {
+                std::lock_guard<std::mutex> lock(gen->mutex_);
+                if (gen->queue_.empty() || gen->cancelled_.load() || !target_open) {
+                    gen->queue_.clear();
+                    gen->splice_ = splice;
+                    gen->spliced_.store(true);
+                    closed = gen->closed_.load();
+                    break;
+                }
+                backlog.swap(gen->queue_);
+            }
+            gen->not_full_cv_.notify_all();
+            for (auto& value : backlog) {
+                if (splice->transform && !splice->transform(value)) {
+                    continue;
+                }
+                if (!target->Send(std::move(value))) {
+                    target_open = false;
+                    break;
+                }
+            }
+        }
+        // Senders parked on a full buffer retry and take the new path
+        gen->not_full_cv_.notify_all();
+        std::vector<std::function<void()>> writable;
+        {
+            std::lock_guard<std::mutex> lock(gen->mutex_);
+            writable.swap(gen->on_writable_);
+            gen->producer_waiters_.fetch_sub(static_cast<int>(writable.size()));
+        }
+        for (auto& cb : writable) {
+            cb();
+        }
+
+        std::weak_ptr<AsyncGenerator<T>> weak = gen;
+        target->OnCancel([weak]() {
+            if (auto upstream = weak.lock()) {
+                upstream->Cancel();
+            }
+        });
+        if (closed) {
+            splice->Finish();
+        }
+        return true;
     }
 
 private:
@@ -93,12 +648,153 @@ private:
 // Create a pair of AsyncIterator and AsyncGenerator
 template <typename T>
 inline std::pair<std::shared_ptr<AsyncIterator<T>>, std::shared_ptr<AsyncGenerator<T>>>
-NewAsyncIteratorPair() {
-    auto generator = std::make_shared<AsyncGenerator<T>>();
+NewAsyncIteratorPair(const AsyncQueueOptions& options = AsyncQueueOptions()) {
+    auto generator = std::make_shared<AsyncGenerator<T>>(options);
     auto iterator = std::make_shared<AsyncIterator<T>>(generator);
     return {iterator, generator};
 }
 
+// ForwardCancel makes a cancel of downstream also cancel upstream, for a
+// layer that forwards one agent's events into its own generator
+template <typename T, typename U>
+void ForwardCancel(const std::shared_ptr<AsyncGenerator<T>>& downstream,
+                   const std::shared_ptr<AsyncIterator<U>>& upstream) {
+    std::weak_ptr<AsyncIterator<U>> weak = upstream;
+    downstream->OnCancel([weak]() {
+        if (auto iter = weak.lock()) {
+            iter->Cancel();
+        }
+    });
+}
+
+// PumpAsync feeds each value of iter to on_value, then calls on_done once
+// iter is exhausted or on_value returns false. Callbacks are tasks on
+// executor and never overlap; between values the pump waits as a
+// continuation rather than on a thread
+//
+// If on_value throws, the pump stops: on_error gets the exception, then
+// on_done runs as usual. Without on_error the exception is rethrown to the
+// executor after on_done (see AgentExecutor::Options::on_task_error)
+//
+// Example:
+//   PumpAsync<std::shared_ptr<AgentEvent>>(inner,
+//       [gen](std::shared_ptr<AgentEvent>& event) {
+//           gen->Send(event);
+//           return true;
+//       },
+//       [gen]() { gen->Close(); },
+//       [gen](std::exception_ptr error) { gen->Send(ErrorEvent(error)); });
+template <typename T>
+void PumpAsync(std::shared_ptr<AsyncIterator<T>> iter,
+               std::function<bool(T&)> on_value,
+               std::function<void()> on_done,
+               std::function<void(std::exception_ptr)> on_error,
+               AgentExecutor& executor = AgentExecutor::Default()) {
+    struct Pump : std::enable_shared_from_this<Pump> {
+        std::shared_ptr<AsyncIterator<T>> iter;
+        std::function<bool(T&)> on_value;
+        std::function<void()> on_done;
+        std::function<void(std::exception_ptr)> on_error;
+        AgentExecutor* executor;
+
+        void Step() {
+            while (true) {
+                T value;
+                bool closed = false;
+                if (iter->TryNext(value, &closed)) {
+                    bool more;
+                    try {
+                        more = on_value(value);
+                    } catch (...) {
+                        Fail(std::current_exception());
+                        return;
+                    }
+                    if (more) {
+                        continue;
+                    }
+                    closed = true;
+                }
+                if (closed) {
+                    on_done();
+                    return;
+                }
+                auto self = this->shared_from_this();
+                if (iter->NotifyWhenReady([self]() {
+                        self->executor->Submit([self]() { self->Step(); });
+                    })) {
+                    return;
+                }
+            }
+        }
+
+        void Fail(std::exception_ptr error) {
+            if (!on_error) {
+                on_done();
+                std::rethrow_exception(error);
+            }
+            on_error(error);
+            on_done();
+        }
+    };
+
+    auto pump = std::make_shared<Pump>();
+    pump->iter = std::move(iter);
+    pump->on_value = std::move(on_value);
+    pump->on_done = std::move(on_done);
+    pump->on_error = std::move(on_error);
+    pump->executor = &executor;
+    executor.Submit([pump]() { pump->Step(); });
+}
+
+template <typename T>
+void PumpAsync(std::shared_ptr<AsyncIterator<T>> iter,
+               std::function<bool(T&)> on_value,
+               std::function<void()> on_done,
+               AgentExecutor& executor = AgentExecutor::Default()) {
+    PumpAsync<T>(std::move(iter), std::move(on_value), std::move(on_done), nullptr, executor);
+}
+
+// ForwardInline forwards every value of iter into target, like a pump
+// whose callback is transform followed by target->Send, but without the
+// hop: values already queued move across at once, and every later Send on
+// iter's generator runs transform and sends to target on the producer's
+// own thread, with no queue, wakeup or task in between. transform may
+// rewrite a value in place and returns false to drop it. on_done runs once
+// the producer closes, on the closing thread. A cancel of target cancels
+// iter's producer.
+//
+// Forwarding layers nest: when target is itself spliced further out, an
+// innermost agent's Send lands directly in the outermost consumer's queue.
+// transform runs on whichever thread sends, so with several producers at
+// once it must be thread-safe. A ring-buffer iterator, whose sends cannot
+// be redirected, falls back to PumpAsync on executor
+//
+// Example:
+//   ForwardInline<std::shared_ptr<AgentEvent>>(inner, gen,
+//       [](std::shared_ptr<AgentEvent>& event) { return event != nullptr; },
+//       [gen]() { gen->Close(); });
+template <typename T>
+void ForwardInline(std::shared_ptr<AsyncIterator<T>> iter,
+                   std::shared_ptr<AsyncGenerator<T>> target,
+                   std::function<bool(T&)> transform,
+                   std::function<void()> on_done,
+                   AgentExecutor& executor = AgentExecutor::Default()) {
+    if (iter->Splice(target, transform, on_done)) {
+        return;
+    }
+    ForwardCancel(target, iter);
+    PumpAsync<T>(
+        iter,
+        [target, transform](T& value) {
+            if (transform && !transform(value)) {
+                return true;
+            }
+            return target->Send(std::move(value));
+        },
+        std::move(on_done),
+        executor);
+}
+
 }  // namespace adk
 }  // namespace eino
 
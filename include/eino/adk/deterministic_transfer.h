@@ -116,6 +116,7 @@ private:
 };
 
 // 辅助函数：为事件流添加转移动作
+// 立即返回，转发在 AgentExecutor 上以续延方式进行，不占用线程
 // 对齐: eino/adk/deterministic_transfer.go appendTransferAction
 void AppendTransferAction(
     void* ctx,
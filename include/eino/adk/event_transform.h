@@ -0,0 +1,70 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_EVENT_TRANSFORM_H_
+#define EINO_CPP_ADK_EVENT_TRANSFORM_H_
+
+// Inline event transforms
+//
+// A forwarding layer (flow orchestration, transfer wrappers, the runner)
+// used to read its inner agent's iterator and re-send each event. With
+// ForwardInline the inner agent writes straight into the outer queue, and
+// the layer's per-event work becomes an EventTransform that runs on the
+// producer's thread. Transforms compose, so a layer that stamps run paths,
+// drops events and records them for a checkpoint still costs one call
+// chain per event rather than one queue hop per concern.
+//
+// Example:
+//   ForwardInline<std::shared_ptr<AgentEvent>>(inner, gen,
+//       ChainTransforms({StampRunPath(name, path), ObserveEvents(record)}),
+//       [gen]() { gen->Close(); });
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace eino {
+namespace adk {
+
+// EventTransform may replace the event and returns false to drop it
+using EventTransform = std::function<bool(std::shared_ptr<AgentEvent>&)>;
+
+// ChainTransforms applies transforms in order and stops at the first drop
+EventTransform ChainTransforms(std::vector<EventTransform> transforms);
+
+// FilterEvents keeps the events keep accepts; null events are dropped
+EventTransform FilterEvents(std::function<bool(const AgentEvent&)> keep);
+
+// ObserveEvents calls observe on every event and keeps them all
+EventTransform ObserveEvents(std::function<void(const std::shared_ptr<AgentEvent>&)> observe);
+
+// StampRunPath names the producer of events that carry no run path yet:
+// agent_name becomes agent_name and run_path becomes run_path. Events a
+// nested layer already stamped pass unchanged. An event still shared with
+// its producer is copied before it is changed
+EventTransform StampRunPath(std::string agent_name, std::vector<RunStep> run_path);
+
+// PrefixRunPath prepends prefix to every event's run path, for a layer
+// whose inner agent runs with a run context relative to that layer
+EventTransform PrefixRunPath(std::vector<RunStep> prefix);
+
+} // namespace adk
+} // namespace eino
+
+#endif // EINO_CPP_ADK_EVENT_TRANSFORM_H_
@@ -146,12 +146,14 @@ private:
         const std::shared_ptr<AgentInput>& input,
         const std::vector<std::shared_ptr<AgentRunOption>>& options);
     
-    // Helper to handle transfer action
+    // Helper to handle transfer action; on_done runs once the transferred
+    // agent's events have all been forwarded
     void HandleTransferAction(
         void* ctx,
         std::shared_ptr<AgentAction> action,
         std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> gen,
-        const std::vector<std::shared_ptr<AgentRunOption>>& options);
+        const std::vector<std::shared_ptr<AgentRunOption>>& options,
+        std::function<void()> on_done);
     
     // genAgentInput generates agent input from run context
     // Aligns with eino adk flowAgent.genAgentInput()
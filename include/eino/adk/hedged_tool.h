@@ -0,0 +1,52 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_HEDGED_TOOL_H_
+#define EINO_CPP_ADK_HEDGED_TOOL_H_
+
+// NewHedgedToolMiddleware hedges slow calls of the named invokable tools
+// in a ToolsNode (see hedging.h). Each tool gets its own Hedger, so a slow
+// search does not set the delay of a fast lookup. Name only tools that
+// are safe to call twice; streaming tools and tools not named pass
+// through.
+//
+// The ToolsNode call returns once every attempt has ended, so attempts
+// use its ctx safely; a tool that never checks cancellation makes the
+// call as slow as its slowest attempt.
+//
+// Example:
+//   HedgePolicy policy;
+//   policy.percentile = 95;
+//   config.tool_call_middlewares.push_back(
+//       NewHedgedToolMiddleware(policy, {"web_search", "fetch_page"}));
+
+#include <string>
+#include <vector>
+
+#include "hedging.h"
+#include "eino/compose/tool_node.h"
+
+namespace eino {
+namespace adk {
+
+compose::ToolMiddleware NewHedgedToolMiddleware(const HedgePolicy& policy,
+                                                const std::vector<std::string>& tools,
+                                                AgentExecutor& executor = AgentExecutor::Default());
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_HEDGED_TOOL_H_
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_HEDGING_H_
+#define EINO_CPP_ADK_HEDGING_H_
+
+// Hedged requests
+// ===============
+// A few slow calls set the tail latency of a model or tool. A Hedger runs
+// a call and, if it has not answered after the delay - the percentile
+// latency of recent calls - starts a duplicate. The first attempt to
+// succeed wins; the others are marked cancelled and their results
+// dropped.
+//
+// The first attempt runs on the calling thread and duplicates on the
+// executor, started by one timer thread shared by every hedger. A call
+// returns only once every attempt it started has ended, so attempts may
+// borrow the caller's state. An attempt cannot be interrupted: a
+// duplicate shortens a call when the first attempt fails, or when the
+// slower attempt polls HedgeAttempt::Cancelled and gives up.
+//
+// Duplicates are extra load, so they draw on a budget that every call
+// refills by max_hedge_ratio; when it is empty, calls run unhedged. Only
+// hedge calls that are safe to repeat.
+//
+// Hedges and the ones that won are counted in eino_hedges_total and
+// eino_hedge_wins_total against eino_hedged_calls_total.
+//
+// Example:
+//   HedgePolicy policy;
+//   policy.percentile = 95;
+//   auto hedger = std::make_shared<Hedger>(policy);
+//   std::string page = hedger->Run<std::string>([url](const HedgeAttempt&) {
+//       return Fetch(url);
+//   });
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "agent_executor.h"
+
+namespace eino {
+namespace adk {
+
+struct HedgePolicy {
+    // Start a duplicate once the call has run longer than this percentile
+    // of recent successful attempts
+    double percentile = 95;
+    // Delay used until min_samples attempts have succeeded
+    std::chrono::milliseconds initial_delay{1000};
+    std::chrono::milliseconds min_delay{1};
+    size_t min_samples = 20;
+    // Successful attempt latencies the percentile is taken over
+    size_t window = 256;
+    // Duplicates per call at most; later ones wait another delay each
+    int max_hedges = 1;
+    // Budget refill per call and its cap, in duplicates: 0.05 allows
+    // about one duplicate per 20 calls
+    double max_hedge_ratio = 0.05;
+    double budget_burst = 10;
+};
+
+struct HedgeStats {
+    uint64_t calls = 0;
+    uint64_t hedges = 0;
+    // Calls a duplicate answered first
+    uint64_t hedge_wins = 0;
+    // Duplicates not started for lack of budget
+    uint64_t budget_denied = 0;
+};
+
+// HedgeAttempt is what one attempt of a call knows about itself
+class HedgeAttempt {
+public:
+    HedgeAttempt(int index, std::shared_ptr<const std::atomic<bool>> cancelled)
+        : index_(index), cancelled_(std::move(cancelled)) {}
+
+    // Index is 0 for the first attempt and counts the duplicates after it
+    int Index() const { return index_; }
+
+    // Cancelled turns true once the call has its answer
+    bool Cancelled() const { return cancelled_->load(std::memory_order_acquire); }
+
+private:
+    int index_;
+    std::shared_ptr<const std::atomic<bool>> cancelled_;
+};
+
+// A Hedger is shared by every caller of one model or tool so that it
+// learns their latency
+class Hedger : public std::enable_shared_from_this<Hedger> {
+public:
+    // Owned through a shared_ptr: running attempts keep the hedger alive.
+    // Duplicates run on executor
+    explicit Hedger(const HedgePolicy& policy = HedgePolicy(),
+                    AgentExecutor& executor = AgentExecutor::Default());
+
+    Hedger(const Hedger&) = delete;
+    Hedger& operator=(const Hedger&) = delete;
+
+    // Run returns the first successful attempt's result, or rethrows the
+    // first error once every started attempt has failed. It returns after
+    // every started attempt has ended
+    template <typename T>
+    T Run(std::function<T(const HedgeAttempt&)> attempt) {
+        // No attempt outlives Race, so results can live on this stack
+        std::vector<std::unique_ptr<T>> results(static_cast<size_t>(policy_.max_hedges) + 1);
+        int winner = Race([&attempt, &results](const HedgeAttempt& a) {
+            results[static_cast<size_t>(a.Index())].reset(new T(attempt(a)));
+        });
+        return std::move(*results[static_cast<size_t>(winner)]);
+    }
+
+    // Delay is how long a call runs before it is hedged
+    std::chrono::nanoseconds Delay() const;
+
+    HedgeStats Stats() const;
+
+private:
+    struct Call;
+
+    // Race runs attempts until one returns and gives its index; the state
+    // an attempt writes is published to the caller under the call's mutex
+    int Race(std::function<void(const HedgeAttempt&)> attempt);
+    // Attempt runs attempt index of call on the current thread
+    void Attempt(const std::shared_ptr<Call>& call, int index);
+    // Hedge starts duplicate index at its deadline unless the call is over
+    void Hedge(const std::shared_ptr<Call>& call, int index);
+    void Record(int64_t latency_ns);
+    bool TakeBudget();
+    std::chrono::nanoseconds DelayLocked() const;
+
+    HedgePolicy policy_;
+    AgentExecutor& executor_;
+
+    mutable std::mutex mutex_;
+    std::deque<int64_t> latencies_ns_;
+    // Delay as of the latencies seen so far; refreshed when they change
+    mutable int64_t delay_ns_ = -1;
+    double budget_;
+    HedgeStats stats_;
+};
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_HEDGING_H_
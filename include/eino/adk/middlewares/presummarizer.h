@@ -0,0 +1,135 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_MIDDLEWARES_PRESUMMARIZER_H_
+#define EINO_CPP_ADK_MIDDLEWARES_PRESUMMARIZER_H_
+
+// Background pre-summarization
+// ============================
+// Summarizing when the context is already full makes that turn wait on an
+// extra model call. A PreSummarizer starts earlier: once the history
+// crosses the prepare watermark it snapshots it and summarizes the
+// snapshot on the executor while the agent keeps running. When the
+// history reaches the trigger, the summary replaces the snapshot in one
+// step and only the messages added since are kept after it.
+//
+// If the history no longer starts with the snapshot (another middleware
+// rewrote it) or the background summary failed, the trigger summarizes
+// synchronously as before. A trigger hit while the summary is still
+// running waits for it, which is still shorter than starting then.
+//
+// Time a turn spends waiting on a summary is recorded in
+// eino_summary_wait_ns.
+//
+// Example:
+//   PreSummarizerConfig config;
+//   config.prepare_tokens = 60000;
+//   config.trigger_tokens = 100000;
+//   auto summarizer = std::make_shared<PreSummarizer>(
+//       config, [model](const std::vector<schema::Message>& prefix) {
+//           return std::vector<schema::Message>{Summarize(model, prefix)};
+//       });
+//   // before each model call
+//   history = summarizer->Update(history, CountTokens(history));
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../agent_executor.h"
+#include "eino/schema/types.h"
+
+namespace eino {
+namespace adk {
+namespace middlewares {
+namespace summarization {
+
+struct PreSummarizerConfig {
+    // Start summarizing in the background once either is reached; 0 leaves
+    // the bound unset
+    int prepare_tokens = 0;
+    int prepare_messages = 0;
+    // Swap the summary in once either is reached
+    int trigger_tokens = 0;
+    int trigger_messages = 0;
+};
+
+struct PreSummarizerStats {
+    // Background summaries started
+    uint64_t prepared = 0;
+    // Triggers served by a background summary
+    uint64_t swapped = 0;
+    // ... of which waited for it to finish
+    uint64_t waited = 0;
+    // Triggers summarized on the spot
+    uint64_t synchronous = 0;
+    // Background summaries dropped: failed or rewritten away
+    uint64_t discarded = 0;
+};
+
+// SummarizeFunc returns the messages that replace prefix; it may throw
+using SummarizeFunc =
+    std::function<std::vector<schema::Message>(const std::vector<schema::Message>& prefix)>;
+
+// A PreSummarizer follows one conversation
+class PreSummarizer {
+public:
+    PreSummarizer(const PreSummarizerConfig& config, SummarizeFunc summarize,
+                  AgentExecutor& executor = AgentExecutor::Default());
+    ~PreSummarizer();
+
+    PreSummarizer(const PreSummarizer&) = delete;
+    PreSummarizer& operator=(const PreSummarizer&) = delete;
+
+    // Update takes the history about to be sent and its token count and
+    // returns the history to send instead: unchanged below the trigger,
+    // otherwise summarized. Errors of a synchronous summary propagate
+    std::vector<schema::Message> Update(const std::vector<schema::Message>& messages,
+                                        int tokens);
+
+    // Pending reports whether a background summary is running or ready
+    bool Pending() const;
+
+    PreSummarizerStats Stats() const;
+
+private:
+    struct Job;
+
+    bool Reached(size_t messages, int tokens, int token_limit, int message_limit) const;
+    void Prepare(const std::vector<schema::Message>& messages);
+    // Swap returns the history with job's summary in place of its
+    // snapshot, or false if it cannot be used
+    bool Swap(const std::shared_ptr<Job>& job, const std::vector<schema::Message>& messages,
+              std::vector<schema::Message>* out);
+
+    PreSummarizerConfig config_;
+    SummarizeFunc summarize_;
+    AgentExecutor& executor_;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<Job> job_;
+    PreSummarizerStats stats_;
+};
+
+}  // namespace summarization
+}  // namespace middlewares
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_MIDDLEWARES_PRESUMMARIZER_H_
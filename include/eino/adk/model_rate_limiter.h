@@ -0,0 +1,242 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_MODEL_RATE_LIMITER_H_
+#define EINO_CPP_ADK_MODEL_RATE_LIMITER_H_
+
+// Shared rate limiting for model calls
+// ====================================
+// Every agent calling one provider shares one ModelRateLimiter, looked up
+// by a key such as "openai/gpt-4o". A call is admitted once
+// - a requests/s bucket and a tokens/s bucket both have room; the token
+//   cost is estimated from the input and corrected with the usage the
+//   provider reports
+// - fewer than the current concurrency limit are in flight
+// Waiting calls queue by lane, interactive before batch, and within a lane
+// in arrival order.
+//
+// The concurrency limit adapts (AIMD): every call that succeeds raises it
+// by 1/limit, so it grows by one per window of calls, and a rate-limit
+// error (429) cuts it by backoff_ratio and empties the request bucket.
+// Only the first 429 of a window cuts the limit, so a burst of rejections
+// from calls that were already in flight counts once.
+//
+// CallWithLimits retries failed calls per FullModelRetryConfig with
+// jittered backoff, going back through the queue each time, so when a
+// provider starts refusing the herd shrinks and spreads out instead of
+// retrying at once. RateLimitedChatModel (rate_limited_chatmodel.h) wraps
+// a ChatModel with it.
+//
+// Queue time is recorded per lane in eino_model_queue_ns.
+//
+// Example:
+//   ModelRateLimits limits;
+//   limits.requests_per_second = 50;
+//   limits.tokens_per_second = 200000;
+//   ModelCallConfig config;
+//   config.limiter = ModelRateLimiter::Shared("openai/gpt-4o", limits);
+//   config.retry.max_retries = 4;
+//   CallWithLimits(config, CountTokens(config, input), [&](ModelRateLimiter::Permit& permit) {
+//       reply = Send(input);
+//       permit.Release(ModelCallOutcome::kSucceeded, reply.usage);
+//   });
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hedging.h"
+#include "retry_chatmodel.h"
+#include "session_host.h"
+#include "eino/schema/types.h"
+
+namespace eino {
+namespace adk {
+
+struct ModelRateLimits {
+    // Sustained rates; 0 is unlimited
+    double requests_per_second = 0;
+    double tokens_per_second = 0;
+    // Bucket capacity, in seconds of the sustained rate
+    double burst_seconds = 1;
+    // Bounds of the adaptive concurrency limit, which starts at max
+    size_t max_concurrency = 16;
+    size_t min_concurrency = 1;
+    // Factor the limit is cut by on a rate-limit error
+    double backoff_ratio = 0.5;
+};
+
+struct ModelRateLimiterStats {
+    size_t in_flight = 0;
+    size_t concurrency_limit = 0;
+    size_t queued_interactive = 0;
+    size_t queued_batch = 0;
+    uint64_t admitted = 0;
+    uint64_t rate_limited = 0;
+};
+
+enum class ModelCallOutcome {
+    kSucceeded,
+    // The provider refused the call for exceeding its limits
+    kRateLimited,
+    kFailed,
+};
+
+class ModelRateLimiter {
+public:
+    explicit ModelRateLimiter(const ModelRateLimits& limits);
+
+    ModelRateLimiter(const ModelRateLimiter&) = delete;
+    ModelRateLimiter& operator=(const ModelRateLimiter&) = delete;
+
+    // Shared returns the limiter for key, creating it with limits if no
+    // live limiter has the key; later limits for the same key are ignored
+    static std::shared_ptr<ModelRateLimiter> Shared(const std::string& key,
+                                                    const ModelRateLimits& limits);
+
+    // Permit is one admitted call; destroying it unreleased counts as
+    // kFailed. The limiter must outlive its permits
+    class Permit {
+    public:
+        Permit() = default;
+        Permit(Permit&& other) noexcept;
+        Permit& operator=(Permit&& other) noexcept;
+        ~Permit();
+
+        // Release ends the call. used_tokens is what the provider reported,
+        // 0 if unknown; tokens beyond the admitted cost put the token
+        // bucket into debt, which holds back later calls
+        void Release(ModelCallOutcome outcome, int64_t used_tokens = 0);
+
+    private:
+        friend class ModelRateLimiter;
+        Permit(ModelRateLimiter* limiter, uint64_t window, int64_t tokens)
+            : limiter_(limiter), window_(window), tokens_(tokens) {}
+
+        ModelRateLimiter* limiter_ = nullptr;
+        uint64_t window_ = 0;
+        int64_t tokens_ = 0;
+    };
+
+    // Acquire waits for admission. A cost above the token bucket's capacity
+    // is charged as the full bucket
+    Permit Acquire(SessionLane lane, int64_t tokens);
+
+    ModelRateLimiterStats Stats() const;
+
+private:
+    void Release(uint64_t window, ModelCallOutcome outcome, int64_t extra_tokens);
+    void Refill(std::chrono::steady_clock::time_point now);
+
+    ModelRateLimits limits_;
+    double request_capacity_;
+    double token_capacity_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    // Waiting calls keyed by (lane, arrival); the first one is served next
+    std::set<std::pair<int, uint64_t>> waiting_;
+    uint64_t next_seq_ = 0;
+    double requests_;
+    double tokens_;
+    std::chrono::steady_clock::time_point refilled_;
+    double limit_;
+    // Bumped on every cut; calls admitted before it do not cut again
+    uint64_t window_ = 0;
+    size_t in_flight_ = 0;
+    uint64_t admitted_ = 0;
+    uint64_t rate_limited_ = 0;
+};
+
+// TokenCounter costs a call's messages and bound tools, returning an error
+// text on failure. It has the type of reduction::TokenCounter
+// (middlewares/reduction.h), so one counter serves both
+using TokenCounter = std::function<std::pair<int64_t, std::string>(
+    const std::vector<schema::Message*>& msgs,
+    const std::vector<std::shared_ptr<schema::ToolInfo>>& tools)>;
+
+// EstimateTokens is the fallback TokenCounter: about four characters of
+// text per token plus a few per message and tool
+std::pair<int64_t, std::string> EstimateTokens(
+    const std::vector<schema::Message*>& msgs,
+    const std::vector<std::shared_ptr<schema::ToolInfo>>& tools);
+
+// ModelCallError is thrown by model clients for a provider's HTTP error;
+// status 429 is a rate-limit rejection
+class ModelCallError : public std::runtime_error {
+public:
+    ModelCallError(int status_code, const std::string& message)
+        : std::runtime_error(message), status_code_(status_code) {}
+
+    int GetStatusCode() const { return status_code_; }
+
+private:
+    int status_code_;
+};
+
+// IsRateLimitedFunc decides whether a failed call was refused for its rate
+using IsRateLimitedFunc = std::function<bool(const std::exception& err)>;
+
+// IsRateLimitError matches a ModelCallError with status 429 only; error
+// texts are not parsed
+bool IsRateLimitError(const std::exception& err);
+
+struct ModelCallConfig {
+    // Required; share one per provider endpoint
+    std::shared_ptr<ModelRateLimiter> limiter;
+    SessionLane lane = SessionLane::kInteractive;
+    // Costs a model wrapper's input; EstimateTokens is used when unset or
+    // when the counter fails
+    TokenCounter token_counter;
+    // Defaults to IsRateLimitError
+    IsRateLimitedFunc is_rate_limited;
+    // Retries of failed calls
+    FullModelRetryConfig retry;
+    // Opt-in: a model wrapper hedges slow calls, each attempt with its own
+    // permit and retries. Share one hedger per model
+    std::shared_ptr<Hedger> hedger;
+};
+
+// CountTokens costs messages and tools with config.token_counter
+int64_t CountTokens(const ModelCallConfig& config,
+                    const std::vector<schema::Message>& messages,
+                    const std::vector<std::shared_ptr<schema::ToolInfo>>& tools =
+                        std::vector<std::shared_ptr<schema::ToolInfo>>());
+
+// CallWithLimits runs call under a permit from config.limiter, retrying
+// per config.retry. call releases the permit once it succeeds, or moves it
+// into whatever outlives the call; if it throws, the permit is released as
+// rate limited or failed. max_retries = 0 rethrows the first error, and
+// running out of retries throws RetryExhaustedError. Once cancelled returns
+// true no permit is taken and no retry made: an error is rethrown as is,
+// otherwise std::runtime_error is thrown
+void CallWithLimits(const ModelCallConfig& config, int64_t tokens,
+                    const std::function<void(ModelRateLimiter::Permit&)>& call,
+                    const std::function<bool()>& cancelled = nullptr);
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_MODEL_RATE_LIMITER_H_
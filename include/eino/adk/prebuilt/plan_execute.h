@@ -21,6 +21,7 @@
 #include "../chat_model_agent.h"
 #include "../executor.h"
 #include "../../schema/types.h"
+#include "plan_steps.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -44,6 +45,16 @@ public:
     
     // FromJSON deserializes JSON content into the Plan
     virtual bool FromJSON(void* ctx, const std::string& json) = 0;
+
+    // Steps returns every step with its dependencies; plans that only
+    // know their first step run one step per turn
+    virtual std::vector<PlanStep> Steps(void* ctx) {
+        std::string first = FirstStep(ctx);
+        if (first.empty()) {
+            return {};
+        }
+        return {PlanStep{first, {}}};
+    }
 };
 
 // DefaultPlan is the default implementation of the Plan interface
@@ -59,18 +70,25 @@ public:
 //   },
 //   "required": ["steps"]
 // }
+// A step may also be {"step": "...", "depends_on": [...]}; see plan_steps.h
 class DefaultPlan : public Plan {
 public:
     std::string FirstStep(void* ctx) override;
     std::string ToJSON(void* ctx) override;
     bool FromJSON(void* ctx, const std::string& json) override;
+    std::vector<PlanStep> Steps(void* ctx) override;
     
+    // AddStep appends a step that runs after the previous one
     void AddStep(const std::string& step);
+    // AddStep appends a step that waits only for depends_on, which must
+    // name earlier steps
+    void AddStep(const std::string& step, const std::vector<size_t>& depends_on);
     void ClearSteps();
     const std::vector<std::string>& GetSteps() const { return steps_; }
     
 private:
     std::vector<std::string> steps_;
+    std::vector<std::vector<size_t>> depends_on_;
 };
 
 // NewPlan is a function type that creates a new Plan instance
@@ -81,12 +99,6 @@ struct Response {
     std::string response;  // The complete response to provide to the user
 };
 
-// ExecutedStep represents a completed step and its result
-struct ExecutedStep {
-    std::string step;
-    std::string result;
-};
-
 // ExecutionContext is the input information for the executor and replanner
 struct ExecutionContext {
     std::vector<Message> user_input;
@@ -153,6 +165,20 @@ struct ExecutorConfig {
     
     // GenInputFn generates the input messages for the executor
     GenModelInputFn gen_input_fn = nullptr;
+
+    // MaxParallelSteps above 1 runs a plan from the session that has
+    // independent steps in one turn, starting steps as their dependencies
+    // finish. A sequential plan, or 1, executes only the first step per
+    // turn so that the replanner sees each result
+    size_t max_parallel_steps = 1;
+};
+
+// ExecutedStepsOutput is the customized output of the executor's last
+// event when it runs the whole plan; message lists the results in plan
+// order and becomes the replanner's input
+struct ExecutedStepsOutput {
+    std::vector<ExecutedStep> executed_steps;
+    schema::Message message;
 };
 
 // NewExecutor creates a new executor agent for plan execution
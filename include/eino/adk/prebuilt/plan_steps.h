@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_PREBUILT_PLAN_STEPS_H_
+#define EINO_CPP_ADK_PREBUILT_PLAN_STEPS_H_
+
+// Plan steps as a dependency graph
+// ================================
+// A step may name the earlier steps whose results it needs. RunPlanSteps
+// starts every step whose dependencies are done, up to max_parallel at a
+// time, so a wide plan takes as long as its longest chain instead of the
+// sum of its steps. Results come back in plan order whatever order the
+// steps finish in.
+//
+// A plan written as plain strings is a chain - each step depends on the
+// one before - which is how plans ran before dependencies existed.
+//
+// JSON form, strings and objects may be mixed:
+//   {"steps": ["search flights",
+//              "search hotels",
+//              {"step": "book the trip", "depends_on": [0, 1]}]}
+// Here "search hotels" still follows "search flights"; to run them side by
+// side write it as {"step": "search hotels", "depends_on": []}.
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../agent_executor.h"
+#include "../async_iterator.h"
+#include "../types.h"
+
+namespace eino {
+namespace adk {
+namespace prebuilt {
+
+// PlanStep is one step of a plan and the steps it waits for
+struct PlanStep {
+    std::string step;
+    // Indices of earlier steps in the plan
+    std::vector<size_t> depends_on;
+};
+
+// ExecutedStep represents a completed step and its result
+struct ExecutedStep {
+    std::string step;
+    std::string result;
+};
+
+// PlanStepsFromJSON parses {"steps": [...]}; false if a step is malformed
+// or depends on a step that does not come before it
+bool PlanStepsFromJSON(const std::string& json, std::vector<PlanStep>* steps);
+
+// PlanStepsToJSON writes a chain as plain strings and other plans as
+// objects, so sequential plans keep their old form
+std::string PlanStepsToJSON(const std::vector<PlanStep>& steps);
+
+// HasIndependentSteps reports whether two steps could run side by side,
+// that is whether some step does not wait, directly or not, for the step
+// before it
+bool HasIndependentSteps(const std::vector<PlanStep>& steps);
+
+// FormatExecutedSteps renders results for the executor and replanner prompts
+std::string FormatExecutedSteps(const std::vector<ExecutedStep>& steps);
+
+// StepRunner starts step index; deps holds the results of its
+// dependencies in plan order
+using StepRunner = std::function<std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>>(
+    size_t index, const PlanStep& step, const std::vector<ExecutedStep>& deps)>;
+
+struct PlanStepsResult {
+    // Steps that finished, in plan order
+    std::vector<ExecutedStep> executed;
+    // First error a step reported; no step starts after it
+    std::string error;
+};
+
+// RunPlanSteps runs steps as their dependencies allow. Events of running
+// steps are spliced into out as they arrive, so concurrent steps
+// interleave; on_done runs once every started step has ended and does not
+// close out. A step's result is the content of the last message it
+// emitted. A step that fails to start, or a plan whose dependencies point
+// forward, adds an error event to out.
+void RunPlanSteps(std::vector<PlanStep> steps, StepRunner runner, size_t max_parallel,
+                  std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> out,
+                  std::function<void(PlanStepsResult)> on_done,
+                  AgentExecutor& executor = AgentExecutor::Default());
+
+}  // namespace prebuilt
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_PREBUILT_PLAN_STEPS_H_
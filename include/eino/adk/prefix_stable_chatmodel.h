@@ -0,0 +1,95 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_PREFIX_STABLE_CHATMODEL_H_
+#define EINO_CPP_ADK_PREFIX_STABLE_CHATMODEL_H_
+
+// PrefixStableChatModel sends a ChatModel the prompts of a PromptAssembler
+// (prompt_assembler.h): tools bound in name order and messages in canonical
+// form, with the reuse of each turn measured. Wrap the model once per
+// session, so that one assembler sees one conversation, and give the
+// middlewares that rewrite history the same assembler to Check against.
+//
+// Experimental and not wired in: ChatModelAgent does not wrap its model
+// and keeps no assembler per session, and no middleware in this tree calls
+// Check. A caller that wants the metrics builds one wrapper per session and
+// passes it as that session's agent model.
+//
+// Example:
+//   auto assembler = std::make_shared<PromptAssembler>();
+//   auto model = NewPrefixStableChatModel(openai_model, assembler);
+//   agent_config->model = model.get();
+
+#include <memory>
+#include <vector>
+
+#include "prompt_assembler.h"
+#include "eino/components/model.h"
+
+namespace eino {
+namespace adk {
+
+class PrefixStableChatModel : public components::ToolCallingChatModel {
+public:
+    PrefixStableChatModel(std::shared_ptr<components::ToolCallingChatModel> model,
+                          std::shared_ptr<PromptAssembler> assembler,
+                          std::vector<schema::ToolInfo> tools = std::vector<schema::ToolInfo>());
+
+    schema::Message Generate(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<schema::Message>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    schema::Message Invoke(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<schema::Message>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    std::shared_ptr<compose::StreamReader<schema::Message>> Stream(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<schema::Message>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    // Collect and Transform read their input as a stream, so they pass
+    // through unassembled
+    schema::Message Collect(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    std::shared_ptr<compose::StreamReader<schema::Message>> Transform(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    // WithTools binds the tools in name order and keeps the assembler
+    std::shared_ptr<components::ToolCallingChatModel> WithTools(
+        const std::vector<schema::ToolInfo>& tools) override;
+
+private:
+    std::shared_ptr<components::ToolCallingChatModel> model_;
+    std::shared_ptr<PromptAssembler> assembler_;
+    std::vector<schema::ToolInfo> tools_;
+};
+
+std::shared_ptr<PrefixStableChatModel> NewPrefixStableChatModel(
+    std::shared_ptr<components::ToolCallingChatModel> model,
+    std::shared_ptr<PromptAssembler> assembler);
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_PREFIX_STABLE_CHATMODEL_H_
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_PROMPT_ASSEMBLER_H_
+#define EINO_CPP_ADK_PROMPT_ASSEMBLER_H_
+
+// Prefix-stable prompts
+// =====================
+// Providers cache the prompt prefix they have already processed, so a turn
+// that only appends to the last one is billed and prefilled for the new
+// part alone. A PromptAssembler keeps the prompts of one conversation in
+// canonical form - tools sorted by name, messages without response
+// metadata or stream indexes - and measures how much of each prompt repeats
+// the previous one, comparing the fast_json serialization (fixed field
+// order, sorted keys).
+//
+// A turn that changes what was already sent (a new tool list, a summarized
+// or trimmed history) is a rewrite: the provider must prefill it again from
+// the first change. Listeners hear of every rewrite, and a middleware can
+// call Check first to learn what a rewrite would cost.
+//
+// Prompt bytes, the bytes reused and rewrites are counted in
+// eino_prompt_bytes_total, eino_prompt_reused_bytes_total and
+// eino_prompt_prefix_rewrites_total; each turn's reuse ratio is recorded
+// in eino_prompt_prefix_reuse_pct. PrefixStableChatModel
+// (prefix_stable_chatmodel.h) assembles every prompt sent to the model it
+// wraps.
+//
+// Experimental: nothing in the agent runtime creates an assembler or calls
+// Check yet, see prefix_stable_chatmodel.h.
+//
+// Example:
+//   auto assembler = std::make_shared<PromptAssembler>();
+//   assembler->AddRewriteListener([](const PrefixRewrite& rewrite) {
+//       LOG(INFO) << "prompt cache lost " << rewrite.lost_bytes << " bytes";
+//   });
+//   AssembledPrompt prompt = assembler->Assemble(tools, history);
+//   reply = Send(prompt.tools, prompt.messages);
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "eino/schema/types.h"
+
+namespace eino {
+namespace adk {
+
+// PrefixRewrite describes a turn that changed an earlier prompt
+struct PrefixRewrite {
+    // Turn of the conversation, counting from 1
+    uint64_t turn = 0;
+    bool tools_changed = false;
+    // First message of the earlier prompt that changed or was dropped
+    size_t first_changed_message = 0;
+    // Bytes of the earlier prompt the provider cannot reuse
+    size_t lost_bytes = 0;
+};
+
+struct AssembledPrompt {
+    std::vector<schema::ToolInfo> tools;
+    std::vector<schema::Message> messages;
+    // Canonical size and the part of it the previous prompt started with
+    size_t bytes = 0;
+    size_t reused_bytes = 0;
+
+    double ReuseRatio() const {
+        return bytes == 0 ? 0 : static_cast<double>(reused_bytes) / static_cast<double>(bytes);
+    }
+};
+
+struct PromptPrefixStats {
+    uint64_t turns = 0;
+    uint64_t bytes = 0;
+    uint64_t reused_bytes = 0;
+    uint64_t rewrites = 0;
+};
+
+// A PromptAssembler follows one conversation; give each session its own
+class PromptAssembler {
+public:
+    using RewriteListener = std::function<void(const PrefixRewrite&)>;
+
+    PromptAssembler() = default;
+    PromptAssembler(const PromptAssembler&) = delete;
+    PromptAssembler& operator=(const PromptAssembler&) = delete;
+
+    // CanonicalTools orders tools by name
+    static std::vector<schema::ToolInfo> CanonicalTools(std::vector<schema::ToolInfo> tools);
+
+    // CanonicalMessage drops what the provider reported rather than was
+    // sent: response metadata and stream indexes of tool calls
+    static schema::Message CanonicalMessage(schema::Message msg);
+
+    // Listeners run on the assembling thread, after the turn is recorded
+    void AddRewriteListener(RewriteListener listener);
+
+    // Assemble canonicalizes a turn's prompt and records it as the prefix
+    // the next turn is measured against
+    AssembledPrompt Assemble(const std::vector<schema::ToolInfo>& tools,
+                             const std::vector<schema::Message>& messages);
+
+    // Check reports whether sending messages next, with the tools of the
+    // last turn, would be a rewrite, and fills *rewrite if so. Nothing is
+    // recorded
+    bool Check(const std::vector<schema::Message>& messages, PrefixRewrite* rewrite) const;
+    bool Check(const std::vector<schema::Message*>& messages, PrefixRewrite* rewrite) const;
+
+    PromptPrefixStats Stats() const;
+
+private:
+    // Prompt is a prompt as the serialized tools and each message
+    struct Prompt {
+        std::string tools;
+        std::vector<std::string> messages;
+        size_t bytes = 0;
+    };
+
+    static std::string SerializeTools(const std::vector<schema::ToolInfo>& tools);
+    static std::string SerializeMessage(const schema::Message& msg);
+
+    // Compare measures next against the last prompt; true if it rewrites it
+    bool Compare(const Prompt& next, size_t* reused, PrefixRewrite* rewrite) const;
+    bool CheckSerialized(std::vector<std::string> messages, PrefixRewrite* rewrite) const;
+
+    mutable std::mutex mutex_;
+    Prompt last_;
+    PromptPrefixStats stats_;
+    std::vector<RewriteListener> listeners_;
+};
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_PROMPT_ASSEMBLER_H_
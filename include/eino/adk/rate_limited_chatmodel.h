@@ -0,0 +1,96 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_RATE_LIMITED_CHATMODEL_H_
+#define EINO_CPP_ADK_RATE_LIMITED_CHATMODEL_H_
+
+// RateLimitedChatModel sends every call of a ChatModel through a shared
+// ModelRateLimiter (model_rate_limiter.h) and retries it per the config.
+// With a hedger set, slow Generate calls are hedged (hedging.h); streams
+// are not.
+// Give interactive agents and batch jobs their own wrapper with the lane
+// set, over one limiter per provider endpoint.
+//
+// Example:
+//   ModelRateLimits limits;
+//   limits.requests_per_second = 50;
+//   ModelCallConfig config;
+//   config.limiter = ModelRateLimiter::Shared("openai/gpt-4o", limits);
+//   config.retry.max_retries = 4;
+//   auto model = NewRateLimitedChatModel(openai_model, config);
+
+#include <memory>
+#include <vector>
+
+#include "model_rate_limiter.h"
+#include "eino/components/model.h"
+
+namespace eino {
+namespace adk {
+
+class RateLimitedChatModel : public components::ToolCallingChatModel {
+public:
+    // tools are the ones bound to model, costed with every call
+    RateLimitedChatModel(std::shared_ptr<components::ToolCallingChatModel> model,
+                         ModelCallConfig config,
+                         const std::vector<schema::ToolInfo>& tools =
+                             std::vector<schema::ToolInfo>());
+
+    schema::Message Generate(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<schema::Message>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    schema::Message Invoke(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<schema::Message>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    // The call holds its permit until the stream is drained or closed; a
+    // read that throws releases it as failed or rate limited
+    std::shared_ptr<compose::StreamReader<schema::Message>> Stream(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<schema::Message>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    schema::Message Collect(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    std::shared_ptr<compose::StreamReader<schema::Message>> Transform(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    // WithTools wraps the bound model with the same limiter
+    std::shared_ptr<components::ToolCallingChatModel> WithTools(
+        const std::vector<schema::ToolInfo>& tools) override;
+
+private:
+    std::shared_ptr<components::ToolCallingChatModel> model_;
+    ModelCallConfig config_;
+    std::vector<std::shared_ptr<schema::ToolInfo>> tools_;
+};
+
+std::shared_ptr<RateLimitedChatModel> NewRateLimitedChatModel(
+    std::shared_ptr<components::ToolCallingChatModel> model,
+    ModelCallConfig config);
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_RATE_LIMITED_CHATMODEL_H_
@@ -25,6 +25,7 @@
 // - Retryable error detection
 // - Backoff strategy (default: exponential with jitter)
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <functional>
@@ -35,9 +36,6 @@
 #include <string>
 #include <thread>
 
-#include "eino/adk/handler.h"
-#include "eino/internal/core/address.h"
-
 namespace eino {
 namespace adk {
 
@@ -87,6 +85,8 @@ using IsRetryableFunc = std::function<bool(const std::string& err)>;
 
 // Default backoff: exponential with jitter, base 100ms, max 10s.
 // Aligned with Go: adk.defaultBackoff()
+// The jitter source is per thread, so concurrent retries neither race on
+// it nor draw the same delays.
 inline std::chrono::milliseconds DefaultBackoff(int attempt) {
     const int64_t base_delay_ms = 100;
     const int64_t max_delay_ms = 10000;
@@ -95,18 +95,12 @@ inline std::chrono::milliseconds DefaultBackoff(int attempt) {
         return std::chrono::milliseconds(base_delay_ms);
     }
 
-    if (attempt > 7) {
-        static std::mt19937 gen(std::random_device{}());
-        std::uniform_int_distribution<int64_t> dist(0, max_delay_ms / 2);
-        return std::chrono::milliseconds(max_delay_ms + dist(gen));
-    }
-
-    int64_t delay_ms = base_delay_ms * (1LL << (attempt - 1));
-    if (delay_ms > max_delay_ms) {
-        delay_ms = max_delay_ms;
+    int64_t delay_ms = max_delay_ms;
+    if (attempt <= 7) {
+        delay_ms = std::min<int64_t>(base_delay_ms << (attempt - 1), max_delay_ms);
     }
 
-    static std::mt19937 gen(std::random_device{}());
+    thread_local std::mt19937 gen(std::random_device{}());
     std::uniform_int_distribution<int64_t> dist(0, delay_ms / 2);
     return std::chrono::milliseconds(delay_ms + dist(gen));
 }
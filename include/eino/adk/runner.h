@@ -125,12 +125,20 @@ private:
     bool enable_streaming_ = false;
     std::shared_ptr<CheckPointStore> checkpoint_store_;
 
-    // Handle iterator events and manage checkpoints
+    // Handle iterator events and manage checkpoints; returns at once and
+    // forwards on the agent executor
     void HandleIteratorWithCheckpoint(
         void* ctx,
         std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> agent_iter,
         std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> gen,
         const std::string& checkpoint_id);
+
+    // Save a checkpoint for the run if it stopped on an interrupt
+    void SaveCheckpoint(
+        void* ctx,
+        const std::shared_ptr<AgentEvent>& interrupt_event,
+        const std::vector<Message>& accumulated_messages,
+        const std::string& checkpoint_id);
 };
 
 // Factory function
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_SESSION_HOST_H_
+#define EINO_CPP_ADK_SESSION_HOST_H_
+
+// SessionHost - admission control for many concurrent sessions
+// =============================================================
+// A Runner starts every Run at once. SessionHost sits in front of it and
+// accepts any number of sessions, but only runs max_active of them at a
+// time; the rest wait in one of two lanes:
+// - interactive sessions are admitted first; a waiting batch session gets
+//   a slot after interactive_burst interactive admissions in a row
+// - within a lane, tenants share admissions in proportion to their weight
+//   (weighted fair queuing on per-tenant virtual finish times), so one
+//   tenant's burst does not delay every other tenant
+//
+// Submit returns the session's event iterator at once. Events start once
+// the session is admitted; the agent's iterator is spliced into it with
+// ForwardInline, so hosting adds no hop per event. Dropping the iterator
+// while queued withdraws the session. Sessions refused by admission
+// control get a single error event.
+//
+// Queue time is recorded per lane in eino_session_queue_ns.
+//
+// Example:
+//   SessionHostConfig config;
+//   config.max_active = 256;
+//   config.tenant_weights["premium"] = 4;
+//   auto host = NewSessionHost(runner, config);
+//   SessionRequest request;
+//   request.tenant = "premium";
+//   request.messages = {schema::UserMessage("hi")};
+//   auto events = host->Submit(request);
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "agent_executor.h"
+#include "async_iterator.h"
+#include "call_options.h"
+#include "types.h"
+
+namespace eino {
+namespace adk {
+
+class Runner;
+
+enum class SessionLane {
+    kInteractive,
+    kBatch,
+};
+
+struct SessionRequest {
+    // Tenant the session is accounted to for fair queuing
+    std::string tenant;
+    SessionLane lane = SessionLane::kInteractive;
+    void* ctx = nullptr;
+    std::vector<Message> messages;
+    std::vector<std::shared_ptr<AgentRunOption>> options;
+};
+
+struct SessionHostConfig {
+    // Sessions running at once
+    size_t max_active = 64;
+    // Sessions waiting at once before Submit refuses more; 0 is unbounded
+    size_t max_queued = 0;
+    // Waiting sessions per tenant; 0 is unbounded
+    size_t max_queued_per_tenant = 0;
+    // Interactive admissions in a row before a waiting batch session runs
+    uint32_t interactive_burst = 8;
+    // Relative share of each tenant; tenants not listed weigh 1
+    std::map<std::string, uint32_t> tenant_weights;
+};
+
+struct SessionHostStats {
+    size_t active = 0;
+    size_t peak_active = 0;
+    size_t queued_interactive = 0;
+    size_t queued_batch = 0;
+    uint64_t admitted = 0;
+    uint64_t completed = 0;
+    uint64_t rejected = 0;
+    uint64_t withdrawn = 0;
+};
+
+class SessionHost : public std::enable_shared_from_this<SessionHost> {
+public:
+    using EventIterator = std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>>;
+
+    // Starter begins an admitted session and returns its events
+    using Starter = std::function<EventIterator(const SessionRequest&)>;
+
+    // Owned through a shared_ptr: running sessions keep the host alive
+    SessionHost(Starter starter, const SessionHostConfig& config,
+                AgentExecutor& executor = AgentExecutor::Default());
+
+    SessionHost(const SessionHost&) = delete;
+    SessionHost& operator=(const SessionHost&) = delete;
+
+    // Submit queues a session, or starts it if a slot is free
+    EventIterator Submit(const SessionRequest& request);
+
+    // SetTenantWeight changes a tenant's share for sessions queued later
+    void SetTenantWeight(const std::string& tenant, uint32_t weight);
+
+    SessionHostStats Stats() const;
+
+private:
+    struct Ticket;
+
+    // Entry orders a lane by virtual finish time, then by arrival
+    struct Entry {
+        double finish;
+        uint64_t seq;
+        std::shared_ptr<Ticket> ticket;
+
+        bool operator>(const Entry& other) const {
+            return finish != other.finish ? finish > other.finish : seq > other.seq;
+        }
+    };
+
+    // TenantState is kept while a tenant has sessions waiting in a lane
+    struct TenantState {
+        // Finish time of the tenant's latest queued entry
+        double finish = 0;
+        size_t queued = 0;
+    };
+
+    struct Lane {
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        // Finish time of the entry admitted last
+        double virtual_time = 0;
+        std::map<std::string, TenantState> tenants;
+        // Entries waiting, not counting withdrawn ones left in heap
+        size_t queued = 0;
+    };
+
+    Lane& LaneOf(SessionLane lane) {
+        return lane == SessionLane::kBatch ? batch_ : interactive_;
+    }
+
+    // NextLocked takes the next session to admit, or null
+    std::shared_ptr<Ticket> NextLocked();
+    std::shared_ptr<Ticket> PopLocked(Lane& lane);
+    void ForgetLocked(Lane& lane, const std::shared_ptr<Ticket>& ticket);
+
+    void Start(const std::shared_ptr<Ticket>& ticket);
+    void Withdraw(const std::shared_ptr<Ticket>& ticket);
+    // Finish frees a slot and schedules the sessions that can now run
+    void Finish();
+
+    Starter starter_;
+    SessionHostConfig config_;
+    AgentExecutor& executor_;
+
+    mutable std::mutex mutex_;
+    Lane interactive_;
+    Lane batch_;
+    uint32_t interactive_streak_ = 0;
+    uint64_t next_seq_ = 0;
+    SessionHostStats stats_;
+};
+
+// NewSessionHost hosts sessions of runner: each admitted session is
+// runner->Run(request.ctx, request.messages, request.options)
+std::shared_ptr<SessionHost> NewSessionHost(std::shared_ptr<Runner> runner,
+                                            const SessionHostConfig& config = SessionHostConfig());
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_SESSION_HOST_H_
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_ADK_TASK_DISPATCH_H_
+#define EINO_CPP_ADK_TASK_DISPATCH_H_
+
+// Sub-agent task dispatch
+// =======================
+// When an orchestrator asks for several "task" calls in one turn,
+// DispatchTasks runs them side by side, up to max_concurrent_tasks at a
+// time, and hands back each result as soon as its sub-agent finishes.
+//
+// Every task gets its own SubAgentContext. The context refers to the
+// parent history instead of copying it: the history is a persistent
+// MessageHistory that shares the parent's messages, and the flat message
+// list a sub-agent reads is only built the first time it asks for one.
+// Whatever a sub-agent appends stays in its own context.
+//
+// Example:
+//   TaskDispatchConfig config;
+//   config.max_concurrent_tasks = 4;
+//   auto results = DispatchTasks(ctx, tasks, starter, parent_history, config);
+//   SubAgentResult result;
+//   while (results->Next(result)) {
+//       Reply(result.call_id, result.error.empty() ? result.result : result.error);
+//   }
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "agent_executor.h"
+#include "async_iterator.h"
+#include "types.h"
+#include "eino/schema/message_ref.h"
+
+namespace eino {
+namespace adk {
+
+// SubAgentTask is one "task" tool call
+struct SubAgentTask {
+    std::string call_id;
+    std::string subagent_type;
+    std::string description;
+};
+
+struct SubAgentResult {
+    // Position of the task among those dispatched together
+    size_t index = 0;
+    std::string call_id;
+    std::string subagent_type;
+    // Content of the last message the sub-agent emitted
+    std::string result;
+    std::string error;
+};
+
+// SubAgentContext is what one task's sub-agent sees: the parent history
+// (when inherited) followed by the task description as a user message
+class SubAgentContext {
+public:
+    SubAgentContext(const SubAgentTask& task, const schema::MessageHistory& parent,
+                    bool inherit_history);
+
+    const SubAgentTask& Task() const { return task_; }
+
+    // History shares the parent's messages; appending to it stays local
+    const schema::MessageHistory& History() const { return history_; }
+
+    // Messages flattens History for agent input, once, on first use. The
+    // pointers stay valid while the context lives
+    const std::vector<Message>& Messages();
+
+    // Materialized reports whether Messages has been called
+    bool Materialized() const;
+
+private:
+    SubAgentTask task_;
+    schema::MessageHistory history_;
+    mutable std::mutex mutex_;
+    bool materialized_ = false;
+    std::vector<schema::Message> storage_;
+    std::vector<Message> messages_;
+};
+
+struct TaskDispatchConfig {
+    // Tasks of one turn running at once
+    size_t max_concurrent_tasks = 4;
+    // Start sub-agents from the parent history instead of the task alone
+    bool inherit_history = false;
+};
+
+using SubAgentEventIterator = std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>>;
+
+// SubAgentStarter runs the sub-agent for a task; it may throw, or return
+// null for an unknown sub-agent
+using SubAgentStarter = std::function<SubAgentEventIterator(
+    void* ctx, const std::shared_ptr<SubAgentContext>& context)>;
+
+// DispatchTasks runs tasks and returns their results in the order they
+// finish. Dropping the iterator stops the running sub-agents and starts
+// no more
+std::shared_ptr<AsyncIterator<SubAgentResult>> DispatchTasks(
+    void* ctx,
+    std::vector<SubAgentTask> tasks,
+    SubAgentStarter starter,
+    const schema::MessageHistory& parent,
+    const TaskDispatchConfig& config = TaskDispatchConfig(),
+    AgentExecutor& executor = AgentExecutor::Default());
+
+}  // namespace adk
+}  // namespace eino
+
+#endif  // EINO_CPP_ADK_TASK_DISPATCH_H_
@@ -24,7 +24,9 @@
 #include <functional>
 
 #include "eino/adk/agent.h"
+#include "eino/adk/task_dispatch.h"
 #include "eino/components/tool.h"
+#include "eino/schema/message_ref.h"
 
 namespace eino {
 namespace adk {
@@ -56,17 +58,23 @@ struct TaskToolArgument {
 // 2. **Run** → The subagent completes the task autonomously
 // 3. **Return** → The subagent provides a single structured result
 // 4. **Reconcile** → Incorporate the result into the main thread
+//
+// RunTasks takes every task call of a turn at once and runs the sub-agents
+// side by side, see task_dispatch.h. The tools node hands calls over one
+// InvokableRun at a time, so InvokableRun is RunTasks over that one call:
+// each sub-agent starts from its own SubAgentContext, and the concurrency
+// limit applies to the calls of one RunTasks.
 class TaskTool : public Tool {
 public:
     // Constructor
-    // @param sub_agents: Map of subagent name -> AgentTool instances
-    // @param sub_agent_slice: Vector of all available subagents (for description generation)
+    // @param sub_agent_slice: All available subagents, run by name
     // @param desc_gen: Optional custom description generator function
+    // @param dispatch: Concurrency and history sharing for RunTasks
     TaskTool(
         void* ctx,
-        std::map<std::string, std::shared_ptr<Tool>> sub_agents,
         std::vector<std::shared_ptr<Agent>> sub_agent_slice,
-        TaskToolDescriptionGenerator desc_gen = nullptr);
+        TaskToolDescriptionGenerator desc_gen = nullptr,
+        const TaskDispatchConfig& dispatch = TaskDispatchConfig());
 
     ~TaskTool() override = default;
 
@@ -78,10 +86,20 @@ public:
         const std::string& arguments_json,
         const std::vector<ToolOption>& opts = {}) override;
 
+    // RunTasks runs the "task" calls of one turn, at most
+    // max_concurrent_tasks at a time, and yields each result as its
+    // sub-agent finishes. parent_history is shared with the sub-agents,
+    // not copied
+    std::shared_ptr<AsyncIterator<SubAgentResult>> RunTasks(
+        void* ctx,
+        const std::vector<schema::ToolCall>& calls,
+        const schema::MessageHistory& parent_history);
+
 private:
-    std::map<std::string, std::shared_ptr<Tool>> sub_agents_;
     std::vector<std::shared_ptr<Agent>> sub_agent_slice_;
     TaskToolDescriptionGenerator desc_gen_;
+    TaskDispatchConfig dispatch_;
+    std::map<std::string, std::shared_ptr<Agent>> agents_by_name_;
 
     // Default task tool description generator
     // 对齐 eino/adk/prebuilt/deep/task_tool.go:163-173
@@ -103,6 +121,7 @@ private:
 // @param tools_config: Tools configuration for the general-purpose subagent
 // @param max_iteration: Maximum iterations for the general-purpose subagent
 // @param middlewares: Agent middlewares for the general-purpose subagent
+// @param dispatch: Concurrency and history sharing for RunTasks
 //
 // @return: Pair of (TaskTool instance, error)
 std::pair<std::shared_ptr<TaskTool>, std::string> NewTaskTool(
@@ -114,7 +133,8 @@ std::pair<std::shared_ptr<TaskTool>, std::string> NewTaskTool(
     const std::string& instruction,
     const ToolsConfig& tools_config,
     int max_iteration,
-    const std::vector<AgentMiddleware>& middlewares);
+    const std::vector<AgentMiddleware>& middlewares,
+    const TaskDispatchConfig& dispatch = TaskDispatchConfig());
 
 // NewTaskToolMiddleware creates an AgentMiddleware that includes the task tool.
 //
@@ -130,7 +150,8 @@ std::pair<AgentMiddleware, std::string> NewTaskToolMiddleware(
     const std::string& instruction,
     const ToolsConfig& tools_config,
     int max_iteration,
-    const std::vector<AgentMiddleware>& middlewares);
+    const std::vector<AgentMiddleware>& middlewares,
+    const TaskDispatchConfig& dispatch = TaskDispatchConfig());
 
 } // namespace adk
 } // namespace eino
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_COMPONENTS_PREBUILT_CACHED_EMBEDDER_H_
+#define EINO_CPP_COMPONENTS_PREBUILT_CACHED_EMBEDDER_H_
+
+#include "../embedding.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace eino {
+namespace components {
+
+// EmbeddingCacheKey is a 128-bit content hash of a text
+// Two independent 64-bit hashes keep accidental collisions negligible
+// without storing the text itself in the cache
+struct EmbeddingCacheKey {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    bool operator==(const EmbeddingCacheKey& other) const {
+        return hi == other.hi && lo == other.lo;
+    }
+
+    // Hex returns the key as a 32-character hex string (used for spill files)
+    std::string Hex() const;
+};
+
+struct EmbeddingCacheKeyHash {
+    size_t operator()(const EmbeddingCacheKey& key) const {
+        return static_cast<size_t>(key.hi ^ (key.lo * 0x9e3779b97f4a7c15ULL));
+    }
+};
+
+// CachedEmbedderConfig configures a CachedEmbedder
+struct CachedEmbedderConfig {
+    // Embedder is the wrapped embedder (required)
+    std::shared_ptr<Embedder> embedder;
+
+    // Namespace is mixed into every content hash so that caches of
+    // different models never serve each other's vectors
+    std::string cache_namespace;
+
+    // MaxCacheBytes bounds the in-memory cache (vector payload bytes)
+    // Least recently used entries are evicted (or spilled) beyond this
+    size_t max_cache_bytes = 64 * 1024 * 1024;
+
+    // SpillDir enables disk spill when non-empty: evicted vectors are
+    // written to <spill_dir>/<key>.emb and reloaded on a later miss
+    std::string spill_dir;
+
+    // MaxBatchSize is the largest batch sent to the wrapped embedder
+    size_t max_batch_size = 64;
+
+    // MaxBatchDelay is the latency budget for coalescing: a batch is
+    // flushed when it is full or when its oldest text has waited this long
+    // Zero disables coalescing; misses are embedded on the caller's thread
+    std::chrono::milliseconds max_batch_delay{5};
+};
+
+// CachedEmbedderStats reports cache effectiveness counters
+struct CachedEmbedderStats {
+    uint64_t requested_texts = 0;   // Texts passed to Invoke
+    uint64_t deduplicated = 0;      // Texts served by a duplicate in the same request
+    uint64_t memory_hits = 0;       // Texts served from the in-memory cache
+    uint64_t inflight_hits = 0;     // Texts joined to an embedding already in flight
+    uint64_t disk_hits = 0;         // Texts reloaded from the spill directory
+    uint64_t embedded_texts = 0;    // Texts sent to the wrapped embedder
+    uint64_t embedder_calls = 0;    // Batches sent to the wrapped embedder
+    uint64_t evictions = 0;         // Entries evicted from memory
+    size_t cached_entries = 0;
+    size_t cached_bytes = 0;
+};
+
+// CachedEmbedder is an Embedder decorator that content-hashes texts,
+// deduplicates them within and across requests, serves repeats from a
+// memory-bounded LRU cache (with optional disk spill), and coalesces
+// concurrent small requests into right-sized batches for the wrapped
+// embedder under a max-latency budget
+//
+// Call options are part of the cache key, so a vector is only served to
+// requests made with the same options. Requests that carry options bypass
+// coalescing (their options are forwarded as-is). A coalesced batch is
+// embedded under the context of its oldest request
+class CachedEmbedder : public Embedder {
+public:
+    explicit CachedEmbedder(const CachedEmbedderConfig& config);
+    virtual ~CachedEmbedder();
+
+    CachedEmbedder(const CachedEmbedder&) = delete;
+    CachedEmbedder& operator=(const CachedEmbedder&) = delete;
+
+    // Invoke embeds texts, returning one vector per input text in order
+    std::vector<std::vector<double>> Invoke(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<std::string>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    std::shared_ptr<compose::StreamReader<std::vector<std::vector<double>>>> Stream(
+        std::shared_ptr<compose::Context> ctx,
+        const std::vector<std::string>& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    std::vector<std::vector<double>> Collect(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::vector<std::string>>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    std::shared_ptr<compose::StreamReader<std::vector<std::vector<double>>>> Transform(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<std::vector<std::string>>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    // GetStats returns a snapshot of the cache counters
+    CachedEmbedderStats GetStats() const;
+
+    // Clear drops all in-memory entries (spilled files are kept)
+    void Clear();
+
+    // HashText returns the cache key of a text under this embedder's
+    // namespace and the given call options
+    EmbeddingCacheKey HashText(const std::string& text,
+                               const std::vector<compose::Option>& opts =
+                                   std::vector<compose::Option>()) const;
+
+private:
+    using EmbeddingFuture = std::shared_future<std::vector<double>>;
+
+    // PendingText is a unique cache miss waiting to be embedded
+    struct PendingText {
+        EmbeddingCacheKey key;
+        std::string text;
+        std::shared_ptr<compose::Context> ctx;
+        std::shared_ptr<std::promise<std::vector<double>>> promise;
+        std::chrono::steady_clock::time_point enqueued_at;
+    };
+
+    struct CacheEntry {
+        std::vector<double> vector;
+        std::list<EmbeddingCacheKey>::iterator lru_it;
+    };
+
+    // Cache helpers; callers must hold mutex_
+    bool LookupLocked(const EmbeddingCacheKey& key, std::vector<double>& out);
+    void InsertLocked(const EmbeddingCacheKey& key, const std::vector<double>& vec,
+                      std::vector<std::pair<EmbeddingCacheKey, std::vector<double>>>& evicted);
+
+    // Disk spill helpers (called without mutex_)
+    std::string SpillPath(const EmbeddingCacheKey& key) const;
+    bool LoadSpilled(const EmbeddingCacheKey& key, std::vector<double>& out) const;
+    void Spill(const std::vector<std::pair<EmbeddingCacheKey, std::vector<double>>>& evicted) const;
+
+    // EmbedBatch resolves a batch of pending texts (disk first, then the
+    // wrapped embedder in chunks of max_batch_size) and fulfils their promises
+    void EmbedBatch(std::shared_ptr<compose::Context> ctx,
+                    std::vector<PendingText>& batch,
+                    const std::vector<compose::Option>& opts);
+
+    // BatcherLoop coalesces queued misses into batches
+    void BatcherLoop();
+
+    CachedEmbedderConfig config_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<EmbeddingCacheKey, CacheEntry, EmbeddingCacheKeyHash> cache_;
+    std::list<EmbeddingCacheKey> lru_;  // front = most recently used
+    size_t cached_bytes_ = 0;
+    std::unordered_map<EmbeddingCacheKey, EmbeddingFuture, EmbeddingCacheKeyHash> inflight_;
+    CachedEmbedderStats stats_;
+
+    // Coalescing queue
+    std::deque<PendingText> queue_;
+    std::condition_variable queue_cv_;
+    bool stopping_ = false;
+    std::thread batcher_;
+};
+
+// NewCachedEmbedder creates a CachedEmbedder wrapping config.embedder
+std::shared_ptr<CachedEmbedder> NewCachedEmbedder(const CachedEmbedderConfig& config);
+
+} // namespace components
+} // namespace eino
+
+#endif // EINO_CPP_COMPONENTS_PREBUILT_CACHED_EMBEDDER_H_
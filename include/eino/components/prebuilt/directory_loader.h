@@ -0,0 +1,122 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_COMPONENTS_PREBUILT_DIRECTORY_LOADER_H_
+#define EINO_CPP_COMPONENTS_PREBUILT_DIRECTORY_LOADER_H_
+
+#include "../document.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eino {
+namespace components {
+
+// DirectoryLoaderConfig configures a DirectoryLoader
+struct DirectoryLoaderConfig {
+    // Recursive walks sub-directories
+    bool recursive = true;
+
+    // FollowSymlinks follows symbolic links to files and directories; each
+    // directory is walked once, so links that form a cycle are not re-entered
+    bool follow_symlinks = false;
+
+    // IncludePatterns are glob patterns a file must match (any of them);
+    // empty means every regular file. A pattern without '/' is matched
+    // against the file name, a pattern with '/' against the path relative
+    // to the root (where '*' also crosses directory separators)
+    std::vector<std::string> include_patterns;
+
+    // ExcludePatterns skip matching files and prune matching directories
+    std::vector<std::string> exclude_patterns;
+
+    // NumWorkers is the number of reader threads (0 = hardware concurrency)
+    size_t num_workers = 0;
+
+    // MaxInflightBytes caps bytes read but not yet consumed from the stream;
+    // readers block when the cap is reached (a single larger file is still
+    // admitted when nothing else is in flight)
+    size_t max_inflight_bytes = 64 * 1024 * 1024;
+
+    // MaxFileBytes skips files larger than this (0 = unlimited)
+    size_t max_file_bytes = 0;
+
+    // FailFast stops the load on the first unreadable file, directory or
+    // root; the error is rethrown from the stream's Read. Otherwise failures
+    // are reported to on_error and the path is skipped
+    bool fail_fast = true;
+
+    // OnError is called (from the walker or a reader thread) for paths that
+    // fail to load when fail_fast is false
+    std::function<void(const std::string& path, const std::string& error)> on_error;
+};
+
+// DirectoryLoader loads files below one or more roots into documents
+// Directories are walked recursively with glob filters while a pool of
+// reader threads loads files in parallel. Documents are emitted through
+// the returned stream as soon as each file is loaded, one chunk per file in
+// completion order, so downstream splitting and embedding overlap with I/O
+//
+// Each document has id and metadata["source"] set to the file path; empty
+// files produce no document. A Source that names a regular file loads just
+// that file
+class DirectoryLoader : public Loader {
+public:
+    explicit DirectoryLoader(const DirectoryLoaderConfig& config = DirectoryLoaderConfig());
+    virtual ~DirectoryLoader() = default;
+
+    // Invoke loads every document below the source and returns them together
+    std::vector<schema::Document> Invoke(
+        std::shared_ptr<compose::Context> ctx,
+        const schema::Source& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    // Stream emits documents below the source as they are loaded
+    std::shared_ptr<compose::StreamReader<std::vector<schema::Document>>> Stream(
+        std::shared_ptr<compose::Context> ctx,
+        const schema::Source& input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    std::vector<schema::Document> Collect(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<schema::Source>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    // Transform walks each source as it arrives on the input stream
+    std::shared_ptr<compose::StreamReader<std::vector<schema::Document>>> Transform(
+        std::shared_ptr<compose::Context> ctx,
+        std::shared_ptr<compose::StreamReader<schema::Source>> input,
+        const std::vector<compose::Option>& opts = std::vector<compose::Option>()) override;
+
+    const DirectoryLoaderConfig& GetConfig() const { return config_; }
+
+    // MatchFile reports whether a path relative to a walk root passes the
+    // include/exclude patterns of config
+    static bool MatchFile(const DirectoryLoaderConfig& config, const std::string& rel_path);
+
+    // ReadFileContent reads a whole file straight into the returned string;
+    // throws std::runtime_error
+    static std::string ReadFileContent(const std::string& path);
+
+private:
+    DirectoryLoaderConfig config_;
+};
+
+} // namespace components
+} // namespace eino
+
+#endif // EINO_CPP_COMPONENTS_PREBUILT_DIRECTORY_LOADER_H_
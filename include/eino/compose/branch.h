@@ -23,6 +23,7 @@
 #include <map>
 #include <set>
 #include <functional>
+#include "branch_speculation.h"
 #include "stream_reader.h"
 
 namespace eino {
@@ -85,9 +86,19 @@ public:
     // SetIndex sets branch index
     virtual void SetIndex(int idx) { index_ = idx; }
 
+    // EnableSpeculation lets idempotent targets start on a predicted outcome
+    // before the condition resolves; see branch_speculation.h
+    void EnableSpeculation(const BranchSpeculation& config) {
+        predictor_ = std::make_shared<BranchPredictor>(config);
+    }
+
+    // GetPredictor returns the speculation predictor, or null when disabled
+    std::shared_ptr<BranchPredictor> GetPredictor() const { return predictor_; }
+
 protected:
     int index_ = 0;
     bool no_data_flow_ = false;
+    std::shared_ptr<BranchPredictor> predictor_;
 };
 
 // ConcreteGraphBranch is templated implementation of GraphBranch
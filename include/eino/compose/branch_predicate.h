@@ -0,0 +1,431 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_COMPOSE_BRANCH_PREDICATE_H_
+#define EINO_CPP_COMPOSE_BRANCH_PREDICATE_H_
+
+// Branch conditions: operators, clause configs and the compiled predicates
+// BranchNode evaluates. They depend on nothing but the standard library, so
+// conditions can be compiled and evaluated without the compose runtime
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace eino {
+namespace compose {
+
+// ============================================================================
+// Operator Types
+// ============================================================================
+// Aligns with: coze-studio/backend/domain/workflow/internal/nodes/selector/operator.go
+
+enum class BranchOperator {
+    Equal,                  // "="
+    NotEqual,              // "!="
+    Empty,                 // "empty"
+    NotEmpty,              // "not_empty"
+    Greater,               // ">"
+    GreaterOrEqual,        // ">="
+    Lesser,                // "<"
+    LesserOrEqual,         // "<="
+    IsTrue,                // "true"
+    IsFalse,               // "false"
+    LengthGreater,         // "len >"
+    LengthGreaterOrEqual,  // "len >="
+    LengthLesser,          // "len <"
+    LengthLesserOrEqual,   // "len <="
+    Contain,               // "contain"
+    NotContain,            // "not_contain"
+    ContainKey,            // "contain_key"
+    NotContainKey,         // "not_contain_key"
+};
+
+// Convert operator enum to string (for debugging)
+inline std::string OperatorToString(BranchOperator op) {
+    switch (op) {
+        case BranchOperator::Equal: return "=";
+        case BranchOperator::NotEqual: return "!=";
+        case BranchOperator::Empty: return "empty";
+        case BranchOperator::NotEmpty: return "not_empty";
+        case BranchOperator::Greater: return ">";
+        case BranchOperator::GreaterOrEqual: return ">=";
+        case BranchOperator::Lesser: return "<";
+        case BranchOperator::LesserOrEqual: return "<=";
+        case BranchOperator::IsTrue: return "true";
+        case BranchOperator::IsFalse: return "false";
+        case BranchOperator::LengthGreater: return "len >";
+        case BranchOperator::LengthGreaterOrEqual: return "len >=";
+        case BranchOperator::LengthLesser: return "len <";
+        case BranchOperator::LengthLesserOrEqual: return "len <=";
+        case BranchOperator::Contain: return "contain";
+        case BranchOperator::NotContain: return "not_contain";
+        case BranchOperator::ContainKey: return "contain_key";
+        case BranchOperator::NotContainKey: return "not_contain_key";
+        default: return "unknown";
+    }
+}
+
+// ============================================================================
+// Node Reference Types - 节点输出引用能力
+// ============================================================================
+// Aligns with: coze-studio/backend/domain/workflow/internal/schema/stream.go
+
+// NodeReference represents a reference to another node's output
+// Aligns with: FieldInfo.Source.Ref (stream.go:40-43)
+struct NodeReference {
+    std::string from_node_key;              // Source node key (e.g., "node_a", "node_b")
+    std::vector<std::string> from_path;     // Path within node output (e.g., ["age"], ["result", "score"])
+    
+    NodeReference() = default;
+    NodeReference(const std::string& node_key, const std::vector<std::string>& path = {})
+        : from_node_key(node_key), from_path(path) {}
+};
+
+// ValueSource represents the source of a value (either a node reference or literal value)
+// Aligns with: FieldInfo.Source (combines Ref and Literal)
+struct ValueSource {
+    enum class Type {
+        Literal,    // Static literal value
+        Reference   // Reference to node output
+    };
+    
+    Type type;
+    std::any literal_value;                       // Used when type == Literal
+    std::shared_ptr<NodeReference> node_ref;      // Used when type == Reference
+    
+    // Create literal value source
+    static ValueSource Literal(const std::any& value) {
+        ValueSource src;
+        src.type = Type::Literal;
+        src.literal_value = value;
+        return src;
+    }
+    
+    // Create node reference source
+    static ValueSource Reference(const std::string& node_key, const std::vector<std::string>& path = {}) {
+        ValueSource src;
+        src.type = Type::Reference;
+        src.node_ref = std::make_shared<NodeReference>(node_key, path);
+        return src;
+    }
+};
+
+// ============================================================================
+// Clause Types
+// ============================================================================
+// Aligns with: coze-studio/backend/domain/workflow/internal/nodes/selector/clause.go
+
+enum class ClauseRelation {
+    AND,  // All clauses must be true
+    OR    // At least one clause must be true
+};
+
+// Operants holds the left and right operands for a condition
+// Aligns with: selector.Operants (selector.go:83-87)
+struct Operants {
+    std::any left;   // Left operand value
+    std::any right;  // Right operand value (optional for unary operators)
+    
+    // For multi-clause support (AND/OR)
+    std::vector<Operants> multi;
+    
+    Operants() = default;
+    Operants(const std::any& l, const std::any& r = std::any()) : left(l), right(r) {}
+};
+
+// Predicate interface - evaluates to bool
+// Aligns with: selector.Predicate (clause.go:27)
+class Predicate {
+public:
+    virtual ~Predicate() = default;
+    
+    // Resolve evaluates the predicate and returns the result
+    virtual bool Resolve() = 0;
+};
+
+// Clause represents a single condition (left op right)
+// Aligns with: selector.Clause (clause.go:29-33)
+class Clause : public Predicate {
+public:
+    std::any left_operand;
+    BranchOperator op;
+    std::any right_operand;
+    
+    Clause(const std::any& left, BranchOperator op_val, const std::any& right = std::any())
+        : left_operand(left), op(op_val), right_operand(right) {}
+    
+    // Resolve implements Predicate interface
+    // Aligns with: selector.Clause.Resolve (clause.go:35-286)
+    bool Resolve() override;
+};
+
+// EvaluateOperator applies op to operands read in place (no copies of
+// strings, lists or maps). A null or empty operand counts as absent
+bool EvaluateOperator(BranchOperator op, const std::any* left, const std::any* right);
+
+// MultiClause represents multiple conditions combined with AND/OR
+// Aligns with: selector.MultiClause (clause.go:35-38)
+class MultiClause : public Predicate {
+public:
+    std::vector<std::shared_ptr<Clause>> clauses;
+    ClauseRelation relation;
+    
+    MultiClause(ClauseRelation rel) : relation(rel) {}
+    
+    void AddClause(std::shared_ptr<Clause> clause) {
+        clauses.push_back(clause);
+    }
+    
+    // Resolve implements Predicate interface
+    // Aligns with: selector.MultiClause.Resolve (clause.go:288-312)
+    bool Resolve() override {
+        if (relation == ClauseRelation::AND) {
+            // All clauses must be true
+            for (const auto& clause : clauses) {
+                if (!clause->Resolve()) {
+                    return false;
+                }
+            }
+            return true;
+        } else {  // OR
+            // At least one clause must be true
+            for (const auto& clause : clauses) {
+                if (clause->Resolve()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+};
+
+// ============================================================================
+// BranchNode Configuration
+// ============================================================================
+
+// OperandConfig represents configuration for a single operand (left or right)
+struct OperandConfig {
+    ValueSource source;
+    
+    OperandConfig() = default;
+    explicit OperandConfig(const ValueSource& src) : source(src) {}
+    
+    // Helper: Create from literal value
+    static OperandConfig FromLiteral(const std::any& value) {
+        return OperandConfig(ValueSource::Literal(value));
+    }
+    
+    // Helper: Create from node reference
+    static OperandConfig FromNode(const std::string& node_key, const std::vector<std::string>& path = {}) {
+        return OperandConfig(ValueSource::Reference(node_key, path));
+    }
+};
+
+// SingleClauseConfig represents one condition (left op right)
+struct SingleClauseConfig {
+    BranchOperator op;
+    OperandConfig left;
+    OperandConfig right;  // Optional for unary operators
+    
+    SingleClauseConfig() = default;
+    SingleClauseConfig(BranchOperator op_val, const OperandConfig& l, const OperandConfig& r = OperandConfig())
+        : op(op_val), left(l), right(r) {}
+};
+
+// OneClauseConfig represents a single branch condition (single or multi-clause)
+// Aligns with: selector.OneClauseSchema (schema.go:23-26)
+struct OneClauseConfig {
+    // Single condition
+    std::shared_ptr<SingleClauseConfig> single;
+    
+    // Multi-clause condition (AND/OR)
+    struct MultiClauseConfig {
+        std::vector<SingleClauseConfig> clauses;
+        ClauseRelation relation;
+    };
+    std::shared_ptr<MultiClauseConfig> multi;
+    
+    OneClauseConfig() = default;
+    
+    // Create single condition (backward compatible - uses literal values)
+    static OneClauseConfig Single(BranchOperator op) {
+        OneClauseConfig config;
+        config.single = std::make_shared<SingleClauseConfig>();
+        config.single->op = op;
+        return config;
+    }
+    
+    // Create single condition with full operand configuration
+    static OneClauseConfig SingleWithOperands(const SingleClauseConfig& clause) {
+        OneClauseConfig config;
+        config.single = std::make_shared<SingleClauseConfig>(clause);
+        return config;
+    }
+    
+    // Create multi-clause condition (backward compatible)
+    static OneClauseConfig Multi(const std::vector<BranchOperator>& ops, ClauseRelation rel) {
+        OneClauseConfig config;
+        config.multi = std::make_shared<MultiClauseConfig>();
+        config.multi->relation = rel;
+        for (const auto& op : ops) {
+            SingleClauseConfig clause;
+            clause.op = op;
+            config.multi->clauses.push_back(clause);
+        }
+        return config;
+    }
+    
+    // Create multi-clause condition with full operand configuration
+    static OneClauseConfig MultiWithOperands(const std::vector<SingleClauseConfig>& clauses, ClauseRelation rel) {
+        OneClauseConfig config;
+        config.multi = std::make_shared<MultiClauseConfig>();
+        config.multi->clauses = clauses;
+        config.multi->relation = rel;
+        return config;
+    }
+};
+
+// BranchNodeConfig configuration for BranchNode
+// Aligns with: selector.Config (selector.go:34-36)
+struct BranchNodeConfig {
+    std::vector<OneClauseConfig> clauses;
+    
+    BranchNodeConfig() = default;
+    
+    // ========== Backward Compatible API (使用literal values) ==========
+    
+    // Add a single condition branch (backward compatible)
+    void AddSingleCondition(BranchOperator op) {
+        clauses.push_back(OneClauseConfig::Single(op));
+    }
+    
+    // Add a multi-clause condition branch (backward compatible)
+    void AddMultiCondition(const std::vector<BranchOperator>& ops, ClauseRelation rel) {
+        clauses.push_back(OneClauseConfig::Multi(ops, rel));
+    }
+    
+    // ========== New API with Node Reference Support ==========
+    
+    // Add single condition with full operand configuration
+    // Example:
+    //   config.AddConditionWithOperands(
+    //       BranchOperator::GreaterOrEqual,
+    //       OperandConfig::FromNode("node_a", {"age"}),      // Reference node A's output.age
+    //       OperandConfig::FromLiteral(18)                    // Compare with literal 18
+    //   );
+    void AddConditionWithOperands(BranchOperator op, 
+                                   const OperandConfig& left,
+                                   const OperandConfig& right = OperandConfig()) {
+        SingleClauseConfig clause(op, left, right);
+        clauses.push_back(OneClauseConfig::SingleWithOperands(clause));
+    }
+    
+    // Add multi-clause condition with full operand configuration
+    // Example:
+    //   config.AddMultiConditionWithOperands({
+    //       SingleClauseConfig(BranchOperator::GreaterOrEqual, 
+    //                          OperandConfig::FromNode("node_a", {"age"}),
+    //                          OperandConfig::FromLiteral(18)),
+    //       SingleClauseConfig(BranchOperator::Equal,
+    //                          OperandConfig::FromNode("node_b", {"vip"}),
+    //                          OperandConfig::FromLiteral(true))
+    //   }, ClauseRelation::AND);
+    void AddMultiConditionWithOperands(const std::vector<SingleClauseConfig>& clauses_list,
+                                        ClauseRelation rel) {
+        clauses.push_back(OneClauseConfig::MultiWithOperands(clauses_list, rel));
+    }
+};
+
+// ============================================================================
+// Compiled Conditions
+// ============================================================================
+// BranchNode::New compiles BranchNodeConfig into these once, so Invoke only
+// walks precomputed paths and compares operands in place
+
+// BranchInputs views a BranchNode input without copying it: each key maps
+// to an output map owned by the caller, e.g. a graph's node outputs
+using BranchInputs = std::map<std::string, const std::map<std::string, std::any>*>;
+
+// OperandAccessor locates one operand: a literal held by value, or a path
+// into the (nested) input map, e.g. {"node_a", "age"} or {"0", "left"}
+struct OperandAccessor {
+    enum class Kind { None, Literal, Path };
+
+    Kind kind = Kind::None;
+    std::any literal;
+    std::vector<std::string> path;
+
+    // Resolve returns the operand inside input (or the literal), or null if
+    // it is absent
+    const std::any* Resolve(const std::map<std::string, std::any>& input) const;
+
+    // Resolve over a view; a path naming a whole viewed map (e.g. a
+    // contain_key test on a node output) copies that map into scratch
+    const std::any* Resolve(const BranchInputs& inputs, std::any& scratch) const;
+};
+
+// CompiledCondition is one "left op right" test
+struct CompiledCondition {
+    BranchOperator op = BranchOperator::Equal;
+    OperandAccessor left;
+    OperandAccessor right;
+    std::string missing_left_error;  // Thrown when left does not resolve
+
+    // Hashed members of a literal list on the left of contain/not_contain
+    // (an "IN" check), so the lookup does not scan the list
+    bool hashed = false;
+    std::unordered_set<int64_t> int_members;
+    std::unordered_set<std::string> string_members;
+
+    bool Evaluate(const std::map<std::string, std::any>& input) const;
+    bool Evaluate(const BranchInputs& inputs) const;
+
+private:
+    bool Test(const std::any* lhs, const std::any* rhs) const;
+};
+
+// CompiledClause is one branch: its conditions short-circuit under relation
+struct CompiledClause {
+    std::vector<CompiledCondition> conditions;
+    ClauseRelation relation = ClauseRelation::AND;
+
+    bool Evaluate(const std::map<std::string, std::any>& input) const;
+    bool Evaluate(const BranchInputs& inputs) const;
+};
+
+// CompileBranchClauses builds the predicate tree for a validated config.
+// Legacy configs read operands from "<i>/left" and "<i>/right" (or
+// "<i>/<j>/left" for multi clauses); reference configs use their sources
+std::vector<CompiledClause> CompileBranchClauses(const BranchNodeConfig& config,
+                                                 bool uses_node_references);
+
+// SelectBranch returns the index of the first clause that matches, or the
+// clause count (the default branch) when none does
+int64_t SelectBranch(const std::vector<CompiledClause>& clauses,
+                     const std::map<std::string, std::any>& input);
+int64_t SelectBranch(const std::vector<CompiledClause>& clauses,
+                     const BranchInputs& inputs);
+
+} // namespace compose
+} // namespace eino
+
+#endif // EINO_CPP_COMPOSE_BRANCH_PREDICATE_H_
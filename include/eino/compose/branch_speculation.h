@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_COMPOSE_BRANCH_SPECULATION_H_
+#define EINO_CPP_COMPOSE_BRANCH_SPECULATION_H_
+
+// Speculative pre-execution of branch targets
+//
+// With speculation enabled on a branch, the GraphRunner starts the predicted
+// target(s) once the upstream node has finished, then evaluates the branch
+// condition while they run. Only targets marked idempotent
+// (Graph::SetNodeIdempotent) whose sole trigger is the branch are started.
+// When the condition agrees, the speculative task is adopted as the target's
+// run; otherwise it is cancelled through TaskManager::Cancel and its result
+// discarded.
+//
+// The targets read the upstream output, so nothing starts before the
+// upstream node ends: a hit only overlaps the target with the condition
+// and saves at most the condition's run time. Speculate behind slow
+// conditions (a model call, a remote lookup); behind a cheap predicate a
+// hit saves next to nothing and a miss still costs a cancelled task.
+//
+// Example:
+//   BranchSpeculation spec;
+//   spec.hint = {"retrieve"};          // or leave empty to learn from history
+//   branch->EnableSpeculation(spec);
+//   graph->SetNodeIdempotent("retrieve");
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "eino/compose/graph_plan.h"
+
+namespace eino {
+namespace compose {
+
+// BranchSpeculation configures speculation for one branch
+struct BranchSpeculation {
+    // Targets to start speculatively; when empty, the most frequent
+    // targets of the last history_size outcomes are used instead
+    std::vector<std::string> hint;
+
+    // Number of past outcomes the history predictor looks at
+    size_t history_size = 16;
+
+    // Upper bound on targets started speculatively per evaluation
+    size_t max_targets = 1;
+};
+
+// BranchPredictor predicts branch outcomes; shared by concurrent runs
+class BranchPredictor {
+public:
+    explicit BranchPredictor(BranchSpeculation config);
+
+    // Predict returns the targets to start speculatively, most likely first
+    std::vector<std::string> Predict() const;
+
+    // Record adds a resolved outcome to the history
+    void Record(const std::vector<std::string>& outcome);
+
+    const BranchSpeculation& Config() const { return config_; }
+
+private:
+    BranchSpeculation config_;
+    mutable std::mutex mu_;
+    std::deque<std::vector<std::string>> history_;
+};
+
+// SpeculationTargets returns the plan ids of the predicted targets that may
+// be started: user nodes that are idempotent, have no plan predecessors (the
+// branch is their only trigger) and are not in interrupt_before
+std::vector<int> SpeculationTargets(const ExecutionPlan& plan,
+                                    const std::vector<std::string>& predicted,
+                                    const std::function<bool(int id)>& idempotent,
+                                    const std::vector<std::string>& interrupt_before);
+
+// ResolveSpeculation runs the branch condition while the speculated targets
+// run. Selected targets are hits: they are adopted as the target's run and
+// left out of the returned selection. The others are passed to cancel, and
+// so is every target if condition throws. The outcome goes to predictor
+std::vector<std::string> ResolveSpeculation(
+    const std::vector<std::string>& speculated,
+    const std::function<std::vector<std::string>()>& condition,
+    const std::function<void(size_t index)>& cancel,
+    BranchPredictor* predictor);
+
+} // namespace compose
+} // namespace eino
+
+#endif // EINO_CPP_COMPOSE_BRANCH_SPECULATION_H_
@@ -22,6 +22,7 @@
 #include <string>
 #include <typeinfo>
 #include <stdexcept>
+#include <utility>
 #include "runnable.h"
 #include "graph_call_options.h"
 
@@ -73,6 +74,7 @@ struct ChainNodeInfo {
     std::string node_key;
     std::shared_ptr<void> node;  // Type-erased node pointer
     std::vector<std::string> options;
+    std::string graph_node_key;  // Graph node running this step (the fused node when fused)
     
     ChainNodeInfo();
     ChainNodeInfo(ChainNodeType type, 
@@ -193,6 +195,156 @@ protected:
     std::vector<ChainNodeInfo> nodes_;
 };
 
+/**
+ * @brief ChainCompileOptions configures Chain::Compile
+ */
+struct ChainCompileOptions {
+    // Fuse maximal runs of two or more fusible steps into one graph node that
+    // calls the steps back to back. Fusible steps are Lambda (with an Invoke
+    // function), ChatTemplate and Passthrough nodes not appended with
+    // WithNoFusion; they must be synchronous and side-effect free, since they
+    // no longer get their own channel, task or checkpoint boundary
+    bool enable_fusion = false;
+
+    // Initialize node callbacks for every fused step under its own key, as
+    // if it still were a graph node. Off by default: the fused node gets
+    // node callbacks once, under its graph key
+    bool fused_step_callbacks = false;
+};
+
+// Node option key set by WithNoFusion
+constexpr const char* kChainNoFusionOption = "chain_no_fusion";
+
+/**
+ * @brief WithNoFusion keeps an appended step out of fusion
+ *
+ * Use it for lambdas with side effects that need their own graph node.
+ * It is the only node option Chain accepts; Append* records an error for
+ * any other
+ */
+inline Option WithNoFusion() {
+    Option opt;
+    opt[kChainNoFusionOption] = true;
+    return opt;
+}
+
+/**
+ * @brief InitFusedStepCallbacks sets up node callbacks for one fused step
+ */
+Context InitFusedStepCallbacks(const Context& ctx,
+                               const std::string& step_key,
+                               const std::vector<Option>& opts);
+
+/**
+ * @brief FusedChainRunnable runs a run of fused chain steps as one runnable
+ *
+ * Invoke passes the value through each step directly, so a step costs one
+ * virtual call instead of a graph superstep. Stream and Transform keep the
+ * first/last step streaming: Transform collects into the first step and
+ * Stream/Transform stream out of the last one
+ */
+template<typename T>
+class FusedChainRunnable : public ComposableRunnable<T, T> {
+public:
+    FusedChainRunnable(std::vector<std::shared_ptr<Runnable<T, T>>> steps,
+                       std::vector<std::string> step_keys,
+                       bool step_callbacks)
+        : steps_(std::move(steps)),
+          step_keys_(std::move(step_keys)),
+          step_callbacks_(step_callbacks) {
+        if (steps_.empty() || steps_.size() != step_keys_.size()) {
+            throw std::invalid_argument("FusedChainRunnable: steps and keys must match");
+        }
+    }
+
+    T Invoke(
+        std::shared_ptr<Context> ctx,
+        const T& input,
+        const std::vector<Option>& opts = std::vector<Option>()) override {
+        T value = RunStep(0, ctx, input, opts);
+        return RunSteps(1, steps_.size(), ctx, std::move(value), opts);
+    }
+
+    std::shared_ptr<StreamReader<T>> Stream(
+        std::shared_ptr<Context> ctx,
+        const T& input,
+        const std::vector<Option>& opts = std::vector<Option>()) override {
+        const size_t last = steps_.size() - 1;
+        if (last == 0) {
+            return steps_[0]->Stream(StepContext(0, ctx, opts), input, opts);
+        }
+        T value = RunStep(0, ctx, input, opts);
+        value = RunSteps(1, last, ctx, std::move(value), opts);
+        return steps_[last]->Stream(StepContext(last, ctx, opts), value, opts);
+    }
+
+    T Collect(
+        std::shared_ptr<Context> ctx,
+        std::shared_ptr<StreamReader<T>> input,
+        const std::vector<Option>& opts = std::vector<Option>()) override {
+        T value = steps_[0]->Collect(StepContext(0, ctx, opts), input, opts);
+        return RunSteps(1, steps_.size(), ctx, std::move(value), opts);
+    }
+
+    std::shared_ptr<StreamReader<T>> Transform(
+        std::shared_ptr<Context> ctx,
+        std::shared_ptr<StreamReader<T>> input,
+        const std::vector<Option>& opts = std::vector<Option>()) override {
+        const size_t last = steps_.size() - 1;
+        if (last == 0) {
+            return steps_[0]->Transform(StepContext(0, ctx, opts), input, opts);
+        }
+        T value = steps_[0]->Collect(StepContext(0, ctx, opts), input, opts);
+        value = RunSteps(1, last, ctx, std::move(value), opts);
+        return steps_[last]->Stream(StepContext(last, ctx, opts), value, opts);
+    }
+
+    const std::type_info& GetInputType() const override {
+        return typeid(T);
+    }
+
+    const std::type_info& GetOutputType() const override {
+        return typeid(T);
+    }
+
+    std::string GetComponentType() const override {
+        return "FusedChain";
+    }
+
+    // GetStepKeys returns the chain node keys of the fused steps, in order
+    const std::vector<std::string>& GetStepKeys() const {
+        return step_keys_;
+    }
+
+private:
+    std::shared_ptr<Context> StepContext(size_t i,
+                                         const std::shared_ptr<Context>& ctx,
+                                         const std::vector<Option>& opts) const {
+        if (!step_callbacks_) {
+            return ctx;
+        }
+        return std::make_shared<Context>(
+            InitFusedStepCallbacks(ctx ? *ctx : Context(), step_keys_[i], opts));
+    }
+
+    T RunStep(size_t i, const std::shared_ptr<Context>& ctx, const T& input,
+              const std::vector<Option>& opts) {
+        return steps_[i]->Invoke(StepContext(i, ctx, opts), input, opts);
+    }
+
+    T RunSteps(size_t begin, size_t end, const std::shared_ptr<Context>& ctx, T value,
+               const std::vector<Option>& opts) {
+        for (size_t i = begin; i < end; ++i) {
+            value = RunStep(i, ctx, value, opts);
+        }
+        return value;
+    }
+
+    std::vector<std::shared_ptr<Runnable<T, T>>> steps_;
+    std::vector<std::string> step_keys_;
+    bool step_callbacks_;
+};
+
 /**
  * @brief Chain represents a linear chain of runnables
  * 
@@ -216,7 +368,8 @@ protected:
  *   auto output = chain->Invoke(ctx, input);
  */
 template<typename I, typename O>
-class Chain : public ComposableRunnable<I, O> {
+class Chain : public ComposableRunnable<I, O>,
+              public std::enable_shared_from_this<Chain<I, O>> {
 public:
     /**
      * @brief Constructor - creates internal graph
@@ -362,6 +515,14 @@ public:
      */
     void Compile(std::shared_ptr<Context> ctx);
     
+    /**
+     * @brief Compile with options (e.g. step fusion)
+     *
+     * Steps are added to the internal graph here, so fusion can see the
+     * whole chain before choosing graph nodes
+     */
+    void Compile(std::shared_ptr<Context> ctx, const ChainCompileOptions& opts);
+    
     /**
      * @brief IsCompiled returns whether the chain is compiled
      */
@@ -377,6 +538,12 @@ public:
      */
     const std::string& GetError() const;
     
+    /**
+     * @brief GetNodes returns every appended step in order, fused or not;
+     * graph_node_key names the graph node that runs it once compiled
+     */
+    const std::vector<ChainNodeInfo>& GetNodes() const;
+    
     // ========================================================================
     // Runnable Interface Implementation
     // ========================================================================
@@ -424,6 +591,27 @@ private:
         std::shared_ptr<Runnable<M, M>> node,
         const std::vector<Option>& opts);
     
+    /**
+     * @brief addStep records a step; graph nodes are built at Compile
+     */
+    template<typename M>
+    std::shared_ptr<Chain<I, O>> addStep(
+        ChainNodeType node_type,
+        std::shared_ptr<Runnable<M, M>> node,
+        bool fusible);
+    
+    /**
+     * @brief buildGraph adds the recorded steps to the internal graph,
+     * fusing runs of fusible steps when enabled
+     */
+    void buildGraph(const ChainCompileOptions& opts);
+    
+    /**
+     * @brief addGraphNode adds one graph node after pre_node_keys_
+     */
+    void addGraphNode(const std::string& key,
+                      std::shared_ptr<Runnable<I, O>> node);
+    
     /**
      * @brief addEndIfNeeded adds __END__ node to complete the chain
      * Aligns with: eino/compose/chain.go:397-418
@@ -444,6 +632,15 @@ private:
     // Aligns with: eino/compose/chain.go:33 gg *Graph[I, O]
     std::shared_ptr<Graph<I, O>> gg_;
     
+    // Appended steps, added to gg_ at Compile
+    struct Step {
+        ChainNodeInfo info;
+        std::shared_ptr<Runnable<I, O>> runnable;
+        bool fusible;
+    };
+    std::vector<Step> steps_;
+    std::vector<ChainNodeInfo> nodes_;
+    
     // Chain state
     bool is_compiled_;
     bool has_end_;
@@ -30,6 +30,9 @@
 #include "runnable.h"
 #include "types.h"
 #include "graph_validation.h"
+#include "graph_plan.h"
+#include "branch_node.h"
+#include "shared_value.h"
 
 namespace eino {
 
@@ -81,6 +84,9 @@ struct NodeInfo {
     std::string output_key;
     NodeTriggerMode trigger_mode;
     std::map<std::string, std::string> metadata;
+    // Running the node more than once for the same input has no side effects,
+    // so it may be started speculatively ahead of a branch decision
+    bool idempotent = false;
     
     NodeInfo() : trigger_mode(NodeTriggerMode::AllPredecessor) {}
 };
@@ -176,6 +182,19 @@ public:
         }
     }
     
+    // SetNodeIdempotent marks a node as safe to start speculatively
+    // (see BranchSpeculation)
+    void SetNodeIdempotent(const std::string& name, bool idempotent = true) {
+        if (is_compiled_) {
+            throw std::runtime_error("Graph already compiled, cannot modify");
+        }
+        auto it = nodes_.find(name);
+        if (it == nodes_.end()) {
+            throw std::runtime_error("Node not found: " + name);
+        }
+        it->second->info.idempotent = idempotent;
+    }
+    
     void AddEdge(const std::string& from, const std::string& to,
                 bool no_control = false, bool no_data = false,
                 const std::vector<std::shared_ptr<FieldMapping>>& mappings = {}) {
@@ -227,6 +246,7 @@ public:
         
         ValidateGraphStructure();
         TopologicalSort();
+        plan_ = BuildExecutionPlan();
         
         compile_options_ = opts;
         is_compiled_ = true;
@@ -236,6 +256,11 @@ public:
         return is_compiled_;
     }
     
+    // GetExecutionPlan returns the integer-indexed plan built by Compile()
+    std::shared_ptr<const ExecutionPlan> GetExecutionPlan() const {
+        return plan_;
+    }
+    
     const GraphCompileOptions& GetCompileOptions() const {
         return compile_options_;
     }
@@ -256,10 +281,11 @@ public:
             ctx = Context::Background();
         }
         
-        // Store outputs from all nodes indexed by node name
-        std::map<std::string, O> node_outputs;
-        node_outputs[START_NODE] = input;
-        O last_output = input;
+        // Node outputs are kept as shared immutable views, so fan-out to
+        // successors reads them in place instead of copying
+        std::map<std::string, SharedValue> node_outputs;
+        const O* last_output = nullptr;
+        std::string last_node;
         
         // Execute nodes in topological order
         for (const auto& node_name : topological_order_) {
@@ -276,56 +302,103 @@ public:
             auto runnable = std::static_pointer_cast<Runnable<I, O>>(node->runnable);
             bool is_branch_node = (runnable && runnable->GetComponentType() == "BranchNode");
             
-            O node_input;
+            // node_input points at a predecessor's output when there is one
+            // predecessor; merged/branch inputs are built into owned_input
+            const O* node_input = nullptr;
+            O owned_input{};
             
             // ✅ Special handling for BranchNode: provide all node outputs for NodeReference mode
-            if (is_branch_node && std::is_same_v<O, std::map<std::string, std::any>>) {
-                // Build input containing all executed node outputs
-                // Format: {"node_a": {...}, "node_b": {...}, ...}
-                std::map<std::string, std::any> branch_input;
-                
-                for (const auto& [nkey, noutput] : node_outputs) {
-                    if (nkey != START_NODE && nkey != END_NODE) {
-                        branch_input[nkey] = noutput;
+            if constexpr (std::is_same_v<O, std::map<std::string, std::any>>) {
+                if (is_branch_node) {
+                    // Input format: {"node_a": <output>, "node_b": ...}; a
+                    // BranchNode gets only the outputs its conditions reference
+                    auto branch = std::dynamic_pointer_cast<BranchNode<O, O>>(runnable);
+                    if (branch) {
+                        // Conditions read the outputs in place through a view
+                        BranchInputs branch_inputs;
+                        for (const auto& [nkey, noutput] : node_outputs) {
+                            if (branch->ReadsInput(nkey)) {
+                                branch_inputs[nkey] = noutput.template Get<O>();
+                            }
+                        }
+                        if constexpr (std::is_same_v<I, std::map<std::string, std::any>>) {
+                            branch_inputs[START_NODE] = &input;
+                        }
+                        
+                        SharedValue& out = node_outputs[node_name];
+                        out = SharedValue::Make<O>(branch->Select(branch_inputs));
+                        last_output = out.template Get<O>();
+                        last_node = node_name;
+                        continue;
                     }
+                    
+                    // Other "BranchNode" runnables take a copy of every output
+                    std::map<std::string, std::any> branch_input;
+                    for (const auto& [nkey, noutput] : node_outputs) {
+                        branch_input[nkey] = *noutput.template Get<O>();
+                    }
+                    
+                    // Also include START node input if it's a map
+                    if constexpr (std::is_same_v<I, std::map<std::string, std::any>>) {
+                        branch_input[START_NODE] = input;
+                    }
+                    
+                    owned_input = std::move(branch_input);
+                    node_input = &owned_input;
                 }
-                
-                // Also include START node input if it's a map
-                if constexpr (std::is_same_v<I, std::map<std::string, std::any>>) {
-                    branch_input[START_NODE] = input;
-                }
-                
-                node_input = branch_input;
-            } else {
+            }
+            
+            if (!node_input) {
                 // Standard input handling for regular nodes
-                std::vector<O> predecessor_outputs;
+                std::vector<const O*> predecessor_outputs;
                 std::vector<std::string> predecessors = GetPredecessors(node_name);
                 
                 if (predecessors.empty()) {
                     // Node has no predecessors, use graph input
-                    predecessor_outputs.push_back(input);
+                    predecessor_outputs.push_back(&input);
                 } else {
                     for (const auto& pred : predecessors) {
                         if (pred == START_NODE) {
-                            predecessor_outputs.push_back(input);
-                        } else if (node_outputs.count(pred)) {
-                            predecessor_outputs.push_back(node_outputs[pred]);
+                            predecessor_outputs.push_back(&input);
+                        } else {
+                            auto it = node_outputs.find(pred);
+                            if (it != node_outputs.end()) {
+                                predecessor_outputs.push_back(it->second.template Get<O>());
+                            }
                         }
                     }
                 }
                 
-                // Merge inputs from multiple predecessors
-                node_input = MergePredecessorOutputs(predecessor_outputs);
+                if (predecessor_outputs.size() == 1) {
+                    node_input = predecessor_outputs[0];
+                } else {
+                    // Merge inputs from multiple predecessors
+                    std::vector<O> values;
+                    values.reserve(predecessor_outputs.size());
+                    for (const O* out : predecessor_outputs) {
+                        values.push_back(*out);
+                    }
+                    owned_input = MergePredecessorOutputs(values);
+                    node_input = &owned_input;
+                }
             }
             
             // Execute the node's runnable
             if (runnable) {
-                node_outputs[node_name] = runnable->Invoke(ctx, node_input, opts);
-                last_output = node_outputs[node_name];
+                SharedValue& out = node_outputs[node_name];
+                out = SharedValue::Make<O>(runnable->Invoke(ctx, *node_input, opts));
+                last_output = out.template Get<O>();
+                last_node = node_name;
             }
         }
         
-        return last_output;
+        if (!last_output) {
+            return input;
+        }
+        // The final output is moved out when nothing else shares it
+        SharedValue result = std::move(node_outputs[last_node]);
+        node_outputs.clear();
+        return std::move(result).template Consume<O>();
     }
     
     std::shared_ptr<StreamReader<O>> Stream(
@@ -732,6 +805,37 @@ public:
     }
     
 private:
+    // BuildExecutionPlan collects nodes and edges into the dense plan
+    std::shared_ptr<const ExecutionPlan> BuildExecutionPlan() const {
+        std::vector<ExecutionPlan::NodeSpec> specs;
+        specs.reserve(nodes_.size());
+        for (const auto& pair : nodes_) {
+            ExecutionPlan::NodeSpec spec;
+            spec.name = pair.first;
+            spec.node = pair.second;
+            // Every ComposableRunnable supports all four methods
+            if (pair.second && pair.second->runnable) {
+                spec.caps.has_invoke = true;
+                spec.caps.has_stream = true;
+                spec.caps.has_collect = true;
+                spec.caps.has_transform = true;
+            }
+            specs.push_back(std::move(spec));
+        }
+        std::vector<PlanEdge> edges;
+        for (const auto& pair : adjacency_list_) {
+            for (const auto& edge : pair.second) {
+                PlanEdge e;
+                e.from = edge.from;
+                e.to = edge.to;
+                e.is_control_edge = edge.is_control_edge;
+                e.is_data_edge = edge.is_data_edge;
+                edges.push_back(std::move(e));
+            }
+        }
+        return ExecutionPlan::Build(specs, edges, START_NODE, END_NODE);
+    }
+    
     std::vector<std::string> GetPredecessors(const std::string& node_name) const {
         std::vector<std::string> preds;
         for (const auto& pair : adjacency_list_) {
@@ -832,6 +936,7 @@ private:
     bool is_compiled_;
     bool has_error_;
     GraphCompileOptions compile_options_;
+    std::shared_ptr<const ExecutionPlan> plan_;
     
     // ✅ Type validation support - Aligns with eino/compose/graph.go:60-63
     GraphValidator validator_;
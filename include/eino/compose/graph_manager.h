@@ -20,8 +20,11 @@
 // Aligns with: eino/compose/graph_manager.go
 // Contains: channel, channelManager, taskManager implementations
 
+#include "eino/compose/graph_plan.h"
+#include <atomic>
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <functional>
@@ -68,6 +71,10 @@ public:
     // Set merge configuration
     virtual void SetMergeConfig(const std::map<std::string, std::string>& config) = 0;
     
+    // Reset returns the channel to its freshly built state for reuse by the
+    // next run, keeping its dependency layout
+    virtual void Reset() = 0;
+    
     // ⭐ Serialization support for checkpoint
     virtual nlohmann::json ToJSON() const = 0;
     static std::shared_ptr<Channel> FromJSON(const nlohmann::json& j);
@@ -97,6 +104,7 @@ public:
     void ConvertValues(std::function<void(std::map<std::string, std::shared_ptr<void>>&)> fn) override;
     void Load(std::shared_ptr<Channel> other) override;
     void SetMergeConfig(const std::map<std::string, std::string>& config) override;
+    void Reset() override;
     
     // ⭐ Serialization
     nlohmann::json ToJSON() const override;
@@ -127,6 +135,7 @@ public:
     void ConvertValues(std::function<void(std::map<std::string, std::shared_ptr<void>>&)> fn) override;
     void Load(std::shared_ptr<Channel> other) override;
     void SetMergeConfig(const std::map<std::string, std::string>& config) override;
+    void Reset() override;
     
     // ⭐ Serialization
     nlohmann::json ToJSON() const override;
@@ -142,6 +151,8 @@ private:
 // Aligns with: eino/compose/graph_manager.go:115-230
 // =============================================================================
 
+// Only channels reported to since the last GetFromReadyChannels (the dirty
+// set) are examined, so a superstep costs O(touched channels), not O(graph)
 class ChannelManager {
 public:
     ChannelManager(bool is_stream,
@@ -150,6 +161,12 @@ public:
                   const std::map<std::string, std::vector<std::string>>& data_predecessors,
                   const std::map<std::string, std::vector<std::string>>& control_predecessors);
     
+    // Plan-backed manager: channels[id] is the channel of plan node id (null
+    // for nodes without a channel, e.g. START)
+    ChannelManager(bool is_stream,
+                  std::shared_ptr<const ExecutionPlan> plan,
+                  const std::vector<std::shared_ptr<Channel>>& channels);
+    
     // Load channels from checkpoint
     void LoadChannels(const std::map<std::string, std::shared_ptr<Channel>>& channels);
     
@@ -173,6 +190,11 @@ public:
     // Get successors for a node
     // Aligns with: accessing successors map in graph_run.go
     std::vector<std::string> GetSuccessors(const std::string& node_name) const {
+        if (plan_) {
+            int id = plan_->Id(node_name);
+            return id == ExecutionPlan::kNoNode ? std::vector<std::string>()
+                                                : plan_->Names(plan_->Successors(id));
+        }
         auto it = successors_.find(node_name);
         if (it != successors_.end()) {
             return it->second;
@@ -183,12 +205,32 @@ public:
     // Get all channels (for checkpoint)
     std::map<std::string, std::shared_ptr<Channel>> GetChannels() const { return channels_; }
     
+    // Number of channels waiting to be examined by GetFromReadyChannels
+    size_t DirtyCount() const { return dirty_.size(); }
+    
+    // Reset resets every channel in place and clears the dirty set. Returns
+    // false, touching nothing, if a channel is still referenced elsewhere
+    // (e.g. by a checkpoint taken on interrupt)
+    bool Reset();
+    
 private:
+    // Slot returns the dense index of a channel, throwing if it doesn't exist
+    int Slot(const std::string& name) const;
+    void MarkDirty(int slot);
+    
     bool is_stream_;
+    std::shared_ptr<const ExecutionPlan> plan_;
     std::map<std::string, std::shared_ptr<Channel>> channels_;
     std::map<std::string, std::vector<std::string>> successors_;
     std::map<std::string, std::vector<std::string>> data_predecessors_;
     std::map<std::string, std::vector<std::string>> control_predecessors_;
+    
+    // Dense channel slots (plan ids when plan-backed) and the dirty set
+    std::vector<std::string> slot_names_;
+    std::vector<Channel*> slot_channels_;
+    std::unordered_map<std::string, int> slot_ids_;
+    std::vector<int> dirty_;
+    std::vector<char> is_dirty_;
 };
 
 // =============================================================================
@@ -208,21 +250,51 @@ public:
     std::vector<std::shared_ptr<Task>> Wait();
     std::vector<std::shared_ptr<Task>> WaitAll();
     
+    // Wait for completions, reporting cancellation and the tasks it cut off
+    // Aligns with: eino/compose/graph_manager.go:345 (wait)
+    void Wait(std::vector<std::shared_ptr<Task>>& completed,
+              bool& was_cancelled,
+              std::vector<std::shared_ptr<Task>>& cancelled_tasks);
+    
+    // Wait for every running task (or cancellation)
+    void WaitAll(std::vector<std::shared_ptr<Task>>& completed,
+                 std::vector<std::shared_ptr<Task>>& cancelled_tasks);
+    
     // Cancel all running tasks
     void Cancel();
     
-    // Get pending count
+    // Speculate starts a task asynchronously ahead of the branch decision
+    // that would schedule it; it completes like a submitted task unless
+    // cancelled. Returns false if the manager was cancelled
+    bool Speculate(const std::shared_ptr<Task>& task);
+    
+    // Cancel discards one speculative task: its result is dropped whether it
+    // is still running or already queued, and waits no longer count it.
+    // Returns false if the task was already delivered by Wait
+    bool Cancel(const std::shared_ptr<Task>& task);
+    
+    // Get pending count (discarded speculative tasks excluded)
     size_t GetPendingCount() const;
     
     // Check if all completed
     bool AllCompleted() const;
     
+    // Reset prepares the manager for another run; returns false if tasks
+    // are still in flight
+    bool Reset();
+    
 private:
     void Execute(std::shared_ptr<Task> task);
     std::shared_ptr<Task> WaitOne();
+    void TakeDoneLocked(std::vector<std::shared_ptr<Task>>& out);
+    void TakeRunningLocked(std::vector<std::shared_ptr<Task>>& out);
+    uint32_t LiveRunning() const { return num_running_.load() - num_discarded_.load(); }
     
     bool need_all_;
     std::atomic<uint32_t> num_running_{0};
+    // Discarded speculative tasks still running; Wait ignores them, WaitAll
+    // and the destructor drain them
+    std::atomic<uint32_t> num_discarded_{0};
     std::mutex mutex_;
     std::condition_variable cv_;
     std::queue<std::shared_ptr<Task>> done_queue_;
@@ -230,6 +302,40 @@ private:
     bool cancelled_ = false;
 };
 
+// =============================================================================
+// Pooled Run State
+// =============================================================================
+
+// TaskArena recycles Task objects across runs. Acquire hands tasks out in
+// order, so every task of a run is distinct; Reset rewinds the cursor and
+// clears the tasks (tasks still referenced elsewhere are replaced)
+class TaskArena {
+public:
+    std::shared_ptr<Task> Acquire();
+    void Reset();
+    
+    // Number of tasks owned by the arena
+    size_t Capacity() const { return tasks_.size(); }
+    
+private:
+    std::vector<std::shared_ptr<Task>> tasks_;
+    size_t next_ = 0;
+};
+
+// RunState is everything one GraphRunner::Run needs besides the compiled
+// plan. Runners keep released states in an internal::ObjectPool, so a
+// steady stream of runs (including concurrent ones) reuses channels, the
+// task manager and tasks instead of rebuilding them
+struct RunState {
+    std::shared_ptr<ChannelManager> channels;
+    std::shared_ptr<TaskManager> tasks;
+    TaskArena arena;
+    
+    // Reset prepares the state for the next run; returns false if it can't
+    // be reused (a failed run left tasks in flight)
+    bool Reset();
+};
+
 // =============================================================================
 // Factory Functions
 // =============================================================================
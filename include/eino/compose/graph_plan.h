@@ -0,0 +1,159 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_COMPOSE_GRAPH_PLAN_H_
+#define EINO_CPP_COMPOSE_GRAPH_PLAN_H_
+
+// ExecutionPlan: the immutable, integer-indexed form of a compiled graph
+//
+// Graph::Compile() assigns every node a dense id, lays successors and
+// predecessors out as CSR arrays and precomputes each node's execution
+// method, so the runner never resolves names or re-derives methods per
+// superstep. START and END get ids too; END has a channel like any node.
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace eino {
+namespace compose {
+
+struct GraphNode;
+
+// NodeCapabilities records which execution methods a node's runnable supports
+struct NodeCapabilities {
+    bool has_invoke = false;
+    bool has_stream = false;
+    bool has_collect = false;
+    bool has_transform = false;
+};
+
+// SelectExecutionMethod is the runner's decision matrix: given the input
+// kind, the node's capabilities and whether downstream wants a stream, pick
+// "Invoke", "Stream", "Collect" or "Transform"
+// Aligns with: eino/compose/graph_run.go:124-125 (runWrapper selection)
+const char* SelectExecutionMethod(bool input_is_stream,
+                                  const NodeCapabilities& caps,
+                                  bool downstream_expects_stream);
+
+// PlanEdge is one graph edge in name form, as collected by Compile()
+struct PlanEdge {
+    std::string from;
+    std::string to;
+    bool is_control_edge = true;
+    bool is_data_edge = true;
+};
+
+class ExecutionPlan {
+public:
+    static constexpr int kNoNode = -1;
+
+    // NodeSpec describes a user node (START/END are added by Build)
+    struct NodeSpec {
+        std::string name;
+        std::shared_ptr<GraphNode> node;
+        NodeCapabilities caps;
+    };
+
+    // IdRange is a view over one CSR row
+    struct IdRange {
+        const int* first = nullptr;
+        const int* last = nullptr;
+
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+    // Build compiles nodes and edges into a plan
+    // Throws std::invalid_argument if an edge references an unknown node
+    static std::shared_ptr<const ExecutionPlan> Build(
+        const std::vector<NodeSpec>& nodes,
+        const std::vector<PlanEdge>& edges,
+        const std::string& start_name = "__START__",
+        const std::string& end_name = "__END__");
+
+    // NodeCount includes START and END
+    size_t NodeCount() const { return names_.size(); }
+    int StartId() const { return start_id_; }
+    int EndId() const { return end_id_; }
+
+    // Id returns the dense id of name, or kNoNode
+    int Id(const std::string& name) const {
+        auto it = ids_.find(name);
+        return it == ids_.end() ? kNoNode : it->second;
+    }
+
+    const std::string& Name(int id) const { return names_[id]; }
+
+    // Node returns the GraphNode for id (null for START/END)
+    const std::shared_ptr<GraphNode>& Node(int id) const { return nodes_[id]; }
+
+    const NodeCapabilities& Capabilities(int id) const { return caps_[id]; }
+
+    // Successors lists every edge target of id in insertion order
+    IdRange Successors(int id) const { return Row(succ_offsets_, succ_, id); }
+
+    // DataSuccessors lists only data-edge targets of id
+    IdRange DataSuccessors(int id) const { return Row(data_succ_offsets_, data_succ_, id); }
+
+    IdRange DataPredecessors(int id) const { return Row(data_pred_offsets_, data_pred_, id); }
+    IdRange ControlPredecessors(int id) const { return Row(ctrl_pred_offsets_, ctrl_pred_, id); }
+
+    // ExecutionMethod returns the precomputed method for a value or stream input
+    const std::string& ExecutionMethod(int id, bool input_is_stream) const {
+        return input_is_stream ? stream_methods_[id] : value_methods_[id];
+    }
+
+    // DownstreamExpectsStream reports whether a data successor prefers stream input
+    bool DownstreamExpectsStream(int id) const { return downstream_stream_[id] != 0; }
+
+    // Names resolves a CSR row to node names
+    std::vector<std::string> Names(IdRange ids) const;
+
+private:
+    ExecutionPlan() = default;
+
+    static IdRange Row(const std::vector<int>& offsets, const std::vector<int>& values, int id) {
+        IdRange r;
+        r.first = values.data() + offsets[id];
+        r.last = values.data() + offsets[id + 1];
+        return r;
+    }
+
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, int> ids_;
+    std::vector<std::shared_ptr<GraphNode>> nodes_;
+    std::vector<NodeCapabilities> caps_;
+    int start_id_ = kNoNode;
+    int end_id_ = kNoNode;
+
+    std::vector<int> succ_offsets_, succ_;
+    std::vector<int> data_succ_offsets_, data_succ_;
+    std::vector<int> data_pred_offsets_, data_pred_;
+    std::vector<int> ctrl_pred_offsets_, ctrl_pred_;
+
+    std::vector<std::string> value_methods_;
+    std::vector<std::string> stream_methods_;
+    std::vector<char> downstream_stream_;
+};
+
+} // namespace compose
+} // namespace eino
+
+#endif // EINO_CPP_COMPOSE_GRAPH_PLAN_H_
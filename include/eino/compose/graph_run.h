@@ -20,6 +20,9 @@
 // Aligns with: eino/compose/graph_run.go
 // Contains: runner struct and execution logic
 
+#include "eino/internal/object_pool.h"
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <map>
 #include <vector>
@@ -43,6 +46,10 @@ class ChannelManager;
 class TaskManager;
 class CheckPointStore;
 class CheckPointer;
+class ExecutionPlan;
+class GraphBranch;
+class TaskArena;
+struct RunState;
 struct Option;
 struct CheckPoint;
 template<typename I, typename O> class Graph;
@@ -86,8 +93,42 @@ struct Task {
     // Determined by smart method selection logic
     std::string execution_method;  // "Invoke", "Stream", "Collect", "Transform"
     
+    // Dense node id in the graph's ExecutionPlan (-1 if unknown)
+    int node_id = -1;
+    
+    // Submit timestamp (metrics::NowNs), used for queue-time metrics
+    uint64_t submit_ns = 0;
+    
+    // Execution time, recorded when metrics are enabled
+    uint64_t run_ns = 0;
+    
+    // Started ahead of a branch decision (TaskManager::Speculate); a
+    // discarded task's completion is dropped instead of delivered
+    bool speculative = false;
+    bool discarded = false;
+    
     Task() = default;
     explicit Task(const std::string& key) : node_key(key) {}
+    
+    // Reset clears the task for reuse by TaskArena, keeping buffer capacity
+    void Reset() {
+        node_key.clear();
+        input.reset();
+        output.reset();
+        error.reset();
+        context.reset();
+        options.clear();
+        status = TaskStatus::Pending;
+        skip_pre_handler = false;
+        execution_order = -1;
+        graph_node.reset();
+        execution_method.clear();
+        node_id = -1;
+        submit_ns = 0;
+        run_ns = 0;
+        speculative = false;
+        discarded = false;
+    }
 };
 
 // =============================================================================
@@ -106,6 +147,8 @@ struct FanInMergeConfig;
 struct GraphRunOptions {
     int max_run_steps = 100;
     GraphRunType run_type = GraphRunType::DAG;
+    // DAG only: dispatch a node as soon as its inputs are ready instead of
+    // waiting for the whole superstep, so latency tracks the critical path
     bool eager_execution = true;
     long timeout_ms = 0;
     
@@ -270,7 +313,7 @@ public:
         std::shared_ptr<Graph<I, O>> graph,
         const GraphRunOptions& opts = GraphRunOptions());
     
-    ~GraphRunner() = default;
+    ~GraphRunner();
     
     // Main execution method
     // Aligns with: eino/compose/graph_run.go:93-103 (run method)
@@ -290,12 +333,21 @@ public:
         return graph_;
     }
     
-    // Get step count
+    // Get step count of the most recent run
     int GetStepCount() const {
-        return step_count_;
+        return step_count_.load(std::memory_order_relaxed);
+    }
+    
+    // Number of run states built so far; stays flat once the pool covers the
+    // peak number of concurrent runs
+    size_t GetRunStateCount() const {
+        return run_states_[0]->CreatedCount() + run_states_[1]->CreatedCount();
     }
     
 private:
+    // Build a fresh run state (channels + task manager) for the pool
+    std::unique_ptr<RunState> NewRunState(bool is_stream);
+    
     // Initialize channel manager
     // Aligns with: eino/compose/graph_run.go:777
     std::shared_ptr<ChannelManager> InitChannelManager(bool is_stream);
@@ -313,42 +365,33 @@ private:
         const std::vector<std::shared_ptr<Task>>& completed_tasks,
         bool is_stream,
         std::shared_ptr<ChannelManager> cm,
-        const std::map<std::string, std::vector<std::any>>& opt_map);
+        const std::map<std::string, std::vector<std::any>>& opt_map,
+        TaskArena* arena = nullptr,
+        TaskManager* tm = nullptr);
     
     // Create tasks from node map
     // Aligns with: eino/compose/graph_run.go:682-700
     std::vector<std::shared_ptr<Task>> CreateTasks(
         std::shared_ptr<Context> ctx,
-        const std::map<std::string, std::shared_ptr<void>>& node_map);
-    
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    // ⭐ Smart Method Selection Helpers
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    
-    // Node capabilities structure
-    struct NodeCapabilities {
-        bool has_invoke = false;
-        bool has_stream = false;
-        bool has_collect = false;
-        bool has_transform = false;
-    };
+        const std::map<std::string, std::shared_ptr<void>>& node_map,
+        TaskArena* arena = nullptr);
     
-    // Determine execution method based on input type, node capabilities, and downstream
-    // Aligns with: eino/compose/graph_run.go:124-125 (runWrapper selection logic)
-    std::string DetermineExecutionMethod(
+    // Build a queued task for plan node node_id, taken from arena if given
+    std::shared_ptr<Task> NewTask(
+        std::shared_ptr<Context> ctx,
+        int node_id,
         std::shared_ptr<void> input,
-        std::shared_ptr<GraphNode> graph_node,
-        const std::string& node_name);
+        TaskArena* arena = nullptr);
+    
+    // Look up the precomputed execution method for the input kind
+    // Aligns with: eino/compose/graph_run.go:124-125 (runWrapper selection logic)
+    const std::string& DetermineExecutionMethod(
+        int node_id,
+        const std::shared_ptr<void>& input);
     
     // Check if input is a StreamReader
     bool IsStreamInput(std::shared_ptr<void> input);
     
-    // Detect node capabilities (which methods it supports)
-    NodeCapabilities DetectNodeCapabilities(std::shared_ptr<GraphNode> graph_node);
-    
-    // Check if downstream nodes expect stream input
-    bool CheckDownstreamExpectsStream(const std::string& node_name);
-    
     // Resolve completed tasks and update channels
     // Aligns with: eino/compose/graph_run.go:702-764
     void ResolveCompletedTasks(
@@ -357,7 +400,17 @@ private:
         bool is_stream,
         std::shared_ptr<ChannelManager> cm,
         std::map<std::string, std::map<std::string, std::shared_ptr<void>>>& values,
-        std::map<std::string, std::vector<std::string>>& controls);
+        std::map<std::string, std::vector<std::string>>& controls,
+        TaskArena* arena = nullptr,
+        TaskManager* tm = nullptr);
+    
+    // Start the predicted targets of a speculative branch on the source's
+    // output before its condition runs; returns the started tasks
+    std::vector<std::shared_ptr<Task>> SpeculateBranch(
+        const std::shared_ptr<GraphBranch>& branch,
+        const std::shared_ptr<Task>& source,
+        TaskArena* arena,
+        TaskManager* tm);
     
     // Restore from checkpoint
     // Aligns with: eino/compose/graph_run.go:366-399
@@ -419,8 +472,14 @@ private:
     CheckPointInfo GetCheckPointInfo(const std::vector<Option>& options);
     
     std::shared_ptr<Graph<I, O>> graph_;
+    std::shared_ptr<const ExecutionPlan> plan_;
     GraphRunOptions options_;
-    int step_count_ = 0;
+    std::atomic<int> step_count_{0};
+    
+    // Released run states, reset in place and reused by later runs; the
+    // channels are built for one mode, so invoke and stream runs (index
+    // is_stream) keep separate pools
+    std::unique_ptr<internal::ObjectPool<RunState>> run_states_[2];
     
     // Run context initializer for state management
     // Aligns with: eino/compose/graph_run.go:54
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_COMPOSE_SHARED_VALUE_H_
+#define EINO_CPP_COMPOSE_SHARED_VALUE_H_
+
+// Shared node outputs
+//
+// SharedValue is an immutable, refcounted view of one value of any type that
+// any number of consumers read without copying; Graph::Invoke keeps node
+// outputs this way so fan-out to successors, BranchNode conditions included
+// (see BranchInputs in branch_node.h), does not copy them. Type checks
+// compare TypeIds, which are fixed per type at compile/link time, not
+// std::type_info
+//
+// Example:
+//   SharedValue view = SharedValue::Make(BigMap{...});
+//   SharedValue other = view;                         // refcount, no copy
+//   const BigMap* m = view.Get<BigMap>();
+//   BigMap owned = std::move(view).Consume<BigMap>(); // copied: other shares it
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace eino {
+namespace compose {
+
+// TypeId identifies a value type: the address of a per-type tag
+using TypeId = const void*;
+
+namespace detail {
+
+template<typename T>
+struct TypeTag {
+    static const char id;
+};
+
+template<typename T>
+const char TypeTag<T>::id = 0;
+
+} // namespace detail
+
+// TypeIdOf returns the TypeId of T (cv-ref qualifiers ignored)
+template<typename T>
+constexpr TypeId TypeIdOf() {
+    return &detail::TypeTag<typename std::decay<T>::type>::id;
+}
+
+// SharedValue is an immutable, shared view of a value; copying it only
+// bumps a refcount
+class SharedValue {
+public:
+    SharedValue() = default;
+
+    template<typename T>
+    static SharedValue Make(T&& value) {
+        using V = typename std::decay<T>::type;
+        return Adopt(std::make_shared<V>(std::forward<T>(value)));
+    }
+
+    // Adopt wraps an existing shared object; it must not be mutated after.
+    // A const object is never moved from, Consume copies it
+    template<typename T>
+    static SharedValue Adopt(std::shared_ptr<T> value) {
+        SharedValue view;
+        view.type_ = TypeIdOf<T>();
+        view.movable_ = !std::is_const<T>::value;
+        view.ptr_ = std::move(value);
+        return view;
+    }
+
+    bool empty() const { return !ptr_; }
+    TypeId type() const { return type_; }
+    long use_count() const { return ptr_.use_count(); }
+
+    template<typename T>
+    bool Is() const { return ptr_ && type_ == TypeIdOf<T>(); }
+
+    // Get returns the value, or null if empty or of another type
+    template<typename T>
+    const T* Get() const {
+        return Is<T>() ? static_cast<const T*>(ptr_.get()) : nullptr;
+    }
+
+    // Consume moves the value out when this is the last view of a non-const
+    // object, else copies. Throws std::runtime_error on type mismatch
+    template<typename T>
+    T Consume() && {
+        if (!Is<T>()) {
+            throw std::runtime_error("SharedValue: type mismatch");
+        }
+        const T* value = static_cast<const T*>(ptr_.get());
+        if (movable_ && ptr_.use_count() == 1) {
+            // Make and Adopt of a non-const T created the object non-const
+            T out(std::move(*const_cast<T*>(value)));
+            ptr_.reset();
+            return out;
+        }
+        T out(*value);
+        ptr_.reset();
+        return out;
+    }
+
+private:
+    TypeId type_ = nullptr;
+    bool movable_ = false;
+    std::shared_ptr<const void> ptr_;
+};
+
+} // namespace compose
+} // namespace eino
+
+#endif // EINO_CPP_COMPOSE_SHARED_VALUE_H_
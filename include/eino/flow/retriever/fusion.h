@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_FLOW_RETRIEVER_FUSION_H_
+#define EINO_CPP_FLOW_RETRIEVER_FUSION_H_
+
+#include "../../schema/types.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace eino {
+namespace flow {
+namespace retriever {
+
+// FusionMode selects how ranked result lists are combined
+enum class FusionMode {
+    kRRF,              // Weighted Reciprocal Rank Fusion: sum(w / (rrf_k + rank))
+    kScoreNormalized,  // Per-list min-max normalized scores, weighted and summed
+    kDedup,            // Keep first occurrence of each id, in list order
+};
+
+// FusionOptions configures FuseDocuments
+struct FusionOptions {
+    FusionMode mode;
+
+    // RRF constant; 60 matches the original RRF paper
+    double rrf_k = 60.0;
+
+    // Per-list weights, aligned with the input lists; missing entries are 1.0
+    std::vector<double> weights;
+
+    // Maximum number of fused documents to return; 0 means unlimited
+    // When set, only a bounded top-k heap is maintained
+    int max_results = 0;
+
+    explicit FusionOptions(FusionMode m = FusionMode::kRRF) : mode(m) {}
+};
+
+// FusedLocation addresses a document in the input lists as (list, rank)
+using FusedLocation = std::pair<uint32_t, uint32_t>;
+
+// FuseOrder computes the fused ranking without touching the documents
+// Documents are deduplicated by id through a hash table over interned ids
+// and scored into dense per-document arrays; ties keep first-seen order
+std::vector<FusedLocation> FuseOrder(
+    const std::vector<const std::vector<schema::Document>*>& lists,
+    const FusionOptions& options);
+
+std::vector<FusedLocation> FuseOrder(
+    const std::vector<std::vector<schema::Document>>& lists,
+    const FusionOptions& options);
+
+// FuseDocuments fuses ranked lists, moving the selected documents out of lists
+std::vector<schema::Document> FuseDocuments(
+    std::vector<std::vector<schema::Document>>&& lists,
+    const FusionOptions& options);
+
+// FuseDocuments fuses ranked lists, copying only the selected documents
+std::vector<schema::Document> FuseDocuments(
+    const std::vector<std::vector<schema::Document>>& lists,
+    const FusionOptions& options);
+
+} // namespace retriever
+} // namespace flow
+} // namespace eino
+
+#endif // EINO_CPP_FLOW_RETRIEVER_FUSION_H_
@@ -21,6 +21,7 @@
 #include "../../components/model.h"
 #include "../../components/prompt.h"
 #include "../../schema/types.h"
+#include "fusion.h"
 #include <functional>
 #include <memory>
 #include <vector>
@@ -73,6 +74,10 @@ public:
         
         // Fusion function for combining results (deduplication by default)
         FusionFunc fusion_func;
+        
+        // Options for the built-in fusion (ignored when fusion_func is set)
+        // Defaults to deduplication; weights align with the generated queries
+        FusionOptions fusion_options = FusionOptions(FusionMode::kDedup);
     };
     
     // Constructor
@@ -143,12 +148,18 @@ public:
     void SetMaxQueriesNum(int max_num) {
         max_queries_num_ = max_num;
     }
+    
+    // Set the built-in fusion options
+    void SetFusionOptions(const FusionOptions& options) {
+        fusion_options_ = options;
+    }
 
 private:
     std::shared_ptr<components::Retriever> retriever_;
     QueryRewriter rewrite_handler_;
-    int max_queries_num_;
+    int max_queries_num_ = 5;
     FusionFunc fusion_func_;
+    FusionOptions fusion_options_ = FusionOptions(FusionMode::kDedup);
     
     // Default fusion function (deduplication)
     static std::vector<schema::Document> DefaultFusion(
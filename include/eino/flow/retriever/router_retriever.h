@@ -19,6 +19,7 @@
 
 #include "../../components/retriever.h"
 #include "../../schema/types.h"
+#include "fusion.h"
 #include <functional>
 #include <map>
 #include <memory>
@@ -55,6 +56,13 @@ public:
         // Fusion function for combining results
         // If not provided, Reciprocal Rank Fusion (RRF) is used
         FusionFunc fusion_func;
+        
+        // Options for the built-in fusion (ignored when fusion_func is set)
+        // Defaults to RRF; use kScoreNormalized to fuse on retriever scores
+        FusionOptions fusion_options;
+        
+        // Per-retriever weights for weighted fusion (missing names weigh 1.0)
+        std::map<std::string, double> retriever_weights;
     };
     
     // Constructor
@@ -126,11 +134,23 @@ public:
     void SetRouter(Router router) {
         router_ = router;
     }
+    
+    // Set the built-in fusion options
+    void SetFusionOptions(const FusionOptions& options) {
+        fusion_options_ = options;
+    }
+    
+    // Set the weight of a retriever for weighted fusion
+    void SetRetrieverWeight(const std::string& name, double weight) {
+        retriever_weights_[name] = weight;
+    }
 
 private:
     std::map<std::string, std::shared_ptr<components::Retriever>> retrievers_;
     Router router_;
     FusionFunc fusion_func_;
+    FusionOptions fusion_options_;
+    std::map<std::string, double> retriever_weights_;
     
     // Default fusion function using Reciprocal Rank Fusion (RRF)
     static std::vector<schema::Document> DefaultRRFFusion(
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_INTERNAL_METRICS_H_
+#define EINO_CPP_INTERNAL_METRICS_H_
+
+// Low-overhead runtime metrics: counters and log-linear (HDR-style)
+// latency histograms
+//
+// Every thread writes into its own shard with relaxed single-writer stores,
+// so recording never takes a lock or a contended cache line. Snapshots sum
+// all live shards plus the totals of exited threads. Handles are resolved
+// once (registration takes a mutex) and are cheap to copy. There is no
+// central list: each subsystem registers what it records from its own
+// source file, as in the example
+//
+// Example:
+//   static const auto hist = metrics::Registry::Global().GetHistogram(
+//       "eino_my_step_ns", "Time spent in my step");
+//   {
+//       metrics::ScopedTimer timer(hist);
+//       DoStep();
+//   }
+//   std::string text = metrics::Registry::Global().Snapshot().ToPrometheus();
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace eino {
+namespace internal {
+namespace metrics {
+
+// Capacity of the registry; slot 0 of each kind absorbs registrations past
+// the limit and is never exported
+constexpr uint32_t kMaxCounters = 512;
+constexpr uint32_t kMaxHistograms = 1024;
+
+// Buckets: values below 2^kSubBucketBits are exact, above that every power
+// of two is split into 2^kSubBucketBits linear sub-buckets (<= 12.5% error)
+constexpr int kSubBucketBits = 3;
+constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;
+constexpr uint32_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+// BucketIndex maps a value to its histogram bucket
+inline uint32_t BucketIndex(uint64_t v) {
+    if (v < kSubBuckets) {
+        return static_cast<uint32_t>(v);
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    int e = 63 - __builtin_clzll(v);
+#else
+    int e = 0;
+    for (uint64_t t = v; t > 1; t >>= 1) {
+        ++e;
+    }
+#endif
+    int shift = e - kSubBucketBits;
+    return static_cast<uint32_t>((e - kSubBucketBits + 1) * kSubBuckets +
+                                 ((v >> shift) & (kSubBuckets - 1)));
+}
+
+// BucketLowerBound returns the smallest value mapped to bucket
+inline uint64_t BucketLowerBound(uint32_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    uint32_t e = bucket / kSubBuckets + kSubBucketBits - 1;
+    uint64_t m = bucket % kSubBuckets;
+    return (kSubBuckets + m) << (e - kSubBucketBits);
+}
+
+// BucketUpperBound returns the largest value mapped to bucket
+inline uint64_t BucketUpperBound(uint32_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    uint32_t e = bucket / kSubBuckets + kSubBucketBits - 1;
+    return BucketLowerBound(bucket) + ((uint64_t(1) << (e - kSubBucketBits)) - 1);
+}
+
+// Prometheus buckets end at 2^k - 1 for k < kExportedBuckets; each is also
+// the end of a bucket above, so the export loses no counts
+constexpr int kExportedBuckets = 64;
+
+inline uint64_t ExportedBucketBound(int k) {
+    return (uint64_t(1) << k) - 1;
+}
+
+// HistogramCells is one thread's data for one histogram
+struct HistogramCells {
+    std::atomic<uint64_t> buckets[kNumBuckets];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+
+    HistogramCells();
+};
+
+// ThreadShard holds one thread's counters and histogram cells
+struct ThreadShard {
+    std::atomic<uint64_t> counters[kMaxCounters];
+    std::atomic<HistogramCells*> histograms[kMaxHistograms];
+
+    ThreadShard();
+    ~ThreadShard();
+
+    // Cells returns the cells of histogram id, allocating them on first use
+    HistogramCells* Cells(uint32_t id) {
+        HistogramCells* cells = histograms[id].load(std::memory_order_acquire);
+        return cells ? cells : AllocateCells(id);
+    }
+
+private:
+    HistogramCells* AllocateCells(uint32_t id);
+};
+
+// LocalShardSlot caches the calling thread's shard; constant-initialized so
+// the hot path is a plain TLS load
+inline ThreadShard*& LocalShardSlot() {
+    static thread_local ThreadShard* shard = nullptr;
+    return shard;
+}
+
+// LocalShardSlow registers a shard for the calling thread
+ThreadShard* LocalShardSlow();
+
+// LocalShard returns the calling thread's shard, registering it on first use
+inline ThreadShard* LocalShard() {
+    ThreadShard* shard = LocalShardSlot();
+    return shard ? shard : LocalShardSlow();
+}
+
+// Single-writer increment: only the owning thread writes its shard
+inline void Bump(std::atomic<uint64_t>& cell, uint64_t n) {
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Enabled reports whether recording is on (default on); disabling turns
+// every Record/Inc into a single relaxed load
+inline std::atomic<bool>& EnabledFlag() {
+    static std::atomic<bool> enabled{true};
+    return enabled;
+}
+
+inline bool Enabled() {
+    return EnabledFlag().load(std::memory_order_relaxed);
+}
+
+inline void SetEnabled(bool enabled) {
+    EnabledFlag().store(enabled, std::memory_order_relaxed);
+}
+
+// Counter is a handle to a monotonically increasing counter
+class Counter {
+public:
+    Counter() = default;
+    explicit Counter(uint32_t id) : id_(id) {}
+
+    void Inc(uint64_t n = 1) const {
+        if (!Enabled()) {
+            return;
+        }
+        Bump(LocalShard()->counters[id_], n);
+    }
+
+    uint32_t id() const { return id_; }
+
+private:
+    uint32_t id_ = 0;
+};
+
+// Histogram is a handle to a latency/size histogram
+class Histogram {
+public:
+    Histogram() = default;
+    explicit Histogram(uint32_t id) : id_(id) {}
+
+    void Record(uint64_t value) const {
+        if (!Enabled()) {
+            return;
+        }
+        HistogramCells* cells = LocalShard()->Cells(id_);
+        Bump(cells->buckets[BucketIndex(value)], 1);
+        Bump(cells->count, 1);
+        Bump(cells->sum, value);
+        if (value > cells->max.load(std::memory_order_relaxed)) {
+            cells->max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t id() const { return id_; }
+
+private:
+    uint32_t id_ = 0;
+};
+
+// NowNs returns a monotonic timestamp in nanoseconds
+inline uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ScopedTimer records the lifetime of the scope into a histogram
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram histogram)
+        : histogram_(histogram), start_(Enabled() ? NowNs() : 0) {}
+
+    ~ScopedTimer() {
+        if (start_ != 0) {
+            histogram_.Record(NowNs() - start_);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram histogram_;
+    uint64_t start_;
+};
+
+using Labels = std::map<std::string, std::string>;
+
+struct CounterSnapshot {
+    std::string name;
+    std::string help;
+    Labels labels;
+    uint64_t value = 0;
+};
+
+struct HistogramSnapshot {
+    std::string name;
+    std::string help;
+    Labels labels;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    // Non-empty buckets as (inclusive upper bound, count), ascending
+    std::vector<std::pair<uint64_t, uint64_t>> buckets;
+
+    // Percentile estimates the p-th percentile (0..100) from the buckets
+    double Percentile(double p) const;
+    double Mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+};
+
+// MetricsSnapshot is a point-in-time copy of every registered metric
+struct MetricsSnapshot {
+    std::vector<CounterSnapshot> counters;
+    std::vector<HistogramSnapshot> histograms;
+
+    // ToPrometheus renders the Prometheus text exposition format; every
+    // histogram has the same kExportedBuckets buckets, empty ones included
+    std::string ToPrometheus() const;
+
+    // ToJSON renders counters and histograms (with p50/p90/p99) as JSON
+    std::string ToJSON() const;
+};
+
+// HistogramFamily is a histogram keyed by the value of one label (e.g. node
+// name); WithLabel resolves through a per-thread cache after the first call
+class HistogramFamily {
+public:
+    HistogramFamily(std::string name, std::string help, std::string label);
+
+    Histogram WithLabel(const std::string& value) const;
+
+private:
+    uint32_t family_id_;
+    std::string name_;
+    std::string help_;
+    std::string label_;
+};
+
+// Registry owns metric registration, shard bookkeeping and snapshots
+class Registry {
+public:
+    static Registry& Global();
+
+    // GetCounter returns the counter for (name, labels), registering it once
+    Counter GetCounter(const std::string& name, const std::string& help,
+                       const Labels& labels = Labels());
+
+    // GetHistogram returns the histogram for (name, labels), registering it once
+    Histogram GetHistogram(const std::string& name, const std::string& help,
+                           const Labels& labels = Labels());
+
+    MetricsSnapshot Snapshot() const;
+
+    // Reset zeroes every value; concurrent records may be partially lost
+    void Reset();
+
+    // AddShard/RetireShard track thread shards; a retired shard is folded
+    // into the exited-thread totals and freed
+    void AddShard(ThreadShard* shard);
+    void RetireShard(ThreadShard* shard);
+
+private:
+    friend class HistogramFamily;
+
+    struct Descriptor {
+        std::string name;
+        std::string help;
+        Labels labels;
+    };
+
+    Registry();
+
+    static std::string Key(const std::string& name, const Labels& labels);
+    uint32_t NextFamilyId();
+
+    mutable std::mutex mutex_;
+    std::map<std::string, uint32_t> counter_ids_;
+    std::map<std::string, uint32_t> histogram_ids_;
+    std::vector<Descriptor> counters_;    // index = id; [0] is overflow
+    std::vector<Descriptor> histograms_;  // index = id; [0] is overflow
+    std::vector<ThreadShard*> shards_;
+    ThreadShard* retired_;  // totals of exited threads
+    uint32_t next_family_id_ = 0;
+};
+
+} // namespace metrics
+} // namespace internal
+} // namespace eino
+
+#endif // EINO_CPP_INTERNAL_METRICS_H_
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_INTERNAL_OBJECT_POOL_H_
+#define EINO_CPP_INTERNAL_OBJECT_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace eino {
+namespace internal {
+
+// ObjectPool keeps expensive-to-build objects for reuse across concurrent
+// callers. Acquire checks out an idle object (or builds one with the
+// factory); the returned Lease hands it back on destruction. Returned
+// objects are passed through the recycler, which resets them in place;
+// objects it rejects, or beyond max_idle, are destroyed
+//
+// Example:
+//   ObjectPool<RunState> pool(
+//       [] { return std::unique_ptr<RunState>(new RunState()); },
+//       [](RunState& s) { return s.Reset(); });
+//   {
+//       auto state = pool.Acquire();
+//       state->Use();
+//   }  // state is reset and back in the pool
+template<typename T>
+class ObjectPool {
+public:
+    using Factory = std::function<std::unique_ptr<T>()>;
+    using Recycler = std::function<bool(T&)>;
+
+    // Lease is a move-only checkout of one pooled object
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease() { Release(); }
+
+        Lease(Lease&& other) noexcept
+            : pool_(other.pool_), object_(std::move(other.object_)) {
+            other.pool_ = nullptr;
+        }
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                Release();
+                pool_ = other.pool_;
+                object_ = std::move(other.object_);
+                other.pool_ = nullptr;
+            }
+            return *this;
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        T* get() const { return object_.get(); }
+        T& operator*() const { return *object_; }
+        T* operator->() const { return object_.get(); }
+        explicit operator bool() const { return static_cast<bool>(object_); }
+
+        // Release returns the object to the pool early
+        void Release() {
+            if (pool_ && object_) {
+                pool_->Return(std::move(object_));
+            }
+            pool_ = nullptr;
+        }
+
+    private:
+        friend class ObjectPool;
+
+        Lease(ObjectPool* pool, std::unique_ptr<T> object)
+            : pool_(pool), object_(std::move(object)) {}
+
+        ObjectPool* pool_ = nullptr;
+        std::unique_ptr<T> object_;
+    };
+
+    ObjectPool(Factory factory, Recycler recycler, size_t max_idle = 16)
+        : factory_(std::move(factory)),
+          recycler_(std::move(recycler)),
+          max_idle_(max_idle) {
+        if (!factory_) {
+            throw std::invalid_argument("ObjectPool: factory is required");
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Acquire checks out an idle object, building a new one if none is idle
+    Lease Acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                std::unique_ptr<T> object = std::move(idle_.back());
+                idle_.pop_back();
+                return Lease(this, std::move(object));
+            }
+        }
+        std::unique_ptr<T> object = factory_();
+        if (!object) {
+            throw std::runtime_error("ObjectPool: factory returned null");
+        }
+        created_.fetch_add(1, std::memory_order_relaxed);
+        return Lease(this, std::move(object));
+    }
+
+    size_t IdleCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return idle_.size();
+    }
+
+    // CreatedCount is the number of objects built by the factory so far
+    size_t CreatedCount() const { return created_.load(std::memory_order_relaxed); }
+
+private:
+    void Return(std::unique_ptr<T> object) {
+        bool reusable = true;
+        if (recycler_) {
+            try {
+                reusable = recycler_(*object);
+            } catch (...) {
+                reusable = false;
+            }
+        }
+        if (!reusable) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() < max_idle_) {
+            idle_.push_back(std::move(object));
+        }
+    }
+
+    Factory factory_;
+    Recycler recycler_;
+    size_t max_idle_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<T>> idle_;
+    std::atomic<size_t> created_{0};
+};
+
+} // namespace internal
+} // namespace eino
+
+#endif // EINO_CPP_INTERNAL_OBJECT_POOL_H_
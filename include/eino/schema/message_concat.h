@@ -104,6 +104,118 @@ inline bool IsBase64AudioPart(const MessageOutputPart& part) {
            part.audio->common.url == nullptr;
 }
 
+// TextRope accumulates string pieces and flattens them on demand. A flush
+// sizes the buffer once for everything pending, so each byte is copied into
+// it once; after Reserve, pieces are appended straight into the buffer
+class TextRope {
+public:
+    void Reserve(size_t bytes) { flat_.reserve(flat_.size() + pending_bytes_ + bytes); }
+    void Append(const std::string& piece);
+    void Append(std::string&& piece);
+
+    size_t size() const { return flat_.size() + pending_bytes_; }
+    bool empty() const { return size() == 0; }
+
+    // Flatten returns the text so far; later appends continue from it
+    const std::string& Flatten();
+
+    // Take returns the text and leaves the rope empty
+    std::string Take();
+
+private:
+    std::string flat_;
+    std::vector<std::string> pending_;
+    size_t pending_bytes_ = 0;
+};
+
+// AssistantPartMerger merges assistant output parts as they arrive:
+// contiguous text parts, and contiguous base64 audio parts, become one part
+class AssistantPartMerger {
+public:
+    void Add(const MessageOutputPart& part);
+
+    bool empty() const { return closed_.empty() && !open_; }
+
+    // Snapshot returns the parts merged so far without consuming them
+    std::vector<MessageOutputPart> Snapshot();
+    std::vector<MessageOutputPart> Finish();
+
+private:
+    enum class RunKind { kText, kAudio };
+
+    // Run is a group of mergeable parts still accepting more
+    struct Run {
+        RunKind kind;
+        MessageOutputPart first;
+        size_t count = 0;
+        TextRope data;
+        std::string mime_type;
+        std::map<std::string, json> extra;
+    };
+
+    MessageOutputPart Materialize(Run& run, bool consume);
+    void Close();
+
+    std::vector<MessageOutputPart> closed_;
+    std::unique_ptr<Run> open_;
+};
+
+// MessageConcatenator concatenates a streamed message one chunk at a time,
+// following the rules of ConcatMessages. Text goes into ropes, ResponseMeta
+// usage and log probs merge in place, and tool call arguments merge per
+// index, so Snapshot can be taken mid-stream (for callbacks or checkpoints)
+// without re-concatenating the earlier chunks
+//
+// Example:
+//   MessageConcatenator concat;
+//   while (stream->Read(chunk)) {
+//       concat.Add(chunk);
+//       OnPartial(concat.Snapshot());
+//   }
+//   Message full = concat.Finish();
+class MessageConcatenator {
+public:
+    // Reserve sizes the text buffers when the totals are known up front
+    void Reserve(size_t content_bytes, size_t reasoning_bytes);
+
+    // Add merges a chunk
+    // Throws std::runtime_error if role, name, tool_call_id or tool_name
+    // conflict with earlier chunks, or a tool call's id/type/name does
+    void Add(const Message& chunk);
+
+    size_t ChunkCount() const { return chunks_; }
+
+    // Snapshot returns the message merged so far
+    Message Snapshot();
+
+    // Finish returns the merged message and resets the concatenator
+    // Throws std::invalid_argument if no chunk was added
+    Message Finish();
+
+private:
+    struct ToolCallRun {
+        std::string id;
+        std::string type;
+        std::string name;
+        TextRope arguments;
+    };
+
+    void AddToolCall(const ToolCall& call);
+    std::vector<ToolCall> BuildToolCalls(bool consume);
+    std::shared_ptr<ResponseMeta> CopyResponseMeta() const;
+
+    size_t chunks_ = 0;
+    Message head_;  // role, name, ids; heavy fields stay empty
+    TextRope content_;
+    TextRope reasoning_;
+    std::vector<ToolCall> unindexed_calls_;
+    std::map<int, ToolCallRun> indexed_calls_;
+    std::map<std::string, json> extra_;
+    std::vector<ChatMessagePart> multi_content_;
+    AssistantPartMerger assistant_parts_;
+    std::shared_ptr<ResponseMeta> response_meta_;
+};
+
 } // namespace schema
 } // namespace eino
 
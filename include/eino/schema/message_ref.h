@@ -0,0 +1,216 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EINO_CPP_SCHEMA_MESSAGE_REF_H_
+#define EINO_CPP_SCHEMA_MESSAGE_REF_H_
+
+// Immutable, structurally shared messages
+//
+// MessageRef is a refcounted handle to an immutable message: copying it is a
+// pointer bump. Heavy fields (content, reasoning, tool calls, multimodal
+// parts, extra) are held separately, so a Builder that changes one field
+// shares every other field with the original. Names are interned.
+//
+// MessageHistory is a persistent message list: appending a turn returns a
+// new history that shares all earlier messages with the old one.
+//
+// Example:
+//   MessageRef user = MessageRef::From(UserMessage("hi"));
+//   MessageRef edited = user.ToBuilder().SetContent("hello").Build();
+//
+//   MessageHistory turn1 = MessageHistory().Append(user);
+//   MessageHistory turn2 = turn1.Append(reply);   // turn1 is unchanged
+//   std::vector<Message> msgs = turn2.ToMessages();
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eino/schema/types.h"
+
+namespace eino {
+namespace schema {
+
+// InternedString is a pointer to a process-wide pooled string; equal
+// strings share storage and compare by pointer. Meant for low-cardinality
+// values such as agent and tool names: pooled strings are never freed
+class InternedString {
+public:
+    InternedString();
+    explicit InternedString(const std::string& s);
+
+    const std::string& str() const { return *str_; }
+    bool empty() const { return str_->empty(); }
+
+    bool operator==(const InternedString& other) const { return str_ == other.str_; }
+    bool operator!=(const InternedString& other) const { return str_ != other.str_; }
+
+private:
+    const std::string* str_;
+};
+
+class MessageRef {
+public:
+    class Builder;
+
+    // A default handle is an empty user message
+    MessageRef();
+
+    // From converts a Message; the rvalue overload moves its fields.
+    // response_meta is copied either way, as ToMessage copies it back
+    static MessageRef From(const Message& msg);
+    static MessageRef From(Message&& msg);
+
+    // ToMessage copies the fields back into a Message
+    Message ToMessage() const;
+
+    // ToBuilder starts a modified copy that shares unchanged fields
+    Builder ToBuilder() const;
+
+    RoleType role() const { return data_->role; }
+    const std::string& content() const { return *data_->content; }
+    const std::string& reasoning_content() const { return *data_->reasoning_content; }
+    const std::vector<ToolCall>& tool_calls() const { return *data_->tool_calls; }
+    const std::vector<MessageInputPart>& user_input_multi_content() const {
+        return *data_->user_input_multi_content;
+    }
+    const std::vector<MessageOutputPart>& assistant_gen_multi_content() const {
+        return *data_->assistant_gen_multi_content;
+    }
+    const std::vector<ChatMessagePart>& multi_content() const { return *data_->multi_content; }
+    const std::string& tool_call_id() const { return data_->tool_call_id; }
+    const std::string& tool_name() const { return data_->tool_name.str(); }
+    const std::string& name() const { return data_->name.str(); }
+    const std::shared_ptr<const ResponseMeta>& response_meta() const { return data_->response_meta; }
+    const std::map<std::string, json>& extra() const { return *data_->extra; }
+
+    // SameAs reports whether both handles point at the same message
+    bool SameAs(const MessageRef& other) const { return data_ == other.data_; }
+
+private:
+    template<typename T>
+    using Field = std::shared_ptr<const T>;
+
+    struct Data {
+        RoleType role = RoleType::kUser;
+        Field<std::string> content;
+        Field<std::string> reasoning_content;
+        Field<std::vector<ToolCall>> tool_calls;
+        Field<std::vector<MessageInputPart>> user_input_multi_content;
+        Field<std::vector<MessageOutputPart>> assistant_gen_multi_content;
+        Field<std::vector<ChatMessagePart>> multi_content;
+        std::string tool_call_id;
+        InternedString tool_name;
+        InternedString name;
+        // A private copy: Message hands out a writable pointer
+        std::shared_ptr<const ResponseMeta> response_meta;
+        Field<std::map<std::string, json>> extra;
+    };
+
+    explicit MessageRef(std::shared_ptr<const Data> data) : data_(std::move(data)) {}
+
+    std::shared_ptr<const Data> data_;
+};
+
+// Builder edits a copy of a message; fields that are not set stay shared
+// with the message it started from
+class MessageRef::Builder {
+public:
+    Builder() : Builder(MessageRef()) {}
+    explicit Builder(const MessageRef& base) : data_(*base.data_) {}
+
+    Builder& SetRole(RoleType role);
+    Builder& SetContent(std::string content);
+    Builder& AppendContent(const std::string& delta);
+    Builder& SetReasoningContent(std::string reasoning);
+    Builder& SetToolCalls(std::vector<ToolCall> tool_calls);
+    Builder& SetUserInputMultiContent(std::vector<MessageInputPart> parts);
+    Builder& SetAssistantGenMultiContent(std::vector<MessageOutputPart> parts);
+    Builder& SetMultiContent(std::vector<ChatMessagePart> parts);
+    Builder& SetToolCallID(std::string id);
+    Builder& SetToolName(const std::string& tool_name);
+    Builder& SetName(const std::string& name);
+    Builder& SetResponseMeta(const std::shared_ptr<const ResponseMeta>& meta);
+    Builder& SetExtra(std::map<std::string, json> extra);
+    Builder& SetExtra(const std::string& key, json value);
+
+    MessageRef Build() const;
+
+private:
+    Data data_;
+};
+
+// MessageHistory is an immutable message list whose appends share every
+// existing message. Messages live in fixed-size chunks linked towards the
+// front, so an append copies at most one chunk of handles
+class MessageHistory {
+public:
+    MessageHistory() = default;
+
+    static MessageHistory FromMessages(const std::vector<Message>& messages);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Append returns a history with msg added; this one is unchanged
+    MessageHistory Append(const MessageRef& msg) const;
+    MessageHistory Append(const std::vector<MessageRef>& msgs) const;
+
+    // Prefix returns the first n messages, sharing them
+    // Throws std::out_of_range if n > size()
+    MessageHistory Prefix(size_t n) const;
+
+    // At returns message i; cost grows with the distance from the back
+    // Throws std::out_of_range if i >= size()
+    const MessageRef& At(size_t i) const;
+    const MessageRef& Back() const { return At(size_ - 1); }
+
+    // ForEach visits messages front to back
+    void ForEach(const std::function<void(const MessageRef&)>& fn) const;
+
+    std::vector<MessageRef> ToRefs() const;
+    std::vector<Message> ToMessages() const;
+
+    // SharesPrefixWith reports whether the first n messages of both
+    // histories are the same nodes (no copy was made)
+    bool SharesPrefixWith(const MessageHistory& other, size_t n) const;
+
+private:
+    static constexpr size_t kChunkSize = 32;
+
+    struct Chunk {
+        std::shared_ptr<const Chunk> prev;
+        size_t base = 0;  // messages before this chunk
+        std::vector<MessageRef> items;
+    };
+
+    MessageHistory(std::shared_ptr<const Chunk> tail, size_t size)
+        : tail_(std::move(tail)), size_(size) {}
+
+    // ChunkAt returns the chunk holding message i
+    const Chunk* ChunkAt(size_t i) const;
+
+    std::shared_ptr<const Chunk> tail_;
+    size_t size_ = 0;
+};
+
+} // namespace schema
+} // namespace eino
+
+#endif // EINO_CPP_SCHEMA_MESSAGE_REF_H_
@@ -18,6 +18,7 @@
 #define EINO_CPP_SCHEMA_STREAM_H_
 
 #include <vector>
+#include <map>
 #include <memory>
 #include <functional>
 #include <queue>
@@ -135,11 +135,12 @@ public:
     ChildStreamReader(std::shared_ptr<ParentStreamReader<T>> parent, int index)
         : parent_(parent), index_(index) {}
 
-    bool Recv(T& value) override {
-        if (!parent_) {
+    bool Recv(T& value, std::string& error) override {
+        if (!parent_ || !parent_->Peek(index_, value)) {
+            error = "EOF";
             return false;
         }
-        return parent_->Peek(index_, value);
+        return true;
     }
 
     void Close() override {
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/agent_executor.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+// The executor whose worker is running on this thread, if any
+thread_local AgentExecutor* current_executor = nullptr;
+
+// Nested scopes on one thread count as a single blocked worker
+thread_local int blocking_depth = 0;
+
+} // namespace
+
+AgentExecutor::AgentExecutor(const Options& options) : options_(options) {
+    if (options_.core_threads == 0) {
+        options_.core_threads = std::max(2u, std::thread::hardware_concurrency());
+    }
+    options_.max_threads = std::max(options_.max_threads, options_.core_threads);
+}
+
+AgentExecutor::~AgentExecutor() {
+    std::unique_lock<std::mutex> lock(mu_);
+    stopping_ = true;
+    work_cv_.notify_all();
+    exit_cv_.wait(lock, [this]() { return threads_ == 0; });
+}
+
+AgentExecutor& AgentExecutor::Default() {
+    // Leaked so detached workers never see it destroyed at exit
+    static AgentExecutor* executor = new AgentExecutor();
+    return *executor;
+}
+
+void AgentExecutor::Submit(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mu_);
+    queue_.push_back(std::move(task));
+    if (idle_ > 0) {
+        work_cv_.notify_one();
+    } else {
+        MaybeSpawnLocked();
+    }
+}
+
+size_t AgentExecutor::Threads() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return threads_;
+}
+
+size_t AgentExecutor::PeakThreads() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return peak_threads_;
+}
+
+size_t AgentExecutor::Blocked() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return blocked_;
+}
+
+void AgentExecutor::MaybeSpawnLocked() {
+    if (queue_.empty() || idle_ > 0 || threads_ >= options_.max_threads ||
+        RunnableLocked() >= options_.core_threads) {
+        return;
+    }
+    ++threads_;
+    peak_threads_ = std::max(peak_threads_, threads_);
+    std::thread([this]() { WorkerLoop(); }).detach();
+}
+
+void AgentExecutor::WorkerLoop() {
+    current_executor = this;
+    std::unique_lock<std::mutex> lock(mu_);
+    while (true) {
+        if (queue_.empty()) {
+            if (stopping_) {
+                break;
+            }
+            ++idle_;
+            bool woke = work_cv_.wait_for(lock, options_.idle_timeout, [this]() {
+                return !queue_.empty() || stopping_;
+            });
+            --idle_;
+            // Spare workers left over from blocking waits retire when idle
+            if (!woke && RunnableLocked() > options_.core_threads) {
+                break;
+            }
+            continue;
+        }
+        auto task = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            ReportTaskError(std::current_exception());
+        }
+        task = nullptr;
+        lock.lock();
+    }
+    current_executor = nullptr;
+    --threads_;
+    exit_cv_.notify_all();
+}
+
+void AgentExecutor::ReportTaskError(std::exception_ptr error) const {
+    if (options_.on_task_error) {
+        try {
+            options_.on_task_error(error);
+            return;
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        std::cerr << "AgentExecutor: task failed: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "AgentExecutor: task failed with a non-standard exception" << std::endl;
+    }
+}
+
+AgentExecutor::BlockingScope::BlockingScope()
+    : executor_(blocking_depth++ == 0 ? current_executor : nullptr) {
+    if (executor_ == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(executor_->mu_);
+    ++executor_->blocked_;
+    executor_->MaybeSpawnLocked();
+}
+
+AgentExecutor::BlockingScope::~BlockingScope() {
+    --blocking_depth;
+    if (executor_ == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(executor_->mu_);
+    --executor_->blocked_;
+}
+
+} // namespace adk
+} // namespace eino
@@ -30,7 +30,6 @@
 #include "eino/compose/checkpoint.h"
 #include "eino/components/model.h"
 #include <memory>
-#include <thread>
 #include <stdexcept>
 #include <limits>
 
@@ -445,9 +444,12 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ChatModelAgent::Run(
     auto iterator = iterator_pair.first;
     auto generator = iterator_pair.second;
 
-    // Execute run_func_ in a separate thread (aligns with go line 712-728)
+    // Execute run_func_ as a task on the agent executor (aligns with go line 712-728)
     // The goroutine pattern with panic recovery
-    std::thread([this, ctx, input, options, generator]() {
+    AgentExecutor::Default().Submit([this, ctx, input, options, generator]() {
+        // The model and tools are called synchronously, so this run holds a
+        // worker until it ends, see agent_executor.h
+        AgentExecutor::BlockingScope blocking;
         try {
             // Call the built run function
             if (run_func_) {
@@ -473,7 +475,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ChatModelAgent::Run(
             generator->Send(error_event);
             generator->Close();
         }
-    }).detach();
+    });
     
     return iterator;
 }
@@ -496,7 +498,10 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ChatModelAgent::Resu
     auto generator = iterator_pair.second;
     
     // Execute run_func_ with resumed state (aligns with go line 738-753)
-    std::thread([this, ctx, info, options, generator]() {
+    AgentExecutor::Default().Submit([this, ctx, info, options, generator]() {
+        // The model and tools are called synchronously, so this run holds a
+        // worker until it ends, see agent_executor.h
+        AgentExecutor::BlockingScope blocking;
         try {
             if (!info || !info->data) {
                 auto error_event = std::make_shared<AgentEvent>();
@@ -541,7 +546,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ChatModelAgent::Resu
             generator->Send(error_event);
             generator->Close();
         }
-    }).detach();
+    });
 
     return iterator;
 }
@@ -17,7 +17,6 @@
 #include "../../include/eino/adk/deterministic_transfer.h"
 #include "../../include/eino/adk/utils.h"
 #include "../../include/eino/schema/types.h"
-#include <thread>
 
 namespace eino {
 namespace adk {
@@ -76,10 +75,8 @@ AgentWithDeterministicTransferToImpl::Run(
     auto iterator = pair.first;
     auto generator = pair.second;
     
-    // 在后台线程中添加转移动作
-    std::thread([ctx, agent_iter, generator, to_agent_names = to_agent_names_]() {
-        AppendTransferAction(ctx, agent_iter, generator, to_agent_names);
-    }).detach();
+    // 在执行器上转发事件并添加转移动作
+    AppendTransferAction(ctx, agent_iter, generator, to_agent_names_);
     
     return iterator;
 }
@@ -113,9 +110,7 @@ ResumableAgentWithDeterministicTransferToImpl::Run(
     auto iterator = pair.first;
     auto generator = pair.second;
     
-    std::thread([ctx, agent_iter, generator, to_agent_names = to_agent_names_]() {
-        AppendTransferAction(ctx, agent_iter, generator, to_agent_names);
-    }).detach();
+    AppendTransferAction(ctx, agent_iter, generator, to_agent_names_);
     
     return iterator;
 }
@@ -132,9 +127,7 @@ ResumableAgentWithDeterministicTransferToImpl::Resume(
     auto iterator = pair.first;
     auto generator = pair.second;
     
-    std::thread([ctx, agent_iter, generator, to_agent_names = to_agent_names_]() {
-        AppendTransferAction(ctx, agent_iter, generator, to_agent_names);
-    }).detach();
+    AppendTransferAction(ctx, agent_iter, generator, to_agent_names_);
     
     return iterator;
 }
@@ -149,64 +142,63 @@ void AppendTransferAction(
     std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> generator,
     const std::vector<std::string>& to_agent_names) {
     
-    try {
-        bool interrupted = false;
-        std::shared_ptr<AgentEvent> event;
-        
-        // 转发所有原始事件
-        while (agent_iter->Next(event)) {
-            generator->Send(event);
-            
+    // 最后一个事件是否为中断；只在原始Agent的发送线程上读写
+    auto interrupted = std::make_shared<bool>(false);
+    
+    // 原始Agent直接写入generator，不经过中间队列；下游取消时一并取消原始Agent
+    ForwardInline<std::shared_ptr<AgentEvent>>(
+        agent_iter,
+        generator,
+        [interrupted](std::shared_ptr<AgentEvent>& event) {
             // 检查是否被中断
-            if (event->action && event->action->interrupted) {
-                interrupted = true;
-            } else {
-                interrupted = false;
+            *interrupted = event && event->action && event->action->interrupted;
+            return true;
+        },
+        [ctx, generator, interrupted, to_agent_names]() {
+            // 如果被中断，不添加转移动作（等待恢复）
+            if (*interrupted) {
+                generator->Close();
+                return;
             }
-        }
-        
-        // 如果被中断，不添加转移动作（等待恢复）
-        if (interrupted) {
-            generator->Close();
-            return;
-        }
-        
-        // 为每个目标Agent生成转移事件
-        for (const auto& to_agent_name : to_agent_names) {
-            // 生成转移消息
-            auto [assistant_msg, tool_msg] = GenTransferMessages(ctx, to_agent_name);
-            
-            // 生成Assistant消息事件
-            auto assistant_event = EventFromMessage(
-                assistant_msg, 
-                nullptr,  // no error
-                schema::RoleType::kAssistant,
-                "");
-            generator->Send(assistant_event);
-            
-            // 生成Tool消息事件（带转移动作）
-            auto tool_event = EventFromMessage(
-                tool_msg,
-                nullptr,
-                schema::RoleType::kTool,
-                tool_msg.tool_name);
             
-            // 添加转移动作
-            tool_event->action = std::make_shared<AgentAction>();
-            tool_event->action->transfer_to_agent = std::make_shared<TransferToAgentAction>();
-            tool_event->action->transfer_to_agent->dest_agent_name = to_agent_name;
+            try {
+                // 为每个目标Agent生成转移事件
+                for (const auto& to_agent_name : to_agent_names) {
+                    // 生成转移消息
+                    auto [assistant_msg, tool_msg] = GenTransferMessages(ctx, to_agent_name);
+                    
+                    // 生成Assistant消息事件
+                    auto assistant_event = EventFromMessage(
+                        assistant_msg, 
+                        nullptr,  // no error
+                        schema::RoleType::kAssistant,
+                        "");
+                    generator->Send(assistant_event);
+                    
+                    // 生成Tool消息事件（带转移动作）
+                    auto tool_event = EventFromMessage(
+                        tool_msg,
+                        nullptr,
+                        schema::RoleType::kTool,
+                        tool_msg.tool_name);
+                    
+                    // 添加转移动作
+                    tool_event->action = std::make_shared<AgentAction>();
+                    tool_event->action->transfer_to_agent = std::make_shared<TransferToAgentAction>();
+                    tool_event->action->transfer_to_agent->dest_agent_name = to_agent_name;
+                    
+                    generator->Send(tool_event);
+                }
+                
+            } catch (const std::exception& e) {
+                // 发送错误事件
+                auto error_event = std::make_shared<AgentEvent>();
+                error_event->error_msg = std::string("AppendTransferAction error: ") + e.what();
+                generator->Send(error_event);
+            }
             
-            generator->Send(tool_event);
-        }
-        
-    } catch (const std::exception& e) {
-        // 发送错误事件
-        auto error_event = std::make_shared<AgentEvent>();
-        error_event->error_msg = std::string("AppendTransferAction error: ") + e.what();
-        generator->Send(error_event);
-    }
-    
-    generator->Close();
+            generator->Close();
+        });
 }
 
 }  // namespace adk
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/event_transform.h"
+
+#include <utility>
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+// Writable returns an event that may be changed in place: event itself
+// when nobody else holds it, otherwise a shallow copy
+AgentEvent& Writable(std::shared_ptr<AgentEvent>& event) {
+    if (event.use_count() > 1) {
+        event = std::make_shared<AgentEvent>(*event);
+    }
+    return *event;
+}
+
+} // namespace
+
+EventTransform ChainTransforms(std::vector<EventTransform> transforms) {
+    return [transforms = std::move(transforms)](std::shared_ptr<AgentEvent>& event) {
+        for (const auto& transform : transforms) {
+            if (transform && !transform(event)) {
+                return false;
+            }
+        }
+        return true;
+    };
+}
+
+EventTransform FilterEvents(std::function<bool(const AgentEvent&)> keep) {
+    return [keep = std::move(keep)](std::shared_ptr<AgentEvent>& event) {
+        return event && keep(*event);
+    };
+}
+
+EventTransform ObserveEvents(std::function<void(const std::shared_ptr<AgentEvent>&)> observe) {
+    return [observe = std::move(observe)](std::shared_ptr<AgentEvent>& event) {
+        observe(event);
+        return true;
+    };
+}
+
+EventTransform StampRunPath(std::string agent_name, std::vector<RunStep> run_path) {
+    return [agent_name = std::move(agent_name),
+            run_path = std::move(run_path)](std::shared_ptr<AgentEvent>& event) {
+        if (!event || !event->run_path.empty()) {
+            return true;
+        }
+        auto& writable = Writable(event);
+        if (writable.agent_name.empty()) {
+            writable.agent_name = agent_name;
+        }
+        writable.run_path = run_path;
+        return true;
+    };
+}
+
+EventTransform PrefixRunPath(std::vector<RunStep> prefix) {
+    return [prefix = std::move(prefix)](std::shared_ptr<AgentEvent>& event) {
+        if (!event || prefix.empty()) {
+            return true;
+        }
+        auto& path = Writable(event).run_path;
+        path.insert(path.begin(), prefix.begin(), prefix.end());
+        return true;
+    };
+}
+
+} // namespace adk
+} // namespace eino
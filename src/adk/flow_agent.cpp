@@ -17,12 +17,125 @@
 #include "../../include/eino/adk/flow_agent.h"
 #include "../../include/eino/adk/async_iterator.h"
 #include "../../include/eino/adk/context.h"
-#include <thread>
+#include "../../include/eino/adk/event_transform.h"
+#include <atomic>
+#include <functional>
 #include <mutex>
 
 namespace eino {
 namespace adk {
 
+namespace {
+
+// SubAgentStamp names the events a sub-agent emits without a run path
+// after the sub-agent, under the flow's own run path
+EventTransform SubAgentStamp(void* ctx, const std::shared_ptr<Agent>& agent) {
+    std::vector<RunStep> run_path;
+    if (auto runCtx = context::GetExecutionContext(ctx)) {
+        run_path = runCtx->GetRunPath();
+    }
+    std::string name = agent->Name(ctx);
+    run_path.push_back(RunStep{name});
+    return StampRunPath(name, std::move(run_path));
+}
+
+// SubAgentPass runs agents one after another, feeding each the last
+// message of the one before. Each sub-agent is spliced into gen, so its
+// events reach the flow's consumer without a hop, and the pass advances by
+// a continuation on the agent executor: it holds no thread meanwhile
+struct SubAgentPass : std::enable_shared_from_this<SubAgentPass> {
+    void* ctx = nullptr;
+    std::shared_ptr<AgentInput> input;
+    std::shared_ptr<AgentInput> current_input;
+    std::vector<std::shared_ptr<Agent>> agents;
+    std::vector<std::shared_ptr<AgentRunOption>> options;
+    std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> gen;
+
+    // on_event sees each forwarded event; false ends the pass early
+    std::function<bool(const std::shared_ptr<AgentEvent>&)> on_event;
+    // on_pass_done runs once per pass, with whether on_event stopped it
+    std::function<void(bool stopped)> on_pass_done;
+    // on_fail reports an exception and must close gen
+    std::function<void(const std::string&)> on_fail;
+
+    size_t index = 0;
+    std::shared_ptr<AgentEvent> last_event;
+
+    void Start() {
+        index = 0;
+        RunNext();
+    }
+
+    void RunNext() {
+        if (index >= agents.size()) {
+            on_pass_done(false);
+            return;
+        }
+        
+        std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> agent_iter;
+        try {
+            agent_iter = agents[index]->Run(ctx, current_input, options);
+        } catch (const std::exception& e) {
+            on_fail(e.what());
+            return;
+        }
+        
+        last_event = nullptr;
+        auto self = shared_from_this();
+        // stopped is raised on the agent's sending thread once on_event
+        // declines; the pass then moves on without waiting for Close, and
+        // advanced keeps the later Close from moving it twice
+        auto stopped = std::make_shared<std::atomic<bool>>(false);
+        auto advanced = std::make_shared<std::atomic<bool>>(false);
+        auto advance = [self, stopped, advanced]() {
+            if (advanced->exchange(true)) {
+                return;
+            }
+            // A task per sub-agent keeps quick agents off one deep stack
+            AgentExecutor::Default().Submit([self, stopped]() { self->Advance(stopped->load()); });
+        };
+        auto stamp = SubAgentStamp(ctx, agents[index]);
+        ForwardInline<std::shared_ptr<AgentEvent>>(
+            agent_iter,
+            gen,
+            [self, stopped, advance, stamp](std::shared_ptr<AgentEvent>& event) {
+                if (stopped->load()) {
+                    return false;
+                }
+                stamp(event);
+                self->last_event = event;
+                if (event && !self->on_event(event)) {
+                    // The deciding event still goes out, then the rest drop
+                    stopped->store(true);
+                    self->gen->Send(event);
+                    advance();
+                    return false;
+                }
+                return true;
+            },
+            advance);
+    }
+
+    void Advance(bool stopped) {
+        if (stopped) {
+            on_pass_done(true);
+            return;
+        }
+        
+        // Prepare input for next agent from last event output
+        if (last_event && last_event->output && last_event->output->message_output) {
+            auto next_input = std::make_shared<AgentInput>();
+            next_input->messages = {last_event->output->message_output->message};
+            next_input->enable_streaming = input->enable_streaming;
+            current_input = next_input;
+        }
+        ++index;
+        RunNext();
+    }
+};
+
+}  // namespace
+
 FlowAgent::FlowAgent()
     : name_("FlowAgent"),
       description_("Default flow agent with sequential execution") {}
@@ -286,61 +399,42 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> FlowAgent::ExecuteSe
     auto iter = pair.first;
     auto gen = pair.second;
 
-    // Capture options by value
-    auto opts_copy = options;
-    std::thread worker([this, ctx, input, opts_copy, gen]() {
+    auto run = std::make_shared<SubAgentPass>();
+    run->ctx = ctx;
+    run->input = input;
+    run->current_input = input;
+    run->agents = sub_agents_;
+    run->options = options;
+    run->gen = gen;
+    auto fail = [gen](const std::string& msg) {
+        auto error_event = std::make_shared<AgentEvent>();
+        error_event->error_msg = msg;
+        gen->Send(error_event);
+        gen->Close();
+    };
+    run->on_fail = fail;
+
+    // Track last action
+    auto lastAction = std::make_shared<std::shared_ptr<AgentAction>>();
+    run->on_event = [lastAction](const std::shared_ptr<AgentEvent>& event) {
+        // Check for agent transfer
+        if (event->action && event->action->transfer_to_agent) {
+            // Transfer will be handled after the pass completes
+            // Store the action and break the sequential execution
+            *lastAction = event->action;
+            return false;
+        }
+        return true;
+    };
+    run->on_pass_done = [this, ctx, lastAction, gen, options, fail](bool) {
+        // Handle transfer action if present
         try {
-            // Execute sub-agents sequentially
-            auto current_input = input;
-            std::shared_ptr<AgentAction> lastAction;  // Track last action
-            
-            for (size_t i = 0; i < sub_agents_.size(); ++i) {
-                auto agent = sub_agents_[i];
-                
-                // Execute current agent
-                auto agent_iter = agent->Run(ctx, current_input, opts_copy);
-                
-                // Collect all events and forward them
-                std::shared_ptr<AgentEvent> last_event;
-                std::shared_ptr<AgentEvent> event;
-                while (agent_iter->Next(event)) {
-                    last_event = event;
-                    gen->Send(event);
-                    
-                    // Check for agent transfer
-                    if (event->action && event->action->transfer_to_agent) {
-                        // Transfer will be handled after loop completes
-                        // Store the action and break the sequential execution
-                        lastAction = event->action;
-                        break;
-                    }
-                }
-                
-                // If we have a transfer action, handle it outside the loop
-                if (lastAction && lastAction->transfer_to_agent) {
-                    break;
-                }
-                
-                // Prepare input for next agent from last event output
-                if (last_event && last_event->output && last_event->output->message_output) {
-                    auto next_input = std::make_shared<AgentInput>();
-                    next_input->messages = {last_event->output->message_output->message};
-                    next_input->enable_streaming = input->enable_streaming;
-                    current_input = next_input;
-                }
-            }
-            
-            // Handle transfer action if present
-            HandleTransferAction(ctx, lastAction, gen, opts_copy);
-            
+            HandleTransferAction(ctx, *lastAction, gen, options, [gen]() { gen->Close(); });
         } catch (const std::exception& e) {
-            auto error_event = std::make_shared<AgentEvent>();
-            error_event->error_msg = e.what();
-            gen->Send(error_event);
+            fail(e.what());
         }
-        gen->Close();
-    });
-    worker.detach();
+    };
+    run->Start();
 
     return iter;
 }
@@ -357,59 +451,60 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> FlowAgent::ExecutePa
     auto iter = pair.first;
     auto gen = pair.second;
 
-    // Capture options by value
-    auto opts_copy = options;
-    std::thread worker([this, ctx, input, opts_copy, gen]() {
-        try {
-            // Use threads for parallel execution
-            std::vector<std::thread> threads;
-            std::mutex output_mutex;
-            std::vector<std::shared_ptr<AgentEvent>> all_events;
-            bool has_error = false;
-            std::string error_msg;
-            
-            // Launch all sub-agents in parallel
-            for (const auto& agent : sub_agents_) {
-                threads.emplace_back([&, agent, ctx, input, opts_copy, gen]() {
-                    try {
-                        auto agent_iter = agent->Run(ctx, input, opts_copy);
-                        
-                        std::shared_ptr<AgentEvent> event;
-                        while (agent_iter->Next(event)) {
-                            std::lock_guard<std::mutex> lock(output_mutex);
-                            all_events.push_back(event);
-                            gen->Send(event);
-                        }
-                    } catch (const std::exception& e) {
-                        std::lock_guard<std::mutex> lock(output_mutex);
-                        has_error = true;
-                        error_msg = e.what();
-                    }
-                });
-            }
-            
-            // Wait for all threads to complete
-            for (auto& t : threads) {
-                if (t.joinable()) {
-                    t.join();
-                }
-            }
-            
-            // Send error if any sub-agent failed
-            if (has_error) {
-                auto error_event = std::make_shared<AgentEvent>();
-                error_event->error_msg = "Parallel execution error: " + error_msg;
-                gen->Send(error_event);
+    // Shared by the sub-agent splices; the last one to close closes gen
+    struct Join {
+        std::mutex output_mutex;
+        std::vector<std::shared_ptr<AgentEvent>> all_events;
+        size_t pending = 0;
+        bool has_error = false;
+        std::string error_msg;
+    };
+    auto join = std::make_shared<Join>();
+    join->pending = sub_agents_.size();
+
+    auto finish = [join, gen]() {
+        {
+            std::lock_guard<std::mutex> lock(join->output_mutex);
+            if (--join->pending > 0) {
+                return;
             }
-            
-        } catch (const std::exception& e) {
+        }
+        // Send error if any sub-agent failed
+        if (join->has_error) {
             auto error_event = std::make_shared<AgentEvent>();
-            error_event->error_msg = std::string("ExecuteParallel error: ") + e.what();
+            error_event->error_msg = "Parallel execution error: " + join->error_msg;
             gen->Send(error_event);
         }
         gen->Close();
-    });
-    worker.detach();
+    };
+
+    // Launch all sub-agents in parallel; each is spliced into gen and
+    // sends its events there from its own thread
+    for (const auto& agent : sub_agents_) {
+        std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> agent_iter;
+        try {
+            agent_iter = agent->Run(ctx, input, options);
+        } catch (const std::exception& e) {
+            {
+                std::lock_guard<std::mutex> lock(join->output_mutex);
+                join->has_error = true;
+                join->error_msg = e.what();
+            }
+            finish();
+            continue;
+        }
+        auto stamp = SubAgentStamp(ctx, agent);
+        ForwardInline<std::shared_ptr<AgentEvent>>(
+            agent_iter,
+            gen,
+            [join, stamp](std::shared_ptr<AgentEvent>& event) {
+                stamp(event);
+                std::lock_guard<std::mutex> lock(join->output_mutex);
+                join->all_events.push_back(event);
+                return true;
+            },
+            finish);
+    }
 
     return iter;
 }
@@ -426,71 +521,52 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> FlowAgent::ExecuteLo
     auto iter = pair.first;
     auto gen = pair.second;
 
-    // Capture options by value
-    auto opts_copy = options;
-    std::thread worker([this, ctx, input, opts_copy, gen]() {
-        try {
-            auto current_input = input;
-            int iteration = 0;
-            const int max_iterations = 100;  // Safety limit
-            bool should_break = false;
-            
-            while (iteration < max_iterations && !should_break) {
-                // Execute all sub-agents in sequence within each iteration
-                for (const auto& agent : sub_agents_) {
-                    auto agent_iter = agent->Run(ctx, current_input, opts_copy);
-                    
-                    std::shared_ptr<AgentEvent> last_event;
-                    std::shared_ptr<AgentEvent> event;
-                    while (agent_iter->Next(event)) {
-                        last_event = event;
-                        gen->Send(event);
-                        
-                        // Check for break_loop action
-                        if (event->action && event->action->break_loop) {
-                            should_break = true;
-                            break;
-                        }
-                        
-                        // Check for exit action
-                        if (event->action && event->action->exit) {
-                            should_break = true;
-                            break;
-                        }
-                    }
-                    
-                    if (should_break) {
-                        break;
-                    }
-                    
-                    // Prepare input for next agent/iteration from last event
-                    if (last_event && last_event->output && 
-                        last_event->output->message_output) {
-                        auto next_input = std::make_shared<AgentInput>();
-                        next_input->messages = {last_event->output->message_output->message};
-                        next_input->enable_streaming = input->enable_streaming;
-                        current_input = next_input;
-                    }
-                }
-                
-                iteration++;
-            }
-            
-            // Warn if max iterations reached
-            if (iteration >= max_iterations && !should_break) {
-                auto warning_event = std::make_shared<AgentEvent>();
-                warning_event->error_msg = "Loop reached maximum iterations limit";
-                gen->Send(warning_event);
-            }
-            
-        } catch (const std::exception& e) {
-            auto error_event = std::make_shared<AgentEvent>();
-            error_event->error_msg = std::string("ExecuteLoop error: ") + e.what();
-            gen->Send(error_event);
+    const int max_iterations = 100;  // Safety limit
+    auto iteration = std::make_shared<int>(0);
+
+    auto run = std::make_shared<SubAgentPass>();
+    run->ctx = ctx;
+    run->input = input;
+    run->current_input = input;
+    run->agents = sub_agents_;
+    run->options = options;
+    run->gen = gen;
+    run->on_fail = [gen](const std::string& msg) {
+        auto error_event = std::make_shared<AgentEvent>();
+        error_event->error_msg = std::string("ExecuteLoop error: ") + msg;
+        gen->Send(error_event);
+        gen->Close();
+    };
+    run->on_event = [](const std::shared_ptr<AgentEvent>& event) {
+        // Check for break_loop action
+        if (event->action && event->action->break_loop) {
+            return false;
+        }
+        
+        // Check for exit action
+        if (event->action && event->action->exit) {
+            return false;
+        }
+        return true;
+    };
+    // Each pass is one iteration; the next starts from the pass's output
+    std::weak_ptr<SubAgentPass> weak_run = run;
+    run->on_pass_done = [gen, iteration, max_iterations, weak_run](bool should_break) {
+        auto run = weak_run.lock();
+        if (!should_break && ++*iteration < max_iterations && run) {
+            run->Start();
+            return;
+        }
+        
+        // Warn if max iterations reached
+        if (!should_break) {
+            auto warning_event = std::make_shared<AgentEvent>();
+            warning_event->error_msg = "Loop reached maximum iterations limit";
+            gen->Send(warning_event);
         }
         gen->Close();
-    });
-    worker.detach();
+    };
+    run->Start();
 
     return iter;
 }
@@ -674,9 +750,11 @@ void FlowAgent::HandleTransferAction(
     void* ctx,
     std::shared_ptr<AgentAction> action,
     std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> gen,
-    const std::vector<std::shared_ptr<AgentRunOption>>& options) {
+    const std::vector<std::shared_ptr<AgentRunOption>>& options,
+    std::function<void()> on_done) {
     
     if (!action) {
+        on_done();
         return;
     }
     
@@ -686,11 +764,13 @@ void FlowAgent::HandleTransferAction(
         if (runCtx) {
             PushInterruptRunContext(ctx, runCtx);
         }
+        on_done();
         return;
     }
     
     // Check for exit - stop processing
     if (action->exit) {
+        on_done();
         return;
     }
     
@@ -705,18 +785,19 @@ void FlowAgent::HandleTransferAction(
             error_event->error_msg = "transfer failed: agent '" + destName + 
                                     "' not found when transferring from '" + Name(ctx) + "'";
             gen->Send(error_event);
+            on_done();
             return;
         }
         
         // Run the target agent (with null input - gets from runCtx)
         auto subAIter = agentToRun->Run(ctx, nullptr, options);
         
-        // Forward all events from transferred agent
-        std::shared_ptr<AgentEvent> subEvent;
-        while (subAIter->Next(subEvent)) {
-            gen->Send(subEvent);
-        }
+        // Splice the transferred agent into gen; its events need no forwarding
+        ForwardInline<std::shared_ptr<AgentEvent>>(subAIter, gen, nullptr, on_done);
+        return;
     }
+    
+    on_done();
 }
 
 std::shared_ptr<FlowAgent> NewFlowAgent() {
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/hedged_tool.h"
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+namespace eino {
+namespace adk {
+
+compose::ToolMiddleware NewHedgedToolMiddleware(const HedgePolicy& policy,
+                                                const std::vector<std::string>& tools,
+                                                AgentExecutor& executor) {
+    // Created once and shared by every endpoint the middleware wraps
+    auto hedgers = std::make_shared<std::map<std::string, std::shared_ptr<Hedger>>>();
+    for (const auto& name : tools) {
+        (*hedgers)[name] = std::make_shared<Hedger>(policy, executor);
+    }
+
+    compose::ToolMiddleware middleware;
+    middleware.invokable = [hedgers](compose::InvokableToolEndpoint next) {
+        return compose::InvokableToolEndpoint(
+            [hedgers, next](void* ctx, const std::shared_ptr<compose::ToolInput>& input) {
+                auto it = hedgers->find(input->name);
+                if (it == hedgers->end()) {
+                    return next(ctx, input);
+                }
+                return it->second->Run<std::shared_ptr<compose::ToolOutput>>(
+                    [next, ctx, input](const HedgeAttempt& attempt) {
+                        // Run waits for every attempt, so ctx outlives this
+                        // one; a duplicate starting after the answer skips the tool
+                        if (attempt.Cancelled()) {
+                            throw std::runtime_error("HedgedTool: attempt cancelled");
+                        }
+                        return next(ctx, input);
+                    });
+            });
+    };
+    return middleware;
+}
+
+}  // namespace adk
+}  // namespace eino
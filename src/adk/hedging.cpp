@@ -0,0 +1,281 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/hedging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <thread>
+#include <utility>
+
+#include "eino/internal/metrics.h"
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+// HedgeMetrics are recorded by Hedger
+struct HedgeMetrics {
+    internal::metrics::Counter hedged_calls;
+    internal::metrics::Counter hedges;
+    internal::metrics::Counter hedge_wins;
+
+    static const HedgeMetrics& Get() {
+        static const HedgeMetrics metrics;
+        return metrics;
+    }
+
+    HedgeMetrics() {
+        auto& registry = internal::metrics::Registry::Global();
+        hedged_calls = registry.GetCounter("eino_hedged_calls_total",
+                                           "Calls run with hedging enabled");
+        hedges = registry.GetCounter("eino_hedges_total",
+                                     "Duplicate attempts started for slow calls");
+        hedge_wins = registry.GetCounter("eino_hedge_wins_total",
+                                         "Hedged calls answered first by a duplicate");
+    }
+};
+
+// HedgeTimer runs short tasks at their deadlines on one thread shared by
+// every hedger, so a call waiting for its hedge delay holds no thread
+class HedgeTimer {
+public:
+    static HedgeTimer& Get() {
+        // Leaked so the detached thread never sees it destroyed at exit
+        static HedgeTimer* timer = new HedgeTimer();
+        return *timer;
+    }
+
+    void At(std::chrono::steady_clock::time_point deadline, std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace(deadline, std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+private:
+    HedgeTimer() { std::thread([this]() { Loop(); }).detach(); }
+
+    void Loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            if (tasks_.empty()) {
+                cv_.wait(lock);
+                continue;
+            }
+            auto first = tasks_.begin();
+            if (std::chrono::steady_clock::now() < first->first) {
+                cv_.wait_until(lock, first->first);
+                continue;
+            }
+            std::function<void()> task = std::move(first->second);
+            tasks_.erase(first);
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> tasks_;
+};
+
+} // namespace
+
+// Call is one Run: its attempts and who answered
+struct Hedger::Call {
+    std::function<void(const HedgeAttempt&)> attempt;
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+    std::chrono::steady_clock::time_point start;
+    std::chrono::nanoseconds delay{0};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int started = 0;
+    int finished = 0;
+    int failed = 0;
+    int winner = -1;
+    // Set once the first attempt has ended; no duplicate starts after it
+    bool closed = false;
+    std::exception_ptr error;
+};
+
+Hedger::Hedger(const HedgePolicy& policy, AgentExecutor& executor)
+    : policy_(policy), executor_(executor) {
+    policy_.max_hedges = std::max(policy_.max_hedges, 0);
+    policy_.window = std::max<size_t>(policy_.window, 1);
+    budget_ = policy_.budget_burst;
+}
+
+void Hedger::Attempt(const std::shared_ptr<Call>& call, int index) {
+    uint64_t start_ns = internal::metrics::NowNs();
+    std::exception_ptr error;
+    {
+        // Attempts wait on a remote model or tool, not on the pool
+        AgentExecutor::BlockingScope scope;
+        try {
+            call->attempt(HedgeAttempt(index, call->cancelled));
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    if (!error) {
+        Record(static_cast<int64_t>(internal::metrics::NowNs() - start_ns));
+    }
+    {
+        std::lock_guard<std::mutex> lock(call->mutex);
+        ++call->finished;
+        if (error) {
+            ++call->failed;
+            if (!call->error) {
+                call->error = std::move(error);
+            }
+        } else if (call->winner < 0) {
+            call->winner = index;
+            // The others may give up now
+            call->cancelled->store(true, std::memory_order_release);
+        }
+    }
+    call->cv.notify_all();
+}
+
+void Hedger::Hedge(const std::shared_ptr<Call>& call, int index) {
+    std::weak_ptr<Hedger> weak_self = shared_from_this();
+    std::weak_ptr<Call> weak_call = call;
+    HedgeTimer::Get().At(call->start + call->delay * index, [weak_self, weak_call, index]() {
+        auto self = weak_self.lock();
+        auto call = weak_call.lock();
+        if (!self || !call) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(call->mutex);
+            if (call->closed || call->winner >= 0 || !self->TakeBudget()) {
+                return;
+            }
+            ++call->started;
+        }
+        if (index < self->policy_.max_hedges) {
+            self->Hedge(call, index + 1);
+        }
+        self->executor_.Submit([self, call, index]() { self->Attempt(call, index); });
+    });
+}
+
+void Hedger::Record(int64_t latency_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_ns_.push_back(latency_ns);
+    if (latencies_ns_.size() > policy_.window) {
+        latencies_ns_.pop_front();
+    }
+    delay_ns_ = -1;
+}
+
+bool Hedger::TakeBudget() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (budget_ < 1) {
+            ++stats_.budget_denied;
+            return false;
+        }
+        budget_ -= 1;
+        ++stats_.hedges;
+    }
+    HedgeMetrics::Get().hedges.Inc();
+    return true;
+}
+
+std::chrono::nanoseconds Hedger::DelayLocked() const {
+    if (latencies_ns_.size() < std::max<size_t>(policy_.min_samples, 1)) {
+        return std::max<std::chrono::nanoseconds>(policy_.initial_delay, policy_.min_delay);
+    }
+    if (delay_ns_ < 0) {
+        std::vector<int64_t> sorted(latencies_ns_.begin(), latencies_ns_.end());
+        double rank = std::ceil(policy_.percentile / 100 * static_cast<double>(sorted.size()));
+        size_t index = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+        index = std::min(index, sorted.size() - 1);
+        std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index),
+                         sorted.end());
+        delay_ns_ = std::max<int64_t>(
+            sorted[index],
+            std::chrono::duration_cast<std::chrono::nanoseconds>(policy_.min_delay).count());
+    }
+    return std::chrono::nanoseconds(delay_ns_);
+}
+
+std::chrono::nanoseconds Hedger::Delay() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return DelayLocked();
+}
+
+HedgeStats Hedger::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+int Hedger::Race(std::function<void(const HedgeAttempt&)> attempt) {
+    auto call = std::make_shared<Call>();
+    call->attempt = std::move(attempt);
+    call->started = 1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.calls;
+        budget_ = std::min(policy_.budget_burst, budget_ + policy_.max_hedge_ratio);
+        call->delay = DelayLocked();
+    }
+    HedgeMetrics::Get().hedged_calls.Inc();
+
+    call->start = std::chrono::steady_clock::now();
+    if (policy_.max_hedges > 0) {
+        Hedge(call, 1);
+    }
+    Attempt(call, 0);
+
+    int winner;
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(call->mutex);
+        call->closed = true;
+        if (call->finished < call->started) {
+            AgentExecutor::BlockingScope scope;
+            call->cv.wait(lock, [&call]() { return call->finished == call->started; });
+        }
+        winner = call->winner;
+        error = std::move(call->error);
+        call->error = nullptr;
+    }
+
+    if (winner < 0) {
+        std::rethrow_exception(error);
+    }
+    if (winner > 0) {
+        {
+            std::lock_guard<std::mutex> stats_lock(mutex_);
+            ++stats_.hedge_wins;
+        }
+        HedgeMetrics::Get().hedge_wins.Inc();
+    }
+    return winner;
+}
+
+}  // namespace adk
+}  // namespace eino
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/middlewares/presummarizer.h"
+
+#include <condition_variable>
+#include <stdexcept>
+#include <utility>
+
+#include "eino/internal/metrics.h"
+#include "eino/schema/fast_json.h"
+
+namespace eino {
+namespace adk {
+namespace middlewares {
+namespace summarization {
+
+// Job is one background summary of a snapshot of the history
+struct PreSummarizer::Job {
+    std::vector<schema::Message> snapshot;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    bool failed = false;
+    std::vector<schema::Message> summary;
+};
+
+namespace {
+
+// SummaryWaitNs is the time turns spend waiting on a summary
+internal::metrics::Histogram SummaryWaitNs() {
+    static const auto hist = internal::metrics::Registry::Global().GetHistogram(
+        "eino_summary_wait_ns", "Time a turn waited on history summarization");
+    return hist;
+}
+
+// SamePrefix reports whether messages starts with prefix, comparing what
+// would be sent. WriteMessage writes every Message field, the multimodal
+// parts included, so a change to any of them breaks the prefix
+bool SamePrefix(const std::vector<schema::Message>& prefix,
+                const std::vector<schema::Message>& messages) {
+    if (prefix.size() > messages.size()) {
+        return false;
+    }
+    schema::JsonWriter a;
+    schema::JsonWriter b;
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        a.Clear();
+        b.Clear();
+        schema::WriteMessage(a, prefix[i]);
+        schema::WriteMessage(b, messages[i]);
+        if (a.str() != b.str()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+PreSummarizer::PreSummarizer(const PreSummarizerConfig& config, SummarizeFunc summarize,
+                             AgentExecutor& executor)
+    : config_(config), summarize_(std::move(summarize)), executor_(executor) {
+    if (!summarize_) {
+        throw std::runtime_error("PreSummarizer: summarize is required");
+    }
+}
+
+// A running summary owns what it reads; it finishes on its own and is dropped
+PreSummarizer::~PreSummarizer() = default;
+
+bool PreSummarizer::Reached(size_t messages, int tokens, int token_limit,
+                            int message_limit) const {
+    return (token_limit > 0 && tokens >= token_limit) ||
+           (message_limit > 0 && messages >= static_cast<size_t>(message_limit));
+}
+
+void PreSummarizer::Prepare(const std::vector<schema::Message>& messages) {
+    auto job = std::make_shared<Job>();
+    job->snapshot = messages;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job_) {
+            return;
+        }
+        job_ = job;
+        ++stats_.prepared;
+    }
+    SummarizeFunc summarize = summarize_;
+    executor_.Submit([job, summarize]() {
+        // The summary is a model call; it waits on the provider, not the pool
+        AgentExecutor::BlockingScope scope;
+        std::vector<schema::Message> summary;
+        bool failed = false;
+        try {
+            summary = summarize(job->snapshot);
+        } catch (...) {
+            failed = true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->summary = std::move(summary);
+            job->failed = failed;
+            job->done = true;
+        }
+        job->cv.notify_all();
+    });
+}
+
+bool PreSummarizer::Swap(const std::shared_ptr<Job>& job,
+                         const std::vector<schema::Message>& messages,
+                         std::vector<schema::Message>* out) {
+    // Checked first: a rewritten history is not worth waiting for
+    if (!SamePrefix(job->snapshot, messages)) {
+        return false;
+    }
+    uint64_t start_ns = internal::metrics::NowNs();
+    bool waited = false;
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        if (!job->done) {
+            waited = true;
+            AgentExecutor::BlockingScope scope;
+            job->cv.wait(lock, [&job]() { return job->done; });
+        }
+        if (job->failed) {
+            return false;
+        }
+        *out = job->summary;
+    }
+    SummaryWaitNs().Record(internal::metrics::NowNs() - start_ns);
+    out->insert(out->end(), messages.begin() + static_cast<std::ptrdiff_t>(job->snapshot.size()),
+                messages.end());
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.swapped;
+    if (waited) {
+        ++stats_.waited;
+    }
+    return true;
+}
+
+std::vector<schema::Message> PreSummarizer::Update(const std::vector<schema::Message>& messages,
+                                                   int tokens) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job = job_;
+    }
+    if (!Reached(messages.size(), tokens, config_.trigger_tokens, config_.trigger_messages)) {
+        if (!job &&
+            Reached(messages.size(), tokens, config_.prepare_tokens, config_.prepare_messages)) {
+            Prepare(messages);
+        }
+        return messages;
+    }
+
+    std::vector<schema::Message> out;
+    bool swapped = job && Swap(job, messages, &out);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job_ == job) {
+            job_.reset();
+        }
+        if (job && !swapped) {
+            ++stats_.discarded;
+        }
+        if (!swapped) {
+            ++stats_.synchronous;
+        }
+    }
+    if (swapped) {
+        return out;
+    }
+    uint64_t start_ns = internal::metrics::NowNs();
+    out = summarize_(messages);
+    SummaryWaitNs().Record(internal::metrics::NowNs() - start_ns);
+    return out;
+}
+
+bool PreSummarizer::Pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return job_ != nullptr;
+}
+
+PreSummarizerStats PreSummarizer::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace summarization
+}  // namespace middlewares
+}  // namespace adk
+}  // namespace eino
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/model_rate_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+#include "eino/adk/agent_executor.h"
+#include "eino/internal/metrics.h"
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+// LimiterMetrics are recorded by ModelRateLimiter and CallWithLimits
+struct LimiterMetrics {
+    internal::metrics::HistogramFamily model_queue_ns;
+    internal::metrics::Counter model_rate_limited;
+    internal::metrics::Counter retries;
+
+    static const LimiterMetrics& Get() {
+        static const LimiterMetrics metrics;
+        return metrics;
+    }
+
+    LimiterMetrics()
+        : model_queue_ns("eino_model_queue_ns",
+                         "Time a model call waited for rate-limit admission", "lane") {
+        auto& registry = internal::metrics::Registry::Global();
+        model_rate_limited = registry.GetCounter(
+            "eino_model_rate_limited_total", "Model calls refused by the provider's rate limits");
+        retries = registry.GetCounter("eino_retries_total",
+                                      "Model call retries");
+    }
+};
+
+const char* LaneName(SessionLane lane) {
+    return lane == SessionLane::kBatch ? "batch" : "interactive";
+}
+
+} // namespace
+
+ModelRateLimiter::Permit::Permit(Permit&& other) noexcept
+    : limiter_(other.limiter_), window_(other.window_), tokens_(other.tokens_) {
+    other.limiter_ = nullptr;
+}
+
+ModelRateLimiter::Permit& ModelRateLimiter::Permit::operator=(Permit&& other) noexcept {
+    if (this != &other) {
+        Release(ModelCallOutcome::kFailed);
+        limiter_ = other.limiter_;
+        window_ = other.window_;
+        tokens_ = other.tokens_;
+        other.limiter_ = nullptr;
+    }
+    return *this;
+}
+
+ModelRateLimiter::Permit::~Permit() {
+    Release(ModelCallOutcome::kFailed);
+}
+
+void ModelRateLimiter::Permit::Release(ModelCallOutcome outcome, int64_t used_tokens) {
+    if (!limiter_) {
+        return;
+    }
+    limiter_->Release(window_, outcome, used_tokens > 0 ? used_tokens - tokens_ : 0);
+    limiter_ = nullptr;
+}
+
+ModelRateLimiter::ModelRateLimiter(const ModelRateLimits& limits)
+    : limits_(limits), refilled_(std::chrono::steady_clock::now()) {
+    limits_.min_concurrency = std::max<size_t>(limits_.min_concurrency, 1);
+    limits_.max_concurrency = std::max(limits_.max_concurrency, limits_.min_concurrency);
+    request_capacity_ = std::max(1.0, limits_.requests_per_second * limits_.burst_seconds);
+    token_capacity_ = std::max(1.0, limits_.tokens_per_second * limits_.burst_seconds);
+    requests_ = request_capacity_;
+    tokens_ = token_capacity_;
+    limit_ = static_cast<double>(limits_.max_concurrency);
+}
+
+std::shared_ptr<ModelRateLimiter> ModelRateLimiter::Shared(const std::string& key,
+                                                           const ModelRateLimits& limits) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<ModelRateLimiter>> limiters;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& slot = limiters[key];
+    auto limiter = slot.lock();
+    if (!limiter) {
+        limiter = std::make_shared<ModelRateLimiter>(limits);
+        slot = limiter;
+    }
+    return limiter;
+}
+
+void ModelRateLimiter::Refill(std::chrono::steady_clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - refilled_).count();
+    refilled_ = now;
+    if (elapsed <= 0) {
+        return;
+    }
+    if (limits_.requests_per_second > 0) {
+        requests_ = std::min(request_capacity_,
+                             requests_ + elapsed * limits_.requests_per_second);
+    }
+    if (limits_.tokens_per_second > 0) {
+        tokens_ = std::min(token_capacity_, tokens_ + elapsed * limits_.tokens_per_second);
+    }
+}
+
+ModelRateLimiter::Permit ModelRateLimiter::Acquire(SessionLane lane, int64_t tokens) {
+    uint64_t start_ns = internal::metrics::NowNs();
+    double cost = 0;
+    if (limits_.tokens_per_second > 0) {
+        cost = std::min(static_cast<double>(std::max<int64_t>(tokens, 0)), token_capacity_);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto key = std::make_pair(static_cast<int>(lane), next_seq_++);
+    waiting_.insert(key);
+    std::unique_ptr<AgentExecutor::BlockingScope> blocking;
+    for (;;) {
+        auto now = std::chrono::steady_clock::now();
+        Refill(now);
+        size_t limit = std::max(limits_.min_concurrency, static_cast<size_t>(limit_));
+        if (*waiting_.begin() == key && in_flight_ < limit) {
+            // First in line with a free slot: wait only for the buckets
+            double wait_s = 0;
+            if (limits_.requests_per_second > 0 && requests_ < 1) {
+                wait_s = (1 - requests_) / limits_.requests_per_second;
+            }
+            if (limits_.tokens_per_second > 0 && tokens_ < cost) {
+                wait_s = std::max(wait_s, (cost - tokens_) / limits_.tokens_per_second);
+            }
+            if (wait_s <= 0) {
+                break;
+            }
+            if (!blocking) {
+                blocking.reset(new AgentExecutor::BlockingScope());
+            }
+            cv_.wait_until(lock, now + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::duration<double>(wait_s)));
+        } else {
+            if (!blocking) {
+                blocking.reset(new AgentExecutor::BlockingScope());
+            }
+            cv_.wait(lock);
+        }
+    }
+    waiting_.erase(key);
+    ++in_flight_;
+    ++admitted_;
+    if (limits_.requests_per_second > 0) {
+        requests_ -= 1;
+    }
+    tokens_ -= cost;
+    uint64_t window = window_;
+    lock.unlock();
+    // Whoever is next in line re-checks
+    cv_.notify_all();
+
+    LimiterMetrics::Get().model_queue_ns.WithLabel(LaneName(lane))
+        .Record(internal::metrics::NowNs() - start_ns);
+    return Permit(this, window, static_cast<int64_t>(cost));
+}
+
+void ModelRateLimiter::Release(uint64_t window, ModelCallOutcome outcome, int64_t extra_tokens) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --in_flight_;
+        if (limits_.tokens_per_second > 0 && extra_tokens > 0) {
+            tokens_ = std::max(tokens_ - extra_tokens, -token_capacity_);
+        }
+        switch (outcome) {
+            case ModelCallOutcome::kSucceeded:
+                limit_ = std::min(static_cast<double>(limits_.max_concurrency),
+                                  limit_ + 1 / limit_);
+                break;
+            case ModelCallOutcome::kRateLimited:
+                ++rate_limited_;
+                if (window == window_) {
+                    limit_ = std::max(static_cast<double>(limits_.min_concurrency),
+                                      std::floor(limit_ * limits_.backoff_ratio));
+                    ++window_;
+                    requests_ = std::min(requests_, 0.0);
+                }
+                break;
+            case ModelCallOutcome::kFailed:
+                break;
+        }
+    }
+    if (outcome == ModelCallOutcome::kRateLimited) {
+        LimiterMetrics::Get().model_rate_limited.Inc();
+    }
+    cv_.notify_all();
+}
+
+ModelRateLimiterStats ModelRateLimiter::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ModelRateLimiterStats stats;
+    stats.in_flight = in_flight_;
+    stats.concurrency_limit = std::max(limits_.min_concurrency, static_cast<size_t>(limit_));
+    for (const auto& key : waiting_) {
+        if (key.first == static_cast<int>(SessionLane::kBatch)) {
+            ++stats.queued_batch;
+        } else {
+            ++stats.queued_interactive;
+        }
+    }
+    stats.admitted = admitted_;
+    stats.rate_limited = rate_limited_;
+    return stats;
+}
+
+std::pair<int64_t, std::string> EstimateTokens(
+    const std::vector<schema::Message*>& msgs,
+    const std::vector<std::shared_ptr<schema::ToolInfo>>& tools) {
+    int64_t tokens = 0;
+    for (const auto* msg : msgs) {
+        if (!msg) {
+            continue;
+        }
+        size_t chars = msg->content.size() + msg->reasoning_content.size();
+        for (const auto& call : msg->tool_calls) {
+            chars += call.function.name.size() + call.function.arguments.size();
+        }
+        tokens += 4 + static_cast<int64_t>((chars + 3) / 4);
+    }
+    for (const auto& tool : tools) {
+        if (tool) {
+            tokens += 4 + static_cast<int64_t>(
+                              (tool->name.size() + tool->description.size() + 3) / 4);
+        }
+    }
+    return {tokens, ""};
+}
+
+bool IsRateLimitError(const std::exception& err) {
+    const auto* call_err = dynamic_cast<const ModelCallError*>(&err);
+    return call_err && call_err->GetStatusCode() == 429;
+}
+
+int64_t CountTokens(const ModelCallConfig& config,
+                    const std::vector<schema::Message>& messages,
+                    const std::vector<std::shared_ptr<schema::ToolInfo>>& tools) {
+    // TokenCounter takes mutable pointers; counters only read them
+    std::vector<schema::Message*> msgs;
+    msgs.reserve(messages.size());
+    for (const auto& msg : messages) {
+        msgs.push_back(const_cast<schema::Message*>(&msg));
+    }
+    if (config.token_counter) {
+        auto counted = config.token_counter(msgs, tools);
+        if (counted.second.empty()) {
+            return counted.first;
+        }
+    }
+    return EstimateTokens(msgs, tools).first;
+}
+
+void CallWithLimits(const ModelCallConfig& config, int64_t tokens,
+                    const std::function<void(ModelRateLimiter::Permit&)>& call,
+                    const std::function<bool()>& cancelled) {
+    const IsRateLimitedFunc& is_rate_limited =
+        config.is_rate_limited ? config.is_rate_limited : IsRateLimitError;
+    for (int attempt = 0;; ++attempt) {
+        if (cancelled && cancelled()) {
+            throw std::runtime_error("CallWithLimits: call cancelled");
+        }
+        auto permit = config.limiter->Acquire(config.lane, tokens);
+        // Admission may have waited; hand the permit back unused
+        if (cancelled && cancelled()) {
+            permit.Release(ModelCallOutcome::kFailed);
+            throw std::runtime_error("CallWithLimits: call cancelled");
+        }
+        try {
+            call(permit);
+            return;
+        } catch (const std::exception& e) {
+            std::string err = e.what();
+            permit.Release(is_rate_limited(e) ? ModelCallOutcome::kRateLimited
+                                                : ModelCallOutcome::kFailed);
+            if (config.retry.max_retries <= 0 || (cancelled && cancelled())) {
+                throw;
+            }
+            bool retryable = config.retry.is_retryable ? config.retry.is_retryable(err)
+                                                       : DefaultIsRetryable(err);
+            if (!retryable) {
+                throw;
+            }
+            if (attempt >= config.retry.max_retries) {
+                throw RetryExhaustedError(err, attempt);
+            }
+        }
+        LimiterMetrics::Get().retries.Inc();
+        auto delay = config.retry.backoff_func ? config.retry.backoff_func(attempt + 1)
+                                               : DefaultBackoff(attempt + 1);
+        AgentExecutor::BlockingScope scope;
+        std::this_thread::sleep_for(delay);
+    }
+}
+
+}  // namespace adk
+}  // namespace eino
@@ -20,6 +20,7 @@
 #include "eino/adk/agent_tool.h"
 #include "eino/components/tool/tool.h"
 #include "eino/schema/types.h"
+#include "eino/adk/task_dispatch.h"
 #include <nlohmann/json.hpp>
 #include <sstream>
 
@@ -165,7 +166,9 @@ public:
     }
 };
 
-// TaskTool implementation
+// TaskTool implementation. The tools node runs each task call through its
+// own InvokableRun, which dispatches it as a task of its own: the subagent
+// starts from a SubAgentContext holding just the task description
 class TaskTool : public tool::InvokableTool {
 public:
     TaskTool(void* ctx,
@@ -173,14 +176,8 @@ public:
              bool without_general_sub_agent,
              const DeepAgentConfig::TaskToolDescriptionGenerator& desc_gen)
         : sub_agents_(sub_agents), desc_generator_(desc_gen) {
-        
-        // Convert agents to agent tools
         for (const auto& agent : sub_agents) {
-            auto agent_tool = NewAgentTool(ctx, agent);
-            if (agent_tool) {
-                std::string agent_name = agent->Name(ctx);
-                agent_tools_[agent_name] = agent_tool;
-            }
+            agents_by_name_[agent->Name(ctx)] = agent;
         }
     }
     
@@ -215,18 +212,29 @@ public:
             std::string subagent_type = j["subagent_type"].get<std::string>();
             std::string description = j["description"].get<std::string>();
             
-            // Find the agent tool
-            auto it = agent_tools_.find(subagent_type);
-            if (it == agent_tools_.end()) {
+            if (agents_by_name_.find(subagent_type) == agents_by_name_.end()) {
                 return "Error: subagent type '" + subagent_type + "' not found";
             }
             
-            // Create request JSON for agent tool
-            json request_json;
-            request_json["request"] = description;
-            
-            // Invoke the agent tool
-            return it->second->InvokableRun(ctx, request_json.dump());
+            SubAgentTask task;
+            task.subagent_type = subagent_type;
+            task.description = description;
+            auto agents = agents_by_name_;
+            SubAgentStarter starter = [agents](
+                void* ctx, const std::shared_ptr<SubAgentContext>& context) -> SubAgentEventIterator {
+                auto input = std::make_shared<AgentInput>();
+                input->messages = context->Messages();
+                return agents.at(context->Task().subagent_type)->Run(ctx, input, {});
+            };
+            auto results = DispatchTasks(ctx, {task}, std::move(starter), schema::MessageHistory());
+            SubAgentResult result;
+            if (!results->Next(result)) {
+                return "Error running task: no result";
+            }
+            if (!result.error.empty()) {
+                return "Error running task: " + result.error;
+            }
+            return result.result;
             
         } catch (const std::exception& e) {
             return std::string("Error running task: ") + e.what();
@@ -249,7 +257,7 @@ private:
     }
     
     std::vector<std::shared_ptr<Agent>> sub_agents_;
-    std::map<std::string, std::shared_ptr<tool::InvokableTool>> agent_tools_;
+    std::map<std::string, std::shared_ptr<Agent>> agents_by_name_;
     DeepAgentConfig::TaskToolDescriptionGenerator desc_generator_;
 };
 
@@ -20,11 +20,9 @@
 #include "eino/adk/context.h"
 #include "eino/compose/chain.h"
 #include "eino/schema/stream.h"
-#include <nlohmann/json.hpp>
 #include <sstream>
 #include <algorithm>
-
-using json = nlohmann::json;
+#include <mutex>
 
 namespace eino {
 namespace adk {
@@ -42,36 +40,46 @@ std::string DefaultPlan::FirstStep(void* ctx) {
 }
 
 std::string DefaultPlan::ToJSON(void* ctx) {
-    json j;
-    j["steps"] = steps_;
-    return j.dump();
+    return PlanStepsToJSON(Steps(ctx));
 }
 
 bool DefaultPlan::FromJSON(void* ctx, const std::string& json_str) {
-    try {
-        auto j = json::parse(json_str);
-        steps_.clear();
-        
-        if (j.contains("steps") && j["steps"].is_array()) {
-            for (const auto& step : j["steps"]) {
-                if (step.is_string()) {
-                    steps_.push_back(step.get<std::string>());
-                }
-            }
-            return !steps_.empty();
-        }
-        return false;
-    } catch (const std::exception&) {
+    std::vector<PlanStep> steps;
+    if (!PlanStepsFromJSON(json_str, &steps)) {
         return false;
     }
+    ClearSteps();
+    for (auto& step : steps) {
+        steps_.push_back(std::move(step.step));
+        depends_on_.push_back(std::move(step.depends_on));
+    }
+    return true;
+}
+
+std::vector<PlanStep> DefaultPlan::Steps(void* ctx) {
+    std::vector<PlanStep> steps;
+    for (size_t i = 0; i < steps_.size(); ++i) {
+        steps.push_back(PlanStep{steps_[i], depends_on_[i]});
+    }
+    return steps;
 }
 
 void DefaultPlan::AddStep(const std::string& step) {
+    if (steps_.empty()) {
+        AddStep(step, {});
+    } else {
+        AddStep(step, {steps_.size() - 1});
+    }
+}
+
+void DefaultPlan::AddStep(const std::string& step, const std::vector<size_t>& depends_on) {
     steps_.push_back(step);
+    depends_on_.push_back(depends_on);
 }
 
 void DefaultPlan::ClearSteps() {
     steps_.clear();
+    depends_on_.clear();
 }
 
 // ============================================================================
@@ -137,6 +145,135 @@ std::shared_ptr<Planner> NewPlanner(void* ctx, const PlannerConfig& config) {
 // Executor
 // ============================================================================
 
+namespace {
+
+std::string ReplaceAll(std::string text, const std::string& from, const std::string& to) {
+    for (size_t pos = text.find(from); pos != std::string::npos;
+         pos = text.find(from, pos + to.size())) {
+        text.replace(pos, from.size(), to);
+    }
+    return text;
+}
+
+// ParallelExecutor runs every step of the session's plan in one turn,
+// each step on its own run of the step agent. Independent steps run side
+// by side; a step sees the results of the steps it depends on
+class ParallelExecutor : public Agent {
+public:
+    ParallelExecutor(std::shared_ptr<Agent> step_agent, const ExecutorConfig& config)
+        : step_agent_(std::move(step_agent)), config_(config) {}
+
+    std::string Name(void* ctx) override { return step_agent_->Name(ctx); }
+    std::string Description(void* ctx) override { return step_agent_->Description(ctx); }
+
+    std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> Run(
+        void* ctx,
+        const std::shared_ptr<AgentInput>& input,
+        const std::vector<std::shared_ptr<AgentRunOption>>& options) override;
+
+private:
+    std::shared_ptr<Agent> step_agent_;
+    ExecutorConfig config_;
+};
+
+// PromptMessages owns the step prompts: AgentInput holds raw messages
+struct PromptMessages {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<schema::Message>> messages;
+
+    Message Keep(schema::Message message) {
+        auto owned = std::make_shared<schema::Message>(std::move(message));
+        std::lock_guard<std::mutex> lock(mutex);
+        messages.push_back(owned);
+        return owned.get();
+    }
+};
+
+std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ParallelExecutor::Run(
+    void* ctx,
+    const std::shared_ptr<AgentInput>& input,
+    const std::vector<std::shared_ptr<AgentRunOption>>& options) {
+
+    // A missing or sequential plan runs one step per turn as without
+    // max_parallel_steps, so the replanner still sees every step
+    auto* plan = static_cast<Plan*>(GetSessionValue(ctx, kSessionKeyPlan));
+    std::vector<PlanStep> steps;
+    if (plan) {
+        steps = plan->Steps(ctx);
+    }
+    if (!HasIndependentSteps(steps)) {
+        return step_agent_->Run(ctx, input, options);
+    }
+
+    std::vector<Message> user_input = input->messages;
+    if (auto* stored = static_cast<std::vector<Message>*>(GetSessionValue(ctx, kSessionKeyUserInput))) {
+        user_input = *stored;
+    }
+    std::string objective;
+    for (const auto& msg : user_input) {
+        if (msg) {
+            objective += msg->content + "\n";
+        }
+    }
+    // Steps get their own copy: the session may replace its plan while
+    // they run
+    auto plan_ref = std::make_shared<DefaultPlan>();
+    for (const auto& step : steps) {
+        plan_ref->AddStep(step.step, step.depends_on);
+    }
+    std::string plan_json = plan_ref->ToJSON(ctx);
+    auto prompts = std::make_shared<PromptMessages>();
+
+    // Steps may outlive this agent's caller; take what they need by value
+    StepRunner runner = [step_agent = step_agent_, gen_input_fn = config_.gen_input_fn, ctx, input,
+                         options, user_input, objective, plan_ref, plan_json,
+                         prompts](size_t index, const PlanStep& step,
+                                  const std::vector<ExecutedStep>& deps) {
+        auto step_input = std::make_shared<AgentInput>(*input);
+        if (gen_input_fn) {
+            ExecutionContext exec_ctx;
+            exec_ctx.user_input = user_input;
+            exec_ctx.plan = plan_ref;
+            exec_ctx.executed_steps = deps;
+            step_input->messages = gen_input_fn(ctx, exec_ctx);
+        } else {
+            std::string prompt = kExecutorPrompt;
+            prompt = ReplaceAll(prompt, "{input}", objective);
+            prompt = ReplaceAll(prompt, "{plan}", plan_json);
+            prompt = ReplaceAll(prompt, "{executed_steps}", FormatExecutedSteps(deps));
+            prompt = ReplaceAll(prompt, "{step}", step.step);
+            step_input->messages = {prompts->Keep(schema::UserMessage(prompt))};
+        }
+        return step_agent->Run(ctx, step_input, options);
+    };
+
+    auto pair = NewAsyncIteratorPair<std::shared_ptr<AgentEvent>>();
+    auto generator = pair.second;
+    RunPlanSteps(
+        std::move(steps), std::move(runner), config_.max_parallel_steps, generator,
+        [generator, prompts, name = step_agent_->Name(ctx)](PlanStepsResult result) {
+            // Errors have already gone out as the failing step's events
+            if (result.error.empty()) {
+                auto output = std::make_shared<ExecutedStepsOutput>();
+                output->executed_steps = std::move(result.executed);
+                output->message =
+                    schema::AssistantMessage(FormatExecutedSteps(output->executed_steps));
+                auto event = std::make_shared<AgentEvent>();
+                event->agent_name = name;
+                event->output = std::make_shared<AgentOutput>();
+                event->output->message_output = std::make_shared<MessageVariant>();
+                event->output->message_output->message = &output->message;
+                event->output->message_output->role = schema::RoleType::kAssistant;
+                event->output->customized_output = output;
+                generator->Send(event);
+            }
+            generator->Close();
+        });
+    return pair.first;
+}
+
+} // namespace
+
 std::shared_ptr<Agent> NewExecutor(void* ctx, const ExecutorConfig& config) {
     // Create a ChatModelAgent configured for execution
     auto cm_config = std::make_shared<ChatModelAgentConfig>();
@@ -173,7 +310,11 @@ std::shared_ptr<Agent> NewExecutor(void* ctx, const ExecutorConfig& config) {
         return input->messages;
     };
     
-    return NewChatModelAgent(ctx, cm_config);
+    auto agent = NewChatModelAgent(ctx, cm_config);
+    if (config.max_parallel_steps > 1 && agent) {
+        return std::make_shared<ParallelExecutor>(agent, config);
+    }
+    return agent;
 }
 
 // ============================================================================
@@ -264,9 +405,46 @@ std::shared_ptr<Agent> NewPlanExecuteReplan(void* ctx, const PlanExecuteReplanCo
 // Tool Info Definitions
 // ============================================================================
 
+namespace {
+
+// PlanToolParams is the Plan tool's schema: steps as objects, each naming
+// the earlier steps it needs (see plan_steps.h)
+std::shared_ptr<schema::ParamsOneOf> PlanToolParams() {
+    auto step = std::make_shared<schema::ParameterInfo>();
+    step->type = schema::DataType::kString;
+    step->description = "What to do in this step";
+    step->required = true;
+
+    auto index = std::make_shared<schema::ParameterInfo>();
+    index->type = schema::DataType::kInteger;
+    auto depends_on = std::make_shared<schema::ParameterInfo>();
+    depends_on->type = schema::DataType::kArray;
+    depends_on->description =
+        "0-based indices of earlier steps whose results this step needs; [] if it needs none";
+    depends_on->required = true;
+    depends_on->elem_info = index;
+
+    auto item = std::make_shared<schema::ParameterInfo>();
+    item->type = schema::DataType::kObject;
+    item->sub_params = {{"step", step}, {"depends_on", depends_on}};
+
+    auto steps = std::make_shared<schema::ParameterInfo>();
+    steps->type = schema::DataType::kArray;
+    steps->description =
+        "The steps of the plan; every step comes after the steps it depends on";
+    steps->required = true;
+    steps->elem_info = item;
+
+    return std::make_shared<schema::ParamsOneOf>(
+        schema::ParamsOneOf::FromParams({{"steps", steps}}));
+}
+
+} // namespace
+
 const schema::ToolInfo kPlanToolInfo = {
     .name = "Plan",
-    .description = "Plan with a list of steps to execute in order. Each step should be clear, actionable, and arranged in a logical sequence.",
+    .description = "Plan with a list of steps. Each step should be clear and actionable, and lists in depends_on the earlier steps whose results it needs; steps that need none of each other's results can run at the same time.",
+    .params = PlanToolParams(),
 };
 
 const schema::ToolInfo kRespondToolInfo = {
@@ -287,8 +465,8 @@ Analyze the objective and generate a strategic plan that breaks down the goal in
 Each step in your plan must be:
 - **Specific and actionable**: Clear instructions that can be executed without ambiguity
 - **Self-contained**: Include all necessary context, parameters, and requirements
-- **Independently executable**: Can be performed by an agent without dependencies on other steps
-- **Logically sequenced**: Arranged in optimal order for efficient execution
+- **Explicit about dependencies**: List in depends_on the 0-based indices of the earlier steps whose results it needs, and [] if it needs none
+- **Logically sequenced**: Arranged so that every step comes after the steps it depends on
 - **Objective-focused**: Directly contribute to achieving the main goal
 
 ## PLANNING GUIDELINES
@@ -296,7 +474,7 @@ Each step in your plan must be:
 - Include relevant constraints, parameters, and success criteria for each step
 - Ensure the final step produces a complete answer or deliverable
 - Anticipate potential challenges and include mitigation strategies
-- Structure steps to build upon each other logically
+- Structure steps to build upon each other logically, but only make a step depend on another when it really needs that result: steps that do not depend on each other run at the same time
 - Provide sufficient detail for successful execution)";
 
 const std::string kExecutorPrompt = R"(You are a diligent and meticulous executor agent. Follow the given plan and execute your tasks carefully and thoroughly.
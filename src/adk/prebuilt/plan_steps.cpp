@@ -0,0 +1,347 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/prebuilt/plan_steps.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include "eino/schema/fast_json.h"
+
+namespace eino {
+namespace adk {
+namespace prebuilt {
+
+namespace {
+
+// ChainDeps is what a plain string step at index waits for
+std::vector<size_t> ChainDeps(size_t index) {
+    return index == 0 ? std::vector<size_t>{} : std::vector<size_t>{index - 1};
+}
+
+std::shared_ptr<AgentEvent> ErrorEvent(const std::string& msg) {
+    auto event = std::make_shared<AgentEvent>();
+    event->error_msg = msg;
+    return event;
+}
+
+// StepsRun is the shared state of one RunPlanSteps call
+struct StepsRun {
+    StepsRun(std::vector<PlanStep> s, StepRunner r, size_t parallel,
+             std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> o,
+             std::function<void(PlanStepsResult)> d, AgentExecutor& e)
+        : steps(std::move(s)), runner(std::move(r)), max_parallel(std::max<size_t>(parallel, 1)),
+          out(std::move(o)), on_done(std::move(d)), executor(e) {}
+
+    std::vector<PlanStep> steps;
+    StepRunner runner;
+    size_t max_parallel;
+    std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> out;
+    std::function<void(PlanStepsResult)> on_done;
+    AgentExecutor& executor;
+
+    std::mutex mutex;
+    // Unfinished dependencies of each step
+    std::vector<size_t> waiting;
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<bool> executed;
+    std::vector<std::string> results;
+    // Steps free to start, lowest index first
+    std::set<size_t> ready;
+    size_t running = 0;
+    std::string error;
+    bool finished = false;
+};
+
+// StepCapture remembers what a step emitted. Only the step's producer
+// writes it, and StepDone reads it after the step has closed
+struct StepCapture {
+    std::string last;
+    std::string error;
+};
+
+void Schedule(const std::shared_ptr<StepsRun>& run);
+
+void StepDone(const std::shared_ptr<StepsRun>& run, size_t index, const StepCapture& capture) {
+    {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        --run->running;
+        if (!capture.error.empty()) {
+            if (run->error.empty()) {
+                run->error = capture.error;
+            }
+        } else {
+            run->executed[index] = true;
+            run->results[index] = capture.last;
+            for (size_t next : run->dependents[index]) {
+                if (--run->waiting[next] == 0) {
+                    run->ready.insert(next);
+                }
+            }
+        }
+    }
+    Schedule(run);
+}
+
+void StartStep(const std::shared_ptr<StepsRun>& run, size_t index) {
+    const PlanStep& step = run->steps[index];
+    std::vector<ExecutedStep> deps;
+    {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        std::vector<size_t> order = step.depends_on;
+        std::sort(order.begin(), order.end());
+        for (size_t dep : order) {
+            deps.push_back(ExecutedStep{run->steps[dep].step, run->results[dep]});
+        }
+    }
+
+    auto capture = std::make_shared<StepCapture>();
+    std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> iter;
+    try {
+        iter = run->runner(index, step, deps);
+    } catch (const std::exception& e) {
+        capture->error = e.what();
+    }
+    if (!iter) {
+        if (capture->error.empty()) {
+            capture->error = "plan step " + std::to_string(index) + " did not start";
+        }
+        run->out->Send(ErrorEvent(capture->error));
+        StepDone(run, index, *capture);
+        return;
+    }
+
+    // The step writes straight into out; the transform only looks
+    ForwardInline<std::shared_ptr<AgentEvent>>(
+        iter, run->out,
+        [capture](std::shared_ptr<AgentEvent>& event) {
+            if (!event) {
+                return true;
+            }
+            if (event->HasError()) {
+                if (capture->error.empty()) {
+                    capture->error = !event->error_msg.empty() ? event->error_msg
+                                                               : event->error->what();
+                }
+            } else if (event->output && event->output->message_output &&
+                       !event->output->message_output->is_streaming &&
+                       event->output->message_output->message) {
+                capture->last = event->output->message_output->message->content;
+            }
+            return true;
+        },
+        [run, index, capture]() { StepDone(run, index, *capture); },
+        run->executor);
+}
+
+void Schedule(const std::shared_ptr<StepsRun>& run) {
+    std::vector<size_t> start;
+    bool done = false;
+    PlanStepsResult result;
+    {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        // A consumer that went away wants no more steps
+        if (run->error.empty() && run->out->Cancelled()) {
+            run->error = "plan steps cancelled";
+        }
+        while (run->error.empty() && run->running < run->max_parallel && !run->ready.empty()) {
+            start.push_back(*run->ready.begin());
+            run->ready.erase(run->ready.begin());
+            ++run->running;
+        }
+        if (run->running == 0 && !run->finished) {
+            run->finished = true;
+            done = true;
+            for (size_t i = 0; i < run->steps.size(); ++i) {
+                if (run->executed[i]) {
+                    result.executed.push_back(ExecutedStep{run->steps[i].step, run->results[i]});
+                }
+            }
+            result.error = run->error;
+        }
+    }
+
+    // Each step starts on its own task: Schedule runs on the thread that
+    // closed the previous step, and the runner may block
+    for (size_t index : start) {
+        run->executor.Submit([run, index]() { StartStep(run, index); });
+    }
+    if (done && run->on_done) {
+        run->on_done(std::move(result));
+    }
+}
+
+} // namespace
+
+bool PlanStepsFromJSON(const std::string& text, std::vector<PlanStep>* steps) {
+    std::vector<PlanStep> parsed;
+    bool has_steps = false;
+    try {
+        schema::JsonReader r(text);
+        std::string key;
+        r.BeginObject();
+        while (r.NextKey(&key)) {
+            if (key != "steps") {
+                r.Skip();
+                continue;
+            }
+            has_steps = true;
+            r.BeginArray();
+            while (r.NextElement()) {
+                size_t index = parsed.size();
+                PlanStep step;
+                if (r.NextIsString()) {
+                    r.ReadString(&step.step);
+                    step.depends_on = ChainDeps(index);
+                    parsed.push_back(std::move(step));
+                    continue;
+                }
+                bool named = false;
+                r.BeginObject();
+                while (r.NextKey(&key)) {
+                    if (key == "step") {
+                        r.ReadString(&step.step);
+                        named = true;
+                    } else if (key == "depends_on") {
+                        r.BeginArray();
+                        while (r.NextElement()) {
+                            // Only earlier steps: plan order is always a
+                            // valid order to run in, and cycles cannot occur
+                            int64_t dep = r.ReadInt();
+                            if (dep < 0 || static_cast<size_t>(dep) >= index) {
+                                return false;
+                            }
+                            step.depends_on.push_back(static_cast<size_t>(dep));
+                        }
+                    } else {
+                        r.Skip();
+                    }
+                }
+                if (!named) {
+                    return false;
+                }
+                std::sort(step.depends_on.begin(), step.depends_on.end());
+                step.depends_on.erase(std::unique(step.depends_on.begin(), step.depends_on.end()),
+                                      step.depends_on.end());
+                parsed.push_back(std::move(step));
+            }
+        }
+        r.ExpectEnd();
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (!has_steps || parsed.empty()) {
+        return false;
+    }
+    *steps = std::move(parsed);
+    return true;
+}
+
+bool HasIndependentSteps(const std::vector<PlanStep>& steps) {
+    // waits[i][j]: step i waits for step j, directly or not
+    std::vector<std::vector<bool>> waits(steps.size(), std::vector<bool>(steps.size(), false));
+    for (size_t i = 0; i < steps.size(); ++i) {
+        for (size_t dep : steps[i].depends_on) {
+            if (dep >= i) {
+                continue;
+            }
+            waits[i][dep] = true;
+            for (size_t j = 0; j < dep; ++j) {
+                if (waits[dep][j]) {
+                    waits[i][j] = true;
+                }
+            }
+        }
+        if (i > 0 && !waits[i][i - 1]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string PlanStepsToJSON(const std::vector<PlanStep>& steps) {
+    schema::JsonWriter w;
+    w.BeginObject();
+    w.Key("steps");
+    w.BeginArray();
+    for (size_t i = 0; i < steps.size(); ++i) {
+        std::vector<size_t> deps = steps[i].depends_on;
+        std::sort(deps.begin(), deps.end());
+        if (deps == ChainDeps(i)) {
+            w.String(steps[i].step);
+            continue;
+        }
+        w.BeginObject();
+        w.Key("step");
+        w.String(steps[i].step);
+        w.Key("depends_on");
+        w.BeginArray();
+        for (size_t dep : deps) {
+            w.Int(static_cast<int64_t>(dep));
+        }
+        w.EndArray();
+        w.EndObject();
+    }
+    w.EndArray();
+    w.EndObject();
+    return w.Take();
+}
+
+std::string FormatExecutedSteps(const std::vector<ExecutedStep>& steps) {
+    std::ostringstream os;
+    for (const auto& step : steps) {
+        os << "Step: " << step.step << "\nResult: " << step.result << "\n\n";
+    }
+    return os.str();
+}
+
+void RunPlanSteps(std::vector<PlanStep> steps, StepRunner runner, size_t max_parallel,
+                  std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> out,
+                  std::function<void(PlanStepsResult)> on_done, AgentExecutor& executor) {
+    auto run = std::make_shared<StepsRun>(std::move(steps), std::move(runner), max_parallel,
+                                          std::move(out), std::move(on_done), executor);
+    size_t n = run->steps.size();
+    run->waiting.assign(n, 0);
+    run->dependents.assign(n, {});
+    run->executed.assign(n, false);
+    run->results.assign(n, "");
+    for (size_t i = 0; i < n; ++i) {
+        std::set<size_t> deps(run->steps[i].depends_on.begin(), run->steps[i].depends_on.end());
+        for (size_t dep : deps) {
+            if (dep >= i) {
+                run->error = "plan step " + std::to_string(i) + " depends on step " +
+                             std::to_string(dep) + " that does not come before it";
+                run->out->Send(ErrorEvent(run->error));
+                break;
+            }
+            run->dependents[dep].push_back(i);
+        }
+        run->waiting[i] = deps.size();
+        if (deps.empty()) {
+            run->ready.insert(i);
+        }
+    }
+    Schedule(run);
+}
+
+}  // namespace prebuilt
+}  // namespace adk
+}  // namespace eino
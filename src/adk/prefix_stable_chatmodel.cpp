@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/prefix_stable_chatmodel.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace eino {
+namespace adk {
+
+PrefixStableChatModel::PrefixStableChatModel(
+    std::shared_ptr<components::ToolCallingChatModel> model,
+    std::shared_ptr<PromptAssembler> assembler,
+    std::vector<schema::ToolInfo> tools)
+    : model_(std::move(model)), assembler_(std::move(assembler)), tools_(std::move(tools)) {
+    if (!model_) {
+        throw std::runtime_error("PrefixStableChatModel: model is required");
+    }
+    if (!assembler_) {
+        throw std::runtime_error("PrefixStableChatModel: assembler is required");
+    }
+}
+
+schema::Message PrefixStableChatModel::Generate(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<schema::Message>& input,
+    const std::vector<compose::Option>& opts) {
+    AssembledPrompt prompt = assembler_->Assemble(tools_, input);
+    return model_->Generate(ctx, prompt.messages, opts);
+}
+
+schema::Message PrefixStableChatModel::Invoke(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<schema::Message>& input,
+    const std::vector<compose::Option>& opts) {
+    return Generate(ctx, input, opts);
+}
+
+std::shared_ptr<compose::StreamReader<schema::Message>> PrefixStableChatModel::Stream(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<schema::Message>& input,
+    const std::vector<compose::Option>& opts) {
+    AssembledPrompt prompt = assembler_->Assemble(tools_, input);
+    return model_->Stream(ctx, prompt.messages, opts);
+}
+
+schema::Message PrefixStableChatModel::Collect(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+    const std::vector<compose::Option>& opts) {
+    return model_->Collect(ctx, input, opts);
+}
+
+std::shared_ptr<compose::StreamReader<schema::Message>> PrefixStableChatModel::Transform(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+    const std::vector<compose::Option>& opts) {
+    return model_->Transform(ctx, input, opts);
+}
+
+std::shared_ptr<components::ToolCallingChatModel> PrefixStableChatModel::WithTools(
+    const std::vector<schema::ToolInfo>& tools) {
+    auto sorted = PromptAssembler::CanonicalTools(tools);
+    return std::make_shared<PrefixStableChatModel>(model_->WithTools(sorted), assembler_, sorted);
+}
+
+std::shared_ptr<PrefixStableChatModel> NewPrefixStableChatModel(
+    std::shared_ptr<components::ToolCallingChatModel> model,
+    std::shared_ptr<PromptAssembler> assembler) {
+    return std::make_shared<PrefixStableChatModel>(std::move(model), std::move(assembler));
+}
+
+}  // namespace adk
+}  // namespace eino
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/prompt_assembler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "eino/internal/metrics.h"
+#include "eino/schema/fast_json.h"
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+// PromptMetrics are recorded by PromptAssembler
+struct PromptMetrics {
+    internal::metrics::Counter prompt_bytes;
+    internal::metrics::Counter prompt_reused_bytes;
+    internal::metrics::Histogram prompt_prefix_reuse_pct;
+    internal::metrics::Counter prompt_prefix_rewrites;
+
+    static const PromptMetrics& Get() {
+        static const PromptMetrics metrics;
+        return metrics;
+    }
+
+    PromptMetrics() {
+        auto& registry = internal::metrics::Registry::Global();
+        prompt_bytes = registry.GetCounter("eino_prompt_bytes_total",
+                                           "Canonical bytes of assembled prompts");
+        prompt_reused_bytes = registry.GetCounter(
+            "eino_prompt_reused_bytes_total", "Prompt bytes repeating the previous turn's prefix");
+        prompt_prefix_reuse_pct = registry.GetHistogram(
+            "eino_prompt_prefix_reuse_pct", "Percent of each prompt repeating the previous turn");
+        prompt_prefix_rewrites = registry.GetCounter("eino_prompt_prefix_rewrites_total",
+                                                     "Turns that changed an earlier prompt");
+    }
+};
+
+size_t CommonPrefix(const std::string& a, const std::string& b) {
+    auto end = std::mismatch(a.begin(), a.begin() + std::min(a.size(), b.size()), b.begin());
+    return static_cast<size_t>(end.first - a.begin());
+}
+
+} // namespace
+
+std::vector<schema::ToolInfo> PromptAssembler::CanonicalTools(std::vector<schema::ToolInfo> tools) {
+    std::stable_sort(tools.begin(), tools.end(),
+                     [](const schema::ToolInfo& a, const schema::ToolInfo& b) {
+                         return a.name < b.name;
+                     });
+    return tools;
+}
+
+schema::Message PromptAssembler::CanonicalMessage(schema::Message msg) {
+    msg.response_meta.reset();
+    for (auto& call : msg.tool_calls) {
+        call.index = nullptr;
+    }
+    return msg;
+}
+
+std::string PromptAssembler::SerializeTools(const std::vector<schema::ToolInfo>& tools) {
+    schema::JsonWriter w;
+    w.BeginArray();
+    for (const auto& tool : tools) {
+        schema::WriteToolInfo(w, tool);
+    }
+    w.EndArray();
+    return w.Take();
+}
+
+std::string PromptAssembler::SerializeMessage(const schema::Message& msg) {
+    schema::JsonWriter w;
+    schema::WriteMessage(w, msg);
+    return w.Take();
+}
+
+void PromptAssembler::AddRewriteListener(RewriteListener listener) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    listeners_.push_back(std::move(listener));
+}
+
+bool PromptAssembler::Compare(const Prompt& next, size_t* reused, PrefixRewrite* rewrite) const {
+    *reused = 0;
+    *rewrite = PrefixRewrite();
+    rewrite->turn = stats_.turns + 1;
+    if (stats_.turns == 0) {
+        return false;
+    }
+    if (next.tools != last_.tools) {
+        *reused = CommonPrefix(last_.tools, next.tools);
+        rewrite->tools_changed = true;
+        rewrite->lost_bytes = last_.bytes - *reused;
+        return true;
+    }
+    *reused = next.tools.size();
+    size_t i = 0;
+    while (i < last_.messages.size() && i < next.messages.size() &&
+           last_.messages[i] == next.messages[i]) {
+        *reused += next.messages[i].size();
+        ++i;
+    }
+    if (i == last_.messages.size()) {
+        // Only appended
+        return false;
+    }
+    if (i < next.messages.size()) {
+        *reused += CommonPrefix(last_.messages[i], next.messages[i]);
+    }
+    rewrite->first_changed_message = i;
+    rewrite->lost_bytes = last_.bytes - *reused;
+    return true;
+}
+
+AssembledPrompt PromptAssembler::Assemble(const std::vector<schema::ToolInfo>& tools,
+                                          const std::vector<schema::Message>& messages) {
+    AssembledPrompt out;
+    out.tools = CanonicalTools(tools);
+    out.messages.reserve(messages.size());
+
+    Prompt next;
+    next.tools = SerializeTools(out.tools);
+    next.bytes = next.tools.size();
+    next.messages.reserve(messages.size());
+    for (const auto& msg : messages) {
+        out.messages.push_back(CanonicalMessage(msg));
+        next.messages.push_back(SerializeMessage(out.messages.back()));
+        next.bytes += next.messages.back().size();
+    }
+    out.bytes = next.bytes;
+
+    PrefixRewrite rewrite;
+    bool rewritten;
+    std::vector<RewriteListener> listeners;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rewritten = Compare(next, &out.reused_bytes, &rewrite);
+        ++stats_.turns;
+        stats_.bytes += out.bytes;
+        stats_.reused_bytes += out.reused_bytes;
+        if (rewritten) {
+            ++stats_.rewrites;
+            listeners = listeners_;
+        }
+        last_ = std::move(next);
+    }
+
+    const auto& metrics = PromptMetrics::Get();
+    metrics.prompt_bytes.Inc(out.bytes);
+    metrics.prompt_reused_bytes.Inc(out.reused_bytes);
+    metrics.prompt_prefix_reuse_pct.Record(static_cast<uint64_t>(out.ReuseRatio() * 100));
+    if (rewritten) {
+        metrics.prompt_prefix_rewrites.Inc();
+        for (const auto& listener : listeners) {
+            listener(rewrite);
+        }
+    }
+    return out;
+}
+
+bool PromptAssembler::CheckSerialized(std::vector<std::string> messages,
+                                      PrefixRewrite* rewrite) const {
+    Prompt next;
+    next.messages = std::move(messages);
+    std::lock_guard<std::mutex> lock(mutex_);
+    next.tools = last_.tools;
+    size_t reused;
+    return Compare(next, &reused, rewrite);
+}
+
+bool PromptAssembler::Check(const std::vector<schema::Message>& messages,
+                            PrefixRewrite* rewrite) const {
+    std::vector<std::string> serialized;
+    serialized.reserve(messages.size());
+    for (const auto& msg : messages) {
+        serialized.push_back(SerializeMessage(CanonicalMessage(msg)));
+    }
+    return CheckSerialized(std::move(serialized), rewrite);
+}
+
+bool PromptAssembler::Check(const std::vector<schema::Message*>& messages,
+                            PrefixRewrite* rewrite) const {
+    std::vector<std::string> serialized;
+    serialized.reserve(messages.size());
+    for (const auto* msg : messages) {
+        serialized.push_back(SerializeMessage(CanonicalMessage(*msg)));
+    }
+    return CheckSerialized(std::move(serialized), rewrite);
+}
+
+PromptPrefixStats PromptAssembler::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+}  // namespace adk
+}  // namespace eino
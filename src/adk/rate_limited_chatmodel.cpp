@@ -0,0 +1,199 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/rate_limited_chatmodel.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+int64_t UsedTokens(const schema::Message& msg) {
+    if (msg.response_meta && msg.response_meta->usage) {
+        return msg.response_meta->usage->total_tokens;
+    }
+    return 0;
+}
+
+// PermitStreamReader keeps a streaming call admitted until its stream
+// ends; a stream that ends in an error releases its permit as failed
+class PermitStreamReader : public compose::StreamReader<schema::Message> {
+public:
+    PermitStreamReader(std::shared_ptr<compose::StreamReader<schema::Message>> reader,
+                       ModelRateLimiter::Permit permit, IsRateLimitedFunc is_rate_limited)
+        : reader_(std::move(reader)),
+          permit_(std::move(permit)),
+          is_rate_limited_(std::move(is_rate_limited)) {}
+
+    ~PermitStreamReader() override { Finish(ModelCallOutcome::kSucceeded); }
+
+    bool Read(schema::Message& value) override {
+        bool ok = false;
+        try {
+            ok = reader_ && reader_->Read(value);
+        } catch (const std::exception& e) {
+            Finish(is_rate_limited_(e) ? ModelCallOutcome::kRateLimited
+                                       : ModelCallOutcome::kFailed);
+            throw;
+        }
+        if (!ok) {
+            Finish(ModelCallOutcome::kSucceeded);
+            return false;
+        }
+        // Providers report usage on the last chunk
+        used_ = std::max(used_, UsedTokens(value));
+        return true;
+    }
+
+    bool Peek(schema::Message& value) override { return reader_ && reader_->Peek(value); }
+
+    void Close() override {
+        if (reader_) {
+            reader_->Close();
+        }
+        Finish(ModelCallOutcome::kSucceeded);
+    }
+
+    bool IsClosed() const override { return !reader_ || reader_->IsClosed(); }
+
+private:
+    void Finish(ModelCallOutcome outcome) { permit_.Release(outcome, used_); }
+
+    std::shared_ptr<compose::StreamReader<schema::Message>> reader_;
+    ModelRateLimiter::Permit permit_;
+    IsRateLimitedFunc is_rate_limited_;
+    int64_t used_ = 0;
+};
+
+} // namespace
+
+RateLimitedChatModel::RateLimitedChatModel(
+    std::shared_ptr<components::ToolCallingChatModel> model, ModelCallConfig config,
+    const std::vector<schema::ToolInfo>& tools)
+    : model_(std::move(model)), config_(std::move(config)) {
+    if (!model_) {
+        throw std::runtime_error("RateLimitedChatModel: model is required");
+    }
+    if (!config_.limiter) {
+        throw std::runtime_error("RateLimitedChatModel: limiter is required");
+    }
+    if (!config_.is_rate_limited) {
+        config_.is_rate_limited = IsRateLimitError;
+    }
+    for (const auto& tool : tools) {
+        tools_.push_back(std::make_shared<schema::ToolInfo>(tool));
+    }
+}
+
+schema::Message RateLimitedChatModel::Generate(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<schema::Message>& input,
+    const std::vector<compose::Option>& opts) {
+    int64_t tokens = CountTokens(config_, input, tools_);
+    if (!config_.hedger) {
+        schema::Message reply;
+        CallWithLimits(config_, tokens, [&](ModelRateLimiter::Permit& permit) {
+            reply = model_->Generate(ctx, input, opts);
+            permit.Release(ModelCallOutcome::kSucceeded, UsedTokens(reply));
+        });
+        return reply;
+    }
+    // Run waits for every attempt, so they read this call's state directly
+    auto& model = model_;
+    auto& config = config_;
+    return config_.hedger->Run<schema::Message>(
+        [&model, &config, tokens, &ctx, &input, &opts](const HedgeAttempt& attempt) {
+            // Once another attempt has answered, take no permit and retry no more
+            schema::Message reply;
+            CallWithLimits(
+                config, tokens,
+                [&](ModelRateLimiter::Permit& permit) {
+                    reply = model->Generate(ctx, input, opts);
+                    permit.Release(ModelCallOutcome::kSucceeded, UsedTokens(reply));
+                },
+                [attempt]() { return attempt.Cancelled(); });
+            return reply;
+        });
+}
+
+schema::Message RateLimitedChatModel::Invoke(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<schema::Message>& input,
+    const std::vector<compose::Option>& opts) {
+    return Generate(ctx, input, opts);
+}
+
+std::shared_ptr<compose::StreamReader<schema::Message>> RateLimitedChatModel::Stream(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<schema::Message>& input,
+    const std::vector<compose::Option>& opts) {
+    std::shared_ptr<compose::StreamReader<schema::Message>> out;
+    CallWithLimits(config_, CountTokens(config_, input, tools_),
+                   [&](ModelRateLimiter::Permit& permit) {
+                       auto reader = model_->Stream(ctx, input, opts);
+                       out = std::make_shared<PermitStreamReader>(
+                           std::move(reader), std::move(permit), config_.is_rate_limited);
+                   });
+    return out;
+}
+
+schema::Message RateLimitedChatModel::Collect(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+    const std::vector<compose::Option>& opts) {
+    // The call consumes its input, so it is neither estimated nor retried
+    ModelCallConfig once = config_;
+    once.retry.max_retries = 0;
+    schema::Message reply;
+    CallWithLimits(once, 0, [&](ModelRateLimiter::Permit& permit) {
+        reply = model_->Collect(ctx, input, opts);
+        permit.Release(ModelCallOutcome::kSucceeded, UsedTokens(reply));
+    });
+    return reply;
+}
+
+std::shared_ptr<compose::StreamReader<schema::Message>> RateLimitedChatModel::Transform(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<std::vector<schema::Message>>> input,
+    const std::vector<compose::Option>& opts) {
+    ModelCallConfig once = config_;
+    once.retry.max_retries = 0;
+    std::shared_ptr<compose::StreamReader<schema::Message>> out;
+    CallWithLimits(once, 0, [&](ModelRateLimiter::Permit& permit) {
+        auto reader = model_->Transform(ctx, input, opts);
+        out = std::make_shared<PermitStreamReader>(std::move(reader), std::move(permit),
+                                                   config_.is_rate_limited);
+    });
+    return out;
+}
+
+std::shared_ptr<components::ToolCallingChatModel> RateLimitedChatModel::WithTools(
+    const std::vector<schema::ToolInfo>& tools) {
+    return std::make_shared<RateLimitedChatModel>(model_->WithTools(tools), config_, tools);
+}
+
+std::shared_ptr<RateLimitedChatModel> NewRateLimitedChatModel(
+    std::shared_ptr<components::ToolCallingChatModel> model,
+    ModelCallConfig config) {
+    return std::make_shared<RateLimitedChatModel>(std::move(model), std::move(config));
+}
+
+}  // namespace adk
+}  // namespace eino
@@ -17,9 +17,9 @@
 #include "../include/eino/adk/runner.h"
 #include "../include/eino/adk/context.h"
 #include "../include/eino/adk/flow_agent.h"
+#include "../include/eino/adk/session_host.h"
 #include "../include/eino/schema/types.h"
 #include <nlohmann/json.hpp>
-#include <thread>
 #include <chrono>
 
 namespace eino {
@@ -82,9 +82,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> Runner::Run(
     auto pair = NewAsyncIteratorPair<std::shared_ptr<AgentEvent>>();
     auto checkpoint_id = common_opts.checkpoint_id ? *common_opts.checkpoint_id : "";
     
-    std::thread([this, ctx, agent_iter, gen = pair.second, checkpoint_id]() {
-        HandleIteratorWithCheckpoint(ctx, agent_iter, gen, checkpoint_id);
-    }).detach();
+    HandleIteratorWithCheckpoint(ctx, agent_iter, pair.second, checkpoint_id);
 
     return pair.first;
 }
@@ -201,9 +199,7 @@ std::pair<std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>>, std::stri
         // Wrap the iterator to save checkpoints during execution
         auto pair = NewAsyncIteratorPair<std::shared_ptr<AgentEvent>>();
         
-        std::thread([this, ctx, agent_iter, gen = pair.second, checkpoint_id]() {
-            HandleIteratorWithCheckpoint(ctx, agent_iter, gen, checkpoint_id);
-        }).detach();
+        HandleIteratorWithCheckpoint(ctx, agent_iter, pair.second, checkpoint_id);
 
         return {pair.first, ""};
         
@@ -244,104 +240,118 @@ void Runner::HandleIteratorWithCheckpoint(
     std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> gen,
     const std::string& checkpoint_id) {
     
-    try {
+    // Written by the transform on the agent's sending thread and read by
+    // on_done, which runs after the agent's Close
+    struct Collected {
         std::shared_ptr<AgentEvent> interrupt_event;
         std::vector<std::shared_ptr<AgentEvent>> all_events;
         std::vector<Message> accumulated_messages;
-        
-        while (true) {
-            std::shared_ptr<AgentEvent> event;
-            if (!agent_iter->Next(event)) {
-                break;
-            }
-
+    };
+    auto collected = std::make_shared<Collected>();
+    
+    // Splice the agent into gen: its events reach the caller without an
+    // extra queue hop, and are recorded for the checkpoint on the way
+    ForwardInline<std::shared_ptr<AgentEvent>>(
+        agent_iter,
+        gen,
+        [collected](std::shared_ptr<AgentEvent>& event) {
             // Collect events for checkpoint serialization
-            all_events.push_back(event);
+            collected->all_events.push_back(event);
 
             // Accumulate messages from events
             if (event && event->message) {
-                accumulated_messages.push_back(*event->message);
+                collected->accumulated_messages.push_back(*event->message);
             }
 
             // Check for interrupt
             if (event && event->action && 
                 (event->action->interrupted || event->action->break_loop)) {
-                interrupt_event = event;
+                collected->interrupt_event = event;
             }
-
-            gen->Send(event);
-        }
-
-        // Save checkpoint if we have interrupt data and a checkpoint store
-        if (interrupt_event && checkpoint_store_ && !checkpoint_id.empty()) {
+            return true;
+        },
+        [this, ctx, collected, gen, checkpoint_id]() {
             try {
-                nlohmann::json checkpoint_json;
-                
-                // Save accumulated messages
-                checkpoint_json["messages"] = accumulated_messages;
-                
-                // Save interrupt state
-                checkpoint_json["interrupted"] = true;
-                checkpoint_json["interrupt_reason"] = interrupt_event->action->interrupted 
-                    ? "interrupted" : "break_loop";
+                SaveCheckpoint(ctx, collected->interrupt_event,
+                               collected->accumulated_messages, checkpoint_id);
+            } catch (const std::exception& e) {
+                auto error_event = std::make_shared<AgentEvent>();
+                error_event->error_msg = std::string("Runner: ") + e.what();
+                gen->Send(error_event);
+            }
+            gen->Close();
+        });
+}
+
+void Runner::SaveCheckpoint(
+    void* ctx,
+    const std::shared_ptr<AgentEvent>& interrupt_event,
+    const std::vector<Message>& accumulated_messages,
+    const std::string& checkpoint_id) {
+    
+    // Save checkpoint if we have interrupt data and a checkpoint store
+    if (interrupt_event && checkpoint_store_ && !checkpoint_id.empty()) {
+        try {
+            nlohmann::json checkpoint_json;
+            
+            // Save accumulated messages
+            checkpoint_json["messages"] = accumulated_messages;
+            
+            // Save interrupt state
+            checkpoint_json["interrupted"] = true;
+            checkpoint_json["interrupt_reason"] = interrupt_event->action->interrupted 
+                ? "interrupted" : "break_loop";
+            
+            // Save session state if available from context
+            // Aligns with: eino/compose/graph_run.go:479-483 (state saving)
+            auto exec_ctx = context::GetExecutionContext(ctx);
+            if (exec_ctx) {
+                nlohmann::json session_state = nlohmann::json::object();
                 
-                // Save session state if available from context
-                // Aligns with: eino/compose/graph_run.go:479-483 (state saving)
-                auto exec_ctx = context::GetExecutionContext(ctx);
-                if (exec_ctx) {
-                    nlohmann::json session_state = nlohmann::json::object();
-                    
-                    // Extract session values from execution context
-                    if (!exec_ctx->session_values.empty()) {
-                        for (const auto& [key, value] : exec_ctx->session_values) {
-                            try {
-                                // Convert std::any to JSON
-                                // This requires proper type handling
-                                if (value.type() == typeid(std::string)) {
-                                    session_state[key] = std::any_cast<std::string>(value);
-                                } else if (value.type() == typeid(int)) {
-                                    session_state[key] = std::any_cast<int>(value);
-                                } else if (value.type() == typeid(double)) {
-                                    session_state[key] = std::any_cast<double>(value);
-                                } else if (value.type() == typeid(bool)) {
-                                    session_state[key] = std::any_cast<bool>(value);
-                                } else if (value.type() == typeid(nlohmann::json)) {
-                                    session_state[key] = std::any_cast<nlohmann::json>(value);
-                                }
-                                // Add more type conversions as needed
-                            } catch (const std::bad_any_cast& e) {
-                                // Skip values that cannot be converted
-                                std::cerr << "Runner: failed to convert session value '" << key << "': " << e.what() << std::endl;
+                // Extract session values from execution context
+                if (!exec_ctx->session_values.empty()) {
+                    for (const auto& [key, value] : exec_ctx->session_values) {
+                        try {
+                            // Convert std::any to JSON
+                            // This requires proper type handling
+                            if (value.type() == typeid(std::string)) {
+                                session_state[key] = std::any_cast<std::string>(value);
+                            } else if (value.type() == typeid(int)) {
+                                session_state[key] = std::any_cast<int>(value);
+                            } else if (value.type() == typeid(double)) {
+                                session_state[key] = std::any_cast<double>(value);
+                            } else if (value.type() == typeid(bool)) {
+                                session_state[key] = std::any_cast<bool>(value);
+                            } else if (value.type() == typeid(nlohmann::json)) {
+                                session_state[key] = std::any_cast<nlohmann::json>(value);
                             }
+                            // Add more type conversions as needed
+                        } catch (const std::bad_any_cast& e) {
+                            // Skip values that cannot be converted
+                            std::cerr << "Runner: failed to convert session value '" << key << "': " << e.what() << std::endl;
                         }
                     }
-                    
-                    checkpoint_json["session_state"] = session_state;
-                }
-                
-                // Save agent state if available
-                if (interrupt_event->state) {
-                    checkpoint_json["agent_state"] = *interrupt_event->state;
                 }
                 
-                // Save timestamp
-                checkpoint_json["timestamp"] = std::chrono::system_clock::now().time_since_epoch().count();
-                
-                // Serialize and save
-                std::string serialized = checkpoint_json.dump();
-                checkpoint_store_->Save(checkpoint_id, serialized);
-                
-            } catch (const std::exception& e) {
-                std::cerr << "Runner: failed to save checkpoint: " << e.what() << std::endl;
+                checkpoint_json["session_state"] = session_state;
+            }
+            
+            // Save agent state if available
+            if (interrupt_event->state) {
+                checkpoint_json["agent_state"] = *interrupt_event->state;
             }
+            
+            // Save timestamp
+            checkpoint_json["timestamp"] = std::chrono::system_clock::now().time_since_epoch().count();
+            
+            // Serialize and save
+            std::string serialized = checkpoint_json.dump();
+            checkpoint_store_->Save(checkpoint_id, serialized);
+            
+        } catch (const std::exception& e) {
+            std::cerr << "Runner: failed to save checkpoint: " << e.what() << std::endl;
         }
-    } catch (const std::exception& e) {
-        auto error_event = std::make_shared<AgentEvent>();
-        error_event->error_msg = std::string("Runner: ") + e.what();
-        gen->Send(error_event);
     }
-
-    gen->Close();
 }
 
 std::shared_ptr<Runner> NewRunner(const RunnerConfig& config) {
@@ -352,5 +362,16 @@ std::shared_ptr<Runner> NewRunner(std::shared_ptr<Agent> agent) {
     return std::make_shared<Runner>(agent);
 }
 
+// Defined here rather than in session_host.cpp, which stays free of the
+// Runner's dependencies
+std::shared_ptr<SessionHost> NewSessionHost(std::shared_ptr<Runner> runner,
+                                            const SessionHostConfig& config) {
+    return std::make_shared<SessionHost>(
+        [runner](const SessionRequest& request) {
+            return runner->Run(request.ctx, request.messages, request.options);
+        },
+        config);
+}
+
 }  // namespace adk
 }  // namespace eino
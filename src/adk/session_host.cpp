@@ -0,0 +1,278 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/session_host.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "eino/internal/metrics.h"
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+// SessionMetrics are recorded by SessionHost admission
+struct SessionMetrics {
+    internal::metrics::HistogramFamily session_queue_ns;
+    internal::metrics::Counter sessions_admitted;
+    internal::metrics::Counter sessions_rejected;
+
+    static const SessionMetrics& Get() {
+        static const SessionMetrics metrics;
+        return metrics;
+    }
+
+    SessionMetrics()
+        : session_queue_ns("eino_session_queue_ns",
+                           "Time a hosted session waited for admission", "lane") {
+        auto& registry = internal::metrics::Registry::Global();
+        sessions_admitted = registry.GetCounter("eino_sessions_admitted_total",
+                                                "Hosted sessions admitted to run");
+        sessions_rejected = registry.GetCounter("eino_sessions_rejected_total",
+                                                "Hosted sessions refused by admission control");
+    }
+};
+
+const char* LaneName(SessionLane lane) {
+    return lane == SessionLane::kBatch ? "batch" : "interactive";
+}
+
+std::shared_ptr<AgentEvent> ErrorEvent(const std::string& msg) {
+    auto event = std::make_shared<AgentEvent>();
+    event->error_msg = "SessionHost: " + msg;
+    return event;
+}
+
+} // namespace
+
+struct SessionHost::Ticket {
+    SessionRequest request;
+    std::shared_ptr<AsyncGenerator<std::shared_ptr<AgentEvent>>> gen;
+    uint64_t submit_ns = 0;
+    // Waiting in a lane; cleared under mutex_ on admission or withdrawal
+    bool queued = false;
+};
+
+SessionHost::SessionHost(Starter starter, const SessionHostConfig& config,
+                         AgentExecutor& executor)
+    : starter_(std::move(starter)), config_(config), executor_(executor) {
+    config_.max_active = std::max<size_t>(config_.max_active, 1);
+}
+
+SessionHost::EventIterator SessionHost::Submit(const SessionRequest& request) {
+    auto pair = NewAsyncIteratorPair<std::shared_ptr<AgentEvent>>();
+    auto ticket = std::make_shared<Ticket>();
+    ticket->request = request;
+    ticket->gen = pair.second;
+    ticket->submit_ns = internal::metrics::NowNs();
+
+    bool start_now = false;
+    bool rejected = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t queued = interactive_.queued + batch_.queued;
+        if (stats_.active < config_.max_active && queued == 0) {
+            ++stats_.active;
+            ++stats_.admitted;
+            stats_.peak_active = std::max(stats_.peak_active, stats_.active);
+            start_now = true;
+        } else if (config_.max_queued > 0 && queued >= config_.max_queued) {
+            rejected = true;
+        } else {
+            const std::string& tenant = request.tenant;
+            Lane& lane = LaneOf(request.lane);
+            if (config_.max_queued_per_tenant > 0) {
+                size_t mine = 0;
+                for (Lane* l : {&interactive_, &batch_}) {
+                    auto it = l->tenants.find(tenant);
+                    mine += it == l->tenants.end() ? 0 : it->second.queued;
+                }
+                rejected = mine >= config_.max_queued_per_tenant;
+            }
+            if (!rejected) {
+                auto weight = config_.tenant_weights.find(tenant);
+                double share = weight == config_.tenant_weights.end() || weight->second == 0
+                                   ? 1.0
+                                   : static_cast<double>(weight->second);
+                // A session costs 1/weight of virtual time, starting no
+                // earlier than the lane's clock or the tenant's last one
+                auto& state = lane.tenants[tenant];
+                state.finish = std::max(lane.virtual_time, state.finish) + 1.0 / share;
+                ++state.queued;
+                ++lane.queued;
+                lane.heap.push(Entry{state.finish, next_seq_++, ticket});
+                ticket->queued = true;
+            }
+        }
+        if (rejected) {
+            ++stats_.rejected;
+        }
+    }
+
+    if (rejected) {
+        SessionMetrics::Get().sessions_rejected.Inc();
+        pair.second->Send(ErrorEvent("too many sessions waiting"));
+        pair.second->Close();
+        return pair.first;
+    }
+    if (start_now) {
+        Start(ticket);
+        return pair.first;
+    }
+
+    // A caller that drops the iterator while waiting gives up the place.
+    // The hook holds the ticket weakly: the ticket owns the generator
+    std::weak_ptr<SessionHost> weak_host = shared_from_this();
+    std::weak_ptr<Ticket> weak_ticket = ticket;
+    pair.second->OnCancel([weak_host, weak_ticket]() {
+        auto host = weak_host.lock();
+        auto ticket = weak_ticket.lock();
+        if (host && ticket) {
+            host->Withdraw(ticket);
+        }
+    });
+    return pair.first;
+}
+
+void SessionHost::SetTenantWeight(const std::string& tenant, uint32_t weight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_.tenant_weights[tenant] = weight;
+}
+
+SessionHostStats SessionHost::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SessionHostStats stats = stats_;
+    stats.queued_interactive = interactive_.queued;
+    stats.queued_batch = batch_.queued;
+    return stats;
+}
+
+std::shared_ptr<SessionHost::Ticket> SessionHost::NextLocked() {
+    // Batch waits behind interactive work, but never for more than
+    // interactive_burst admissions at a time
+    if (batch_.queued > 0 &&
+        (interactive_.queued == 0 || interactive_streak_ >= config_.interactive_burst)) {
+        interactive_streak_ = 0;
+        return PopLocked(batch_);
+    }
+    if (interactive_.queued > 0) {
+        if (batch_.queued > 0) {
+            ++interactive_streak_;
+        }
+        return PopLocked(interactive_);
+    }
+    return nullptr;
+}
+
+std::shared_ptr<SessionHost::Ticket> SessionHost::PopLocked(Lane& lane) {
+    while (!lane.heap.empty()) {
+        Entry entry = lane.heap.top();
+        lane.heap.pop();
+        // Withdrawn entries are left in the heap and skipped here
+        if (!entry.ticket->queued) {
+            continue;
+        }
+        lane.virtual_time = entry.finish;
+        ForgetLocked(lane, entry.ticket);
+        return entry.ticket;
+    }
+    return nullptr;
+}
+
+void SessionHost::ForgetLocked(Lane& lane, const std::shared_ptr<Ticket>& ticket) {
+    ticket->queued = false;
+    --lane.queued;
+    auto it = lane.tenants.find(ticket->request.tenant);
+    // A tenant with nothing waiting starts afresh from the lane's clock
+    if (it != lane.tenants.end() && --it->second.queued == 0) {
+        lane.tenants.erase(it);
+    }
+}
+
+void SessionHost::Start(const std::shared_ptr<Ticket>& ticket) {
+    const auto& metrics = SessionMetrics::Get();
+    metrics.sessions_admitted.Inc();
+    metrics.session_queue_ns.WithLabel(LaneName(ticket->request.lane))
+        .Record(internal::metrics::NowNs() - ticket->submit_ns);
+
+    auto self = shared_from_this();
+    auto gen = ticket->gen;
+    EventIterator iter;
+    std::string error;
+    try {
+        iter = starter_(ticket->request);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    if (!iter) {
+        gen->Send(ErrorEvent(error.empty() ? "session did not start" : error));
+        gen->Close();
+        Finish();
+        return;
+    }
+
+    // The agent writes straight into the caller's iterator; its Close
+    // frees the slot
+    ForwardInline<std::shared_ptr<AgentEvent>>(
+        iter, gen, nullptr,
+        [self, gen]() {
+            gen->Close();
+            self->Finish();
+        },
+        executor_);
+}
+
+void SessionHost::Withdraw(const std::shared_ptr<Ticket>& ticket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ticket->queued) {
+        return;
+    }
+    ForgetLocked(LaneOf(ticket->request.lane), ticket);
+    ++stats_.withdrawn;
+}
+
+void SessionHost::Finish() {
+    std::vector<std::shared_ptr<Ticket>> admitted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --stats_.active;
+        ++stats_.completed;
+        while (stats_.active < config_.max_active) {
+            auto ticket = NextLocked();
+            if (!ticket) {
+                break;
+            }
+            ++stats_.active;
+            ++stats_.admitted;
+            admitted.push_back(std::move(ticket));
+        }
+        stats_.peak_active = std::max(stats_.peak_active, stats_.active);
+    }
+
+    // Start each on its own task: Finish runs on the thread that closed the
+    // last session, and a session that ends inside Start would otherwise
+    // start the next one deeper on the same stack
+    auto self = shared_from_this();
+    for (auto& ticket : admitted) {
+        executor_.Submit([self, ticket]() { self->Start(ticket); });
+    }
+}
+
+}  // namespace adk
+}  // namespace eino
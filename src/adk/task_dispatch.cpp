@@ -0,0 +1,182 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/task_dispatch.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace eino {
+namespace adk {
+
+namespace {
+
+// DispatchRun is the shared state of one DispatchTasks call
+struct DispatchRun {
+    DispatchRun(void* c, std::vector<SubAgentTask> t, SubAgentStarter s,
+                const schema::MessageHistory& p, const TaskDispatchConfig& cfg, AgentExecutor& e)
+        : ctx(c), tasks(std::move(t)), starter(std::move(s)), parent(p), config(cfg),
+          executor(e) {
+        config.max_concurrent_tasks = std::max<size_t>(config.max_concurrent_tasks, 1);
+    }
+
+    void* ctx;
+    std::vector<SubAgentTask> tasks;
+    SubAgentStarter starter;
+    schema::MessageHistory parent;
+    TaskDispatchConfig config;
+    AgentExecutor& executor;
+    std::shared_ptr<AsyncGenerator<SubAgentResult>> out;
+
+    std::mutex mutex;
+    size_t next = 0;
+    size_t running = 0;
+    bool closed = false;
+};
+
+void StartMore(const std::shared_ptr<DispatchRun>& run);
+
+void Finish(const std::shared_ptr<DispatchRun>& run, SubAgentResult result) {
+    run->out->Send(std::move(result));
+    {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        --run->running;
+    }
+    StartMore(run);
+}
+
+void StartTask(const std::shared_ptr<DispatchRun>& run, size_t index) {
+    const SubAgentTask& task = run->tasks[index];
+    auto result = std::make_shared<SubAgentResult>();
+    result->index = index;
+    result->call_id = task.call_id;
+    result->subagent_type = task.subagent_type;
+
+    auto context = std::make_shared<SubAgentContext>(task, run->parent,
+                                                     run->config.inherit_history);
+    SubAgentEventIterator iter;
+    try {
+        iter = run->starter(run->ctx, context);
+    } catch (const std::exception& e) {
+        result->error = e.what();
+    }
+    if (!iter) {
+        if (result->error.empty()) {
+            result->error = "subagent type '" + task.subagent_type + "' not found";
+        }
+        Finish(run, std::move(*result));
+        return;
+    }
+
+    // The pump holds no thread while the sub-agent works; the context
+    // lives until the sub-agent is done with its messages
+    PumpAsync<std::shared_ptr<AgentEvent>>(
+        iter,
+        [run, result](std::shared_ptr<AgentEvent>& event) {
+            if (event && event->HasError()) {
+                if (result->error.empty()) {
+                    result->error = !event->error_msg.empty() ? event->error_msg
+                                                              : event->error->what();
+                }
+            } else if (event && event->output && event->output->message_output &&
+                       !event->output->message_output->is_streaming &&
+                       event->output->message_output->message) {
+                result->result = event->output->message_output->message->content;
+            }
+            // Nobody is waiting for the result any more
+            return !run->out->Cancelled();
+        },
+        [run, result, context]() { Finish(run, std::move(*result)); },
+        [result](std::exception_ptr error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                result->error = e.what();
+            } catch (...) {
+                result->error = "unknown error while reading subagent events";
+            }
+        },
+        run->executor);
+}
+
+void StartMore(const std::shared_ptr<DispatchRun>& run) {
+    std::vector<size_t> start;
+    bool close = false;
+    {
+        std::lock_guard<std::mutex> lock(run->mutex);
+        bool cancelled = run->out->Cancelled();
+        while (!cancelled && run->running < run->config.max_concurrent_tasks &&
+               run->next < run->tasks.size()) {
+            start.push_back(run->next++);
+            ++run->running;
+        }
+        if (run->running == 0 && (cancelled || run->next == run->tasks.size()) && !run->closed) {
+            run->closed = true;
+            close = true;
+        }
+    }
+    for (size_t index : start) {
+        run->executor.Submit([run, index]() { StartTask(run, index); });
+    }
+    if (close) {
+        run->out->Close();
+    }
+}
+
+} // namespace
+
+SubAgentContext::SubAgentContext(const SubAgentTask& task, const schema::MessageHistory& parent,
+                                 bool inherit_history)
+    : task_(task),
+      history_((inherit_history ? parent : schema::MessageHistory())
+                   .Append(schema::MessageRef::From(schema::UserMessage(task.description)))) {}
+
+const std::vector<Message>& SubAgentContext::Messages() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!materialized_) {
+        storage_ = history_.ToMessages();
+        messages_.reserve(storage_.size());
+        for (auto& msg : storage_) {
+            messages_.push_back(&msg);
+        }
+        materialized_ = true;
+    }
+    return messages_;
+}
+
+bool SubAgentContext::Materialized() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return materialized_;
+}
+
+std::shared_ptr<AsyncIterator<SubAgentResult>> DispatchTasks(
+    void* ctx,
+    std::vector<SubAgentTask> tasks,
+    SubAgentStarter starter,
+    const schema::MessageHistory& parent,
+    const TaskDispatchConfig& config,
+    AgentExecutor& executor) {
+    auto pair = NewAsyncIteratorPair<SubAgentResult>();
+    auto run = std::make_shared<DispatchRun>(ctx, std::move(tasks), std::move(starter), parent,
+                                             config, executor);
+    run->out = pair.second;
+    StartMore(run);
+    return pair.first;
+}
+
+}  // namespace adk
+}  // namespace eino
@@ -17,11 +17,12 @@
 #include "eino/adk/task_tool.h"
 
 #include <sstream>
+#include <stdexcept>
 #include <nlohmann/json.hpp>
 
-#include "eino/adk/agent_tool.h"
 #include "eino/adk/chat_model_agent.h"
 #include "eino/adk/prompts.h"
+#include "eino/schema/fast_json.h"
 
 namespace eino {
 namespace adk {
@@ -35,18 +36,37 @@ namespace {
         "for a keyword or file and are not confident that you will find the right "
         "match in the first few tries use this agent to perform the search for you. "
         "This agent has access to all tools as the main agent.";
+
+    // ParseTaskArguments reads {"subagent_type", "description"} into task
+    void ParseTaskArguments(const std::string& arguments_json, SubAgentTask* task) {
+        schema::JsonReader r(arguments_json);
+        std::string key;
+        r.BeginObject();
+        while (r.NextKey(&key)) {
+            if (key == "subagent_type") {
+                r.ReadString(&task->subagent_type);
+            } else if (key == "description") {
+                r.ReadString(&task->description);
+            } else {
+                r.Skip();
+            }
+        }
+    }
 } // anonymous namespace
 
 // TaskTool implementation
 
 TaskTool::TaskTool(
     void* ctx,
-    std::map<std::string, std::shared_ptr<Tool>> sub_agents,
     std::vector<std::shared_ptr<Agent>> sub_agent_slice,
-    TaskToolDescriptionGenerator desc_gen)
-    : sub_agents_(std::move(sub_agents))
-    , sub_agent_slice_(std::move(sub_agent_slice))
-    , desc_gen_(desc_gen ? desc_gen : DefaultTaskToolDescription) {
+    TaskToolDescriptionGenerator desc_gen,
+    const TaskDispatchConfig& dispatch)
+    : sub_agent_slice_(std::move(sub_agent_slice))
+    , desc_gen_(desc_gen ? desc_gen : DefaultTaskToolDescription)
+    , dispatch_(dispatch) {
+    for (const auto& agent : sub_agent_slice_) {
+        agents_by_name_[agent->Name(ctx)] = agent;
+    }
 }
 
 ToolInfo TaskTool::Info(void* ctx) const {
@@ -73,31 +93,59 @@ std::string TaskTool::InvokableRun(
     const std::string& arguments_json,
     const std::vector<ToolOption>& opts) {
     
-    // Parse input arguments
     // 对齐 eino/adk/prebuilt/deep/task_tool.go:142-160
-    try {
-        auto args = nlohmann::json::parse(arguments_json);
-        
-        std::string subagent_type = args["subagent_type"];
-        std::string description = args["description"];
-        
-        // Find the subagent
-        auto it = sub_agents_.find(subagent_type);
-        if (it == sub_agents_.end()) {
-            return "Error: subagent type '" + subagent_type + "' not found";
+    // One call is a turn of one task: it runs in its own SubAgentContext
+    schema::ToolCall call;
+    call.function.arguments = arguments_json;
+    auto results = RunTasks(ctx, {call}, schema::MessageHistory());
+    SubAgentResult result;
+    if (!results->Next(result)) {
+        return "Error running task: no result";
+    }
+    if (!result.error.empty()) {
+        return "Error: " + result.error;
+    }
+    return result.result;
+}
+
+std::shared_ptr<AsyncIterator<SubAgentResult>> TaskTool::RunTasks(
+    void* ctx,
+    const std::vector<schema::ToolCall>& calls,
+    const schema::MessageHistory& parent_history) {
+
+    std::vector<SubAgentTask> tasks;
+    // Calls whose arguments did not parse fail when their turn comes
+    auto parse_errors = std::make_shared<std::map<std::string, std::string>>();
+    for (const auto& call : calls) {
+        SubAgentTask task;
+        task.call_id = call.id;
+        try {
+            ParseTaskArguments(call.function.arguments, &task);
+        } catch (const std::exception& e) {
+            (*parse_errors)[call.id] =
+                std::string("Error parsing task tool arguments: ") + e.what();
         }
-        
-        // Prepare agent tool input
-        nlohmann::json agent_input{
-            {"request", description}
-        };
-        
-        // Invoke the subagent
-        return it->second->InvokableRun(ctx, agent_input.dump(), opts);
-        
-    } catch (const std::exception& e) {
-        return std::string("Error parsing task tool arguments: ") + e.what();
+        tasks.push_back(std::move(task));
     }
+
+    auto agents = agents_by_name_;
+    SubAgentStarter starter = [agents, parse_errors](
+        void* ctx, const std::shared_ptr<SubAgentContext>& context) -> SubAgentEventIterator {
+        auto error = parse_errors->find(context->Task().call_id);
+        if (error != parse_errors->end()) {
+            throw std::runtime_error(error->second);
+        }
+        auto it = agents.find(context->Task().subagent_type);
+        if (it == agents.end()) {
+            return nullptr;
+        }
+        // The sub-agent reads the context's messages; the dispatcher keeps
+        // the context alive until the sub-agent is done
+        auto input = std::make_shared<AgentInput>();
+        input->messages = context->Messages();
+        return it->second->Run(ctx, input, {});
+    };
+    return DispatchTasks(ctx, std::move(tasks), std::move(starter), parent_history, dispatch_);
 }
 
 std::string TaskTool::DefaultTaskToolDescription(
@@ -135,11 +183,11 @@ std::pair<std::shared_ptr<TaskTool>, std::string> NewTaskTool(
     const std::string& instruction,
     const ToolsConfig& tools_config,
     int max_iteration,
-    const std::vector<AgentMiddleware>& middlewares) {
+    const std::vector<AgentMiddleware>& middlewares,
+    const TaskDispatchConfig& dispatch) {
     
     // 对齐 eino/adk/prebuilt/deep/task_tool.go:56-111
     
-    std::map<std::string, std::shared_ptr<Tool>> sub_agent_tools;
     std::vector<std::shared_ptr<Agent>> sub_agent_slice = sub_agents;
     
     // Create general-purpose agent if needed
@@ -158,33 +206,14 @@ std::pair<std::shared_ptr<TaskTool>, std::string> NewTaskTool(
             return {nullptr, "Failed to create general-purpose agent"};
         }
         
-        // Convert to AgentTool
-        auto agent_tool = NewAgentTool(ctx, general_agent);
-        if (!agent_tool) {
-            return {nullptr, "Failed to create AgentTool for general agent"};
-        }
-        
-        sub_agent_tools[kGeneralAgentName] = agent_tool;
         sub_agent_slice.push_back(general_agent);
     }
     
-    // Convert all subagents to tools
-    for (const auto& agent : sub_agents) {
-        std::string name = agent->Name(ctx);
-        
-        auto agent_tool = NewAgentTool(ctx, agent);
-        if (!agent_tool) {
-            return {nullptr, "Failed to create AgentTool for " + name};
-        }
-        
-        sub_agent_tools[name] = agent_tool;
-    }
-    
     auto task_tool = std::make_shared<TaskTool>(
         ctx, 
-        sub_agent_tools, 
         sub_agent_slice,
-        task_tool_desc_gen);
+        task_tool_desc_gen,
+        dispatch);
     
     return {task_tool, ""};
 }
@@ -198,7 +227,8 @@ std::pair<AgentMiddleware, std::string> NewTaskToolMiddleware(
     const std::string& instruction,
     const ToolsConfig& tools_config,
     int max_iteration,
-    const std::vector<AgentMiddleware>& middlewares) {
+    const std::vector<AgentMiddleware>& middlewares,
+    const TaskDispatchConfig& dispatch) {
     
     // 对齐 eino/adk/prebuilt/deep/task_tool.go:34-55
     
@@ -211,7 +241,8 @@ std::pair<AgentMiddleware, std::string> NewTaskToolMiddleware(
         instruction,
         tools_config,
         max_iteration,
-        middlewares);
+        middlewares,
+        dispatch);
     
     if (!err.empty()) {
         return {AgentMiddleware{}, err};
@@ -279,61 +279,52 @@ public:
         auto iterator = pair.first;
         auto generator = pair.second;
         
-        // Launch thread to forward events and append transfers
-        std::thread([inner_iter, generator, to_agent_names = to_agent_names_, ctx]() {
-            bool interrupted = false;
-            
-            // Forward all events from inner agent
-            while (true) {
-                std::shared_ptr<AgentEvent> event;
-                if (!inner_iter->Next(event)) {
-                    break;
-                }
-                
-                generator->Send(event);
-                
+        // Splice the inner agent into generator, then append transfers
+        // once it closes; the flag is only touched on its sending thread
+        auto interrupted = std::make_shared<bool>(false);
+        ForwardInline<std::shared_ptr<AgentEvent>>(
+            inner_iter,
+            generator,
+            [interrupted](std::shared_ptr<AgentEvent>& event) {
                 // Track if agent was interrupted
-                if (event && event->action && event->action->interrupted) {
-                    interrupted = true;
-                } else {
-                    interrupted = false;
-                }
-            }
-            
-            // If not interrupted, append transfer actions
-            if (!interrupted) {
-                for (const auto& to_agent_name : to_agent_names) {
-                    auto [a_msg, t_msg] = GenTransferMessages(ctx, to_agent_name);
+                *interrupted = event && event->action && event->action->interrupted;
+                return true;
+            },
+            [generator, interrupted, to_agent_names = to_agent_names_, ctx]() {
+                // If not interrupted, append transfer actions
+                if (!*interrupted) {
+                    for (const auto& to_agent_name : to_agent_names) {
+                        auto [a_msg, t_msg] = GenTransferMessages(ctx, to_agent_name);
                     
-                    // Send assistant message event
-                    auto a_event = std::make_shared<AgentEvent>();
-                    a_event->output = std::make_shared<AgentOutput>();
-                    a_event->output->message_output = std::make_shared<MessageOutput>();
-                    a_event->output->message_output->is_streaming = false;
-                    a_event->output->message_output->message = std::make_shared<Message>(a_msg);
-                    a_event->output->message_output->role = schema::RoleType::Assistant;
-                    generator->Send(a_event);
+                        // Send assistant message event
+                        auto a_event = std::make_shared<AgentEvent>();
+                        a_event->output = std::make_shared<AgentOutput>();
+                        a_event->output->message_output = std::make_shared<MessageOutput>();
+                        a_event->output->message_output->is_streaming = false;
+                        a_event->output->message_output->message = std::make_shared<Message>(a_msg);
+                        a_event->output->message_output->role = schema::RoleType::Assistant;
+                        generator->Send(a_event);
                     
-                    // Send tool message event with transfer action
-                    auto t_event = std::make_shared<AgentEvent>();
-                    t_event->output = std::make_shared<AgentOutput>();
-                    t_event->output->message_output = std::make_shared<MessageOutput>();
-                    t_event->output->message_output->is_streaming = false;
-                    t_event->output->message_output->message = std::make_shared<Message>(t_msg);
-                    t_event->output->message_output->role = schema::RoleType::Tool;
-                    t_event->output->message_output->tool_name = t_msg.tool_name;
+                        // Send tool message event with transfer action
+                        auto t_event = std::make_shared<AgentEvent>();
+                        t_event->output = std::make_shared<AgentOutput>();
+                        t_event->output->message_output = std::make_shared<MessageOutput>();
+                        t_event->output->message_output->is_streaming = false;
+                        t_event->output->message_output->message = std::make_shared<Message>(t_msg);
+                        t_event->output->message_output->role = schema::RoleType::Tool;
+                        t_event->output->message_output->tool_name = t_msg.tool_name;
                     
-                    // Add transfer action
-                    t_event->action = std::make_shared<AgentAction>();
-                    t_event->action->transfer_to_agent = std::make_shared<TransferToAgentAction>();
-                    t_event->action->transfer_to_agent->dest_agent_name = to_agent_name;
+                        // Add transfer action
+                        t_event->action = std::make_shared<AgentAction>();
+                        t_event->action->transfer_to_agent = std::make_shared<TransferToAgentAction>();
+                        t_event->action->transfer_to_agent->dest_agent_name = to_agent_name;
                     
-                    generator->Send(t_event);
+                        generator->Send(t_event);
+                    }
                 }
-            }
-            
-            generator->Close();
-        }).detach();
+                
+                generator->Close();
+            });
         
         return iterator;
     }
@@ -16,8 +16,8 @@
 
 #include "../include/eino/adk/workflow.h"
 #include "../include/eino/adk/context.h"
-#include <thread>
-#include <future>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
 namespace eino {
@@ -120,41 +120,59 @@ void WorkflowAgent::ExecuteParallelInternal(
     const std::shared_ptr<WorkflowInterruptInfo>& interrupt_info) {
 
     auto sub_agents = GetSubAgents();
-    std::vector<std::future<void>> futures;
     std::vector<std::shared_ptr<AgentEvent>> interrupt_events;
     std::mutex interrupt_mutex;
+    std::condition_variable done_cv;
+    size_t pending = sub_agents.size();
 
-    // Launch parallel execution
+    // Splice every sub-agent into gen; each sends from its own thread and
+    // none of them holds one of ours while its agent is busy
     for (size_t i = 0; i < sub_agents.size(); ++i) {
         auto agent = sub_agents[i];
-        size_t agent_index = i;
-
-        futures.push_back(std::async(std::launch::async, [this, ctx, input, options, agent, agent_index, 
-                                                         interrupt_info, gen, &interrupt_events, 
-                                                         &interrupt_mutex]() {
-            auto agent_iter = agent->Run(ctx, input, options);
-            std::shared_ptr<AgentEvent> event;
-            
-            while (agent_iter->Next(event)) {
-                if (event && event->action && event->action->interrupted) {
-                    std::lock_guard<std::mutex> lock(interrupt_mutex);
-                    interrupt_events.push_back(event);
-                    break;
-                }
-                gen->Send(event);
+        auto finish = [&interrupt_mutex, &done_cv, &pending]() {
+            std::lock_guard<std::mutex> lock(interrupt_mutex);
+            if (--pending == 0) {
+                done_cv.notify_one();
             }
-        }));
-    }
+        };
 
-    // Wait for all tasks
-    for (auto& fut : futures) {
+        std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> agent_iter;
         try {
-            fut.get();
+            agent_iter = agent->Run(ctx, input, options);
         } catch (const std::exception& e) {
             auto error_event = std::make_shared<AgentEvent>();
             error_event->error_msg = std::string("Parallel execution error: ") + e.what();
             gen->Send(error_event);
+            finish();
+            continue;
         }
+
+        // An interrupt is held back for the combined one below, and
+        // anything the agent sends after it is dropped
+        auto interrupted = std::make_shared<bool>(false);
+        ForwardInline<std::shared_ptr<AgentEvent>>(
+            agent_iter,
+            gen,
+            [interrupted, &interrupt_events, &interrupt_mutex](std::shared_ptr<AgentEvent>& event) {
+                if (*interrupted) {
+                    return false;
+                }
+                if (event && event->action && event->action->interrupted) {
+                    *interrupted = true;
+                    std::lock_guard<std::mutex> lock(interrupt_mutex);
+                    interrupt_events.push_back(event);
+                    return false;
+                }
+                return true;
+            },
+            finish);
+    }
+
+    // Wait for all sub-agents
+    {
+        AgentExecutor::BlockingScope blocking;
+        std::unique_lock<std::mutex> lock(interrupt_mutex);
+        done_cv.wait(lock, [&pending]() { return pending == 0; });
     }
 
     // Handle interrupts
@@ -240,7 +258,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> SequentialAgent::Run
     auto iter = pair.first;
     auto gen = pair.second;
 
-    std::thread([this, ctx, input, options, gen]() {
+    AgentExecutor::Default().Submit([this, ctx, input, options, gen]() {
         try {
             ExecuteSequentialInternal(ctx, input, options, gen);
         } catch (const std::exception& e) {
@@ -249,7 +267,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> SequentialAgent::Run
             gen->Send(error_event);
         }
         gen->Close();
-    }).detach();
+    });
 
     return iter;
 }
@@ -263,7 +281,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> SequentialAgent::Res
     auto iter = pair.first;
     auto gen = pair.second;
 
-    std::thread([this, ctx, info, options, gen]() {
+    AgentExecutor::Default().Submit([this, ctx, info, options, gen]() {
         try {
             auto interrupt_info = std::static_pointer_cast<WorkflowInterruptInfo>(
                 std::shared_ptr<void>(info->interrupt_info.data));
@@ -274,7 +292,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> SequentialAgent::Res
             gen->Send(error_event);
         }
         gen->Close();
-    }).detach();
+    });
 
     return iter;
 }
@@ -301,7 +319,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ParallelAgent::Run(
     auto iter = pair.first;
     auto gen = pair.second;
 
-    std::thread([this, ctx, input, options, gen]() {
+    AgentExecutor::Default().Submit([this, ctx, input, options, gen]() {
         try {
             ExecuteParallelInternal(ctx, input, options, gen);
         } catch (const std::exception& e) {
@@ -310,7 +328,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ParallelAgent::Run(
             gen->Send(error_event);
         }
         gen->Close();
-    }).detach();
+    });
 
     return iter;
 }
@@ -324,7 +342,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ParallelAgent::Resum
     auto iter = pair.first;
     auto gen = pair.second;
 
-    std::thread([this, ctx, info, options, gen]() {
+    AgentExecutor::Default().Submit([this, ctx, info, options, gen]() {
         try {
             auto interrupt_info = std::static_pointer_cast<WorkflowInterruptInfo>(
                 std::shared_ptr<void>(info->interrupt_info.data));
@@ -335,7 +353,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> ParallelAgent::Resum
             gen->Send(error_event);
         }
         gen->Close();
-    }).detach();
+    });
 
     return iter;
 }
@@ -362,7 +380,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> LoopAgent::Run(
     auto iter = pair.first;
     auto gen = pair.second;
 
-    std::thread([this, ctx, input, options, gen]() {
+    AgentExecutor::Default().Submit([this, ctx, input, options, gen]() {
         try {
             ExecuteLoopInternal(ctx, input, options, gen);
         } catch (const std::exception& e) {
@@ -371,7 +389,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> LoopAgent::Run(
             gen->Send(error_event);
         }
         gen->Close();
-    }).detach();
+    });
 
     return iter;
 }
@@ -385,7 +403,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> LoopAgent::Resume(
     auto iter = pair.first;
     auto gen = pair.second;
 
-    std::thread([this, ctx, info, options, gen]() {
+    AgentExecutor::Default().Submit([this, ctx, info, options, gen]() {
         try {
             auto interrupt_info = std::static_pointer_cast<WorkflowInterruptInfo>(
                 std::shared_ptr<void>(info->interrupt_info.data));
@@ -396,7 +414,7 @@ std::shared_ptr<AsyncIterator<std::shared_ptr<AgentEvent>>> LoopAgent::Resume(
             gen->Send(error_event);
         }
         gen->Close();
-    }).detach();
+    });
 
     return iter;
 }
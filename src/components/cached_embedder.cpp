@@ -0,0 +1,475 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/components/prebuilt/cached_embedder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace eino {
+namespace components {
+
+namespace {
+
+const uint64_t kFNVOffsetBasis = 14695981039346656037ULL;
+const uint64_t kFNVPrime = 1099511628211ULL;
+
+uint64_t FNV1a(uint64_t h, const char* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= kFNVPrime;
+    }
+    return h;
+}
+
+uint64_t Mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t WordHash(uint64_t h, const char* data, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = Mix64(h ^ word) * 0x9e3779b97f4a7c15ULL;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, len - i);
+    return Mix64(h ^ tail ^ (static_cast<uint64_t>(len) << 56));
+}
+
+size_t VectorBytes(const std::vector<double>& vec) {
+    return vec.size() * sizeof(double);
+}
+
+} // namespace
+
+std::string EmbeddingCacheKey::Hex() const {
+    char buf[33];
+    std::snprintf(buf, sizeof(buf), "%016llx%016llx",
+                  static_cast<unsigned long long>(hi),
+                  static_cast<unsigned long long>(lo));
+    return std::string(buf, 32);
+}
+
+CachedEmbedder::CachedEmbedder(const CachedEmbedderConfig& config)
+    : config_(config) {
+    if (!config_.embedder) {
+        throw std::invalid_argument("CachedEmbedder: embedder is required");
+    }
+    if (config_.max_batch_size == 0) {
+        config_.max_batch_size = std::numeric_limits<size_t>::max();
+    }
+    if (config_.max_batch_delay.count() > 0) {
+        batcher_ = std::thread(&CachedEmbedder::BatcherLoop, this);
+    }
+}
+
+CachedEmbedder::~CachedEmbedder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    if (batcher_.joinable()) {
+        batcher_.join();
+    }
+}
+
+EmbeddingCacheKey CachedEmbedder::HashText(const std::string& text,
+                                           const std::vector<compose::Option>& opts) const {
+    EmbeddingCacheKey key;
+    const std::string& ns = config_.cache_namespace;
+    key.hi = FNV1a(kFNVOffsetBasis, ns.data(), ns.size());
+    key.hi = FNV1a(key.hi, "\0", 1);
+    key.lo = WordHash(Mix64(ns.size() + 1), ns.data(), ns.size());
+    // Options select the model, dimensions and the like; Option is an
+    // ordered map, so its dump is the same for equal options
+    for (const auto& opt : opts) {
+        std::string dumped = nlohmann::json(opt).dump();
+        key.hi = FNV1a(key.hi, dumped.data(), dumped.size());
+        key.hi = FNV1a(key.hi, "\0", 1);
+        key.lo = WordHash(key.lo, dumped.data(), dumped.size());
+    }
+    key.hi = FNV1a(key.hi, text.data(), text.size());
+    key.lo = WordHash(key.lo, text.data(), text.size());
+    return key;
+}
+
+bool CachedEmbedder::LookupLocked(const EmbeddingCacheKey& key, std::vector<double>& out) {
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    out = it->second.vector;
+    return true;
+}
+
+void CachedEmbedder::InsertLocked(
+    const EmbeddingCacheKey& key,
+    const std::vector<double>& vec,
+    std::vector<std::pair<EmbeddingCacheKey, std::vector<double>>>& evicted) {
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+        return;
+    }
+
+    lru_.push_front(key);
+    CacheEntry entry;
+    entry.vector = vec;
+    entry.lru_it = lru_.begin();
+    cached_bytes_ += VectorBytes(vec);
+    cache_.emplace(key, std::move(entry));
+
+    while (cached_bytes_ > config_.max_cache_bytes && !lru_.empty()) {
+        auto victim = cache_.find(lru_.back());
+        cached_bytes_ -= VectorBytes(victim->second.vector);
+        if (!config_.spill_dir.empty()) {
+            evicted.emplace_back(victim->first, std::move(victim->second.vector));
+        }
+        cache_.erase(victim);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+std::string CachedEmbedder::SpillPath(const EmbeddingCacheKey& key) const {
+    return config_.spill_dir + "/" + key.Hex() + ".emb";
+}
+
+bool CachedEmbedder::LoadSpilled(const EmbeddingCacheKey& key, std::vector<double>& out) const {
+    std::ifstream file(SpillPath(key), std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamoff size = file.tellg();
+    if (size < static_cast<std::streamoff>(sizeof(uint64_t))) {
+        return false;
+    }
+    file.seekg(0);
+
+    uint64_t count = 0;
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || static_cast<std::streamoff>(sizeof(count) + count * sizeof(double)) != size) {
+        return false;
+    }
+    out.resize(static_cast<size_t>(count));
+    file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(count * sizeof(double)));
+    return static_cast<bool>(file);
+}
+
+void CachedEmbedder::Spill(
+    const std::vector<std::pair<EmbeddingCacheKey, std::vector<double>>>& evicted) const {
+    for (const auto& kv : evicted) {
+        // Write to a temp file and rename so readers never see partial vectors
+        std::string path = SpillPath(kv.first);
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                continue;
+            }
+            uint64_t count = kv.second.size();
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            file.write(reinterpret_cast<const char*>(kv.second.data()),
+                       static_cast<std::streamsize>(count * sizeof(double)));
+            if (!file) {
+                file.close();
+                std::remove(tmp.c_str());
+                continue;
+            }
+        }
+        std::rename(tmp.c_str(), path.c_str());
+    }
+}
+
+void CachedEmbedder::EmbedBatch(
+    std::shared_ptr<compose::Context> ctx,
+    std::vector<PendingText>& batch,
+    const std::vector<compose::Option>& opts) {
+    std::vector<PendingText*> remaining;
+    remaining.reserve(batch.size());
+
+    // Serve spilled vectors before calling the wrapped embedder
+    if (!config_.spill_dir.empty()) {
+        std::vector<std::pair<PendingText*, std::vector<double>>> loaded;
+        for (auto& p : batch) {
+            std::vector<double> vec;
+            if (LoadSpilled(p.key, vec)) {
+                loaded.emplace_back(&p, std::move(vec));
+            } else {
+                remaining.push_back(&p);
+            }
+        }
+        if (!loaded.empty()) {
+            std::vector<std::pair<EmbeddingCacheKey, std::vector<double>>> evicted;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto& kv : loaded) {
+                    InsertLocked(kv.first->key, kv.second, evicted);
+                    inflight_.erase(kv.first->key);
+                    stats_.disk_hits++;
+                }
+            }
+            Spill(evicted);
+            for (auto& kv : loaded) {
+                kv.first->promise->set_value(std::move(kv.second));
+            }
+        }
+    } else {
+        for (auto& p : batch) {
+            remaining.push_back(&p);
+        }
+    }
+
+    size_t end = 0;
+    for (size_t start = 0; start < remaining.size(); start = end) {
+        end = start + std::min(config_.max_batch_size, remaining.size() - start);
+        std::vector<std::string> texts;
+        texts.reserve(end - start);
+        for (size_t i = start; i < end; ++i) {
+            texts.push_back(remaining[i]->text);
+        }
+
+        std::vector<std::vector<double>> vecs;
+        try {
+            vecs = config_.embedder->Invoke(ctx, texts, opts);
+            if (vecs.size() != texts.size()) {
+                throw std::runtime_error(
+                    "CachedEmbedder: embedder returned " + std::to_string(vecs.size()) +
+                    " vectors for " + std::to_string(texts.size()) + " texts");
+            }
+        } catch (...) {
+            auto error = std::current_exception();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (size_t i = start; i < end; ++i) {
+                    inflight_.erase(remaining[i]->key);
+                }
+            }
+            for (size_t i = start; i < end; ++i) {
+                remaining[i]->promise->set_exception(error);
+            }
+            continue;
+        }
+
+        std::vector<std::pair<EmbeddingCacheKey, std::vector<double>>> evicted;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.embedder_calls++;
+            stats_.embedded_texts += texts.size();
+            for (size_t i = start; i < end; ++i) {
+                InsertLocked(remaining[i]->key, vecs[i - start], evicted);
+                inflight_.erase(remaining[i]->key);
+            }
+        }
+        Spill(evicted);
+        for (size_t i = start; i < end; ++i) {
+            remaining[i]->promise->set_value(std::move(vecs[i - start]));
+        }
+    }
+}
+
+void CachedEmbedder::BatcherLoop() {
+    while (true) {
+        std::vector<PendingText> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // stopping with nothing left to flush
+            }
+
+            // Wait until the batch is full or its oldest text hits the budget
+            auto deadline = queue_.front().enqueued_at + config_.max_batch_delay;
+            while (!stopping_ && queue_.size() < config_.max_batch_size) {
+                if (queue_cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+                    break;
+                }
+            }
+
+            size_t n = std::min(queue_.size(), config_.max_batch_size);
+            batch.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+        // The batch runs under its oldest request's context
+        auto ctx = batch.front().ctx ? batch.front().ctx : compose::Context::Background();
+        EmbedBatch(ctx, batch, std::vector<compose::Option>());
+    }
+}
+
+std::vector<std::vector<double>> CachedEmbedder::Invoke(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<std::string>& input,
+    const std::vector<compose::Option>& opts) {
+    if (input.empty()) {
+        return std::vector<std::vector<double>>();
+    }
+
+    // Deduplicate within the request: slot[i] indexes the unique text of input[i]
+    std::unordered_map<EmbeddingCacheKey, size_t, EmbeddingCacheKeyHash> unique_index;
+    std::vector<EmbeddingCacheKey> unique_keys;
+    std::vector<size_t> unique_first;
+    std::vector<size_t> slot(input.size());
+    unique_index.reserve(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        EmbeddingCacheKey key = HashText(input[i], opts);
+        auto ins = unique_index.emplace(key, unique_keys.size());
+        if (ins.second) {
+            unique_keys.push_back(key);
+            unique_first.push_back(i);
+        }
+        slot[i] = ins.first->second;
+    }
+
+    std::vector<std::vector<double>> unique_vecs(unique_keys.size());
+    std::vector<std::pair<size_t, EmbeddingFuture>> waits;
+    std::vector<PendingText> misses;
+    bool coalesce = opts.empty() && batcher_.joinable();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.requested_texts += input.size();
+        stats_.deduplicated += input.size() - unique_keys.size();
+
+        auto now = std::chrono::steady_clock::now();
+        for (size_t u = 0; u < unique_keys.size(); ++u) {
+            const EmbeddingCacheKey& key = unique_keys[u];
+            if (LookupLocked(key, unique_vecs[u])) {
+                stats_.memory_hits++;
+                continue;
+            }
+            auto inflight = inflight_.find(key);
+            if (inflight != inflight_.end()) {
+                stats_.inflight_hits++;
+                waits.emplace_back(u, inflight->second);
+                continue;
+            }
+
+            PendingText pending;
+            pending.key = key;
+            pending.text = input[unique_first[u]];
+            pending.ctx = ctx;
+            pending.promise = std::make_shared<std::promise<std::vector<double>>>();
+            pending.enqueued_at = now;
+            EmbeddingFuture future = pending.promise->get_future().share();
+            inflight_.emplace(key, future);
+            waits.emplace_back(u, future);
+            misses.push_back(std::move(pending));
+        }
+
+        if (coalesce) {
+            for (auto& pending : misses) {
+                queue_.push_back(std::move(pending));
+            }
+        }
+    }
+
+    if (coalesce) {
+        if (!misses.empty()) {
+            queue_cv_.notify_one();
+        }
+    } else if (!misses.empty()) {
+        EmbedBatch(ctx, misses, opts);
+    }
+
+    for (auto& w : waits) {
+        unique_vecs[w.first] = w.second.get();  // rethrows embedder failures
+    }
+
+    std::vector<std::vector<double>> result;
+    result.reserve(input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        result.push_back(unique_vecs[slot[i]]);
+    }
+    return result;
+}
+
+std::shared_ptr<compose::StreamReader<std::vector<std::vector<double>>>> CachedEmbedder::Stream(
+    std::shared_ptr<compose::Context> ctx,
+    const std::vector<std::string>& input,
+    const std::vector<compose::Option>& opts) {
+    auto embeddings = Invoke(ctx, input, opts);
+    auto reader = std::make_shared<compose::SimpleStreamReader<std::vector<std::vector<double>>>>();
+    reader->Add(embeddings);
+    return reader;
+}
+
+std::vector<std::vector<double>> CachedEmbedder::Collect(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<std::vector<std::string>>> input,
+    const std::vector<compose::Option>& opts) {
+    std::vector<std::vector<double>> result;
+    std::vector<std::string> texts;
+
+    while (input->Read(texts)) {
+        auto embeddings = Invoke(ctx, texts, opts);
+        result.insert(result.end(), embeddings.begin(), embeddings.end());
+    }
+
+    return result;
+}
+
+std::shared_ptr<compose::StreamReader<std::vector<std::vector<double>>>> CachedEmbedder::Transform(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<std::vector<std::string>>> input,
+    const std::vector<compose::Option>& opts) {
+    auto reader = std::make_shared<compose::SimpleStreamReader<std::vector<std::vector<double>>>>();
+    std::vector<std::string> texts;
+
+    while (input->Read(texts)) {
+        auto embeddings = Invoke(ctx, texts, opts);
+        reader->Add(embeddings);
+    }
+
+    return reader;
+}
+
+CachedEmbedderStats CachedEmbedder::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CachedEmbedderStats stats = stats_;
+    stats.cached_entries = cache_.size();
+    stats.cached_bytes = cached_bytes_;
+    return stats;
+}
+
+void CachedEmbedder::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    lru_.clear();
+    cached_bytes_ = 0;
+}
+
+std::shared_ptr<CachedEmbedder> NewCachedEmbedder(const CachedEmbedderConfig& config) {
+    return std::make_shared<CachedEmbedder>(config);
+}
+
+} // namespace components
+} // namespace eino
@@ -0,0 +1,528 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/components/prebuilt/directory_loader.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace eino {
+namespace components {
+
+namespace {
+
+// Upper bound on walked-but-unread paths so the walker cannot run far ahead
+const size_t kMaxQueuedFiles = 4096;
+
+std::string ErrnoMessage(const std::string& what, const std::string& path) {
+    return what + " " + path + ": " + std::strerror(errno);
+}
+
+bool MatchAny(const std::vector<std::string>& patterns, const std::string& rel_path) {
+    std::string::size_type slash = rel_path.rfind('/');
+    std::string base = slash == std::string::npos ? rel_path : rel_path.substr(slash + 1);
+    for (const auto& pattern : patterns) {
+        const std::string& subject =
+            pattern.find('/') == std::string::npos ? base : rel_path;
+        if (fnmatch(pattern.c_str(), subject.c_str(), 0) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct FileTask {
+    std::string path;
+    size_t size = 0;
+};
+
+struct LoadedChunk {
+    std::vector<schema::Document> docs;
+    size_t bytes = 0;
+};
+
+// LoadState is shared by the walker, the readers and the consumer stream
+struct LoadState {
+    DirectoryLoaderConfig config;
+
+    // Roots come either from a fixed list or lazily from an input stream
+    std::vector<std::string> roots;
+    std::shared_ptr<compose::StreamReader<schema::Source>> root_stream;
+
+    std::mutex mutex;
+    std::condition_variable work_cv;    // work queued / walk finished / closed
+    std::condition_variable space_cv;   // work queue drained
+    std::condition_variable out_cv;     // chunk ready / load finished
+    std::condition_variable budget_cv;  // in-flight bytes released
+
+    std::deque<FileTask> work;
+    std::deque<LoadedChunk> out;
+    bool walk_done = false;
+    size_t busy_readers = 0;
+    size_t inflight_bytes = 0;
+    bool closed = false;
+    std::exception_ptr error;
+
+    // Directories already walked, by (st_dev, st_ino); only the walker
+    // touches it, and only when following symlinks
+    std::set<std::pair<dev_t, ino_t>> visited_dirs;
+
+    bool Finished() const {
+        return out.empty() && walk_done && work.empty() && busy_readers == 0;
+    }
+
+    void Fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = e;
+        }
+        closed = true;
+        work_cv.notify_all();
+        space_cv.notify_all();
+        out_cv.notify_all();
+        budget_cv.notify_all();
+    }
+};
+
+// Enqueue blocks while the work queue is full; returns false once closed
+bool Enqueue(LoadState& state, FileTask task) {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.space_cv.wait(lock, [&state] {
+        return state.closed || state.work.size() < kMaxQueuedFiles;
+    });
+    if (state.closed) {
+        return false;
+    }
+    state.work.push_back(std::move(task));
+    state.work_cv.notify_one();
+    return true;
+}
+
+// WalkError fails the load when fail_fast is set; otherwise the path is
+// reported to on_error and the walk skips it
+void WalkError(LoadState& state, const std::string& path, const std::string& error) {
+    if (state.config.fail_fast) {
+        throw std::runtime_error(error);
+    }
+    if (state.config.on_error) {
+        state.config.on_error(path, error);
+    }
+}
+
+// FirstVisit records dir as walked; false if a symlink already led there
+bool FirstVisit(LoadState& state, const struct stat& st) {
+    if (!state.config.follow_symlinks) {
+        return true;
+    }
+    return state.visited_dirs.insert(std::make_pair(st.st_dev, st.st_ino)).second;
+}
+
+bool IsClosed(LoadState& state) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.closed;
+}
+
+// WalkDir queues matching files below dir; returns false once closed
+bool WalkDir(LoadState& state, const std::string& root, const std::string& rel_dir) {
+    std::string dir_path = rel_dir.empty() ? root : root + "/" + rel_dir;
+    DIR* dir = opendir(dir_path.c_str());
+    if (dir == nullptr) {
+        WalkError(state, dir_path, ErrnoMessage("DirectoryLoader: cannot open directory", dir_path));
+        return true;
+    }
+    std::unique_ptr<DIR, int (*)(DIR*)> guard(dir, closedir);
+
+    std::vector<std::string> subdirs;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        const char* name = entry->d_name;
+        if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) {
+            continue;
+        }
+        std::string rel = rel_dir.empty() ? std::string(name) : rel_dir + "/" + name;
+        std::string path = root + "/" + rel;
+
+        struct stat st;
+        int rc = state.config.follow_symlinks ? stat(path.c_str(), &st) : lstat(path.c_str(), &st);
+        if (rc != 0) {
+            continue;  // entry vanished while walking
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            if (state.config.recursive &&
+                !MatchAny(state.config.exclude_patterns, rel) && FirstVisit(state, st)) {
+                subdirs.push_back(rel);
+            }
+        } else if (S_ISREG(st.st_mode)) {
+            if (state.config.max_file_bytes > 0 &&
+                static_cast<size_t>(st.st_size) > state.config.max_file_bytes) {
+                continue;
+            }
+            if (!DirectoryLoader::MatchFile(state.config, rel)) {
+                continue;
+            }
+            FileTask task;
+            task.path = path;
+            task.size = static_cast<size_t>(st.st_size);
+            if (!Enqueue(state, std::move(task))) {
+                return false;
+            }
+        }
+    }
+    guard.reset();
+
+    for (const auto& sub : subdirs) {
+        if (!WalkDir(state, root, sub)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WalkRoot(LoadState& state, const std::string& root) {
+    if (root.find("://") != std::string::npos) {
+        WalkError(state, root, "DirectoryLoader: remote URI not supported: " + root);
+        return true;
+    }
+    struct stat st;
+    if (stat(root.c_str(), &st) != 0) {
+        WalkError(state, root, ErrnoMessage("DirectoryLoader: cannot stat", root));
+        return true;
+    }
+    if (S_ISREG(st.st_mode)) {
+        FileTask task;
+        task.path = root;
+        task.size = static_cast<size_t>(st.st_size);
+        return Enqueue(state, std::move(task));
+    }
+    std::string trimmed = root;
+    while (trimmed.size() > 1 && trimmed.back() == '/') {
+        trimmed.pop_back();
+    }
+    if (!FirstVisit(state, st)) {
+        return true;
+    }
+    return WalkDir(state, trimmed, "");
+}
+
+void WalkerLoop(std::shared_ptr<LoadState> state) {
+    try {
+        if (state->root_stream) {
+            schema::Source source;
+            while (!IsClosed(*state) && state->root_stream->Read(source)) {
+                if (!WalkRoot(*state, source.uri)) {
+                    break;
+                }
+            }
+        } else {
+            for (const auto& root : state->roots) {
+                if (!WalkRoot(*state, root)) {
+                    break;
+                }
+            }
+        }
+    } catch (...) {
+        state->Fail(std::current_exception());
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->walk_done = true;
+    state->work_cv.notify_all();
+    state->out_cv.notify_all();
+}
+
+void ReaderLoop(std::shared_ptr<LoadState> state) {
+    const DirectoryLoaderConfig& config = state->config;
+    while (true) {
+        FileTask task;
+        size_t cost = 0;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->work_cv.wait(lock, [&state] {
+                return state->closed || !state->work.empty() || state->walk_done;
+            });
+            if (state->closed || state->work.empty()) {
+                return;
+            }
+            task = std::move(state->work.front());
+            state->work.pop_front();
+            state->space_cv.notify_one();
+            state->busy_readers++;
+
+            // Admit the file against the in-flight byte budget
+            cost = task.size;
+            state->budget_cv.wait(lock, [&state, &config, cost] {
+                return state->closed || state->inflight_bytes == 0 ||
+                       state->inflight_bytes + cost <= config.max_inflight_bytes;
+            });
+            if (state->closed) {
+                state->busy_readers--;
+                state->out_cv.notify_all();
+                return;
+            }
+            state->inflight_bytes += cost;
+        }
+
+        LoadedChunk chunk;
+        chunk.bytes = cost;
+        std::string error;
+        try {
+            std::string content = DirectoryLoader::ReadFileContent(task.path);
+            if (!content.empty()) {
+                schema::Document doc;
+                doc.id = task.path;
+                doc.page_content = std::move(content);
+                doc.metadata["source"] = task.path;
+                chunk.docs.push_back(std::move(doc));
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+            if (config.fail_fast) {
+                state->Fail(std::current_exception());
+            }
+        }
+
+        if (!error.empty() && !config.fail_fast && config.on_error) {
+            config.on_error(task.path, error);
+        }
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->busy_readers--;
+        if (chunk.docs.empty()) {
+            state->inflight_bytes -= cost;
+            state->budget_cv.notify_all();
+        } else {
+            state->out.push_back(std::move(chunk));
+        }
+        state->out_cv.notify_one();
+    }
+}
+
+// DirectoryLoadStream emits loaded chunks; closing it stops the load
+class DirectoryLoadStream : public compose::StreamReader<std::vector<schema::Document>> {
+public:
+    explicit DirectoryLoadStream(std::shared_ptr<LoadState> state)
+        : state_(state), closed_(false) {
+        size_t workers = state_->config.num_workers;
+        if (workers == 0) {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads_.emplace_back(WalkerLoop, state_);
+        for (size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back(ReaderLoop, state_);
+        }
+    }
+
+    ~DirectoryLoadStream() override {
+        Close();
+    }
+
+    bool Read(std::vector<schema::Document>& value) override {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        if (!WaitForChunk(lock)) {
+            return false;
+        }
+        LoadedChunk chunk = std::move(state_->out.front());
+        state_->out.pop_front();
+        state_->inflight_bytes -= chunk.bytes;
+        state_->budget_cv.notify_all();
+        value = std::move(chunk.docs);
+        return true;
+    }
+
+    bool Peek(std::vector<schema::Document>& value) override {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        if (!WaitForChunk(lock)) {
+            return false;
+        }
+        value = state_->out.front().docs;
+        return true;
+    }
+
+    void Close() override {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->closed = true;
+        }
+        state_->work_cv.notify_all();
+        state_->space_cv.notify_all();
+        state_->out_cv.notify_all();
+        state_->budget_cv.notify_all();
+        if (state_->root_stream) {
+            state_->root_stream->Close();
+        }
+        for (auto& t : threads_) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+    }
+
+    bool IsClosed() const override {
+        return closed_;
+    }
+
+private:
+    // WaitForChunk waits for a chunk; rethrows a load failure once all
+    // chunks loaded before it have been delivered
+    bool WaitForChunk(std::unique_lock<std::mutex>& lock) {
+        if (closed_) {
+            return false;
+        }
+        state_->out_cv.wait(lock, [this] {
+            return !state_->out.empty() || state_->Finished() || state_->error;
+        });
+        if (!state_->out.empty()) {
+            return true;
+        }
+        if (state_->error) {
+            std::rethrow_exception(state_->error);
+        }
+        return false;
+    }
+
+    std::shared_ptr<LoadState> state_;
+    std::vector<std::thread> threads_;
+    bool closed_;
+};
+
+std::shared_ptr<LoadState> NewLoadState(const DirectoryLoaderConfig& config) {
+    auto state = std::make_shared<LoadState>();
+    state->config = config;
+    if (state->config.max_inflight_bytes == 0) {
+        state->config.max_inflight_bytes = static_cast<size_t>(-1);
+    }
+    return state;
+}
+
+} // namespace
+
+DirectoryLoader::DirectoryLoader(const DirectoryLoaderConfig& config)
+    : config_(config) {
+}
+
+bool DirectoryLoader::MatchFile(const DirectoryLoaderConfig& config, const std::string& rel_path) {
+    if (!config.include_patterns.empty() && !MatchAny(config.include_patterns, rel_path)) {
+        return false;
+    }
+    return !MatchAny(config.exclude_patterns, rel_path);
+}
+
+std::string DirectoryLoader::ReadFileContent(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(ErrnoMessage("DirectoryLoader: cannot open", path));
+    }
+    std::unique_ptr<int, void (*)(int*)> fd_guard(&fd, [](int* f) { close(*f); });
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        throw std::runtime_error(ErrnoMessage("DirectoryLoader: cannot stat", path));
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+        return std::string();
+    }
+
+    // Document owns its text as a std::string, so the bytes are copied
+    // once whatever the source; read() into the string is that copy, where
+    // mmap would add the mapping and page faults on top of it
+    std::string content(size, '\0');
+    size_t offset = 0;
+    while (offset < size) {
+        ssize_t n = read(fd, &content[offset], size - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(ErrnoMessage("DirectoryLoader: cannot read", path));
+        }
+        if (n == 0) {
+            break;  // file shrank while reading
+        }
+        offset += static_cast<size_t>(n);
+    }
+    content.resize(offset);
+    return content;
+}
+
+std::vector<schema::Document> DirectoryLoader::Invoke(
+    std::shared_ptr<compose::Context> ctx,
+    const schema::Source& input,
+    const std::vector<compose::Option>& opts) {
+    std::vector<schema::Document> result;
+    auto reader = Stream(ctx, input, opts);
+    std::vector<schema::Document> docs;
+    while (reader->Read(docs)) {
+        for (auto& doc : docs) {
+            result.push_back(std::move(doc));
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<compose::StreamReader<std::vector<schema::Document>>> DirectoryLoader::Stream(
+    std::shared_ptr<compose::Context> ctx,
+    const schema::Source& input,
+    const std::vector<compose::Option>& opts) {
+    auto state = NewLoadState(config_);
+    state->roots.push_back(input.uri);
+    return std::make_shared<DirectoryLoadStream>(state);
+}
+
+std::vector<schema::Document> DirectoryLoader::Collect(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<schema::Source>> input,
+    const std::vector<compose::Option>& opts) {
+    std::vector<schema::Document> result;
+    auto reader = Transform(ctx, input, opts);
+    std::vector<schema::Document> docs;
+    while (reader->Read(docs)) {
+        for (auto& doc : docs) {
+            result.push_back(std::move(doc));
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<compose::StreamReader<std::vector<schema::Document>>> DirectoryLoader::Transform(
+    std::shared_ptr<compose::Context> ctx,
+    std::shared_ptr<compose::StreamReader<schema::Source>> input,
+    const std::vector<compose::Option>& opts) {
+    auto state = NewLoadState(config_);
+    state->root_stream = input;
+    return std::make_shared<DirectoryLoadStream>(state);
+}
+
+} // namespace components
+} // namespace eino
@@ -15,8 +15,7 @@
  */
 
 #include "eino/components/prebuilt/simple_loader.h"
-#include <fstream>
-#include <sstream>
+#include "eino/components/prebuilt/directory_loader.h"
 #include <sys/stat.h>
 #include <dirent.h>
 
@@ -27,21 +26,14 @@ std::vector<schema::Document> SimpleLoader::LoadFromFile(const std::string& file
     std::vector<schema::Document> docs;
     
     try {
-        std::ifstream file(file_path);
-        if (!file.is_open()) {
-            return docs;
-        }
-        
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string content = buffer.str();
+        std::string content = DirectoryLoader::ReadFileContent(file_path);
         
         if (!content.empty()) {
             schema::Document doc;
             doc.id = file_path;
-            doc.page_content = content;
+            doc.page_content = std::move(content);
             doc.metadata["source"] = file_path;
-            docs.push_back(doc);
+            docs.push_back(std::move(doc));
         }
     } catch (...) {
         // Silently handle errors
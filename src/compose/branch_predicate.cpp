@@ -0,0 +1,564 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/compose/branch_predicate.h"
+
+namespace eino {
+namespace compose {
+
+namespace {
+
+using AnyMap = std::map<std::string, std::any>;
+
+template<typename T>
+const T* As(const std::any* value) {
+    return value ? std::any_cast<T>(value) : nullptr;
+}
+
+bool Present(const std::any* value) {
+    return value && value->has_value();
+}
+
+// Number views an int64/double operand; int64 vs double pairs compare as
+// double
+// Aligns with: alignNumberTypes (clause.go:289-300)
+struct Number {
+    bool ok = false;
+    bool is_int = false;
+    int64_t i = 0;
+    double d = 0;
+
+    explicit Number(const std::any* value) {
+        if (const auto* v = As<int64_t>(value)) {
+            ok = is_int = true;
+            i = *v;
+            d = static_cast<double>(*v);
+        } else if (const auto* v = As<double>(value)) {
+            ok = true;
+            d = *v;
+        }
+    }
+};
+
+template<typename T>
+bool Compare(BranchOperator op, const T& left, const T& right) {
+    switch (op) {
+        case BranchOperator::Greater: return left > right;
+        case BranchOperator::GreaterOrEqual: return left >= right;
+        case BranchOperator::Lesser: return left < right;
+        case BranchOperator::LesserOrEqual: return left <= right;
+        default: return false;
+    }
+}
+
+// Aligns with: clause.go:47-54
+bool EvaluateEqual(const std::any* left, const std::any* right) {
+    if (!Present(left) && !Present(right)) {
+        return true;
+    }
+    if (!Present(left) || !Present(right)) {
+        return false;
+    }
+
+    Number l(left), r(right);
+    if (l.ok || r.ok) {
+        if (!l.ok || !r.ok) {
+            return false;
+        }
+        return l.is_int && r.is_int ? l.i == r.i : l.d == r.d;
+    }
+    if (const auto* lb = As<bool>(left)) {
+        const auto* rb = As<bool>(right);
+        return rb && *lb == *rb;
+    }
+    if (const auto* ls = As<std::string>(left)) {
+        const auto* rs = As<std::string>(right);
+        return rs && *ls == *rs;
+    }
+    return false;
+}
+
+// Aligns with: clause.go:66-93
+bool EvaluateEmpty(const std::any* left) {
+    if (!Present(left)) {
+        return true;
+    }
+    if (const auto* vec = As<std::vector<std::any>>(left)) {
+        return vec->empty();
+    }
+    if (const auto* map = As<AnyMap>(left)) {
+        return map->empty();
+    }
+    if (const auto* str = As<std::string>(left)) {
+        return str->empty() || *str == "None";
+    }
+    if (const auto* v = As<int64_t>(left)) {
+        return *v == 0;
+    }
+    if (const auto* v = As<double>(left)) {
+        return *v == 0.0;
+    }
+    if (const auto* v = As<bool>(left)) {
+        return !*v;
+    }
+    return false;
+}
+
+// Aligns with: clause.go:97-163
+bool EvaluateComparison(BranchOperator op, const std::any* left, const std::any* right) {
+    if (!Present(left)) {
+        if (op == BranchOperator::GreaterOrEqual || op == BranchOperator::LesserOrEqual) {
+            return !Present(right);
+        }
+        return op == BranchOperator::Lesser;
+    }
+    if (!Present(right)) {
+        return op == BranchOperator::GreaterOrEqual;
+    }
+
+    Number l(left), r(right);
+    if (!l.ok || !r.ok) {
+        return false;
+    }
+    return l.is_int && r.is_int ? Compare(op, l.i, r.i) : Compare(op, l.d, r.d);
+}
+
+// Aligns with: clause.go:164-174
+bool EvaluateBoolean(BranchOperator op, const std::any* left) {
+    if (!Present(left)) {
+        return op == BranchOperator::IsFalse;
+    }
+    const auto* val = As<bool>(left);
+    if (!val) {
+        return false;
+    }
+    return op == BranchOperator::IsTrue ? *val : !*val;
+}
+
+// Aligns with: clause.go:175-217
+bool EvaluateLength(BranchOperator op, const std::any* left, const std::any* right) {
+    const auto* threshold = As<int64_t>(right);
+    if (!threshold) {
+        throw std::runtime_error(
+            "BranchNode: " + OperatorToString(op) + " requires an int64 right operand");
+    }
+
+    if (!Present(left)) {
+        switch (op) {
+            case BranchOperator::LengthGreaterOrEqual:
+            case BranchOperator::LengthLesserOrEqual:
+                return *threshold == 0;
+            case BranchOperator::LengthLesser:
+                return *threshold > 0;
+            default:
+                return false;
+        }
+    }
+
+    int64_t length = 0;
+    if (const auto* str = As<std::string>(left)) {
+        length = static_cast<int64_t>(str->length());
+    } else if (const auto* vec = As<std::vector<std::any>>(left)) {
+        length = static_cast<int64_t>(vec->size());
+    } else {
+        return false;
+    }
+
+    switch (op) {
+        case BranchOperator::LengthGreater: return length > *threshold;
+        case BranchOperator::LengthGreaterOrEqual: return length >= *threshold;
+        case BranchOperator::LengthLesser: return length < *threshold;
+        case BranchOperator::LengthLesserOrEqual: return length <= *threshold;
+        default: return false;
+    }
+}
+
+// ListContains scans a list for an int64 or string element equal to value
+bool ListContains(const std::vector<std::any>& list, const std::any* value) {
+    if (const auto* v = As<int64_t>(value)) {
+        for (const auto& elem : list) {
+            const auto* e = std::any_cast<int64_t>(&elem);
+            if (e && *e == *v) {
+                return true;
+            }
+        }
+    } else if (const auto* v = As<std::string>(value)) {
+        for (const auto& elem : list) {
+            const auto* e = std::any_cast<std::string>(&elem);
+            if (e && *e == *v) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Aligns with: clause.go:218-254
+bool EvaluateContain(BranchOperator op, const std::any* left, const std::any* right) {
+    if (!Present(left)) {
+        return false;
+    }
+    bool should_contain = (op == BranchOperator::Contain);
+
+    if (const auto* str = As<std::string>(left)) {
+        const auto* needle = As<std::string>(right);
+        bool contains = needle && str->find(*needle) != std::string::npos;
+        return should_contain ? contains : !contains;
+    }
+    if (const auto* vec = As<std::vector<std::any>>(left)) {
+        return ListContains(*vec, right) ? should_contain : !should_contain;
+    }
+    return false;
+}
+
+// Aligns with: clause.go:255-286
+bool EvaluateContainKey(BranchOperator op, const std::any* left, const std::any* right) {
+    if (!Present(left)) {
+        return false;
+    }
+    const auto* map = As<AnyMap>(left);
+    const auto* key = As<std::string>(right);
+    if (!map || !key) {
+        return false;
+    }
+    bool contains = map->find(*key) != map->end();
+    return op == BranchOperator::ContainKey ? contains : !contains;
+}
+
+} // namespace
+
+// ============================================================================
+// EvaluateOperator - Main resolution logic
+// ============================================================================
+// Aligns with: clause.go:35-286
+
+bool EvaluateOperator(BranchOperator op, const std::any* left, const std::any* right) {
+    switch (op) {
+        case BranchOperator::Equal:
+            return EvaluateEqual(left, right);
+
+        case BranchOperator::NotEqual:
+            return !EvaluateEqual(left, right);
+
+        case BranchOperator::Empty:
+            return EvaluateEmpty(left);
+
+        case BranchOperator::NotEmpty:
+            return !EvaluateEmpty(left);
+
+        case BranchOperator::Greater:
+        case BranchOperator::GreaterOrEqual:
+        case BranchOperator::Lesser:
+        case BranchOperator::LesserOrEqual:
+            return EvaluateComparison(op, left, right);
+
+        case BranchOperator::IsTrue:
+        case BranchOperator::IsFalse:
+            return EvaluateBoolean(op, left);
+
+        case BranchOperator::LengthGreater:
+        case BranchOperator::LengthGreaterOrEqual:
+        case BranchOperator::LengthLesser:
+        case BranchOperator::LengthLesserOrEqual:
+            return EvaluateLength(op, left, right);
+
+        case BranchOperator::Contain:
+        case BranchOperator::NotContain:
+            return EvaluateContain(op, left, right);
+
+        case BranchOperator::ContainKey:
+        case BranchOperator::NotContainKey:
+            return EvaluateContainKey(op, left, right);
+
+        default:
+            throw std::runtime_error("Unknown operator: " + OperatorToString(op));
+    }
+}
+
+bool Clause::Resolve() {
+    return EvaluateOperator(op, &left_operand, &right_operand);
+}
+
+// ============================================================================
+// Compiled Conditions
+// ============================================================================
+
+namespace {
+
+// Walk follows path[from..] down nested maps, starting at current
+const std::any* Walk(const AnyMap* current, const std::vector<std::string>& path,
+                     size_t from) {
+    for (size_t i = from;; ++i) {
+        auto it = current->find(path[i]);
+        if (it == current->end()) {
+            return nullptr;
+        }
+        if (i + 1 == path.size()) {
+            return &it->second;
+        }
+        current = As<AnyMap>(&it->second);
+        if (!current) {
+            return nullptr;
+        }
+    }
+}
+
+} // namespace
+
+const std::any* OperandAccessor::Resolve(const std::map<std::string, std::any>& input) const {
+    if (kind == Kind::Literal) {
+        return &literal;
+    }
+    if (kind == Kind::None || path.empty()) {
+        return nullptr;
+    }
+    return Walk(&input, path, 0);
+}
+
+const std::any* OperandAccessor::Resolve(const BranchInputs& inputs,
+                                         std::any& scratch) const {
+    if (kind == Kind::Literal) {
+        return &literal;
+    }
+    if (kind == Kind::None || path.empty()) {
+        return nullptr;
+    }
+    auto it = inputs.find(path.front());
+    if (it == inputs.end() || !it->second) {
+        return nullptr;
+    }
+    if (path.size() == 1) {
+        scratch = *it->second;
+        return &scratch;
+    }
+    return Walk(it->second, path, 1);
+}
+
+bool CompiledCondition::Evaluate(const std::map<std::string, std::any>& input) const {
+    const std::any* lhs = left.Resolve(input);
+    if (!lhs) {
+        throw std::runtime_error(missing_left_error);
+    }
+    return Test(lhs, right.Resolve(input));
+}
+
+bool CompiledCondition::Evaluate(const BranchInputs& inputs) const {
+    std::any left_scratch;
+    std::any right_scratch;
+    const std::any* lhs = left.Resolve(inputs, left_scratch);
+    if (!lhs) {
+        throw std::runtime_error(missing_left_error);
+    }
+    return Test(lhs, right.Resolve(inputs, right_scratch));
+}
+
+bool CompiledCondition::Test(const std::any* lhs, const std::any* rhs) const {
+    if (hashed) {
+        bool contains = false;
+        if (const auto* v = As<int64_t>(rhs)) {
+            contains = int_members.count(*v) > 0;
+        } else if (const auto* v = As<std::string>(rhs)) {
+            contains = string_members.count(*v) > 0;
+        }
+        return op == BranchOperator::Contain ? contains : !contains;
+    }
+    return EvaluateOperator(op, lhs, rhs);
+}
+
+namespace {
+
+// EvaluateClause short-circuits the conditions of clause under its relation
+template<typename Input>
+bool EvaluateClause(const CompiledClause& clause, const Input& input) {
+    // Aligns with: selector.MultiClause.Resolve (clause.go:288-312)
+    if (clause.relation == ClauseRelation::AND) {
+        for (const auto& condition : clause.conditions) {
+            if (!condition.Evaluate(input)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (const auto& condition : clause.conditions) {
+        if (condition.Evaluate(input)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename Input>
+int64_t FirstMatch(const std::vector<CompiledClause>& clauses, const Input& input) {
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        if (EvaluateClause(clauses[i], input)) {
+            return static_cast<int64_t>(i);
+        }
+    }
+    return static_cast<int64_t>(clauses.size());
+}
+
+} // namespace
+
+bool CompiledClause::Evaluate(const std::map<std::string, std::any>& input) const {
+    return EvaluateClause(*this, input);
+}
+
+bool CompiledClause::Evaluate(const BranchInputs& inputs) const {
+    return EvaluateClause(*this, inputs);
+}
+
+int64_t SelectBranch(const std::vector<CompiledClause>& clauses,
+                     const std::map<std::string, std::any>& input) {
+    return FirstMatch(clauses, input);
+}
+
+int64_t SelectBranch(const std::vector<CompiledClause>& clauses,
+                     const BranchInputs& inputs) {
+    return FirstMatch(clauses, inputs);
+}
+
+namespace {
+
+// NormalizeLiteral widens literal numbers to int64/double and C strings to
+// std::string, the types operands are compared as
+std::any NormalizeLiteral(const std::any& value) {
+    if (const auto* v = std::any_cast<int>(&value)) {
+        return static_cast<int64_t>(*v);
+    }
+    if (const auto* v = std::any_cast<long>(&value)) {
+        return static_cast<int64_t>(*v);
+    }
+    if (const auto* v = std::any_cast<long long>(&value)) {
+        return static_cast<int64_t>(*v);
+    }
+    if (const auto* v = std::any_cast<float>(&value)) {
+        return static_cast<double>(*v);
+    }
+    if (const auto* v = std::any_cast<const char*>(&value)) {
+        return std::string(*v);
+    }
+    return value;
+}
+
+OperandAccessor SourceAccessor(const ValueSource& source) {
+    OperandAccessor accessor;
+    if (source.type == ValueSource::Type::Literal) {
+        // A literal without a value is an omitted (unary) operand
+        if (source.literal_value.has_value()) {
+            accessor.kind = OperandAccessor::Kind::Literal;
+            accessor.literal = NormalizeLiteral(source.literal_value);
+        }
+    } else if (source.node_ref) {
+        accessor.kind = OperandAccessor::Kind::Path;
+        accessor.path.push_back(source.node_ref->from_node_key);
+        accessor.path.insert(accessor.path.end(),
+                             source.node_ref->from_path.begin(),
+                             source.node_ref->from_path.end());
+    }
+    return accessor;
+}
+
+OperandAccessor PathAccessor(std::vector<std::string> path) {
+    OperandAccessor accessor;
+    accessor.kind = OperandAccessor::Kind::Path;
+    accessor.path = std::move(path);
+    return accessor;
+}
+
+// HashMembers indexes a literal int64/string list on the left of
+// contain/not_contain; lists with other element types keep the scan
+void HashMembers(CompiledCondition& condition) {
+    if (condition.op != BranchOperator::Contain && condition.op != BranchOperator::NotContain) {
+        return;
+    }
+    if (condition.left.kind != OperandAccessor::Kind::Literal) {
+        return;
+    }
+    const auto* list = std::any_cast<std::vector<std::any>>(&condition.left.literal);
+    if (!list) {
+        return;
+    }
+    for (const auto& elem : *list) {
+        if (const auto* v = std::any_cast<int64_t>(&elem)) {
+            condition.int_members.insert(*v);
+        } else if (const auto* v = std::any_cast<std::string>(&elem)) {
+            condition.string_members.insert(*v);
+        }
+    }
+    condition.hashed = true;
+}
+
+CompiledCondition CompileCondition(const SingleClauseConfig& config,
+                                   bool uses_node_references,
+                                   const std::vector<std::string>& legacy_prefix,
+                                   const std::string& location) {
+    CompiledCondition condition;
+    condition.op = config.op;
+    if (uses_node_references) {
+        condition.left = SourceAccessor(config.left.source);
+        condition.right = SourceAccessor(config.right.source);
+        condition.missing_left_error = "Failed to resolve left operand for " + location;
+    } else {
+        auto left = legacy_prefix;
+        left.push_back("left");
+        auto right = legacy_prefix;
+        right.push_back("right");
+        condition.left = PathAccessor(std::move(left));
+        condition.right = PathAccessor(std::move(right));
+        condition.missing_left_error =
+            "Failed to take left operand from input map, " + location;
+    }
+    HashMembers(condition);
+    return condition;
+}
+
+} // namespace
+
+std::vector<CompiledClause> CompileBranchClauses(const BranchNodeConfig& config,
+                                                 bool uses_node_references) {
+    std::vector<CompiledClause> compiled;
+    compiled.reserve(config.clauses.size());
+
+    for (size_t i = 0; i < config.clauses.size(); ++i) {
+        const auto& clause_config = config.clauses[i];
+        const std::string index = std::to_string(i);
+        CompiledClause clause;
+
+        if (clause_config.single) {
+            clause.conditions.push_back(CompileCondition(
+                *clause_config.single, uses_node_references, {index},
+                "clause index=" + index));
+        } else if (clause_config.multi) {
+            clause.relation = clause_config.multi->relation;
+            for (size_t j = 0; j < clause_config.multi->clauses.size(); ++j) {
+                const std::string sub = std::to_string(j);
+                clause.conditions.push_back(CompileCondition(
+                    clause_config.multi->clauses[j], uses_node_references, {index, sub},
+                    "clause index=" + index + ", single clause index=" + sub));
+            }
+        } else {
+            throw std::runtime_error(
+                "Invalid clause config, both single and multi are null at index " + index);
+        }
+
+        compiled.push_back(std::move(clause));
+    }
+
+    return compiled;
+}
+
+} // namespace compose
+} // namespace eino
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/compose/branch_speculation.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "eino/internal/metrics.h"
+
+namespace eino {
+namespace compose {
+
+namespace {
+
+// SpeculationMetrics count how speculative branch targets ended
+struct SpeculationMetrics {
+    internal::metrics::Counter speculation_hits;
+    internal::metrics::Counter speculation_misses;
+
+    static const SpeculationMetrics& Get() {
+        static const SpeculationMetrics metrics;
+        return metrics;
+    }
+
+    SpeculationMetrics() {
+        auto& registry = internal::metrics::Registry::Global();
+        speculation_hits = registry.GetCounter("eino_branch_speculation_hits_total",
+                                               "Speculative branch targets that were selected");
+        speculation_misses = registry.GetCounter("eino_branch_speculation_misses_total",
+                                                 "Speculative branch targets that were discarded");
+    }
+};
+
+} // namespace
+
+BranchPredictor::BranchPredictor(BranchSpeculation config)
+    : config_(std::move(config)) {}
+
+std::vector<std::string> BranchPredictor::Predict() const {
+    if (config_.max_targets == 0) {
+        return {};
+    }
+    if (!config_.hint.empty()) {
+        size_t n = std::min(config_.hint.size(), config_.max_targets);
+        return std::vector<std::string>(config_.hint.begin(), config_.hint.begin() + n);
+    }
+
+    // Count occurrences, remembering the latest position to break ties
+    // towards the most recent outcome
+    struct Score {
+        size_t count = 0;
+        size_t last = 0;
+    };
+    std::map<std::string, Score> scores;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        size_t pos = 0;
+        for (const auto& outcome : history_) {
+            ++pos;
+            for (const auto& target : outcome) {
+                auto& s = scores[target];
+                s.count++;
+                s.last = pos;
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string, Score>> ranked(scores.begin(), scores.end());
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        if (a.second.count != b.second.count) {
+            return a.second.count > b.second.count;
+        }
+        return a.second.last > b.second.last;
+    });
+
+    std::vector<std::string> predicted;
+    for (size_t i = 0; i < ranked.size() && i < config_.max_targets; ++i) {
+        predicted.push_back(ranked[i].first);
+    }
+    return predicted;
+}
+
+void BranchPredictor::Record(const std::vector<std::string>& outcome) {
+    if (!config_.hint.empty() || config_.history_size == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mu_);
+    history_.push_back(outcome);
+    while (history_.size() > config_.history_size) {
+        history_.pop_front();
+    }
+}
+
+std::vector<int> SpeculationTargets(const ExecutionPlan& plan,
+                                    const std::vector<std::string>& predicted,
+                                    const std::function<bool(int id)>& idempotent,
+                                    const std::vector<std::string>& interrupt_before) {
+    std::vector<int> targets;
+    for (const auto& name : predicted) {
+        int id = plan.Id(name);
+        if (id == ExecutionPlan::kNoNode || id == plan.StartId() || id == plan.EndId()) {
+            continue;
+        }
+        if (!idempotent(id) ||
+            !plan.ControlPredecessors(id).empty() ||
+            !plan.DataPredecessors(id).empty() ||
+            std::find(interrupt_before.begin(), interrupt_before.end(), name) !=
+                interrupt_before.end()) {
+            continue;
+        }
+        targets.push_back(id);
+    }
+    return targets;
+}
+
+std::vector<std::string> ResolveSpeculation(
+    const std::vector<std::string>& speculated,
+    const std::function<std::vector<std::string>()>& condition,
+    const std::function<void(size_t index)>& cancel,
+    BranchPredictor* predictor) {
+    std::vector<std::string> selected;
+    try {
+        selected = condition();
+    } catch (...) {
+        for (size_t i = 0; i < speculated.size(); ++i) {
+            cancel(i);
+        }
+        throw;
+    }
+    if (predictor) {
+        predictor->Record(selected);
+    }
+
+    const auto& metrics = SpeculationMetrics::Get();
+    for (size_t i = 0; i < speculated.size(); ++i) {
+        auto it = std::find(selected.begin(), selected.end(), speculated[i]);
+        if (it != selected.end()) {
+            // Already running: its completion arrives through Wait
+            selected.erase(it);
+            metrics.speculation_hits.Inc();
+        } else {
+            cancel(i);
+            metrics.speculation_misses.Inc();
+        }
+    }
+    return selected;
+}
+
+} // namespace compose
+} // namespace eino
@@ -16,8 +16,10 @@
 
 #include "eino/compose/chain.h"
 #include "eino/compose/graph.h"
+#include "eino/compose/utils.h"
 #include <sstream>
 #include <algorithm>
+#include <type_traits>
 
 namespace eino {
 namespace compose {
@@ -204,6 +206,12 @@ ChainNodeType StringToChainNodeType(const std::string& str) {
     return ChainNodeType::Unknown;
 }
 
+Context InitFusedStepCallbacks(const Context& ctx,
+                               const std::string& step_key,
+                               const std::vector<Option>& opts) {
+    return InitNodeCallbacks(ctx, step_key, nullptr, nullptr, opts);
+}
+
 // ============================================================================
 // Chain Template Implementation
 // Aligns with: eino/compose/chain.go
@@ -249,6 +257,11 @@ const std::string& Chain<I, O>::GetError() const {
     return error_;
 }
 
+template<typename I, typename O>
+const std::vector<ChainNodeInfo>& Chain<I, O>::GetNodes() const {
+    return nodes_;
+}
+
 // ============================================================================
 // Builder Methods Implementation
 // ============================================================================
@@ -349,30 +362,16 @@ std::shared_ptr<Chain<I, O>> Chain<I, O>::AppendParallel(
     ValidateNotCompiled();
     
     if (HasError()) {
-        return std::shared_ptr<Chain<I, O>>(this);
+        return this->shared_from_this();
     }
     
     if (!parallel) {
         error_ = "Parallel node cannot be null";
-        return std::shared_ptr<Chain<I, O>>(this);
-    }
-    
-    // Add Parallel as a node to graph
-    std::string node_key = NextNodeKey();
-    
-    // Add edges from previous nodes
-    for (const auto& pre_key : pre_node_keys_) {
-        gg_->AddEdge(pre_key, node_key);
+        return this->shared_from_this();
     }
     
-    // Add the parallel node
-    gg_->AddNode(node_key, std::static_pointer_cast<Runnable<M, M>>(parallel), opts);
-    
-    // Update pre_node_keys
-    pre_node_keys_.clear();
-    pre_node_keys_.push_back(node_key);
-    
-    return std::shared_ptr<Chain<I, O>>(this);
+    return addStep(ChainNodeType::Parallel,
+                   std::static_pointer_cast<Runnable<M, M>>(parallel), false);
 }
 
 template<typename I, typename O>
@@ -383,30 +382,16 @@ std::shared_ptr<Chain<I, O>> Chain<I, O>::AppendBranch(
     ValidateNotCompiled();
     
     if (HasError()) {
-        return std::shared_ptr<Chain<I, O>>(this);
+        return this->shared_from_this();
     }
     
     if (!branch) {
         error_ = "Branch node cannot be null";
-        return std::shared_ptr<Chain<I, O>>(this);
+        return this->shared_from_this();
     }
     
-    // Add Branch as a node to graph
-    std::string node_key = NextNodeKey();
-    
-    // Add edges from previous nodes
-    for (const auto& pre_key : pre_node_keys_) {
-        gg_->AddEdge(pre_key, node_key);
-    }
-    
-    // Add the branch node
-    gg_->AddNode(node_key, std::static_pointer_cast<Runnable<M, M>>(branch), opts);
-    
-    // Update pre_node_keys
-    pre_node_keys_.clear();
-    pre_node_keys_.push_back(node_key);
-    
-    return std::shared_ptr<Chain<I, O>>(this);
+    return addStep(ChainNodeType::Branch,
+                   std::static_pointer_cast<Runnable<M, M>>(branch), false);
 }
 
 // ============================================================================
@@ -424,35 +409,118 @@ std::shared_ptr<Chain<I, O>> Chain<I, O>::appendNode(
     ValidateNotCompiled();
     
     if (HasError()) {
-        return std::shared_ptr<Chain<I, O>>(this);
+        return this->shared_from_this();
     }
     
     if (!node) {
         error_ = ChainNodeTypeToString(node_type) + " node cannot be null";
-        return std::shared_ptr<Chain<I, O>>(this);
+        return this->shared_from_this();
     }
     
-    // Generate unique node key
-    std::string node_key = NextNodeKey();
+    // The internal graph takes no per-node options, so WithNoFusion is the
+    // only one a step can carry
+    bool no_fusion = false;
+    for (const auto& opt : opts) {
+        if (opt.size() != 1 || opt.count(kChainNoFusionOption) == 0) {
+            error_ = ChainNodeTypeToString(node_type) +
+                     " node options are not supported by Chain";
+            return this->shared_from_this();
+        }
+        no_fusion = true;
+    }
+    
+    // Synchronous lambdas, templates and passthroughs may be fused at Compile
+    bool fusible = !no_fusion &&
+        (node_type == ChainNodeType::ChatTemplate ||
+         node_type == ChainNodeType::Passthrough);
+    if (!no_fusion && node_type == ChainNodeType::Lambda) {
+        auto lambda = std::dynamic_pointer_cast<LambdaRunnable<M, M>>(node);
+        fusible = !lambda || lambda->HasInvokeFunc();
+    }
+    
+    return addStep(node_type, node, fusible);
+}
+
+template<typename I, typename O>
+template<typename M>
+std::shared_ptr<Chain<I, O>> Chain<I, O>::addStep(
+    ChainNodeType node_type,
+    std::shared_ptr<Runnable<M, M>> node,
+    bool fusible) {
+    
+    // Graph<I, O> nodes are Runnable<I, O>
+    if constexpr (!std::is_same<Runnable<M, M>, Runnable<I, O>>::value) {
+        error_ = ChainNodeTypeToString(node_type) +
+                 " node type does not match the chain input/output type";
+        return this->shared_from_this();
+    } else {
+        Step step;
+        step.info = ChainNodeInfo(node_type, NextNodeKey(), node);
+        step.info.graph_node_key = step.info.node_key;
+        step.runnable = node;
+        step.fusible = fusible;
+        steps_.push_back(std::move(step));
+        nodes_.push_back(steps_.back().info);
+        return this->shared_from_this();
+    }
+}
+
+template<typename I, typename O>
+void Chain<I, O>::addGraphNode(const std::string& key,
+                               std::shared_ptr<Runnable<I, O>> node) {
+    gg_->AddNode(key, node);
     
     // First node: add START edge
     if (pre_node_keys_.empty()) {
-        gg_->AddEdge("__START__", node_key);
+        gg_->AddEdge("__START__", key);
     } else {
         // Add edges from all previous nodes
         for (const auto& pre_key : pre_node_keys_) {
-            gg_->AddEdge(pre_key, node_key);
+            gg_->AddEdge(pre_key, key);
         }
     }
     
-    // Add the node to graph
-    gg_->AddNode(node_key, node, opts);
-    
     // Update pre_node_keys for next node
     pre_node_keys_.clear();
-    pre_node_keys_.push_back(node_key);
-    
-    return std::shared_ptr<Chain<I, O>>(this);
+    pre_node_keys_.push_back(key);
+}
+
+template<typename I, typename O>
+void Chain<I, O>::buildGraph(const ChainCompileOptions& opts) {
+    // A fused run is one Runnable<T, T>, so only I == O chains fuse
+    const bool fuse = opts.enable_fusion && std::is_same<I, O>::value;
+    
+    size_t i = 0;
+    while (i < steps_.size()) {
+        // Find the maximal run of fusible steps starting at i
+        size_t end = i + 1;
+        if (fuse && steps_[i].fusible) {
+            while (end < steps_.size() && steps_[end].fusible) {
+                ++end;
+            }
+        }
+        
+        if (end - i < 2) {
+            addGraphNode(steps_[i].info.node_key, steps_[i].runnable);
+            i = end;
+            continue;
+        }
+        
+        if constexpr (std::is_same<I, O>::value) {
+            // The fused node takes the first step's key
+            const std::string key = steps_[i].info.node_key;
+            std::vector<std::shared_ptr<Runnable<I, O>>> runnables;
+            std::vector<std::string> keys;
+            for (size_t j = i; j < end; ++j) {
+                runnables.push_back(steps_[j].runnable);
+                keys.push_back(steps_[j].info.node_key);
+                nodes_[j].graph_node_key = key;
+            }
+            addGraphNode(key, std::make_shared<FusedChainRunnable<I>>(
+                std::move(runnables), std::move(keys), opts.fused_step_callbacks));
+        }
+        i = end;
+    }
 }
 
 // ============================================================================
@@ -483,11 +551,20 @@ void Chain<I, O>::addEndIfNeeded() {
 
 template<typename I, typename O>
 void Chain<I, O>::Compile(std::shared_ptr<Context> ctx) {
+    Compile(ctx, ChainCompileOptions());
+}
+
+template<typename I, typename O>
+void Chain<I, O>::Compile(std::shared_ptr<Context> ctx, const ChainCompileOptions& opts) {
     // Aligns with: eino/compose/chain.go:316-341
     if (is_compiled_) {
         return;
     }
     
+    if (!HasError()) {
+        buildGraph(opts);
+    }
+    
     // Add __END__ node if needed
     addEndIfNeeded();
     
@@ -496,7 +573,7 @@ void Chain<I, O>::Compile(std::shared_ptr<Context> ctx) {
     }
     
     // Compile internal graph
-    gg_->Compile(ctx);
+    gg_->Compile();
     
     is_compiled_ = true;
 }
@@ -567,5 +644,19 @@ template class Chain<std::string, std::string>;
 template class Chain<int, int>;
 template class Chain<double, double>;
 
+// Same-type lambda and passthrough steps
+template std::shared_ptr<Chain<std::string, std::string>> Chain<std::string, std::string>::AppendLambda<std::string>(
+    std::shared_ptr<Runnable<std::string, std::string>>, const std::vector<Option>&);
+template std::shared_ptr<Chain<std::string, std::string>> Chain<std::string, std::string>::AppendPassthrough<std::string>(
+    std::shared_ptr<Runnable<std::string, std::string>>, const std::vector<Option>&);
+template std::shared_ptr<Chain<int, int>> Chain<int, int>::AppendLambda<int>(
+    std::shared_ptr<Runnable<int, int>>, const std::vector<Option>&);
+template std::shared_ptr<Chain<int, int>> Chain<int, int>::AppendPassthrough<int>(
+    std::shared_ptr<Runnable<int, int>>, const std::vector<Option>&);
+template std::shared_ptr<Chain<double, double>> Chain<double, double>::AppendLambda<double>(
+    std::shared_ptr<Runnable<double, double>>, const std::vector<Option>&);
+template std::shared_ptr<Chain<double, double>> Chain<double, double>::AppendPassthrough<double>(
+    std::shared_ptr<Runnable<double, double>>, const std::vector<Option>&);
+
 } // namespace compose
 } // namespace eino
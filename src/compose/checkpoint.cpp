@@ -20,6 +20,7 @@
 #include "eino/compose/stream_reader.h"
 #include "eino/compose/graph_compile_options.h"
 #include "eino/context.h"
+#include "eino/internal/metrics.h"
 #include <fstream>
 #include <sstream>
 #include <nlohmann/json.hpp>
@@ -400,7 +401,13 @@ std::string CheckPointer::Set(
         return err;
     }
     
-    return store_->Set(ctx, id, data);
+    err = store_->Set(ctx, id, data);
+    if (err.empty()) {
+        static const auto checkpoint_bytes = internal::metrics::Registry::Global().GetCounter(
+            "eino_checkpoint_bytes_total", "Serialized checkpoint bytes written");
+        checkpoint_bytes.Inc(data.size());
+    }
+    return err;
 }
 
 std::string CheckPointer::ConvertCheckPoint(std::shared_ptr<CheckPoint> cp, bool is_stream) {
@@ -21,11 +21,46 @@
 #include "eino/compose/graph_run.h"
 #include "eino/compose/value_merge.h"
 #include "eino/compose/utils.h"
+#include "eino/internal/metrics.h"
 #include <algorithm>
 
 namespace eino {
 namespace compose {
 
+namespace {
+
+// TaskMetrics are recorded by graph task scheduling
+struct TaskMetrics {
+    internal::metrics::Counter tasks_spawned;
+    internal::metrics::Counter task_failures;
+    internal::metrics::Histogram task_queue_ns;
+    internal::metrics::HistogramFamily node_duration_ns;
+    internal::metrics::Histogram channel_update_ns;
+    internal::metrics::Histogram speculation_wasted_ns;
+
+    static const TaskMetrics& Get() {
+        static const TaskMetrics metrics;
+        return metrics;
+    }
+
+    TaskMetrics()
+        : node_duration_ns("eino_node_duration_ns", "Graph node execution time", "node") {
+        auto& registry = internal::metrics::Registry::Global();
+        tasks_spawned = registry.GetCounter("eino_tasks_spawned_total",
+                                            "Graph tasks submitted for execution");
+        task_failures = registry.GetCounter("eino_task_failures_total",
+                                            "Graph tasks that finished with an error");
+        task_queue_ns = registry.GetHistogram("eino_task_queue_ns",
+                                              "Time from task submit to start of execution");
+        channel_update_ns = registry.GetHistogram("eino_channel_update_ns",
+                                                  "ChannelManager update-and-get duration");
+        speculation_wasted_ns = registry.GetHistogram("eino_branch_speculation_wasted_ns",
+                                                      "Run time of discarded speculative tasks");
+    }
+};
+
+} // namespace
+
 // =============================================================================
 // DAG Channel Implementation
 // Aligns with: eino/compose/dag.go:50-180
@@ -200,6 +235,18 @@ void DAGChannel::SetMergeConfig(const std::map<std::string, std::string>& config
     merge_config_ = config;
 }
 
+void DAGChannel::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& pair : control_predecessors_) {
+        pair.second = DependencyState::Waiting;
+    }
+    for (auto& pair : data_predecessors_) {
+        pair.second = false;
+    }
+    values_.clear();
+    skipped_ = false;
+}
+
 // =============================================================================
 // Pregel Channel Implementation
 // Aligns with: eino/compose/pregel.go:25-90
@@ -300,6 +347,11 @@ void PregelChannel::SetMergeConfig(const std::map<std::string, std::string>& con
     merge_config_ = config;
 }
 
+void PregelChannel::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values_.clear();
+}
+
 // =============================================================================
 // Channel Manager Implementation
 // Aligns with: eino/compose/graph_manager.go:115-230
@@ -315,52 +367,118 @@ ChannelManager::ChannelManager(
       channels_(channels),
       successors_(successors),
       data_predecessors_(data_predecessors),
-      control_predecessors_(control_predecessors) {}
+      control_predecessors_(control_predecessors) {
+    for (const auto& pair : channels_) {
+        slot_ids_[pair.first] = static_cast<int>(slot_names_.size());
+        slot_names_.push_back(pair.first);
+        slot_channels_.push_back(pair.second.get());
+    }
+    is_dirty_.assign(slot_names_.size(), 0);
+}
+
+ChannelManager::ChannelManager(
+    bool is_stream,
+    std::shared_ptr<const ExecutionPlan> plan,
+    const std::vector<std::shared_ptr<Channel>>& channels)
+    : is_stream_(is_stream),
+      plan_(std::move(plan)) {
+    if (!plan_ || channels.size() != plan_->NodeCount()) {
+        throw std::invalid_argument("ChannelManager: one channel slot per plan node required");
+    }
+    slot_names_.reserve(channels.size());
+    slot_channels_.reserve(channels.size());
+    for (size_t id = 0; id < channels.size(); ++id) {
+        const auto& name = plan_->Name(static_cast<int>(id));
+        slot_names_.push_back(name);
+        slot_channels_.push_back(channels[id].get());
+        if (channels[id]) {
+            channels_[name] = channels[id];
+        }
+    }
+    is_dirty_.assign(slot_names_.size(), 0);
+}
+
+int ChannelManager::Slot(const std::string& name) const {
+    int slot = ExecutionPlan::kNoNode;
+    if (plan_) {
+        slot = plan_->Id(name);
+    } else {
+        auto it = slot_ids_.find(name);
+        if (it != slot_ids_.end()) {
+            slot = it->second;
+        }
+    }
+    if (slot == ExecutionPlan::kNoNode || !slot_channels_[slot]) {
+        throw std::runtime_error("Target channel doesn't exist: " + name);
+    }
+    return slot;
+}
+
+void ChannelManager::MarkDirty(int slot) {
+    if (!is_dirty_[slot]) {
+        is_dirty_[slot] = 1;
+        dirty_.push_back(slot);
+    }
+}
+
+bool ChannelManager::Reset() {
+    for (const auto& pair : channels_) {
+        if (pair.second.use_count() != 1) {
+            return false;
+        }
+    }
+    for (Channel* channel : slot_channels_) {
+        if (channel) {
+            channel->Reset();
+        }
+    }
+    for (int slot : dirty_) {
+        is_dirty_[slot] = 0;
+    }
+    dirty_.clear();
+    return true;
+}
 
 void ChannelManager::LoadChannels(const std::map<std::string, std::shared_ptr<Channel>>& channels) {
     for (const auto& pair : channels_) {
         auto it = channels.find(pair.first);
         if (it != channels.end()) {
             pair.second->Load(it->second);
+            // Restored channels may already be complete
+            MarkDirty(Slot(pair.first));
         }
     }
 }
 
 void ChannelManager::UpdateValues(const std::map<std::string, std::map<std::string, std::shared_ptr<void>>>& values) {
     for (const auto& target_pair : values) {
-        const auto& target = target_pair.first;
-        const auto& from_map = target_pair.second;
-        
-        auto ch_it = channels_.find(target);
-        if (ch_it == channels_.end()) {
-            throw std::runtime_error("Target channel doesn't exist: " + target);
-        }
-        
-        ch_it->second->ReportValues(from_map);
+        int slot = Slot(target_pair.first);
+        slot_channels_[slot]->ReportValues(target_pair.second);
+        MarkDirty(slot);
     }
 }
 
 void ChannelManager::UpdateDependencies(const std::map<std::string, std::vector<std::string>>& deps) {
     for (const auto& target_pair : deps) {
-        const auto& target = target_pair.first;
-        const auto& dependencies = target_pair.second;
-        
-        auto ch_it = channels_.find(target);
-        if (ch_it == channels_.end()) {
-            throw std::runtime_error("Target channel doesn't exist: " + target);
-        }
-        
-        ch_it->second->ReportDependencies(dependencies);
+        int slot = Slot(target_pair.first);
+        slot_channels_[slot]->ReportDependencies(target_pair.second);
+        MarkDirty(slot);
     }
 }
 
 std::map<std::string, std::shared_ptr<void>> ChannelManager::GetFromReadyChannels() {
     std::map<std::string, std::shared_ptr<void>> result;
     
-    for (const auto& pair : channels_) {
+    // Readiness only changes through Report*, so untouched channels are skipped
+    std::vector<int> dirty;
+    dirty.swap(dirty_);
+    for (int slot : dirty) {
+        is_dirty_[slot] = 0;
+    }
+    for (int slot : dirty) {
         std::shared_ptr<void> value;
-        if (pair.second->Get(is_stream_, pair.first, value)) {
-            result[pair.first] = value;
+        if (slot_channels_[slot]->Get(is_stream_, slot_names_[slot], value)) {
+            result[slot_names_[slot]] = value;
         }
     }
     
@@ -371,6 +489,7 @@ std::map<std::string, std::shared_ptr<void>> ChannelManager::UpdateAndGet(
     const std::map<std::string, std::map<std::string, std::shared_ptr<void>>>& values,
     const std::map<std::string, std::vector<std::string>>& deps) {
     
+    internal::metrics::ScopedTimer timer(TaskMetrics::Get().channel_update_ns);
     UpdateValues(values);
     UpdateDependencies(deps);
     return GetFromReadyChannels();
@@ -379,9 +498,12 @@ std::map<std::string, std::shared_ptr<void>> ChannelManager::UpdateAndGet(
 void ChannelManager::ReportBranch(const std::string& from, const std::vector<std::string>& skipped_nodes) {
     std::vector<std::string> to_process;
     
+    // A skip can complete a channel's dependencies, so every channel
+    // reported to becomes dirty
     for (const auto& node : skipped_nodes) {
         auto ch_it = channels_.find(node);
         if (ch_it != channels_.end()) {
+            MarkDirty(Slot(node));
             if (ch_it->second->ReportSkip({from})) {
                 to_process.push_back(node);
             }
@@ -390,16 +512,14 @@ void ChannelManager::ReportBranch(const std::string& from, const std::vector<std
     
     // Propagate skip to successors
     for (size_t i = 0; i < to_process.size(); ++i) {
-        const auto& key = to_process[i];
+        const auto key = to_process[i];
         
-        auto succ_it = successors_.find(key);
-        if (succ_it != successors_.end()) {
-            for (const auto& successor : succ_it->second) {
-                auto ch_it = channels_.find(successor);
-                if (ch_it != channels_.end()) {
-                    if (ch_it->second->ReportSkip({key})) {
-                        to_process.push_back(successor);
-                    }
+        for (const auto& successor : GetSuccessors(key)) {
+            auto ch_it = channels_.find(successor);
+            if (ch_it != channels_.end()) {
+                MarkDirty(Slot(successor));
+                if (ch_it->second->ReportSkip({key})) {
+                    to_process.push_back(successor);
                 }
             }
         }
@@ -416,6 +536,9 @@ TaskManager::TaskManager(bool need_all)
 
 TaskManager::~TaskManager() {
     Cancel();
+    // Detached workers still reference this manager; let them finish
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return num_running_.load() == 0; });
 }
 
 void TaskManager::Submit(const std::vector<std::shared_ptr<Task>>& tasks) {
@@ -458,13 +581,13 @@ void TaskManager::Submit(const std::vector<std::shared_ptr<Task>>& tasks) {
                 task->node_key + "]: " + e.what());
             task->status = TaskStatus::Failed;
             
-            // Send directly to done queue
+            // Send directly to done queue; it never ran, so it isn't counted
+            // as running
             {
                 std::lock_guard<std::mutex> lock(mutex_);
                 done_queue_.push(task);
-                num_running_++;  // Increment for WaitOne
             }
-            cv_.notify_one();
+            cv_.notify_all();
         }
     }
     
@@ -473,6 +596,13 @@ void TaskManager::Submit(const std::vector<std::shared_ptr<Task>>& tasks) {
         return;
     }
     
+    const auto& metrics = TaskMetrics::Get();
+    metrics.tasks_spawned.Inc(valid_tasks.size());
+    uint64_t submit_ns = internal::metrics::Enabled() ? internal::metrics::NowNs() : 0;
+    for (const auto& task : valid_tasks) {
+        task->submit_ns = submit_ns;
+    }
+    
     // ⭐ Aligns with: eino/compose/graph_manager.go:314-325
     // Synchronous execution optimization (optional)
     std::shared_ptr<Task> sync_task = nullptr;
@@ -493,21 +623,23 @@ void TaskManager::Submit(const std::vector<std::shared_ptr<Task>>& tasks) {
             running_tasks_[task->node_key] = task;
             num_running_++;
         }
+        if (sync_task) {
+            running_tasks_[sync_task->node_key] = sync_task;
+            num_running_++;
+        }
     }
     
-    // Execute sync task first (optimization)
-    if (sync_task) {
-        running_tasks_[sync_task->node_key] = sync_task;
-        num_running_++;
-        Execute(sync_task);
-    }
-    
-    // Execute remaining tasks asynchronously
+    // Start the asynchronous tasks before running the sync one, so they
+    // don't queue behind it
     for (const auto& task : valid_tasks) {
         std::thread([this, task]() {
             Execute(task);
         }).detach();
     }
+    
+    if (sync_task) {
+        Execute(sync_task);
+    }
 }
 
 void TaskManager::Execute(std::shared_ptr<Task> task) {
@@ -527,6 +659,12 @@ void TaskManager::Execute(std::shared_ptr<Task> task) {
     //     currentTask.output, currentTask.err = t.runWrapper(ctx, currentTask.call.action, currentTask.input, currentTask.option...)
     // }
     
+    const auto& metrics = TaskMetrics::Get();
+    uint64_t start_ns = task->submit_ns ? internal::metrics::NowNs() : 0;
+    if (start_ns) {
+        metrics.task_queue_ns.Record(start_ns - task->submit_ns);
+    }
+    
     // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
     // ⭐ PANIC RECOVERY (defer + recover in Go)
     // Must ALWAYS execute, even if task succeeds
@@ -725,19 +863,32 @@ void TaskManager::Execute(std::shared_ptr<Task> task) {
     // Aligns with Go's: defer func() { t.done.Send(currentTask) }()
     // This MUST run regardless of success/failure/panic
     // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
+    if (start_ns) {
+        task->run_ns = internal::metrics::NowNs() - start_ns;
+        metrics.node_duration_ns.WithLabel(task->node_key).Record(task->run_ns);
+    }
+    if (task->error) {
+        metrics.task_failures.Inc();
+    }
+    // Notify under the lock: once num_running_ hits zero the destructor may
+    // free cv_
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (task->discarded) {
+        // A losing speculation: nobody waits for its result
+        metrics.speculation_wasted_ns.Record(task->run_ns);
+        num_discarded_--;
+    } else {
         done_queue_.push(task);
-        num_running_--;
     }
-    cv_.notify_one();
+    num_running_--;
+    cv_.notify_all();
 }
 
 std::shared_ptr<Task> TaskManager::WaitOne() {
     std::unique_lock<std::mutex> lock(mutex_);
     
     cv_.wait(lock, [this]() {
-        return !done_queue_.empty() || cancelled_;
+        return !done_queue_.empty() || cancelled_ || LiveRunning() == 0;
     });
     
     if (cancelled_ || done_queue_.empty()) {
@@ -777,14 +928,122 @@ std::vector<std::shared_ptr<Task>> TaskManager::WaitAll() {
     return result;
 }
 
+// Wait returns as soon as a completion is available (or, with need_all,
+// once every task finished), taking every completion already queued, so
+// eager runs dispatch successors of fast tasks without waiting for slow ones
+// Aligns with: eino/compose/graph_manager.go:345-390 (wait)
+void TaskManager::Wait(std::vector<std::shared_ptr<Task>>& completed,
+                       bool& was_cancelled,
+                       std::vector<std::shared_ptr<Task>>& cancelled_tasks) {
+    completed.clear();
+    cancelled_tasks.clear();
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() {
+        return cancelled_ || LiveRunning() == 0 ||
+               (!need_all_ && !done_queue_.empty());
+    });
+    TakeDoneLocked(completed);
+    was_cancelled = cancelled_;
+    if (cancelled_) {
+        TakeRunningLocked(cancelled_tasks);
+    }
+}
+
+// WaitAll drains every running task, discarded speculations included: the
+// consistent cut used before interrupts and checkpoints
+void TaskManager::WaitAll(std::vector<std::shared_ptr<Task>>& completed,
+                          std::vector<std::shared_ptr<Task>>& cancelled_tasks) {
+    completed.clear();
+    cancelled_tasks.clear();
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() {
+        return cancelled_ || num_running_.load() == 0;
+    });
+    TakeDoneLocked(completed);
+    if (cancelled_) {
+        TakeRunningLocked(cancelled_tasks);
+    }
+}
+
+void TaskManager::TakeDoneLocked(std::vector<std::shared_ptr<Task>>& out) {
+    while (!done_queue_.empty()) {
+        auto task = done_queue_.front();
+        done_queue_.pop();
+        running_tasks_.erase(task->node_key);
+        out.push_back(task);
+    }
+}
+
+void TaskManager::TakeRunningLocked(std::vector<std::shared_ptr<Task>>& out) {
+    for (const auto& pair : running_tasks_) {
+        out.push_back(pair.second);
+    }
+}
+
 void TaskManager::Cancel() {
     std::lock_guard<std::mutex> lock(mutex_);
     cancelled_ = true;
     cv_.notify_all();
 }
 
+// Speculative tasks always run on their own thread: running one inline
+// would delay the branch decision it is racing
+bool TaskManager::Speculate(const std::shared_ptr<Task>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled_) {
+            return false;
+        }
+        task->speculative = true;
+        task->submit_ns = internal::metrics::Enabled() ? internal::metrics::NowNs() : 0;
+        running_tasks_[task->node_key] = task;
+        num_running_++;
+    }
+    TaskMetrics::Get().tasks_spawned.Inc();
+    std::thread([this, task]() {
+        Execute(task);
+    }).detach();
+    return true;
+}
+
+bool TaskManager::Cancel(const std::shared_ptr<Task>& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (task->discarded) {
+        return true;
+    }
+    auto it = running_tasks_.find(task->node_key);
+    if (it == running_tasks_.end() || it->second != task) {
+        return false;
+    }
+    running_tasks_.erase(it);
+    task->discarded = true;
+    task->status = TaskStatus::Cancelled;
+    
+    // Already finished: pull it back out of the done queue
+    bool queued = false;
+    std::queue<std::shared_ptr<Task>> kept;
+    while (!done_queue_.empty()) {
+        auto done = std::move(done_queue_.front());
+        done_queue_.pop();
+        if (done == task) {
+            queued = true;
+        } else {
+            kept.push(std::move(done));
+        }
+    }
+    done_queue_.swap(kept);
+    
+    if (queued) {
+        TaskMetrics::Get().speculation_wasted_ns.Record(task->run_ns);
+    } else {
+        num_discarded_++;
+    }
+    cv_.notify_all();
+    return true;
+}
+
 size_t TaskManager::GetPendingCount() const {
-    return num_running_.load();
+    return LiveRunning();
 }
 
 bool TaskManager::AllCompleted() const {
@@ -792,6 +1051,52 @@ bool TaskManager::AllCompleted() const {
     return running_tasks_.empty() && done_queue_.empty();
 }
 
+bool TaskManager::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (num_running_.load() != 0 || !running_tasks_.empty()) {
+        return false;
+    }
+    std::queue<std::shared_ptr<Task>>().swap(done_queue_);
+    cancelled_ = false;
+    return true;
+}
+
+// =============================================================================
+// Pooled Run State
+// =============================================================================
+
+std::shared_ptr<Task> TaskArena::Acquire() {
+    if (next_ == tasks_.size()) {
+        tasks_.push_back(std::make_shared<Task>());
+    } else if (tasks_[next_].use_count() != 1) {
+        tasks_[next_] = std::make_shared<Task>();
+    }
+    return tasks_[next_++];
+}
+
+void TaskArena::Reset() {
+    for (size_t i = 0; i < next_; ++i) {
+        if (tasks_[i].use_count() == 1) {
+            tasks_[i]->Reset();
+        } else {
+            // Still referenced (e.g. by an interrupt), leave it to its owner
+            tasks_[i] = std::make_shared<Task>();
+        }
+    }
+    next_ = 0;
+}
+
+bool RunState::Reset() {
+    if (tasks && !tasks->Reset()) {
+        return false;
+    }
+    if (channels && !channels->Reset()) {
+        return false;
+    }
+    arena.Reset();
+    return true;
+}
+
 // =============================================================================
 // Factory Functions
 // =============================================================================
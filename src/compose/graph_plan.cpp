@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/compose/graph_plan.h"
+#include <stdexcept>
+
+namespace eino {
+namespace compose {
+
+constexpr int ExecutionPlan::kNoNode;
+
+const char* SelectExecutionMethod(bool input_is_stream,
+                                  const NodeCapabilities& caps,
+                                  bool downstream_expects_stream) {
+    if (input_is_stream) {
+        // Stream input: Transform > Collect > Invoke
+        if (downstream_expects_stream && caps.has_transform) {
+            return "Transform";
+        }
+        if (!downstream_expects_stream && caps.has_collect) {
+            return "Collect";
+        }
+        return "Invoke";
+    }
+    // Value input: Stream only if downstream wants one and the node can
+    if (downstream_expects_stream && caps.has_stream) {
+        return "Stream";
+    }
+    return "Invoke";
+}
+
+namespace {
+
+// FillCSR lays (row, value) pairs out as offsets/values, keeping the pair
+// order within each row
+void FillCSR(size_t rows, const std::vector<std::pair<int, int>>& pairs,
+             std::vector<int>& offsets, std::vector<int>& values) {
+    offsets.assign(rows + 1, 0);
+    for (const auto& p : pairs) {
+        offsets[p.first + 1]++;
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    values.assign(pairs.size(), 0);
+    std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto& p : pairs) {
+        values[cursor[p.first]++] = p.second;
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const ExecutionPlan> ExecutionPlan::Build(
+    const std::vector<NodeSpec>& nodes,
+    const std::vector<PlanEdge>& edges,
+    const std::string& start_name,
+    const std::string& end_name) {
+
+    std::shared_ptr<ExecutionPlan> plan(new ExecutionPlan());
+
+    auto add = [&](const std::string& name, std::shared_ptr<GraphNode> node,
+                   const NodeCapabilities& caps) {
+        if (!plan->ids_.emplace(name, static_cast<int>(plan->names_.size())).second) {
+            throw std::invalid_argument("duplicate node in execution plan: " + name);
+        }
+        plan->names_.push_back(name);
+        plan->nodes_.push_back(std::move(node));
+        plan->caps_.push_back(caps);
+    };
+
+    add(start_name, nullptr, NodeCapabilities());
+    add(end_name, nullptr, NodeCapabilities());
+    plan->start_id_ = 0;
+    plan->end_id_ = 1;
+    for (const auto& spec : nodes) {
+        add(spec.name, spec.node, spec.caps);
+    }
+
+    const size_t n = plan->names_.size();
+    std::vector<std::pair<int, int>> succ, data_succ, data_pred, ctrl_pred;
+    succ.reserve(edges.size());
+    for (const auto& edge : edges) {
+        int from = plan->Id(edge.from);
+        int to = plan->Id(edge.to);
+        if (from == kNoNode || to == kNoNode) {
+            throw std::invalid_argument("edge references unknown node: " +
+                                        edge.from + " -> " + edge.to);
+        }
+        succ.emplace_back(from, to);
+        if (edge.is_data_edge) {
+            data_succ.emplace_back(from, to);
+            data_pred.emplace_back(to, from);
+        }
+        if (edge.is_control_edge) {
+            ctrl_pred.emplace_back(to, from);
+        }
+    }
+    FillCSR(n, succ, plan->succ_offsets_, plan->succ_);
+    FillCSR(n, data_succ, plan->data_succ_offsets_, plan->data_succ_);
+    FillCSR(n, data_pred, plan->data_pred_offsets_, plan->data_pred_);
+    FillCSR(n, ctrl_pred, plan->ctrl_pred_offsets_, plan->ctrl_pred_);
+
+    // Downstream stream preference: the first data successor decides when it
+    // is END (graph output is non-stream); otherwise any successor that can
+    // only Transform wants a stream
+    plan->downstream_stream_.assign(n, 0);
+    for (size_t id = 0; id < n; ++id) {
+        for (int s : plan->DataSuccessors(static_cast<int>(id))) {
+            if (s == plan->end_id_) {
+                break;
+            }
+            const auto& caps = plan->caps_[s];
+            if (caps.has_transform && !caps.has_collect) {
+                plan->downstream_stream_[id] = 1;
+                break;
+            }
+        }
+    }
+
+    plan->value_methods_.resize(n);
+    plan->stream_methods_.resize(n);
+    for (size_t id = 0; id < n; ++id) {
+        bool downstream = plan->downstream_stream_[id] != 0;
+        if (static_cast<int>(id) == plan->start_id_ || static_cast<int>(id) == plan->end_id_) {
+            plan->value_methods_[id] = "Invoke";
+            plan->stream_methods_[id] = "Invoke";
+            continue;
+        }
+        plan->value_methods_[id] = SelectExecutionMethod(false, plan->caps_[id], downstream);
+        plan->stream_methods_[id] = SelectExecutionMethod(true, plan->caps_[id], downstream);
+    }
+
+    return plan;
+}
+
+std::vector<std::string> ExecutionPlan::Names(IdRange ids) const {
+    std::vector<std::string> out;
+    out.reserve(ids.size());
+    for (int id : ids) {
+        out.push_back(names_[id]);
+    }
+    return out;
+}
+
+} // namespace compose
+} // namespace eino
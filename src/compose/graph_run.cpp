@@ -20,15 +20,44 @@
 #include "eino/compose/graph_run.h"
 #include "eino/compose/graph.h"
 #include "eino/compose/graph_manager.h"
+#include "eino/compose/graph_plan.h"
 #include "eino/compose/state.h"
 #include "eino/compose/checkpoint.h"
 #include "eino/compose/typed_value.h"
+#include "eino/internal/metrics.h"
+#include <algorithm>
 #include <stdexcept>
 #include <nlohmann/json.hpp>
 
 namespace eino {
 namespace compose {
 
+namespace {
+
+// RunnerMetrics are recorded by the graph runner loop
+struct RunnerMetrics {
+    internal::metrics::Histogram superstep_ns;
+    internal::metrics::Histogram task_wait_ns;
+    internal::metrics::Counter speculations;
+
+    static const RunnerMetrics& Get() {
+        static const RunnerMetrics metrics;
+        return metrics;
+    }
+
+    RunnerMetrics() {
+        auto& registry = internal::metrics::Registry::Global();
+        superstep_ns = registry.GetHistogram("eino_superstep_ns",
+                                             "Duration of one graph superstep");
+        task_wait_ns = registry.GetHistogram("eino_task_wait_ns",
+                                             "Time the graph runner waited on running tasks");
+        speculations = registry.GetCounter("eino_branch_speculations_total",
+                                           "Branch targets started speculatively");
+    }
+};
+
+} // namespace
+
 using json = nlohmann::json;
 
 // =============================================================================
@@ -75,11 +104,16 @@ template<typename I, typename O>
 GraphRunner<I, O>::GraphRunner(
     std::shared_ptr<Graph<I, O>> graph,
     const GraphRunOptions& opts)
-    : graph_(graph), options_(opts), step_count_(0) {
+    : graph_(graph), options_(opts) {
     if (!graph_) {
         throw std::runtime_error("Graph cannot be null");
     }
     
+    plan_ = graph_->GetExecutionPlan();
+    if (!plan_) {
+        throw std::runtime_error("Graph has no execution plan, call Compile() first");
+    }
+    
     // Extract interrupt configuration from options
     // Aligns with: eino/compose/graph.go:834-836
     interrupt_before_nodes_ = opts.interrupt_before_nodes;
@@ -95,6 +129,24 @@ GraphRunner<I, O>::GraphRunner(
         check_pointer_ = std::make_shared<CheckPointer>(
             std::shared_ptr<CheckPointStore>(checkpoint_store_, [](CheckPointStore*){}));
     }
+    
+    // Run state is built once per concurrent run and reset in place after
+    for (bool is_stream : {false, true}) {
+        run_states_[is_stream].reset(new internal::ObjectPool<RunState>(
+            [this, is_stream]() { return NewRunState(is_stream); },
+            [](RunState& state) { return state.Reset(); }));
+    }
+}
+
+template<typename I, typename O>
+GraphRunner<I, O>::~GraphRunner() = default;
+
+template<typename I, typename O>
+std::unique_ptr<RunState> GraphRunner<I, O>::NewRunState(bool is_stream) {
+    std::unique_ptr<RunState> state(new RunState());
+    state->channels = InitChannelManager(is_stream);
+    state->tasks = InitTaskManager();
+    return state;
 }
 
 // Main execution method
@@ -119,8 +171,11 @@ O GraphRunner<I, O>::Run(
     
     // Initialize runtime components
     // Aligns with: eino/compose/graph_run.go:115-120
-    auto cm = InitChannelManager(is_stream);
-    auto tm = InitTaskManager();
+    // Checked out of the pool; returned (and reset) when the run ends
+    auto run_state = run_states_[is_stream]->Acquire();
+    auto cm = run_state->channels;
+    auto tm = run_state->tasks;
+    TaskArena* arena = &run_state->arena;
     
     int max_steps = options_.max_run_steps;
     
@@ -130,8 +185,9 @@ O GraphRunner<I, O>::Run(
         if (options_.max_run_steps > 0) {
             throw std::runtime_error("Cannot set max_run_steps in DAG mode");
         }
-        // DAG mode doesn't need step limit, use a large value as safety bound
-        max_steps = 1000;
+        // DAG mode doesn't need step limit, use a large value as safety bound;
+        // an eager run may take one step per node
+        max_steps = std::max<int>(1000, static_cast<int>(plan_->NodeCount()) + 1);
     } else {
         // Pregel mode requires step limit
         if (max_steps < 1) {
@@ -211,18 +267,8 @@ O GraphRunner<I, O>::Run(
         
         // Create initial tasks from START node
         // Aligns with: eino/compose/graph_run.go:165-213
-        auto start_task = std::make_shared<Task>("__START__");
-        start_task->input = std::make_shared<I>(input);
-        start_task->context = ctx;
-        start_task->status = TaskStatus::Queued;
-        
-        auto start_nodes = graph_->GetStartNodes();
-        for (const auto& node_name : start_nodes) {
-            auto task = std::make_shared<Task>(node_name);
-            task->input = std::make_shared<I>(input);
-            task->context = ctx;
-            task->status = TaskStatus::Queued;
-            next_tasks.push_back(task);
+        for (int node_id : plan_->Successors(plan_->StartId())) {
+            next_tasks.push_back(NewTask(ctx, node_id, std::make_shared<I>(input), arena));
         }
         
         // Check for interrupt before initial nodes
@@ -244,7 +290,9 @@ O GraphRunner<I, O>::Run(
     
     // Main execution loop
     // Aligns with: eino/compose/graph_run.go:232-363
-    for (step_count_ = 0; step_count_ < max_steps; ++step_count_) {
+    for (int step = 0; step < max_steps; ++step) {
+        step_count_.store(step, std::memory_order_relaxed);
+        
         // Check for context cancellation
         // Aligns with: eino/compose/graph_run.go:234-239
         if (ctx->IsCancelled()) {
@@ -252,20 +300,26 @@ O GraphRunner<I, O>::Run(
             throw std::runtime_error("Context has been canceled");
         }
         
-        if (next_tasks.empty()) {
+        // Eager runs carry tasks over from earlier steps, so the run is only
+        // out of work once nothing is queued or running
+        if (next_tasks.empty() && tm->GetPendingCount() == 0) {
             if (last_completed.empty()) {
                 throw std::runtime_error("No tasks to execute");
             }
             break;
         }
         
-        if (options_.run_type != GraphRunType::DAG && step_count_ >= max_steps) {
+        if (options_.run_type != GraphRunType::DAG && step >= max_steps) {
             throw std::runtime_error("Exceeded max run steps");
         }
         
-        // Submit tasks for execution
+        internal::metrics::ScopedTimer superstep_timer(RunnerMetrics::Get().superstep_ns);
+        
+        // Submit tasks for execution; in eager mode successors of a finished
+        // task start right away, alongside tasks still running
         // Aligns with: eino/compose/graph_run.go:249-252
         tm->Submit(next_tasks);
+        next_tasks.clear();
         
         // Wait for tasks to complete and handle cancellation
         // Aligns with: eino/compose/graph_run.go:254-271
@@ -274,7 +328,10 @@ O GraphRunner<I, O>::Run(
         std::vector<std::shared_ptr<Task>> cancelled_tasks;
         bool was_cancelled = false;
         
-        tm->Wait(completed_tasks, was_cancelled, cancelled_tasks);
+        {
+            internal::metrics::ScopedTimer wait_timer(RunnerMetrics::Get().task_wait_ns);
+            tm->Wait(completed_tasks, was_cancelled, cancelled_tasks);
+        }
         
         if (was_cancelled) {
             if (!cancelled_tasks.empty()) {
@@ -335,6 +392,8 @@ O GraphRunner<I, O>::Run(
         // Check for errors
         for (const auto& task : completed_tasks) {
             if (task->status == TaskStatus::Failed) {
+                // Stop waiting on tasks still running in eager mode
+                tm->Cancel();
                 if (task->error) {
                     throw *task->error;
                 }
@@ -345,13 +404,18 @@ O GraphRunner<I, O>::Run(
         // Calculate next tasks
         // Aligns with: eino/compose/graph_run.go:313-319
         auto [calc_next_tasks, calc_result, is_end, calc_err] = 
-            CalculateNextTasks(ctx, completed_tasks, is_stream, cm, std::map<std::string, std::vector<std::any>>{});
+            CalculateNextTasks(ctx, completed_tasks, is_stream, cm, std::map<std::string, std::vector<std::any>>{}, arena, tm.get());
         
         if (!calc_err.empty()) {
             throw std::runtime_error("Failed to calculate next tasks: " + calc_err);
         }
         
         if (is_end) {
+            // Eager runs may still have tasks off the END path in flight;
+            // drain them so the run state can go back to the pool
+            std::vector<std::shared_ptr<Task>> rest_completed;
+            std::vector<std::shared_ptr<Task>> rest_cancelled;
+            tm->WaitAll(rest_completed, rest_cancelled);
             return calc_result;
         }
         
@@ -382,6 +446,13 @@ O GraphRunner<I, O>::Run(
             
             ResolveInterruptCompletedTasks(temp_info, new_completed);
             
+            // Tasks that were still running in eager mode finished at this
+            // cut point and can hit interrupt-after too
+            auto drained_after = GetHitKeys(new_completed, interrupt_after_nodes_);
+            temp_info->interrupt_after_nodes.insert(
+                temp_info->interrupt_after_nodes.end(),
+                drained_after.begin(), drained_after.end());
+            
             if (!temp_info->sub_graph_interrupts.empty() || 
                 !temp_info->interrupt_rerun_nodes.empty()) {
                 
@@ -400,7 +471,7 @@ O GraphRunner<I, O>::Run(
             // Simple interrupt
             auto combined_next = next_tasks;
             auto [new_next, new_result, new_is_end, new_err] = 
-                CalculateNextTasks(ctx, new_completed, is_stream, cm, std::map<std::string, std::vector<std::any>>{});
+                CalculateNextTasks(ctx, new_completed, is_stream, cm, std::map<std::string, std::vector<std::any>>{}, arena);
             
             if (!new_err.empty()) {
                 throw std::runtime_error("Failed to calculate next tasks: " + new_err);
@@ -421,55 +492,44 @@ O GraphRunner<I, O>::Run(
 // Aligns with: eino/compose/graph_run.go:777-846
 template<typename I, typename O>
 std::shared_ptr<ChannelManager> GraphRunner<I, O>::InitChannelManager(bool is_stream) {
-    std::map<std::string, std::shared_ptr<Channel>> channels;
-    std::map<std::string, std::vector<std::string>> successors;
-    std::map<std::string, std::vector<std::string>> data_predecessors;
-    std::map<std::string, std::vector<std::string>> control_predecessors;
-    
-    auto create_channel = [this](const std::vector<std::string>& ctrl_deps,
-                                 const std::vector<std::string>& data_deps) {
-        if (options_.run_type == GraphRunType::DAG) {
-            return CreateDAGChannel(ctrl_deps, data_deps);
-        } else {
-            return CreatePregelChannel();
-        }
-    };
-    
-    auto node_names = graph_->GetNodeNames();
+    // One channel per plan node except START, whose successors are seeded
+    // directly with the graph input
+    std::vector<std::shared_ptr<Channel>> channels(plan_->NodeCount());
+    const int start_id = plan_->StartId();
     
-    for (const auto& node_name : node_names) {
-        auto edges = graph_->GetEdges(node_name);
-        
-        std::vector<std::string> node_successors;
-        
-        for (const auto& edge : edges) {
-            node_successors.push_back(edge.to);
-            
-            if (edge.is_data_edge) {
-                data_predecessors[edge.to].push_back(node_name);
+    for (size_t id = 0; id < channels.size(); ++id) {
+        if (static_cast<int>(id) == start_id) {
+            continue;
+        }
+        if (options_.run_type != GraphRunType::DAG) {
+            channels[id] = CreatePregelChannel();
+            continue;
+        }
+        std::vector<std::string> ctrl_deps;
+        std::vector<std::string> data_deps;
+        for (int pred : plan_->ControlPredecessors(static_cast<int>(id))) {
+            if (pred != start_id) {
+                ctrl_deps.push_back(plan_->Name(pred));
             }
-            if (edge.is_control_edge) {
-                control_predecessors[edge.to].push_back(node_name);
+        }
+        for (int pred : plan_->DataPredecessors(static_cast<int>(id))) {
+            if (pred != start_id) {
+                data_deps.push_back(plan_->Name(pred));
             }
         }
-        
-        successors[node_name] = node_successors;
-        
-        channels[node_name] = create_channel(
-            control_predecessors[node_name],
-            data_predecessors[node_name]
-        );
+        channels[id] = CreateDAGChannel(ctrl_deps, data_deps);
     }
     
-    return std::make_shared<ChannelManager>(
-        is_stream, channels, successors, data_predecessors, control_predecessors);
+    return std::make_shared<ChannelManager>(is_stream, plan_, channels);
 }
 
 // Initialize task manager
 // Aligns with: eino/compose/graph_run.go:766-775
 template<typename I, typename O>
 std::shared_ptr<TaskManager> GraphRunner<I, O>::InitTaskManager() {
-    bool need_all = !options_.eager_execution;
+    // Eager (barrier-free) dispatch is DAG-only; Pregel keeps supersteps
+    bool need_all = options_.run_type != GraphRunType::DAG ||
+                    !options_.eager_execution || options_.eager_disabled;
     return std::make_shared<TaskManager>(need_all);
 }
 
@@ -482,12 +542,14 @@ GraphRunner<I, O>::CalculateNextTasks(
     const std::vector<std::shared_ptr<Task>>& completed_tasks,
     bool is_stream,
     std::shared_ptr<ChannelManager> cm,
-    const std::map<std::string, std::vector<std::any>>& opt_map) {
+    const std::map<std::string, std::vector<std::any>>& opt_map,
+    TaskArena* arena,
+    TaskManager* tm) {
     
     std::map<std::string, std::map<std::string, std::shared_ptr<void>>> write_values;
     std::map<std::string, std::vector<std::string>> controls;
     
-    ResolveCompletedTasks(ctx, completed_tasks, is_stream, cm, write_values, controls);
+    ResolveCompletedTasks(ctx, completed_tasks, is_stream, cm, write_values, controls, arena, tm);
     
     auto node_map = cm->UpdateAndGet(write_values, controls);
     
@@ -497,7 +559,7 @@ GraphRunner<I, O>::CalculateNextTasks(
         return {std::vector<std::shared_ptr<Task>>{}, result, true, ""};
     }
     
-    auto next_tasks = CreateTasks(ctx, node_map);
+    auto next_tasks = CreateTasks(ctx, node_map, arena);
     return {next_tasks, result, false, ""};
 }
 
@@ -506,123 +568,56 @@ GraphRunner<I, O>::CalculateNextTasks(
 template<typename I, typename O>
 std::vector<std::shared_ptr<Task>> GraphRunner<I, O>::CreateTasks(
     std::shared_ptr<Context> ctx,
-    const std::map<std::string, std::shared_ptr<void>>& node_map) {
+    const std::map<std::string, std::shared_ptr<void>>& node_map,
+    TaskArena* arena) {
     
     std::vector<std::shared_ptr<Task>> tasks;
+    tasks.reserve(node_map.size());
     
     for (const auto& pair : node_map) {
-        const auto& node_name = pair.first;
-        auto node_input = pair.second;
-        
-        auto task = std::make_shared<Task>(node_name);
-        task->context = ctx;
-        task->input = node_input;
-        task->status = TaskStatus::Queued;
-        
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        // ⭐ 1. 设置 graph_node（用于 Execute 中获取 runnable）
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        task->graph_node = graph_->GetNode(node_name);
-        if (!task->graph_node) {
-            throw std::runtime_error("Node not found in graph: " + node_name);
+        int node_id = plan_->Id(pair.first);
+        if (node_id == ExecutionPlan::kNoNode) {
+            throw std::runtime_error("Node not found in graph: " + pair.first);
         }
-        
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        // ⭐ 2. 智能方法选择（Smart Method Selection）
-        // Aligns with: eino/compose/graph_run.go:124-125
-        //   runWrapper = runnableInvoke
-        //   if isStream { runWrapper = runnableTransform }
-        //
-        // 决策逻辑：
-        //   1. 检测输入类型（是否为 StreamReader）
-        //   2. 检测节点能力（支持哪些方法）
-        //   3. 检测下游需求（后继节点是否期望流式输入）
-        //   4. 根据决策矩阵选择最优方法
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        task->execution_method = DetermineExecutionMethod(
-            node_input, 
-            task->graph_node, 
-            node_name);
-        
-        tasks.push_back(task);
+        tasks.push_back(NewTask(ctx, node_id, pair.second, arena));
     }
     
     return tasks;
 }
 
+// NewTask builds a queued task for a plan node; the GraphNode and the
+// execution method come straight from the compiled plan
+template<typename I, typename O>
+std::shared_ptr<Task> GraphRunner<I, O>::NewTask(
+    std::shared_ptr<Context> ctx,
+    int node_id,
+    std::shared_ptr<void> input,
+    TaskArena* arena) {
+    
+    auto task = arena ? arena->Acquire() : std::make_shared<Task>();
+    task->node_key = plan_->Name(node_id);
+    task->node_id = node_id;
+    task->context = ctx;
+    task->input = input;
+    task->status = TaskStatus::Queued;
+    task->graph_node = plan_->Node(node_id);
+    
+    // Smart method selection, precomputed per node at Compile()
+    // Aligns with: eino/compose/graph_run.go:124-125
+    task->execution_method = DetermineExecutionMethod(node_id, task->input);
+    return task;
+}
+
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// ⭐ Helper: Determine execution method based on input type, 
-//           node capabilities, and downstream requirements
+// ⭐ Helper: Determine execution method
+// Node capabilities and downstream requirements are folded into the plan at
+// Compile() (see SelectExecutionMethod); only the input kind is per task
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 template<typename I, typename O>
-std::string GraphRunner<I, O>::DetermineExecutionMethod(
-    std::shared_ptr<void> input,
-    std::shared_ptr<GraphNode> graph_node,
-    const std::string& node_name) {
-    
-    if (!graph_node || !graph_node->runnable) {
-        // Fallback: default to Invoke
-        return "Invoke";
-    }
-    
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    // STEP 1: 检测输入是否为流式（StreamReader）
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    bool input_is_stream = IsStreamInput(input);
-    
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    // STEP 2: 检测节点能力
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    NodeCapabilities caps = DetectNodeCapabilities(graph_node);
-    
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    // STEP 3: 检测下游是否需要流式输出
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    bool downstream_expects_stream = CheckDownstreamExpectsStream(node_name);
-    
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    // STEP 4: 决策矩阵（Decision Matrix）
-    // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    
-    if (input_is_stream) {
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        // 流式输入 → 优先级：Transform > Collect > Invoke
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        if (downstream_expects_stream && caps.has_transform) {
-            // 最优：流式→流式（无需转换）
-            return "Transform";
-        }
-        if (!downstream_expects_stream && caps.has_collect) {
-            // 次优：流式→非流式（主动收集）
-            return "Collect";
-        }
-        if (caps.has_invoke) {
-            // 兜底：先收集再调用（隐式转换）
-            return "Invoke";
-        }
-        // 完全无能力，默认 Invoke（会失败）
-        return "Invoke";
-        
-    } else {
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        // 非流式输入 → 根据下游需求决定
-        // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-        if (downstream_expects_stream) {
-            // 下游需要流：优先使用 Stream 方法
-            if (caps.has_stream) {
-                return "Stream";
-            }
-            // 兜底：Invoke + 后续包装（由 Execute 处理）
-            return "Invoke";
-        } else {
-            // 下游不需要流：直接使用 Invoke
-            if (caps.has_invoke) {
-                return "Invoke";
-            }
-            // 兜底：默认 Invoke
-            return "Invoke";
-        }
-    }
+const std::string& GraphRunner<I, O>::DetermineExecutionMethod(
+    int node_id,
+    const std::shared_ptr<void>& input) {
+    return plan_->ExecutionMethod(node_id, IsStreamInput(input));
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -670,81 +665,6 @@ bool GraphRunner<I, O>::IsStreamInput(std::shared_ptr<void> input) {
     return IsStreamValue(input);
 }
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// ⭐ Helper: Detect node capabilities (which methods it supports)
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-template<typename I, typename O>
-typename GraphRunner<I, O>::NodeCapabilities 
-GraphRunner<I, O>::DetectNodeCapabilities(std::shared_ptr<GraphNode> graph_node) {
-    
-    NodeCapabilities caps;
-    
-    if (!graph_node || !graph_node->runnable) {
-        return caps;
-    }
-    
-    // ⭐ CRITICAL: Capability detection
-    // In a production implementation, this would:
-    // 1. Check if runnable implements each interface (Invoke/Stream/Collect/Transform)
-    // 2. Cache capabilities in GraphNode to avoid repeated detection
-    // 3. Use reflection or interface checking
-    
-    try {
-        // Attempt to cast to ComposableRunnable<I, O>
-        auto runnable = std::static_pointer_cast<ComposableRunnable<I, O>>(graph_node->runnable);
-        
-        if (runnable) {
-            // ✅ All ComposableRunnable support all methods
-            caps.has_invoke = true;
-            caps.has_stream = true;
-            caps.has_collect = true;
-            caps.has_transform = true;
-        }
-    } catch (...) {
-        // Basic Runnable only supports Invoke
-        caps.has_invoke = true;
-    }
-    
-    return caps;
-}
-
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// ⭐ Helper: Check if downstream nodes expect stream input
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-template<typename I, typename O>
-bool GraphRunner<I, O>::CheckDownstreamExpectsStream(const std::string& node_name) {
-    
-    // ⭐ CRITICAL: Downstream analysis
-    // This requires looking at successor nodes and checking if:
-    // 1. They have Transform capability (prefer stream input)
-    // 2. They are configured to run in stream mode
-    // 3. The edge is marked as stream-only
-    
-    // Get successors
-    auto successors = graph_->GetSuccessors(node_name);
-    
-    // If output goes to END node, check graph's output mode
-    for (const auto& succ : successors) {
-        if (succ == Graph<I, O>::END_NODE) {
-            // Check if graph is in stream mode (from runner options)
-            // For now, default to non-stream
-            return false;
-        }
-        
-        // Check if any successor prefers stream input
-        auto succ_node = graph_->GetNode(succ);
-        if (succ_node) {
-            NodeCapabilities caps = DetectNodeCapabilities(succ_node);
-            // If successor has Transform capability, it prefers stream
-            if (caps.has_transform && !caps.has_collect) {
-                return true;
-            }
-        }
-    }
-    
-    return false;
-}
-
 // Resolve completed tasks and update channels
 // Aligns with: eino/compose/graph_run.go:702-764
 template<typename I, typename O>
@@ -754,22 +674,32 @@ void GraphRunner<I, O>::ResolveCompletedTasks(
     bool is_stream,
     std::shared_ptr<ChannelManager> cm,
     std::map<std::string, std::map<std::string, std::shared_ptr<void>>>& write_values,
-    std::map<std::string, std::vector<std::string>>& controls) {
+    std::map<std::string, std::vector<std::string>>& controls,
+    TaskArena* arena,
+    TaskManager* tm) {
     
     for (const auto& task : completed_tasks) {
-        auto successors = cm->GetSuccessors(task->node_key);
+        int node_id = task->node_id != ExecutionPlan::kNoNode ? task->node_id
+                                                              : plan_->Id(task->node_key);
+        std::vector<std::string> successors;
+        if (node_id != ExecutionPlan::kNoNode) {
+            successors = plan_->Names(plan_->Successors(node_id));
+        }
         
         auto branches = graph_->GetBranches(task->node_key);
-        if (!branches.empty()) {
-            std::vector<std::shared_ptr<void>> branch_inputs;
-            for (size_t i = 0; i < branches.size(); ++i) {
-                branch_inputs.push_back(task->output);
-            }
-            
-            for (size_t i = 0; i < branches.size(); ++i) {
-                auto branch_successors = branches[i]->Invoke(task->context.get(), task->output.get());
-                successors.insert(successors.end(), branch_successors.begin(), branch_successors.end());
+        for (const auto& branch : branches) {
+            // Predicted targets race the condition; see branch_speculation.h
+            auto speculated = SpeculateBranch(branch, task, arena, tm);
+            std::vector<std::string> speculated_keys;
+            for (const auto& spec : speculated) {
+                speculated_keys.push_back(spec->node_key);
             }
+            auto branch_successors = ResolveSpeculation(
+                speculated_keys,
+                [&]() { return branch->Invoke(task->context.get(), task->output.get()); },
+                [&](size_t i) { tm->Cancel(speculated[i]); },
+                branch->GetPredictor().get());
+            successors.insert(successors.end(), branch_successors.begin(), branch_successors.end());
         }
         
         for (const auto& successor : successors) {
@@ -782,6 +712,38 @@ void GraphRunner<I, O>::ResolveCompletedTasks(
     }
 }
 
+// Only idempotent targets whose sole trigger is the branch are started, so
+// an adopted speculative task is exactly the run the branch would schedule
+template<typename I, typename O>
+std::vector<std::shared_ptr<Task>> GraphRunner<I, O>::SpeculateBranch(
+    const std::shared_ptr<GraphBranch>& branch,
+    const std::shared_ptr<Task>& source,
+    TaskArena* arena,
+    TaskManager* tm) {
+    
+    std::vector<std::shared_ptr<Task>> speculated;
+    auto predictor = branch->GetPredictor();
+    if (!tm || !predictor || !source->output || IsStreamInput(source->output)) {
+        // A stream can't be read by both the condition and a target
+        return speculated;
+    }
+    
+    auto idempotent = [this](int id) {
+        const auto& node = plan_->Node(id);
+        return node && node->info.idempotent;
+    };
+    for (int id : SpeculationTargets(*plan_, predictor->Predict(), idempotent,
+                                     interrupt_before_nodes_)) {
+        auto task = NewTask(source->context, id, source->output, arena);
+        if (!tm->Speculate(task)) {
+            break;
+        }
+        RunnerMetrics::Get().speculations.Inc();
+        speculated.push_back(task);
+    }
+    return speculated;
+}
+
 // Resolve interrupt information from completed tasks
 // Aligns with: eino/compose/graph_run.go:418-451
 template<typename I, typename O>
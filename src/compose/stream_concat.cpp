@@ -17,6 +17,7 @@
 #include "eino/compose/stream_concat.h"
 
 #include "eino/schema/message.h"
+#include "eino/schema/message_concat.h"
 
 namespace eino {
 namespace compose {
@@ -51,33 +52,18 @@ void StreamChunkConcatRegistry::RegisterDefaultConcatFuncs() {
             return result;
         });
     
-    // Register concat function for Message (combine content)
+    // Register concat function for Message, with ConcatMessages semantics
     RegisterConcatFunc<schema::Message>(
         [](const std::vector<schema::Message>& items) {
             if (items.empty()) {
                 return schema::Message();
             }
             
-            schema::Message result = items[0];
-            for (size_t i = 1; i < items.size(); ++i) {
-                // Concatenate content
-                result.content += items[i].content;
-                
-                // Merge tool calls if any
-                if (!items[i].tool_calls.empty()) {
-                    result.tool_calls.insert(
-                        result.tool_calls.end(),
-                        items[i].tool_calls.begin(),
-                        items[i].tool_calls.end());
-                }
-                
-                // Keep the last response_metadata
-                if (!items[i].response_metadata.empty()) {
-                    result.response_metadata = items[i].response_metadata;
-                }
+            schema::MessageConcatenator concat;
+            for (const auto& item : items) {
+                concat.Add(item);
             }
-            
-            return result;
+            return concat.Finish();
         });
     
     // Register concat function for ChatModelResponse
@@ -15,6 +15,7 @@
  */
 
 #include "../../include/eino/compose/tool_node.h"
+#include "eino/internal/metrics.h"
 #include <thread>
 #include <future>
 #include <sstream>
@@ -22,6 +23,31 @@
 namespace eino {
 namespace compose {
 
+namespace {
+
+// ToolMetrics are recorded by ToolsNode
+struct ToolMetrics {
+    internal::metrics::Counter tool_calls;
+    internal::metrics::Counter tool_errors;
+    internal::metrics::HistogramFamily tool_duration_ns;
+
+    static const ToolMetrics& Get() {
+        static const ToolMetrics metrics;
+        return metrics;
+    }
+
+    ToolMetrics()
+        : tool_duration_ns("eino_tool_duration_ns", "Tool execution time", "tool") {
+        auto& registry = internal::metrics::Registry::Global();
+        tool_calls = registry.GetCounter("eino_tool_calls_total",
+                                         "Tool invocations made by ToolsNode");
+        tool_errors = registry.GetCounter("eino_tool_errors_total",
+                                          "Tool invocations that failed");
+    }
+};
+
+} // namespace
+
 // New creates a new ToolsNode with configuration
 // Aligns with eino compose.NewToolNode
 // Go reference: eino/compose/tool_node.go lines 172-262
@@ -163,10 +189,14 @@ schema::Message ToolsNode::ExecuteTool(
     endpoint = ApplyInvokableMiddleware(endpoint);
     
     // Execute tool
+    const auto& metrics = ToolMetrics::Get();
+    metrics.tool_calls.Inc();
+    internal::metrics::ScopedTimer timer(metrics.tool_duration_ns.WithLabel(tool_name));
     try {
         auto output = endpoint(ctx, tool_input);
         return schema::ToolMessage(call_id, tool_name, output->result);
     } catch (const std::exception& e) {
+        metrics.tool_errors.Inc();
         return schema::ToolMessage(
             call_id, 
             tool_name,
@@ -259,6 +289,9 @@ std::shared_ptr<StreamReader<schema::Message>> ToolsNode::ExecuteToolStream(
     endpoint = ApplyStreamableMiddleware(endpoint);
     
     // Execute tool
+    const auto& metrics = ToolMetrics::Get();
+    metrics.tool_calls.Inc();
+    internal::metrics::ScopedTimer timer(metrics.tool_duration_ns.WithLabel(tool_name));
     try {
         auto stream_output = endpoint(ctx, tool_input);
         
@@ -275,6 +308,7 @@ std::shared_ptr<StreamReader<schema::Message>> ToolsNode::ExecuteToolStream(
         return std::make_shared<SimpleStreamReader<schema::Message>>(
             std::vector<schema::Message>{msg});
     } catch (const std::exception& e) {
+        metrics.tool_errors.Inc();
         auto error_msg = schema::ToolMessage(
             call_id, 
             tool_name,
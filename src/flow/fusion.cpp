@@ -0,0 +1,188 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/flow/retriever/fusion.h"
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace eino {
+namespace flow {
+namespace retriever {
+
+namespace {
+
+// Ids are interned by pointer into the input lists, so no id is copied
+struct InternedIdHash {
+    size_t operator()(const std::string* id) const {
+        return std::hash<std::string>()(*id);
+    }
+};
+
+struct InternedIdEqual {
+    bool operator()(const std::string* a, const std::string* b) const {
+        return *a == *b;
+    }
+};
+
+} // namespace
+
+std::vector<FusedLocation> FuseOrder(
+    const std::vector<const std::vector<schema::Document>*>& lists,
+    const FusionOptions& options) {
+    size_t total = 0;
+    for (const auto* docs : lists) {
+        total += docs->size();
+    }
+
+    std::unordered_map<const std::string*, uint32_t, InternedIdHash, InternedIdEqual> ids;
+    ids.reserve(total);
+    std::vector<FusedLocation> first_seen;  // dense doc index -> first location
+    std::vector<double> scores;             // dense doc index -> fused score
+    first_seen.reserve(total);
+    scores.reserve(total);
+
+    double rrf_k = options.rrf_k > 0.0 ? options.rrf_k : 60.0;
+
+    for (size_t l = 0; l < lists.size(); ++l) {
+        const auto& docs = *lists[l];
+        double weight = l < options.weights.size() ? options.weights[l] : 1.0;
+
+        double min_score = 0.0;
+        double max_score = 0.0;
+        if (options.mode == FusionMode::kScoreNormalized && !docs.empty()) {
+            min_score = max_score = docs[0].GetScore();
+            for (const auto& doc : docs) {
+                double s = doc.GetScore();
+                min_score = std::min(min_score, s);
+                max_score = std::max(max_score, s);
+            }
+        }
+
+        for (size_t i = 0; i < docs.size(); ++i) {
+            auto ins = ids.emplace(&docs[i].id, static_cast<uint32_t>(first_seen.size()));
+            if (ins.second) {
+                first_seen.emplace_back(static_cast<uint32_t>(l), static_cast<uint32_t>(i));
+                scores.push_back(0.0);
+            }
+            uint32_t u = ins.first->second;
+
+            switch (options.mode) {
+                case FusionMode::kRRF:
+                    scores[u] += weight / (rrf_k + static_cast<double>(i));
+                    break;
+                case FusionMode::kScoreNormalized: {
+                    double range = max_score - min_score;
+                    double norm = range > 0.0 ? (docs[i].GetScore() - min_score) / range : 1.0;
+                    scores[u] += weight * norm;
+                    break;
+                }
+                case FusionMode::kDedup:
+                    break;
+            }
+        }
+    }
+
+    size_t n = first_seen.size();
+    size_t k = n;
+    if (options.max_results > 0) {
+        k = std::min(n, static_cast<size_t>(options.max_results));
+    }
+
+    std::vector<FusedLocation> order;
+    order.reserve(k);
+
+    if (options.mode == FusionMode::kDedup) {
+        order.assign(first_seen.begin(), first_seen.begin() + k);
+        return order;
+    }
+
+    // better(a, b): a ranks before b; ties keep first-seen order
+    auto better = [&scores](uint32_t a, uint32_t b) {
+        if (scores[a] != scores[b]) {
+            return scores[a] > scores[b];
+        }
+        return a < b;
+    };
+
+    std::vector<uint32_t> ranked;
+    if (k < n) {
+        // Bounded heap whose front is the worst of the current top-k
+        ranked.reserve(k);
+        for (uint32_t u = 0; u < n; ++u) {
+            if (ranked.size() < k) {
+                ranked.push_back(u);
+                std::push_heap(ranked.begin(), ranked.end(), better);
+            } else if (k > 0 && better(u, ranked.front())) {
+                std::pop_heap(ranked.begin(), ranked.end(), better);
+                ranked.back() = u;
+                std::push_heap(ranked.begin(), ranked.end(), better);
+            }
+        }
+        std::sort_heap(ranked.begin(), ranked.end(), better);
+    } else {
+        ranked.resize(n);
+        for (uint32_t u = 0; u < n; ++u) {
+            ranked[u] = u;
+        }
+        std::sort(ranked.begin(), ranked.end(), better);
+    }
+
+    for (uint32_t u : ranked) {
+        order.push_back(first_seen[u]);
+    }
+    return order;
+}
+
+std::vector<FusedLocation> FuseOrder(
+    const std::vector<std::vector<schema::Document>>& lists,
+    const FusionOptions& options) {
+    std::vector<const std::vector<schema::Document>*> views;
+    views.reserve(lists.size());
+    for (const auto& docs : lists) {
+        views.push_back(&docs);
+    }
+    return FuseOrder(views, options);
+}
+
+std::vector<schema::Document> FuseDocuments(
+    std::vector<std::vector<schema::Document>>&& lists,
+    const FusionOptions& options) {
+    auto order = FuseOrder(lists, options);
+    std::vector<schema::Document> result;
+    result.reserve(order.size());
+    for (const auto& loc : order) {
+        result.push_back(std::move(lists[loc.first][loc.second]));
+    }
+    return result;
+}
+
+std::vector<schema::Document> FuseDocuments(
+    const std::vector<std::vector<schema::Document>>& lists,
+    const FusionOptions& options) {
+    auto order = FuseOrder(lists, options);
+    std::vector<schema::Document> result;
+    result.reserve(order.size());
+    for (const auto& loc : order) {
+        result.push_back(lists[loc.first][loc.second]);
+    }
+    return result;
+}
+
+} // namespace retriever
+} // namespace flow
+} // namespace eino
@@ -17,6 +17,7 @@
 #include "eino/flow/retriever/multi_query_retriever.h"
 #include <algorithm>
 #include <thread>
+#include <utility>
 
 namespace eino {
 namespace flow {
@@ -29,16 +30,10 @@ std::shared_ptr<MultiQueryRetriever> MultiQueryRetriever::Create(
     mqr->retriever_ = config.retriever;
     mqr->rewrite_handler_ = config.rewrite_handler;
     mqr->max_queries_num_ = config.max_queries_num > 0 ? config.max_queries_num : 5;
+    mqr->fusion_options_ = config.fusion_options;
     
-    // Set fusion function (use provided or default)
-    if (config.fusion_func) {
-        mqr->fusion_func_ = config.fusion_func;
-    } else {
-        mqr->fusion_func_ = [](std::shared_ptr<compose::Context> ctx, 
-                                const std::vector<std::vector<schema::Document>>& docs_list) {
-            return MultiQueryRetriever::DefaultFusion(ctx, docs_list);
-        };
-    }
+    // Custom fusion function; when unset Retrieve fuses in place
+    mqr->fusion_func_ = config.fusion_func;
     
     return mqr;
 }
@@ -67,14 +62,14 @@ std::vector<schema::Document> MultiQueryRetriever::Retrieve(
     
     // Retrieve documents for each query (sequentially for now)
     std::vector<std::vector<schema::Document>> results;
+    results.reserve(queries.size());
     for (const auto& q : queries) {
-        auto docs = retriever_->Retrieve(ctx, q, opts);
-        results.push_back(docs);
+        results.push_back(retriever_->Retrieve(ctx, q, opts));
     }
     
     // Fusion
     if (!fusion_func_) {
-        return DefaultFusion(ctx, results);
+        return FuseDocuments(std::move(results), fusion_options_);
     }
     return fusion_func_(ctx, results);
 }
@@ -83,20 +78,8 @@ std::vector<schema::Document> MultiQueryRetriever::DefaultFusion(
     std::shared_ptr<compose::Context> ctx,
     const std::vector<std::vector<schema::Document>>& docs_list) {
     
-    std::vector<schema::Document> result;
-    std::vector<std::string> seen_ids;
-    
-    for (const auto& docs : docs_list) {
-        for (const auto& doc : docs) {
-            // Deduplicate by document ID
-            if (std::find(seen_ids.begin(), seen_ids.end(), doc.id) == seen_ids.end()) {
-                seen_ids.push_back(doc.id);
-                result.push_back(doc);
-            }
-        }
-    }
-    
-    return result;
+    // Deduplicate by document ID, keeping first occurrences in order
+    return FuseDocuments(docs_list, FusionOptions(FusionMode::kDedup));
 }
 
 std::vector<std::string> MultiQueryRetriever::GenerateQueries(
@@ -16,7 +16,7 @@
 
 #include "eino/flow/retriever/router_retriever.h"
 #include <algorithm>
-#include <cmath>
+#include <utility>
 
 namespace eino {
 namespace flow {
@@ -28,16 +28,11 @@ std::shared_ptr<RouterRetriever> RouterRetriever::Create(
     auto rr = std::make_shared<RouterRetriever>();
     rr->retrievers_ = config.retrievers;
     rr->router_ = config.router;
+    rr->fusion_options_ = config.fusion_options;
+    rr->retriever_weights_ = config.retriever_weights;
     
-    // Set fusion function (use provided or default)
-    if (config.fusion_func) {
-        rr->fusion_func_ = config.fusion_func;
-    } else {
-        rr->fusion_func_ = [](std::shared_ptr<compose::Context> ctx,
-                               const std::map<std::string, std::vector<schema::Document>>& results) {
-            return RouterRetriever::DefaultRRFFusion(ctx, results);
-        };
-    }
+    // Custom fusion function; when unset Retrieve fuses in place with RRF
+    rr->fusion_func_ = config.fusion_func;
     
     return rr;
 }
@@ -54,72 +49,52 @@ std::vector<schema::Document> RouterRetriever::Retrieve(
         return std::vector<schema::Document>();
     }
     
-    // Retrieve documents from selected retrievers
-    std::map<std::string, std::vector<schema::Document>> results;
+    // Custom fusion receives results keyed by retriever name
+    if (fusion_func_) {
+        std::map<std::string, std::vector<schema::Document>> results;
+        for (const auto& name : retriever_names) {
+            auto it = retrievers_.find(name);
+            if (it != retrievers_.end() && it->second) {
+                results[name] = it->second->Retrieve(ctx, query, opts);
+            }
+        }
+        return fusion_func_(ctx, results);
+    }
+    
+    // Built-in fusion: retrieved lists are fused and their documents moved out
+    std::vector<std::vector<schema::Document>> lists;
+    FusionOptions options = fusion_options_;
+    options.weights.clear();
+    lists.reserve(retriever_names.size());
+    options.weights.reserve(retriever_names.size());
     for (const auto& name : retriever_names) {
         auto it = retrievers_.find(name);
         if (it != retrievers_.end() && it->second) {
-            auto docs = it->second->Retrieve(ctx, query, opts);
-            results[name] = docs;
+            lists.push_back(it->second->Retrieve(ctx, query, opts));
+            auto weight = retriever_weights_.find(name);
+            options.weights.push_back(weight != retriever_weights_.end() ? weight->second : 1.0);
         }
     }
     
-    // Fusion
-    if (!fusion_func_) {
-        return DefaultRRFFusion(ctx, results);
-    }
-    return fusion_func_(ctx, results);
+    return FuseDocuments(std::move(lists), options);
 }
 
 std::vector<schema::Document> RouterRetriever::DefaultRRFFusion(
     std::shared_ptr<compose::Context> ctx,
     const std::map<std::string, std::vector<schema::Document>>& results) {
     
-    if (results.empty()) {
-        return std::vector<schema::Document>();
-    }
-    
-    // If only one retriever returned results
-    if (results.size() == 1) {
-        return results.begin()->second;
-    }
-    
-    // Reciprocal Rank Fusion (RRF)
-    std::map<std::string, double> doc_rank_map;  // doc_id -> rank score
-    std::map<std::string, schema::Document> doc_map;  // doc_id -> document
-    
+    std::vector<const std::vector<schema::Document>*> lists;
+    lists.reserve(results.size());
     for (const auto& pair : results) {
-        const auto& docs = pair.second;
-        for (size_t i = 0; i < docs.size(); ++i) {
-            doc_map[docs[i].id] = docs[i];
-            
-            if (doc_rank_map.find(docs[i].id) == doc_rank_map.end()) {
-                // 1 / (i + 60) is the RRF formula
-                doc_rank_map[docs[i].id] = 1.0 / (i + 60.0);
-            } else {
-                doc_rank_map[docs[i].id] += 1.0 / (i + 60.0);
-            }
-        }
-    }
-    
-    // Sort by rank score - convert to vector of (score, doc) pairs
-    std::vector<std::pair<double, schema::Document>> sorted_docs;
-    for (const auto& pair : doc_map) {
-        sorted_docs.push_back({doc_rank_map[pair.first], pair.second});
-    }
-    
-    // Custom sort using simple comparison
-    for (size_t i = 0; i < sorted_docs.size(); ++i) {
-        for (size_t j = i + 1; j < sorted_docs.size(); ++j) {
-            if (sorted_docs[j].first > sorted_docs[i].first) {
-                std::swap(sorted_docs[i], sorted_docs[j]);
-            }
-        }
+        lists.push_back(&pair.second);
     }
     
+    // Reciprocal Rank Fusion (RRF); only the fused documents are copied
+    auto order = FuseOrder(lists, FusionOptions(FusionMode::kRRF));
     std::vector<schema::Document> result;
-    for (const auto& pair : sorted_docs) {
-        result.push_back(pair.second);  // pair.first is score, pair.second is document
+    result.reserve(order.size());
+    for (const auto& loc : order) {
+        result.push_back((*lists[loc.first])[loc.second]);
     }
     
     return result;
@@ -0,0 +1,438 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/internal/metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <unordered_map>
+
+namespace eino {
+namespace internal {
+namespace metrics {
+
+namespace {
+
+// Discard absorbs records made while a thread is being torn down, after its
+// shard was retired; racy increments there are harmless and never exported
+ThreadShard* DiscardShard() {
+    static ThreadShard* shard = new ThreadShard();
+    return shard;
+}
+
+// ShardOwner retires the thread's shard when the thread exits
+struct ShardOwner {
+    ThreadShard* shard = nullptr;
+
+    ~ShardOwner() {
+        if (shard != nullptr) {
+            Registry::Global().RetireShard(shard);
+            LocalShardSlot() = DiscardShard();
+        }
+    }
+};
+
+uint64_t Load(const std::atomic<uint64_t>& cell) {
+    return cell.load(std::memory_order_relaxed);
+}
+
+// Accumulate adds src into dst; the caller holds the registry mutex
+void Accumulate(ThreadShard* dst, const ThreadShard* src) {
+    for (uint32_t i = 0; i < kMaxCounters; ++i) {
+        uint64_t v = Load(src->counters[i]);
+        if (v != 0) {
+            Bump(dst->counters[i], v);
+        }
+    }
+    for (uint32_t id = 0; id < kMaxHistograms; ++id) {
+        HistogramCells* from = src->histograms[id].load(std::memory_order_acquire);
+        if (from == nullptr || Load(from->count) == 0) {
+            continue;
+        }
+        HistogramCells* to = dst->Cells(id);
+        for (uint32_t b = 0; b < kNumBuckets; ++b) {
+            uint64_t v = Load(from->buckets[b]);
+            if (v != 0) {
+                Bump(to->buckets[b], v);
+            }
+        }
+        Bump(to->count, Load(from->count));
+        Bump(to->sum, Load(from->sum));
+        if (Load(from->max) > Load(to->max)) {
+            to->max.store(Load(from->max), std::memory_order_relaxed);
+        }
+    }
+}
+
+std::string FormatLabels(const Labels& labels, const std::string& extra_key = "",
+                         const std::string& extra_value = "") {
+    if (labels.empty() && extra_key.empty()) {
+        return "";
+    }
+    std::string out = "{";
+    bool first = true;
+    auto append = [&](const std::string& k, const std::string& v) {
+        if (!first) {
+            out += ",";
+        }
+        first = false;
+        out += k;
+        out += "=\"";
+        for (char c : v) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+        out += "\"";
+    };
+    for (const auto& kv : labels) {
+        append(kv.first, kv.second);
+    }
+    if (!extra_key.empty()) {
+        append(extra_key, extra_value);
+    }
+    out += "}";
+    return out;
+}
+
+std::string JSONString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += "\"";
+    return out;
+}
+
+std::string JSONLabels(const Labels& labels) {
+    std::string out = "{";
+    bool first = true;
+    for (const auto& kv : labels) {
+        if (!first) {
+            out += ",";
+        }
+        first = false;
+        out += JSONString(kv.first) + ":" + JSONString(kv.second);
+    }
+    out += "}";
+    return out;
+}
+
+} // namespace
+
+HistogramCells::HistogramCells() : count(0), sum(0), max(0) {
+    for (auto& b : buckets) {
+        b.store(0, std::memory_order_relaxed);
+    }
+}
+
+ThreadShard::ThreadShard() {
+    for (auto& c : counters) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    for (auto& h : histograms) {
+        h.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ThreadShard::~ThreadShard() {
+    for (auto& h : histograms) {
+        delete h.load(std::memory_order_relaxed);
+    }
+}
+
+HistogramCells* ThreadShard::AllocateCells(uint32_t id) {
+    auto* cells = new HistogramCells();
+    // Release so a concurrent snapshot sees zeroed cells
+    histograms[id].store(cells, std::memory_order_release);
+    return cells;
+}
+
+ThreadShard* LocalShardSlow() {
+    static thread_local ShardOwner owner;
+    if (owner.shard == nullptr) {
+        owner.shard = new ThreadShard();
+        Registry::Global().AddShard(owner.shard);
+    }
+    LocalShardSlot() = owner.shard;
+    return owner.shard;
+}
+
+double HistogramSnapshot::Percentile(double p) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    p = std::max(0.0, std::min(100.0, p));
+    double rank = p / 100.0 * static_cast<double>(count);
+    uint64_t seen = 0;
+    uint64_t prev_upper = 0;
+    for (const auto& b : buckets) {
+        uint64_t lower = BucketLowerBound(BucketIndex(b.first));
+        if (static_cast<double>(seen + b.second) >= rank) {
+            // Interpolate inside the bucket, clamped to the observed max
+            double frac = b.second ? (rank - static_cast<double>(seen)) / b.second : 0.0;
+            double value = static_cast<double>(lower) +
+                           frac * static_cast<double>(b.first - lower);
+            return std::min(value, static_cast<double>(max));
+        }
+        seen += b.second;
+        prev_upper = b.first;
+    }
+    return static_cast<double>(std::max(prev_upper, max));
+}
+
+std::string MetricsSnapshot::ToPrometheus() const {
+    std::ostringstream out;
+    std::string last_name;
+    for (const auto& c : counters) {
+        if (c.name != last_name) {
+            out << "# HELP " << c.name << " " << c.help << "\n";
+            out << "# TYPE " << c.name << " counter\n";
+            last_name = c.name;
+        }
+        out << c.name << FormatLabels(c.labels) << " " << c.value << "\n";
+    }
+    last_name.clear();
+    for (const auto& h : histograms) {
+        if (h.name != last_name) {
+            out << "# HELP " << h.name << " " << h.help << "\n";
+            out << "# TYPE " << h.name << " histogram\n";
+            last_name = h.name;
+        }
+        uint64_t cumulative = 0;
+        size_t next = 0;
+        for (int k = 0; k < kExportedBuckets; ++k) {
+            uint64_t le = ExportedBucketBound(k);
+            while (next < h.buckets.size() && h.buckets[next].first <= le) {
+                cumulative += h.buckets[next++].second;
+            }
+            out << h.name << "_bucket" << FormatLabels(h.labels, "le", std::to_string(le))
+                << " " << cumulative << "\n";
+        }
+        out << h.name << "_bucket" << FormatLabels(h.labels, "le", "+Inf") << " " << h.count
+            << "\n";
+        out << h.name << "_sum" << FormatLabels(h.labels) << " " << h.sum << "\n";
+        out << h.name << "_count" << FormatLabels(h.labels) << " " << h.count << "\n";
+    }
+    return out.str();
+}
+
+std::string MetricsSnapshot::ToJSON() const {
+    std::ostringstream out;
+    out << "{\"counters\":[";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        const auto& c = counters[i];
+        out << (i ? "," : "") << "{\"name\":" << JSONString(c.name)
+            << ",\"labels\":" << JSONLabels(c.labels) << ",\"value\":" << c.value << "}";
+    }
+    out << "],\"histograms\":[";
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        const auto& h = histograms[i];
+        out << (i ? "," : "") << "{\"name\":" << JSONString(h.name)
+            << ",\"labels\":" << JSONLabels(h.labels) << ",\"count\":" << h.count
+            << ",\"sum\":" << h.sum << ",\"max\":" << h.max << ",\"mean\":" << h.Mean()
+            << ",\"p50\":" << h.Percentile(50) << ",\"p90\":" << h.Percentile(90)
+            << ",\"p99\":" << h.Percentile(99) << ",\"buckets\":[";
+        for (size_t j = 0; j < h.buckets.size(); ++j) {
+            out << (j ? "," : "") << "[" << h.buckets[j].first << "," << h.buckets[j].second
+                << "]";
+        }
+        out << "]}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+Registry::Registry() : retired_(new ThreadShard()) {
+    counters_.push_back(Descriptor{"", "", Labels()});
+    histograms_.push_back(Descriptor{"", "", Labels()});
+}
+
+Registry& Registry::Global() {
+    // Leaked on purpose: thread-exit hooks may run after static destructors
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+std::string Registry::Key(const std::string& name, const Labels& labels) {
+    return name + FormatLabels(labels);
+}
+
+Counter Registry::GetCounter(const std::string& name, const std::string& help,
+                             const Labels& labels) {
+    std::string key = Key(name, labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = counter_ids_.find(key);
+    if (it != counter_ids_.end()) {
+        return Counter(it->second);
+    }
+    if (counters_.size() >= kMaxCounters) {
+        return Counter(0);
+    }
+    uint32_t id = static_cast<uint32_t>(counters_.size());
+    counters_.push_back(Descriptor{name, help, labels});
+    counter_ids_[key] = id;
+    return Counter(id);
+}
+
+Histogram Registry::GetHistogram(const std::string& name, const std::string& help,
+                                 const Labels& labels) {
+    std::string key = Key(name, labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = histogram_ids_.find(key);
+    if (it != histogram_ids_.end()) {
+        return Histogram(it->second);
+    }
+    if (histograms_.size() >= kMaxHistograms) {
+        return Histogram(0);
+    }
+    uint32_t id = static_cast<uint32_t>(histograms_.size());
+    histograms_.push_back(Descriptor{name, help, labels});
+    histogram_ids_[key] = id;
+    return Histogram(id);
+}
+
+void Registry::AddShard(ThreadShard* shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shards_.push_back(shard);
+}
+
+void Registry::RetireShard(ThreadShard* shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Accumulate(retired_, shard);
+    shards_.erase(std::remove(shards_.begin(), shards_.end(), shard), shards_.end());
+    delete shard;
+}
+
+uint32_t Registry::NextFamilyId() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_family_id_++;
+}
+
+MetricsSnapshot Registry::Snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ThreadShard total;
+    Accumulate(&total, retired_);
+    for (const auto* shard : shards_) {
+        Accumulate(&total, shard);
+    }
+
+    MetricsSnapshot snapshot;
+    for (uint32_t id = 1; id < counters_.size(); ++id) {
+        const auto& d = counters_[id];
+        snapshot.counters.push_back(CounterSnapshot{d.name, d.help, d.labels,
+                                                    Load(total.counters[id])});
+    }
+    for (uint32_t id = 1; id < histograms_.size(); ++id) {
+        const auto& d = histograms_[id];
+        HistogramSnapshot h;
+        h.name = d.name;
+        h.help = d.help;
+        h.labels = d.labels;
+        HistogramCells* cells = total.histograms[id].load(std::memory_order_relaxed);
+        if (cells != nullptr) {
+            h.count = Load(cells->count);
+            h.sum = Load(cells->sum);
+            h.max = Load(cells->max);
+            for (uint32_t b = 0; b < kNumBuckets; ++b) {
+                uint64_t v = Load(cells->buckets[b]);
+                if (v != 0) {
+                    h.buckets.emplace_back(BucketUpperBound(b), v);
+                }
+            }
+        }
+        snapshot.histograms.push_back(std::move(h));
+    }
+    // Group series of one metric so the exposition emits HELP/TYPE once
+    auto by_name = [](const std::string& a, const std::string& b) { return a < b; };
+    std::stable_sort(snapshot.counters.begin(), snapshot.counters.end(),
+                     [&](const CounterSnapshot& a, const CounterSnapshot& b) {
+                         return by_name(a.name, b.name);
+                     });
+    std::stable_sort(snapshot.histograms.begin(), snapshot.histograms.end(),
+                     [&](const HistogramSnapshot& a, const HistogramSnapshot& b) {
+                         return by_name(a.name, b.name);
+                     });
+    return snapshot;
+}
+
+void Registry::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ThreadShard*> all = shards_;
+    all.push_back(retired_);
+    for (auto* shard : all) {
+        for (auto& c : shard->counters) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        for (auto& h : shard->histograms) {
+            HistogramCells* cells = h.load(std::memory_order_acquire);
+            if (cells == nullptr) {
+                continue;
+            }
+            for (auto& b : cells->buckets) {
+                b.store(0, std::memory_order_relaxed);
+            }
+            cells->count.store(0, std::memory_order_relaxed);
+            cells->sum.store(0, std::memory_order_relaxed);
+            cells->max.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+HistogramFamily::HistogramFamily(std::string name, std::string help, std::string label)
+    : family_id_(Registry::Global().NextFamilyId()),
+      name_(std::move(name)),
+      help_(std::move(help)),
+      label_(std::move(label)) {}
+
+Histogram HistogramFamily::WithLabel(const std::string& value) const {
+    // Per-thread cache: steady-state lookups take no lock
+    static thread_local std::vector<std::unordered_map<std::string, Histogram>> cache;
+    if (cache.size() <= family_id_) {
+        cache.resize(family_id_ + 1);
+    }
+    auto& entries = cache[family_id_];
+    auto it = entries.find(value);
+    if (it != entries.end()) {
+        return it->second;
+    }
+    Histogram h = Registry::Global().GetHistogram(name_, help_, Labels{{label_, value}});
+    entries.emplace(value, h);
+    return h;
+}
+
+} // namespace metrics
+} // namespace internal
+} // namespace eino
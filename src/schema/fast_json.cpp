@@ -0,0 +1,1470 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/schema/fast_json.h"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace eino {
+namespace schema {
+
+namespace {
+
+constexpr int kMaxDepth = 512;
+
+inline bool IsSpecial(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+// SWAR tests over 8 bytes at once; both are exact about whether any byte
+// matches, which is all the scan needs
+constexpr uint64_t kOnes = 0x0101010101010101ULL;
+constexpr uint64_t kHighs = 0x8080808080808080ULL;
+
+inline uint64_t HasZero(uint64_t w) {
+    return (w - kOnes) & ~w & kHighs;
+}
+
+inline uint64_t HasLess(uint64_t w, uint8_t n) {
+    return (w - kOnes * n) & ~w & kHighs;
+}
+
+// FindSpecial returns the first '"', '\\' or control byte in [p, end), or
+// end. Everything before it can be copied verbatim
+const char* FindSpecial(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v));
+        int mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        p += 16;
+    }
+#endif
+    while (end - p >= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, sizeof(w));
+        if (HasZero(w ^ (kOnes * '"')) | HasZero(w ^ (kOnes * '\\')) | HasLess(w, 0x20)) {
+            break;
+        }
+        p += 8;
+    }
+    while (p < end && !IsSpecial(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+    return p;
+}
+
+void AppendUTF8(std::string* out, uint32_t cp) {
+    if (cp < 0x80) {
+        out->push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out->push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// IndexSlot returns a process-lifetime pointer for a decoded tool call
+// index; ToolCall does not own its index
+int* IndexSlot(int idx) {
+    static std::mutex mu;
+    static std::set<int>* pool = new std::set<int>();
+    std::lock_guard<std::mutex> lock(mu);
+    return const_cast<int*>(&*pool->insert(idx).first);
+}
+
+const char* RoleName(RoleType role) {
+    switch (role) {
+        case RoleType::kAssistant: return "assistant";
+        case RoleType::kUser: return "user";
+        case RoleType::kSystem: return "system";
+        case RoleType::kTool: return "tool";
+    }
+    return "user";
+}
+
+RoleType ParseRole(const std::string& s) {
+    if (s == "assistant") return RoleType::kAssistant;
+    if (s == "user") return RoleType::kUser;
+    if (s == "system") return RoleType::kSystem;
+    if (s == "tool") return RoleType::kTool;
+    throw std::runtime_error("fast_json: unknown role '" + s + "'");
+}
+
+ChatMessagePartType ParsePartType(const std::string& s) {
+    if (s == "text") return ChatMessagePartType::kText;
+    if (s == "image_url") return ChatMessagePartType::kImageURL;
+    if (s == "audio_url") return ChatMessagePartType::kAudioURL;
+    if (s == "video_url") return ChatMessagePartType::kVideoURL;
+    if (s == "file_url") return ChatMessagePartType::kFileURL;
+    throw std::runtime_error("fast_json: unknown message part type '" + s + "'");
+}
+
+ImageURLDetail ParseDetail(const std::string& s) {
+    if (s == "high") return ImageURLDetail::kHigh;
+    if (s == "low") return ImageURLDetail::kLow;
+    return ImageURLDetail::kAuto;
+}
+
+// Go's omitempty: empty strings are left out
+void OptionalString(JsonWriter& w, const char* key, const std::string& value) {
+    if (!value.empty()) {
+        w.Key(key);
+        w.String(value);
+    }
+}
+
+void WriteJSONMap(JsonWriter& w, const std::map<std::string, json>& values) {
+    w.BeginObject();
+    for (const auto& kv : values) {
+        w.Key(kv.first);
+        w.Value(kv.second);
+    }
+    w.EndObject();
+}
+
+void OptionalMap(JsonWriter& w, const char* key, const std::map<std::string, json>& values) {
+    if (!values.empty()) {
+        w.Key(key);
+        WriteJSONMap(w, values);
+    }
+}
+
+// ============================================================================
+// Multimodal parts
+// ============================================================================
+
+void WritePartCommon(JsonWriter& w, const MessagePartCommon& common) {
+    if (common.url) {
+        w.Key("url");
+        w.String(*common.url);
+    }
+    if (common.base64_data) {
+        w.Key("base64data");
+        w.String(*common.base64_data);
+    }
+    OptionalString(w, "mime_type", common.mime_type);
+    OptionalMap(w, "extra", common.extra);
+}
+
+template<typename Media>
+void OptionalMedia(JsonWriter& w, const char* key, const std::shared_ptr<Media>& media) {
+    if (media) {
+        w.Key(key);
+        w.BeginObject();
+        WritePartCommon(w, media->common);
+        w.EndObject();
+    }
+}
+
+void WritePartType(JsonWriter& w, ChatMessagePartType type) {
+    w.Key("type");
+    w.String(ChatMessagePartTypeToString(type));
+}
+
+void WriteInputPart(JsonWriter& w, const MessageInputPart& part) {
+    w.BeginObject();
+    WritePartType(w, part.type);
+    OptionalString(w, "text", part.text);
+    if (part.image) {
+        w.Key("image");
+        w.BeginObject();
+        WritePartCommon(w, part.image->common);
+        w.Key("detail");
+        w.String(ImageURLDetailToString(part.image->detail));
+        w.EndObject();
+    }
+    OptionalMedia(w, "audio", part.audio);
+    OptionalMedia(w, "video", part.video);
+    OptionalMedia(w, "file", part.file);
+    w.EndObject();
+}
+
+void WriteOutputPart(JsonWriter& w, const MessageOutputPart& part) {
+    w.BeginObject();
+    WritePartType(w, part.type);
+    OptionalString(w, "text", part.text);
+    OptionalMedia(w, "image", part.image);
+    OptionalMedia(w, "audio", part.audio);
+    OptionalMedia(w, "video", part.video);
+    w.EndObject();
+}
+
+// Fields shared by the deprecated *URL part structs
+template<typename URL>
+void WriteURLFields(JsonWriter& w, const URL& url) {
+    OptionalString(w, "url", url.url);
+    OptionalString(w, "uri", url.uri);
+    OptionalString(w, "mime_type", url.mime_type);
+    OptionalMap(w, "extra", url.extra);
+}
+
+void WriteChatPart(JsonWriter& w, const ChatMessagePart& part) {
+    w.BeginObject();
+    WritePartType(w, part.type);
+    OptionalString(w, "text", part.text);
+    if (part.image_url) {
+        w.Key("image_url");
+        w.BeginObject();
+        WriteURLFields(w, *part.image_url);
+        w.Key("detail");
+        w.String(ImageURLDetailToString(part.image_url->detail));
+        w.EndObject();
+    }
+    if (part.audio_url) {
+        w.Key("audio_url");
+        w.BeginObject();
+        WriteURLFields(w, *part.audio_url);
+        w.EndObject();
+    }
+    if (part.video_url) {
+        w.Key("video_url");
+        w.BeginObject();
+        WriteURLFields(w, *part.video_url);
+        w.EndObject();
+    }
+    if (part.file_url) {
+        w.Key("file_url");
+        w.BeginObject();
+        WriteURLFields(w, *part.file_url);
+        OptionalString(w, "name", part.file_url->name);
+        w.EndObject();
+    }
+    w.EndObject();
+}
+
+template<typename Part, typename WritePart>
+void OptionalParts(JsonWriter& w, const char* key, const std::vector<Part>& parts,
+                   WritePart write) {
+    if (!parts.empty()) {
+        w.Key(key);
+        w.BeginArray();
+        for (const auto& part : parts) {
+            write(w, part);
+        }
+        w.EndArray();
+    }
+}
+
+// ============================================================================
+// Tool parameters
+// ============================================================================
+
+void WriteParameterInfo(JsonWriter& w, const ParameterInfo& param);
+
+// WriteProperties writes the "properties" and "required" keys of an object
+void WriteProperties(JsonWriter& w,
+                     const std::map<std::string, std::shared_ptr<ParameterInfo>>& params) {
+    w.Key("properties");
+    w.BeginObject();
+    std::vector<const std::string*> required;
+    for (const auto& kv : params) {
+        if (!kv.second) {
+            continue;
+        }
+        w.Key(kv.first);
+        WriteParameterInfo(w, *kv.second);
+        if (kv.second->required) {
+            required.push_back(&kv.first);
+        }
+    }
+    w.EndObject();
+    if (!required.empty()) {
+        w.Key("required");
+        w.BeginArray();
+        for (const auto* name : required) {
+            w.String(*name);
+        }
+        w.EndArray();
+    }
+}
+
+void WriteParameterInfo(JsonWriter& w, const ParameterInfo& param) {
+    w.BeginObject();
+    w.Key("type");
+    w.String(DataTypeToString(param.type));
+    OptionalString(w, "description", param.description);
+    if (!param.enum_values.empty()) {
+        w.Key("enum");
+        w.BeginArray();
+        for (const auto& value : param.enum_values) {
+            w.String(value);
+        }
+        w.EndArray();
+    }
+    if (param.elem_info) {
+        w.Key("items");
+        WriteParameterInfo(w, *param.elem_info);
+    }
+    if (!param.sub_params.empty()) {
+        WriteProperties(w, param.sub_params);
+    }
+    w.EndObject();
+}
+
+void WriteBytes(JsonWriter& w, const std::vector<int64_t>& bytes) {
+    w.BeginArray();
+    for (int64_t b : bytes) {
+        w.Int(b);
+    }
+    w.EndArray();
+}
+
+void WriteResponseMeta(JsonWriter& w, const ResponseMeta& meta) {
+    w.BeginObject();
+    OptionalString(w, "finish_reason", meta.finish_reason);
+    if (meta.usage) {
+        w.Key("usage");
+        w.BeginObject();
+        w.Key("prompt_tokens");
+        w.Int(meta.usage->prompt_tokens);
+        w.Key("prompt_token_details");
+        w.BeginObject();
+        w.Key("cached_tokens");
+        w.Int(meta.usage->prompt_token_details.cached_tokens);
+        w.EndObject();
+        w.Key("completion_tokens");
+        w.Int(meta.usage->completion_tokens);
+        w.Key("total_tokens");
+        w.Int(meta.usage->total_tokens);
+        w.EndObject();
+    }
+    if (meta.logprobs) {
+        w.Key("logprobs");
+        w.BeginObject();
+        w.Key("content");
+        w.BeginArray();
+        for (const auto& lp : meta.logprobs->content) {
+            w.BeginObject();
+            w.Key("token");
+            w.String(lp.token);
+            w.Key("logprob");
+            w.Double(lp.logprob);
+            w.Key("bytes");
+            WriteBytes(w, lp.bytes);
+            w.Key("top_logprobs");
+            w.BeginArray();
+            for (const auto& top : lp.top_logprobs) {
+                w.BeginObject();
+                w.Key("token");
+                w.String(top.token);
+                w.Key("logprob");
+                w.Double(top.logprob);
+                w.Key("bytes");
+                WriteBytes(w, top.bytes);
+                w.EndObject();
+            }
+            w.EndArray();
+            w.EndObject();
+        }
+        w.EndArray();
+        w.EndObject();
+    }
+    w.EndObject();
+}
+
+// Strings may be null on the wire (e.g. assistant content with tool calls)
+void ReadNullableString(JsonReader& r, std::string* out) {
+    if (r.TryNull()) {
+        out->clear();
+    } else {
+        r.ReadString(out);
+    }
+}
+
+void ReadJSONMap(JsonReader& r, std::map<std::string, json>* out) {
+    if (r.TryNull()) {
+        return;
+    }
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        (*out)[key] = r.ReadValue();
+    }
+}
+
+void ReadBytes(JsonReader& r, std::vector<int64_t>* out) {
+    if (r.TryNull()) {
+        return;
+    }
+    r.BeginArray();
+    while (r.NextElement()) {
+        out->push_back(r.ReadInt());
+    }
+}
+
+template<typename LP>
+void ReadLogProbFields(JsonReader& r, const std::string& key, LP* out) {
+    if (key == "token") {
+        ReadNullableString(r, &out->token);
+    } else if (key == "logprob") {
+        out->logprob = r.ReadDouble();
+    } else if (key == "bytes") {
+        ReadBytes(r, &out->bytes);
+    } else {
+        r.Skip();
+    }
+}
+
+void ReadLogProbs(JsonReader& r, LogProbs* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key != "content") {
+            r.Skip();
+            continue;
+        }
+        if (r.TryNull()) {
+            continue;
+        }
+        r.BeginArray();
+        while (r.NextElement()) {
+            out->content.emplace_back();
+            LogProb& lp = out->content.back();
+            r.BeginObject();
+            std::string field;
+            while (r.NextKey(&field)) {
+                if (field != "top_logprobs") {
+                    ReadLogProbFields(r, field, &lp);
+                    continue;
+                }
+                if (r.TryNull()) {
+                    continue;
+                }
+                r.BeginArray();
+                while (r.NextElement()) {
+                    lp.top_logprobs.emplace_back();
+                    r.BeginObject();
+                    std::string top_field;
+                    while (r.NextKey(&top_field)) {
+                        ReadLogProbFields(r, top_field, &lp.top_logprobs.back());
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ReadUsage(JsonReader& r, TokenUsage* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "prompt_tokens") {
+            out->prompt_tokens = static_cast<int>(r.ReadInt());
+        } else if (key == "completion_tokens") {
+            out->completion_tokens = static_cast<int>(r.ReadInt());
+        } else if (key == "total_tokens") {
+            out->total_tokens = static_cast<int>(r.ReadInt());
+        } else if (key == "prompt_token_details") {
+            if (r.TryNull()) {
+                continue;
+            }
+            r.BeginObject();
+            std::string detail;
+            while (r.NextKey(&detail)) {
+                if (detail == "cached_tokens") {
+                    out->prompt_token_details.cached_tokens = static_cast<int>(r.ReadInt());
+                } else {
+                    r.Skip();
+                }
+            }
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+void ReadResponseMeta(JsonReader& r, ResponseMeta* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "finish_reason") {
+            ReadNullableString(r, &out->finish_reason);
+        } else if (key == "usage") {
+            if (!r.TryNull()) {
+                out->usage = std::make_shared<TokenUsage>();
+                ReadUsage(r, out->usage.get());
+            }
+        } else if (key == "logprobs") {
+            if (!r.TryNull()) {
+                out->logprobs = std::make_shared<LogProbs>();
+                ReadLogProbs(r, out->logprobs.get());
+            }
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+void ReadPartString(JsonReader& r, std::string** out) {
+    delete *out;
+    *out = nullptr;
+    if (!r.TryNull()) {
+        *out = new std::string();
+        r.ReadString(*out);
+    }
+}
+
+bool ReadPartCommonField(JsonReader& r, const std::string& key, MessagePartCommon* out) {
+    if (key == "url") {
+        ReadPartString(r, &out->url);
+    } else if (key == "base64data") {
+        ReadPartString(r, &out->base64_data);
+    } else if (key == "mime_type") {
+        ReadNullableString(r, &out->mime_type);
+    } else if (key == "extra") {
+        ReadJSONMap(r, &out->extra);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template<typename Media>
+void ReadMedia(JsonReader& r, std::shared_ptr<Media>* out) {
+    if (r.TryNull()) {
+        return;
+    }
+    *out = std::make_shared<Media>();
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (!ReadPartCommonField(r, key, &(*out)->common)) {
+            r.Skip();
+        }
+    }
+}
+
+void ReadInputImage(JsonReader& r, std::shared_ptr<MessageInputImage>* out) {
+    if (r.TryNull()) {
+        return;
+    }
+    *out = std::make_shared<MessageInputImage>();
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "detail") {
+            std::string detail;
+            ReadNullableString(r, &detail);
+            (*out)->detail = ParseDetail(detail);
+        } else if (!ReadPartCommonField(r, key, &(*out)->common)) {
+            r.Skip();
+        }
+    }
+}
+
+void ReadInputPart(JsonReader& r, MessageInputPart* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "type") {
+            std::string type;
+            r.ReadString(&type);
+            out->type = ParsePartType(type);
+        } else if (key == "text") {
+            ReadNullableString(r, &out->text);
+        } else if (key == "image") {
+            ReadInputImage(r, &out->image);
+        } else if (key == "audio") {
+            ReadMedia(r, &out->audio);
+        } else if (key == "video") {
+            ReadMedia(r, &out->video);
+        } else if (key == "file") {
+            ReadMedia(r, &out->file);
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+void ReadOutputPart(JsonReader& r, MessageOutputPart* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "type") {
+            std::string type;
+            r.ReadString(&type);
+            out->type = ParsePartType(type);
+        } else if (key == "text") {
+            ReadNullableString(r, &out->text);
+        } else if (key == "image") {
+            ReadMedia(r, &out->image);
+        } else if (key == "audio") {
+            ReadMedia(r, &out->audio);
+        } else if (key == "video") {
+            ReadMedia(r, &out->video);
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+// ReadURL reads a deprecated *URL part; extra_field handles the fields
+// only some of them have and returns false for unknown keys
+template<typename URL, typename ExtraField>
+void ReadURL(JsonReader& r, std::shared_ptr<URL>* out, ExtraField extra_field) {
+    if (r.TryNull()) {
+        return;
+    }
+    *out = std::make_shared<URL>();
+    URL* url = out->get();
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "url") {
+            ReadNullableString(r, &url->url);
+        } else if (key == "uri") {
+            ReadNullableString(r, &url->uri);
+        } else if (key == "mime_type") {
+            ReadNullableString(r, &url->mime_type);
+        } else if (key == "extra") {
+            ReadJSONMap(r, &url->extra);
+        } else if (!extra_field(key, url)) {
+            r.Skip();
+        }
+    }
+}
+
+void ReadChatPart(JsonReader& r, ChatMessagePart* out) {
+    auto none = [](const std::string&, void*) { return false; };
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "type") {
+            std::string type;
+            r.ReadString(&type);
+            out->type = ParsePartType(type);
+        } else if (key == "text") {
+            ReadNullableString(r, &out->text);
+        } else if (key == "image_url") {
+            ReadURL(r, &out->image_url, [&r](const std::string& field, ChatMessageImageURL* url) {
+                if (field != "detail") {
+                    return false;
+                }
+                std::string detail;
+                ReadNullableString(r, &detail);
+                url->detail = ParseDetail(detail);
+                return true;
+            });
+        } else if (key == "audio_url") {
+            ReadURL(r, &out->audio_url, none);
+        } else if (key == "video_url") {
+            ReadURL(r, &out->video_url, none);
+        } else if (key == "file_url") {
+            ReadURL(r, &out->file_url, [&r](const std::string& field, ChatMessageFileURL* url) {
+                if (field != "name") {
+                    return false;
+                }
+                ReadNullableString(r, &url->name);
+                return true;
+            });
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+template<typename Part, typename ReadPart>
+void ReadParts(JsonReader& r, std::vector<Part>* out, ReadPart read) {
+    if (r.TryNull()) {
+        return;
+    }
+    r.BeginArray();
+    while (r.NextElement()) {
+        out->emplace_back();
+        read(r, &out->back());
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// JsonWriter
+// ============================================================================
+
+std::string JsonWriter::Take() {
+    std::string out = std::move(buf_);
+    Clear();
+    return out;
+}
+
+void JsonWriter::BeginObject() {
+    Separate();
+    buf_.push_back('{');
+    comma_ = false;
+}
+
+void JsonWriter::EndObject() {
+    buf_.push_back('}');
+    comma_ = true;
+}
+
+void JsonWriter::BeginArray() {
+    Separate();
+    buf_.push_back('[');
+    comma_ = false;
+}
+
+void JsonWriter::EndArray() {
+    buf_.push_back(']');
+    comma_ = true;
+}
+
+void JsonWriter::Key(const char* key, size_t len) {
+    Separate();
+    AppendEscaped(key, len);
+    buf_.push_back(':');
+    comma_ = false;
+}
+
+void JsonWriter::String(const char* s, size_t len) {
+    Separate();
+    AppendEscaped(s, len);
+    comma_ = true;
+}
+
+void JsonWriter::Int(int64_t v) {
+    Separate();
+    char tmp[24];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    buf_.append(tmp, res.ptr - tmp);
+    comma_ = true;
+}
+
+void JsonWriter::Double(double v) {
+    Separate();
+    if (!std::isfinite(v)) {
+        // JSON has no NaN/Inf
+        buf_.append("null");
+    } else {
+        char tmp[32];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        buf_.append(tmp, res.ptr - tmp);
+    }
+    comma_ = true;
+}
+
+void JsonWriter::Bool(bool v) {
+    Separate();
+    buf_.append(v ? "true" : "false");
+    comma_ = true;
+}
+
+void JsonWriter::Null() {
+    Separate();
+    buf_.append("null");
+    comma_ = true;
+}
+
+void JsonWriter::Value(const json& v) {
+    switch (v.type()) {
+        case json::null:
+            Null();
+            break;
+        case json::string:
+            String(v.get_string());
+            break;
+        case json::boolean:
+            Bool(v.get_boolean());
+            break;
+        case json::number_integer:
+            Int(v.get_integer());
+            break;
+        case json::number_float:
+            Double(v.get_double());
+            break;
+        default:
+            Separate();
+            buf_.append(v.dump());
+            comma_ = true;
+            break;
+    }
+}
+
+void JsonWriter::AppendEscaped(const char* s, size_t len) {
+    static const char kHex[] = "0123456789abcdef";
+    const char* p = s;
+    const char* end = s + len;
+    buf_.push_back('"');
+    while (true) {
+        const char* q = FindSpecial(p, end);
+        buf_.append(p, q - p);
+        if (q == end) {
+            break;
+        }
+        unsigned char c = static_cast<unsigned char>(*q);
+        switch (c) {
+            case '"': buf_.append("\\\""); break;
+            case '\\': buf_.append("\\\\"); break;
+            case '\n': buf_.append("\\n"); break;
+            case '\r': buf_.append("\\r"); break;
+            case '\t': buf_.append("\\t"); break;
+            case '\b': buf_.append("\\b"); break;
+            case '\f': buf_.append("\\f"); break;
+            default: {
+                char esc[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                buf_.append(esc, sizeof(esc));
+                break;
+            }
+        }
+        p = q + 1;
+    }
+    buf_.push_back('"');
+}
+
+// ============================================================================
+// JsonReader
+// ============================================================================
+
+void JsonReader::Fail(const char* what) const {
+    throw std::runtime_error(std::string("fast_json: ") + what + " at offset " +
+                             std::to_string(p_ - begin_));
+}
+
+char JsonReader::Peek() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+        ++p_;
+    }
+    if (p_ == end_) {
+        Fail("unexpected end of input");
+    }
+    return *p_;
+}
+
+void JsonReader::Expect(char c) {
+    if (Peek() != c) {
+        std::string what = std::string("expected '") + c + "'";
+        Fail(what.c_str());
+    }
+    ++p_;
+}
+
+void JsonReader::BeginObject() {
+    Expect('{');
+    first_ = true;
+}
+
+bool JsonReader::NextKey(std::string* key) {
+    char c = Peek();
+    if (c == '}') {
+        ++p_;
+        first_ = false;
+        return false;
+    }
+    if (!first_) {
+        if (c != ',') {
+            Fail("expected ',' or '}'");
+        }
+        ++p_;
+    }
+    first_ = false;
+    ReadString(key);
+    Expect(':');
+    return true;
+}
+
+void JsonReader::BeginArray() {
+    Expect('[');
+    first_ = true;
+}
+
+bool JsonReader::NextElement() {
+    char c = Peek();
+    if (c == ']') {
+        ++p_;
+        first_ = false;
+        return false;
+    }
+    if (!first_) {
+        if (c != ',') {
+            Fail("expected ',' or ']'");
+        }
+        ++p_;
+    }
+    first_ = false;
+    return true;
+}
+
+bool JsonReader::TryNull() {
+    if (Peek() != 'n') {
+        return false;
+    }
+    SkipLiteral("null", 4);
+    return true;
+}
+
+std::string JsonReader::ReadString() {
+    std::string out;
+    ReadString(&out);
+    return out;
+}
+
+void JsonReader::ReadString(std::string* out) {
+    Expect('"');
+    out->clear();
+    while (true) {
+        const char* q = FindSpecial(p_, end_);
+        out->append(p_, q - p_);
+        p_ = q;
+        if (q == end_) {
+            Fail("unterminated string");
+        }
+        if (*q == '"') {
+            ++p_;
+            return;
+        }
+        if (*q != '\\') {
+            Fail("control character in string");
+        }
+        if (end_ - p_ < 2) {
+            Fail("unterminated escape");
+        }
+        char e = p_[1];
+        p_ += 2;
+        switch (e) {
+            case '"': out->push_back('"'); break;
+            case '\\': out->push_back('\\'); break;
+            case '/': out->push_back('/'); break;
+            case 'b': out->push_back('\b'); break;
+            case 'f': out->push_back('\f'); break;
+            case 'n': out->push_back('\n'); break;
+            case 'r': out->push_back('\r'); break;
+            case 't': out->push_back('\t'); break;
+            case 'u': {
+                auto read_hex4 = [this]() -> uint32_t {
+                    if (end_ - p_ < 4) {
+                        Fail("truncated \\u escape");
+                    }
+                    uint32_t v = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        int h = HexValue(p_[i]);
+                        if (h < 0) {
+                            Fail("bad \\u escape");
+                        }
+                        v = (v << 4) | static_cast<uint32_t>(h);
+                    }
+                    p_ += 4;
+                    return v;
+                };
+                uint32_t cp = read_hex4();
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') {
+                        Fail("unpaired surrogate");
+                    }
+                    p_ += 2;
+                    uint32_t lo = read_hex4();
+                    if (lo < 0xDC00 || lo > 0xDFFF) {
+                        Fail("unpaired surrogate");
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    Fail("unpaired surrogate");
+                }
+                AppendUTF8(out, cp);
+                break;
+            }
+            default:
+                p_ -= 1;
+                Fail("bad escape");
+        }
+    }
+}
+
+void JsonReader::SkipString() {
+    Expect('"');
+    while (true) {
+        const char* q = FindSpecial(p_, end_);
+        p_ = q;
+        if (q == end_) {
+            Fail("unterminated string");
+        }
+        if (*q == '"') {
+            ++p_;
+            return;
+        }
+        if (*q != '\\') {
+            Fail("control character in string");
+        }
+        if (end_ - p_ < 2) {
+            Fail("unterminated escape");
+        }
+        p_ += 2;
+    }
+}
+
+void JsonReader::SkipLiteral(const char* lit, size_t len) {
+    if (static_cast<size_t>(end_ - p_) < len || std::memcmp(p_, lit, len) != 0) {
+        Fail("bad literal");
+    }
+    p_ += len;
+}
+
+const char* JsonReader::ScanNumber() {
+    Peek();
+    const char* start = p_;
+    while (p_ < end_) {
+        char c = *p_;
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            ++p_;
+        } else {
+            break;
+        }
+    }
+    if (p_ == start) {
+        Fail("expected a value");
+    }
+    return start;
+}
+
+int64_t JsonReader::ReadInt() {
+    const char* start = ScanNumber();
+    int64_t v = 0;
+    auto res = std::from_chars(start, p_, v);
+    if (res.ec != std::errc() || res.ptr != p_) {
+        p_ = start;
+        Fail("expected an integer");
+    }
+    return v;
+}
+
+double JsonReader::ReadDouble() {
+    const char* start = ScanNumber();
+    double v = 0;
+    auto res = std::from_chars(start, p_, v);
+    if (res.ec != std::errc() || res.ptr != p_) {
+        p_ = start;
+        Fail("expected a number");
+    }
+    return v;
+}
+
+bool JsonReader::ReadBool() {
+    char c = Peek();
+    if (c == 't') {
+        SkipLiteral("true", 4);
+        return true;
+    }
+    if (c == 'f') {
+        SkipLiteral("false", 5);
+        return false;
+    }
+    Fail("expected a boolean");
+}
+
+json JsonReader::ReadValue() {
+    return ReadValue(0);
+}
+
+json JsonReader::ReadValue(int depth) {
+    if (depth > kMaxDepth) {
+        Fail("nesting too deep");
+    }
+    switch (Peek()) {
+        case '"':
+            return json(ReadString());
+        case 't':
+        case 'f':
+            return json(ReadBool());
+        case 'n':
+            SkipLiteral("null", 4);
+            return json();
+        case '{': {
+            std::map<std::string, json> obj;
+            BeginObject();
+            std::string key;
+            while (NextKey(&key)) {
+                obj[key] = ReadValue(depth + 1);
+            }
+            return json(obj);
+        }
+        case '[': {
+            std::vector<json> arr;
+            BeginArray();
+            while (NextElement()) {
+                arr.push_back(ReadValue(depth + 1));
+            }
+            return json(arr);
+        }
+        default: {
+            const char* start = ScanNumber();
+            int64_t i = 0;
+            auto res = std::from_chars(start, p_, i);
+            if (res.ec == std::errc() && res.ptr == p_ &&
+                i >= std::numeric_limits<int>::min() && i <= std::numeric_limits<int>::max()) {
+                return json(static_cast<int>(i));
+            }
+            double d = 0;
+            auto dres = std::from_chars(start, p_, d);
+            if (dres.ec != std::errc() || dres.ptr != p_) {
+                p_ = start;
+                Fail("expected a number");
+            }
+            return json(d);
+        }
+    }
+}
+
+void JsonReader::Skip() {
+    char c = Peek();
+    switch (c) {
+        case '"':
+            SkipString();
+            return;
+        case 't':
+            SkipLiteral("true", 4);
+            return;
+        case 'f':
+            SkipLiteral("false", 5);
+            return;
+        case 'n':
+            SkipLiteral("null", 4);
+            return;
+        case '{':
+        case '[':
+            break;
+        default:
+            ScanNumber();
+            return;
+    }
+    // Containers are skipped by bracket depth alone; strings are still
+    // scanned properly so brackets inside them don't count
+    int depth = 0;
+    while (true) {
+        c = Peek();
+        if (c == '"') {
+            SkipString();
+        } else if (c == '{' || c == '[') {
+            if (++depth > kMaxDepth) {
+                Fail("nesting too deep");
+            }
+            ++p_;
+        } else if (c == '}' || c == ']') {
+            ++p_;
+            if (--depth == 0) {
+                return;
+            }
+        } else {
+            ++p_;
+        }
+    }
+}
+
+void JsonReader::ExpectEnd() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+        ++p_;
+    }
+    if (p_ != end_) {
+        Fail("trailing characters");
+    }
+}
+
+// ============================================================================
+// Schema writers
+// ============================================================================
+
+void WriteToolCall(JsonWriter& w, const ToolCall& call) {
+    w.BeginObject();
+    if (call.index) {
+        w.Key("index");
+        w.Int(*call.index);
+    }
+    w.Key("id");
+    w.String(call.id);
+    w.Key("type");
+    w.String(call.type);
+    w.Key("function");
+    w.BeginObject();
+    w.Key("name");
+    w.String(call.function.name);
+    w.Key("arguments");
+    w.String(call.function.arguments);
+    w.EndObject();
+    OptionalMap(w, "extra", call.extra);
+    w.EndObject();
+}
+
+void WriteMessage(JsonWriter& w, const Message& msg) {
+    w.BeginObject();
+    w.Key("role");
+    const char* role = RoleName(msg.role);
+    w.String(role, std::strlen(role));
+    w.Key("content");
+    w.String(msg.content);
+    OptionalParts(w, "multi_content", msg.multi_content, WriteChatPart);
+    OptionalParts(w, "user_input_multi_content", msg.user_input_multi_content, WriteInputPart);
+    OptionalParts(w, "assistant_output_multi_content", msg.assistant_gen_multi_content,
+                  WriteOutputPart);
+    OptionalString(w, "name", msg.name);
+    if (!msg.tool_calls.empty()) {
+        w.Key("tool_calls");
+        w.BeginArray();
+        for (const auto& call : msg.tool_calls) {
+            WriteToolCall(w, call);
+        }
+        w.EndArray();
+    }
+    OptionalString(w, "tool_call_id", msg.tool_call_id);
+    OptionalString(w, "tool_name", msg.tool_name);
+    if (msg.response_meta) {
+        w.Key("response_meta");
+        WriteResponseMeta(w, *msg.response_meta);
+    }
+    OptionalString(w, "reasoning_content", msg.reasoning_content);
+    OptionalMap(w, "extra", msg.extra);
+    w.EndObject();
+}
+
+void WriteMessages(JsonWriter& w, const std::vector<Message>& msgs) {
+    w.BeginArray();
+    for (const auto& msg : msgs) {
+        WriteMessage(w, msg);
+    }
+    w.EndArray();
+}
+
+void WriteToolInfo(JsonWriter& w, const ToolInfo& info) {
+    w.BeginObject();
+    w.Key("name");
+    w.String(info.name);
+    w.Key("description");
+    w.String(info.description);
+    // ParameterInfo maps go out as the equivalent JSON schema
+    if (info.params) {
+        w.Key("parameters");
+        if (info.params->has_params) {
+            w.BeginObject();
+            w.Key("type");
+            w.String("object");
+            WriteProperties(w, info.params->params);
+            w.EndObject();
+        } else {
+            w.Value(info.params->json_schema);
+        }
+    }
+    OptionalMap(w, "extra", info.extra);
+    w.EndObject();
+}
+
+void WriteDocument(JsonWriter& w, const Document& doc) {
+    w.BeginObject();
+    w.Key("id");
+    w.String(doc.id);
+    w.Key("content");
+    w.String(doc.page_content);
+    w.Key("meta_data");
+    WriteJSONMap(w, doc.metadata);
+    w.EndObject();
+}
+
+// ============================================================================
+// Schema readers
+// ============================================================================
+
+void ReadToolCall(JsonReader& r, ToolCall* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "index") {
+            out->index = r.TryNull() ? nullptr : IndexSlot(static_cast<int>(r.ReadInt()));
+        } else if (key == "id") {
+            ReadNullableString(r, &out->id);
+        } else if (key == "type") {
+            ReadNullableString(r, &out->type);
+        } else if (key == "function") {
+            if (r.TryNull()) {
+                continue;
+            }
+            r.BeginObject();
+            std::string field;
+            while (r.NextKey(&field)) {
+                if (field == "name") {
+                    ReadNullableString(r, &out->function.name);
+                } else if (field == "arguments") {
+                    ReadNullableString(r, &out->function.arguments);
+                } else {
+                    r.Skip();
+                }
+            }
+        } else if (key == "extra") {
+            ReadJSONMap(r, &out->extra);
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+void ReadMessage(JsonReader& r, Message* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "role") {
+            std::string role;
+            r.ReadString(&role);
+            out->role = ParseRole(role);
+        } else if (key == "content") {
+            ReadNullableString(r, &out->content);
+        } else if (key == "multi_content") {
+            ReadParts(r, &out->multi_content, ReadChatPart);
+        } else if (key == "user_input_multi_content") {
+            ReadParts(r, &out->user_input_multi_content, ReadInputPart);
+        } else if (key == "assistant_output_multi_content") {
+            ReadParts(r, &out->assistant_gen_multi_content, ReadOutputPart);
+        } else if (key == "name") {
+            ReadNullableString(r, &out->name);
+        } else if (key == "tool_calls") {
+            if (r.TryNull()) {
+                continue;
+            }
+            r.BeginArray();
+            while (r.NextElement()) {
+                out->tool_calls.emplace_back();
+                ReadToolCall(r, &out->tool_calls.back());
+            }
+        } else if (key == "tool_call_id") {
+            ReadNullableString(r, &out->tool_call_id);
+        } else if (key == "tool_name") {
+            ReadNullableString(r, &out->tool_name);
+        } else if (key == "response_meta") {
+            if (!r.TryNull()) {
+                out->response_meta = std::make_shared<ResponseMeta>();
+                ReadResponseMeta(r, out->response_meta.get());
+            }
+        } else if (key == "reasoning_content") {
+            ReadNullableString(r, &out->reasoning_content);
+        } else if (key == "extra") {
+            ReadJSONMap(r, &out->extra);
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+void ReadMessages(JsonReader& r, std::vector<Message>* out) {
+    r.BeginArray();
+    while (r.NextElement()) {
+        out->emplace_back();
+        ReadMessage(r, &out->back());
+    }
+}
+
+void ReadToolInfo(JsonReader& r, ToolInfo* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "name") {
+            ReadNullableString(r, &out->name);
+        } else if (key == "description") {
+            ReadNullableString(r, &out->description);
+        } else if (key == "parameters") {
+            if (!r.TryNull()) {
+                out->params = std::make_shared<ParamsOneOf>(
+                    ParamsOneOf::FromJSONSchema(r.ReadValue()));
+            }
+        } else if (key == "extra") {
+            ReadJSONMap(r, &out->extra);
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+void ReadDocument(JsonReader& r, Document* out) {
+    r.BeginObject();
+    std::string key;
+    while (r.NextKey(&key)) {
+        if (key == "id") {
+            ReadNullableString(r, &out->id);
+        } else if (key == "content") {
+            ReadNullableString(r, &out->page_content);
+        } else if (key == "meta_data") {
+            ReadJSONMap(r, &out->metadata);
+        } else {
+            r.Skip();
+        }
+    }
+}
+
+// ============================================================================
+// Whole-text helpers
+// ============================================================================
+
+std::string MessageToJSON(const Message& msg) {
+    JsonWriter w;
+    WriteMessage(w, msg);
+    return w.Take();
+}
+
+Message ParseMessage(const std::string& text) {
+    JsonReader r(text);
+    Message msg;
+    ReadMessage(r, &msg);
+    r.ExpectEnd();
+    return msg;
+}
+
+std::vector<Message> ParseMessages(const std::string& text) {
+    JsonReader r(text);
+    std::vector<Message> msgs;
+    ReadMessages(r, &msgs);
+    r.ExpectEnd();
+    return msgs;
+}
+
+Document ParseDocument(const std::string& text) {
+    JsonReader r(text);
+    Document doc;
+    ReadDocument(r, &doc);
+    r.ExpectEnd();
+    return doc;
+}
+
+} // namespace schema
+} // namespace eino
@@ -15,187 +15,339 @@
  */
 
 #include "eino/schema/message_concat.h"
-#include <sstream>
 #include <algorithm>
+#include <mutex>
+#include <set>
+#include <utility>
 
 namespace eino {
 namespace schema {
 
-std::vector<ToolCall> ConcatToolCalls(const std::vector<ToolCall>& chunks) {
-    std::vector<ToolCall> merged;
-    std::map<int, std::vector<size_t>> index_map;  // index -> chunk positions
-    
-    // Group by index
-    for (size_t i = 0; i < chunks.size(); ++i) {
-        const auto& tc = chunks[i];
-        if (tc.index == nullptr) {
-            merged.push_back(tc);
-        } else {
-            index_map[*tc.index].push_back(i);
-        }
+// ============================================================================
+// TextRope
+// ============================================================================
+
+void TextRope::Append(const std::string& piece) {
+    if (piece.empty()) {
+        return;
     }
-    
-    // Merge tool calls with same index
-    for (const auto& [idx, positions] : index_map) {
-        ToolCall tool_call;
-        tool_call.index = new int(idx);
-        
-        std::string tool_id, tool_type, tool_name;
-        std::ostringstream args_builder;
-        
-        for (size_t pos : positions) {
-            const auto& chunk = chunks[pos];
-            
-            // Validate and merge ID
-            if (!chunk.id.empty()) {
-                if (tool_id.empty()) {
-                    tool_id = chunk.id;
-                } else if (tool_id != chunk.id) {
-                    throw std::runtime_error(
-                        "Cannot concat ToolCalls with different IDs: '" + 
-                        tool_id + "' vs '" + chunk.id + "'");
-                }
-            }
-            
-            // Validate and merge Type
-            if (!chunk.type.empty()) {
-                if (tool_type.empty()) {
-                    tool_type = chunk.type;
-                } else if (tool_type != chunk.type) {
-                    throw std::runtime_error(
-                        "Cannot concat ToolCalls with different types: '" + 
-                        tool_type + "' vs '" + chunk.type + "'");
-                }
-            }
-            
-            // Validate and merge Function Name
-            if (!chunk.function.name.empty()) {
-                if (tool_name.empty()) {
-                    tool_name = chunk.function.name;
-                } else if (tool_name != chunk.function.name) {
-                    throw std::runtime_error(
-                        "Cannot concat ToolCalls with different names: '" + 
-                        tool_name + "' vs '" + chunk.function.name + "'");
-                }
-            }
-            
-            // Concatenate arguments
-            if (!chunk.function.arguments.empty()) {
-                args_builder << chunk.function.arguments;
-            }
+    if (pending_.empty() && flat_.capacity() - flat_.size() >= piece.size()) {
+        flat_.append(piece);
+        return;
+    }
+    pending_.push_back(piece);
+    pending_bytes_ += piece.size();
+}
+
+void TextRope::Append(std::string&& piece) {
+    if (piece.empty()) {
+        return;
+    }
+    if (pending_.empty() && flat_.capacity() - flat_.size() >= piece.size()) {
+        flat_.append(piece);
+        return;
+    }
+    pending_.push_back(std::move(piece));
+    pending_bytes_ += pending_.back().size();
+}
+
+const std::string& TextRope::Flatten() {
+    if (!pending_.empty()) {
+        size_t needed = flat_.size() + pending_bytes_;
+        if (needed > flat_.capacity()) {
+            // Grow geometrically once flushed mid-stream, so repeated
+            // snapshots don't recopy the prefix every time
+            flat_.reserve(flat_.empty() ? needed : std::max(needed, flat_.capacity() * 2));
         }
-        
-        tool_call.id = tool_id;
-        tool_call.type = tool_type;
-        tool_call.function.name = tool_name;
-        tool_call.function.arguments = args_builder.str();
-        
-        merged.push_back(tool_call);
+        for (const auto& piece : pending_) {
+            flat_.append(piece);
+        }
+        pending_.clear();
+        pending_bytes_ = 0;
     }
+    return flat_;
+}
+
+std::string TextRope::Take() {
+    Flatten();
+    std::string out = std::move(flat_);
+    flat_.clear();
+    return out;
+}
+
+// ============================================================================
+// AssistantPartMerger
+// ============================================================================
+
+void AssistantPartMerger::Add(const MessageOutputPart& part) {
+    bool is_text = part.type == ChatMessagePartType::kText;
+    bool is_audio = !is_text && IsBase64AudioPart(part);
+    RunKind kind = is_text ? RunKind::kText : RunKind::kAudio;
     
-    // Sort by index
-    if (merged.size() > 1) {
-        std::stable_sort(merged.begin(), merged.end(), 
-            [](const ToolCall& a, const ToolCall& b) {
-                if (a.index == nullptr && b.index == nullptr) return false;
-                if (a.index == nullptr) return true;
-                if (b.index == nullptr) return false;
-                return *a.index < *b.index;
-            });
+    if (open_ && (!(is_text || is_audio) || open_->kind != kind)) {
+        Close();
+    }
+    if (!is_text && !is_audio) {
+        // Non-mergeable part
+        closed_.push_back(part);
+        return;
     }
     
+    if (!open_) {
+        open_.reset(new Run());
+        open_->kind = kind;
+        open_->first = part;
+    }
+    Run& run = *open_;
+    run.count++;
+    if (is_text) {
+        run.data.Append(part.text);
+        return;
+    }
+    const auto& common = part.audio->common;
+    run.data.Append(*common.base64_data);
+    if (run.mime_type.empty()) {
+        run.mime_type = common.mime_type;
+    }
+    // Later values override earlier ones, as in ConcatExtra
+    for (const auto& kv : common.extra) {
+        run.extra[kv.first] = kv.second;
+    }
+}
+
+MessageOutputPart AssistantPartMerger::Materialize(Run& run, bool consume) {
+    if (run.count == 1) {
+        return run.first;
+    }
+    MessageOutputPart merged;
+    if (run.kind == RunKind::kText) {
+        merged.type = ChatMessagePartType::kText;
+        merged.text = consume ? run.data.Take() : run.data.Flatten();
+        return merged;
+    }
+    merged.type = ChatMessagePartType::kAudioURL;
+    merged.audio = std::make_shared<MessageOutputAudio>();
+    merged.audio->common.base64_data =
+        new std::string(consume ? run.data.Take() : run.data.Flatten());
+    merged.audio->common.mime_type = run.mime_type;
+    merged.audio->common.extra = run.extra;
     return merged;
 }
 
-std::vector<MessageOutputPart> ConcatAssistantMultiContent(
-    const std::vector<MessageOutputPart>& parts) {
-    
-    if (parts.empty()) {
-        return parts;
+void AssistantPartMerger::Close() {
+    closed_.push_back(Materialize(*open_, true));
+    open_.reset();
+}
+
+std::vector<MessageOutputPart> AssistantPartMerger::Snapshot() {
+    std::vector<MessageOutputPart> parts = closed_;
+    if (open_) {
+        parts.push_back(Materialize(*open_, false));
+    }
+    return parts;
+}
+
+std::vector<MessageOutputPart> AssistantPartMerger::Finish() {
+    if (open_) {
+        Close();
     }
+    std::vector<MessageOutputPart> parts = std::move(closed_);
+    closed_.clear();
+    return parts;
+}
+
+// ============================================================================
+// MessageConcatenator
+// ============================================================================
+
+namespace {
+
+// PooledIndex returns a process-lifetime pointer for a tool call index, so
+// merged calls don't own (or leak) their index
+int* PooledIndex(int idx) {
+    static std::mutex mu;
+    static std::set<int>* pool = new std::set<int>();
+    std::lock_guard<std::mutex> lock(mu);
+    return const_cast<int*>(&*pool->insert(idx).first);
+}
+
+// MergeField sets field from value, or checks that they agree
+void MergeField(std::string& field, const std::string& value,
+                const char* what, const char* object) {
+    if (value.empty()) {
+        return;
+    }
+    if (field.empty()) {
+        field = value;
+    } else if (field != value) {
+        throw std::runtime_error(
+            std::string("Cannot concat ") + object + " with different " + what + ": '" +
+            field + "' vs '" + value + "'");
+    }
+}
+
+} // namespace
+
+void MessageConcatenator::Reserve(size_t content_bytes, size_t reasoning_bytes) {
+    content_.Reserve(content_bytes);
+    reasoning_.Reserve(reasoning_bytes);
+}
+
+void MessageConcatenator::Add(const Message& chunk) {
+    if (chunks_ == 0) {
+        head_.role = chunk.role;
+    } else if (head_.role != chunk.role) {
+        throw std::runtime_error(
+            "Cannot concat messages with different roles: '" +
+            head_.GetRoleString() + "' vs '" + chunk.GetRoleString() + "'");
+    }
+    MergeField(head_.name, chunk.name, "names", "messages");
+    MergeField(head_.tool_call_id, chunk.tool_call_id, "tool_call_ids", "messages");
+    MergeField(head_.tool_name, chunk.tool_name, "tool_names", "messages");
+    chunks_++;
     
-    std::vector<MessageOutputPart> merged;
-    size_t i = 0;
+    content_.Append(chunk.content);
+    reasoning_.Append(chunk.reasoning_content);
     
-    while (i < parts.size()) {
-        const auto& current = parts[i];
-        size_t start = i;
-        
-        if (current.type == ChatMessagePartType::kText) {
-            // Text merging: find contiguous text block
-            size_t end = start + 1;
-            while (end < parts.size() && parts[end].type == ChatMessagePartType::kText) {
-                ++end;
-            }
-            
-            if (end == start + 1) {
-                merged.push_back(current);
-            } else {
-                // Merge multiple text parts
-                std::ostringstream text_builder;
-                for (size_t k = start; k < end; ++k) {
-                    text_builder << parts[k].text;
-                }
-                
-                MessageOutputPart merged_part;
-                merged_part.type = ChatMessagePartType::kText;
-                merged_part.text = text_builder.str();
-                merged.push_back(merged_part);
-            }
-            i = end;
-            
-        } else if (IsBase64AudioPart(current)) {
-            // Audio merging: find contiguous audio block
-            size_t end = start + 1;
-            while (end < parts.size() && IsBase64AudioPart(parts[end])) {
-                ++end;
-            }
-            
-            if (end == start + 1) {
-                merged.push_back(current);
-            } else {
-                // Merge multiple audio parts
-                std::ostringstream b64_builder;
-                std::string mime_type;
-                std::vector<std::map<std::string, json>> extra_list;
-                
-                for (size_t k = start; k < end; ++k) {
-                    const auto& audio_part = parts[k].audio;
-                    if (audio_part->common.base64_data != nullptr) {
-                        b64_builder << *audio_part->common.base64_data;
-                    }
-                    if (mime_type.empty()) {
-                        mime_type = audio_part->common.mime_type;
-                    }
-                    if (!audio_part->common.extra.empty()) {
-                        extra_list.push_back(audio_part->common.extra);
-                    }
-                }
-                
-                MessageOutputPart merged_part;
-                merged_part.type = ChatMessagePartType::kAudioURL;
-                merged_part.audio = std::make_shared<MessageOutputAudio>();
-                
-                std::string* b64_data = new std::string(b64_builder.str());
-                merged_part.audio->common.base64_data = b64_data;
-                merged_part.audio->common.mime_type = mime_type;
-                
-                if (!extra_list.empty()) {
-                    merged_part.audio->common.extra = ConcatExtra(extra_list);
-                }
-                
-                merged.push_back(merged_part);
-            }
-            i = end;
-            
-        } else {
-            // Non-mergeable part
-            merged.push_back(current);
-            ++i;
+    for (const auto& call : chunk.tool_calls) {
+        AddToolCall(call);
+    }
+    for (const auto& kv : chunk.extra) {
+        extra_[kv.first] = kv.second;
+    }
+    multi_content_.insert(multi_content_.end(),
+                          chunk.multi_content.begin(), chunk.multi_content.end());
+    for (const auto& part : chunk.assistant_gen_multi_content) {
+        assistant_parts_.Add(part);
+    }
+    
+    const auto& meta = chunk.response_meta;
+    if (meta == nullptr) {
+        return;
+    }
+    if (response_meta_ == nullptr) {
+        response_meta_ = std::make_shared<ResponseMeta>();
+    }
+    // Keep last valid FinishReason
+    if (!meta->finish_reason.empty()) {
+        response_meta_->finish_reason = meta->finish_reason;
+    }
+    // Usage keeps the maximum of each counter
+    if (meta->usage != nullptr) {
+        if (response_meta_->usage == nullptr) {
+            response_meta_->usage = std::make_shared<TokenUsage>();
         }
+        auto& ru = *response_meta_->usage;
+        const auto& mu = *meta->usage;
+        ru.prompt_tokens = std::max(ru.prompt_tokens, mu.prompt_tokens);
+        ru.completion_tokens = std::max(ru.completion_tokens, mu.completion_tokens);
+        ru.total_tokens = std::max(ru.total_tokens, mu.total_tokens);
+        ru.prompt_token_details.cached_tokens = std::max(
+            ru.prompt_token_details.cached_tokens,
+            mu.prompt_token_details.cached_tokens);
+    }
+    // LogProbs accumulate
+    if (meta->logprobs != nullptr) {
+        if (response_meta_->logprobs == nullptr) {
+            response_meta_->logprobs = std::make_shared<LogProbs>();
+        }
+        response_meta_->logprobs->content.insert(
+            response_meta_->logprobs->content.end(),
+            meta->logprobs->content.begin(), meta->logprobs->content.end());
+    }
+}
+
+void MessageConcatenator::AddToolCall(const ToolCall& call) {
+    if (call.index == nullptr) {
+        unindexed_calls_.push_back(call);
+        return;
+    }
+    ToolCallRun& run = indexed_calls_[*call.index];
+    MergeField(run.id, call.id, "IDs", "ToolCalls");
+    MergeField(run.type, call.type, "types", "ToolCalls");
+    MergeField(run.name, call.function.name, "names", "ToolCalls");
+    run.arguments.Append(call.function.arguments);
+}
+
+// Unindexed calls come first, then merged calls by index
+std::vector<ToolCall> MessageConcatenator::BuildToolCalls(bool consume) {
+    std::vector<ToolCall> calls;
+    calls.reserve(unindexed_calls_.size() + indexed_calls_.size());
+    calls.insert(calls.end(), unindexed_calls_.begin(), unindexed_calls_.end());
+    for (auto& kv : indexed_calls_) {
+        ToolCall call;
+        call.index = PooledIndex(kv.first);
+        call.id = kv.second.id;
+        call.type = kv.second.type;
+        call.function.name = kv.second.name;
+        call.function.arguments =
+            consume ? kv.second.arguments.Take() : kv.second.arguments.Flatten();
+        calls.push_back(std::move(call));
+    }
+    return calls;
+}
+
+// Snapshots get their own copy: the merged meta keeps changing in place
+std::shared_ptr<ResponseMeta> MessageConcatenator::CopyResponseMeta() const {
+    if (response_meta_ == nullptr) {
+        return nullptr;
+    }
+    auto meta = std::make_shared<ResponseMeta>();
+    meta->finish_reason = response_meta_->finish_reason;
+    if (response_meta_->usage) {
+        meta->usage = std::make_shared<TokenUsage>(*response_meta_->usage);
     }
+    if (response_meta_->logprobs) {
+        meta->logprobs = std::make_shared<LogProbs>(*response_meta_->logprobs);
+    }
+    return meta;
+}
+
+Message MessageConcatenator::Snapshot() {
+    Message result = head_;
+    result.content = content_.Flatten();
+    result.reasoning_content = reasoning_.Flatten();
+    result.tool_calls = BuildToolCalls(false);
+    result.extra = extra_;
+    result.multi_content = multi_content_;
+    result.assistant_gen_multi_content = assistant_parts_.Snapshot();
+    result.response_meta = CopyResponseMeta();
+    return result;
+}
+
+Message MessageConcatenator::Finish() {
+    if (chunks_ == 0) {
+        throw std::invalid_argument("Cannot concat empty message list");
+    }
+    Message result = std::move(head_);
+    result.content = content_.Take();
+    result.reasoning_content = reasoning_.Take();
+    result.tool_calls = BuildToolCalls(true);
+    result.extra = std::move(extra_);
+    result.multi_content = std::move(multi_content_);
+    result.assistant_gen_multi_content = assistant_parts_.Finish();
+    result.response_meta = std::move(response_meta_);
     
-    return merged;
+    *this = MessageConcatenator();
+    return result;
+}
+
+std::vector<ToolCall> ConcatToolCalls(const std::vector<ToolCall>& chunks) {
+    MessageConcatenator concat;
+    Message chunk;
+    chunk.tool_calls = chunks;
+    concat.Add(chunk);
+    return concat.Finish().tool_calls;
+}
+
+std::vector<MessageOutputPart> ConcatAssistantMultiContent(
+    const std::vector<MessageOutputPart>& parts) {
+    
+    AssistantPartMerger merger;
+    for (const auto& part : parts) {
+        merger.Add(part);
+    }
+    return merger.Finish();
 }
 
 std::map<std::string, json> ConcatExtra(
@@ -226,189 +378,23 @@ Message ConcatMessages(const std::vector<Message*>& msgs) {
         throw std::invalid_argument("Cannot concat empty message list");
     }
     
-    Message result;
-    std::vector<std::string> contents;
+    // Size the text once: every chunk is already at hand
     size_t content_len = 0;
-    std::vector<std::string> reasoning_contents;
     size_t reasoning_len = 0;
-    std::vector<ToolCall> tool_calls;
-    std::vector<ChatMessagePart> multi_content_parts;
-    std::vector<MessageOutputPart> assistant_gen_parts;
-    std::vector<std::map<std::string, json>> extra_list;
-    
     for (size_t idx = 0; idx < msgs.size(); ++idx) {
-        const auto* msg = msgs[idx];
-        if (msg == nullptr) {
+        if (msgs[idx] == nullptr) {
             throw std::runtime_error("Unexpected nil chunk at index " + std::to_string(idx));
         }
-        
-        // Validate and set Role
-        if (!result.GetRoleString().empty()) {
-            if (result.role != msg->role) {
-                throw std::runtime_error(
-                    "Cannot concat messages with different roles: '" + 
-                    result.GetRoleString() + "' vs '" + msg->GetRoleString() + "'");
-            }
-        } else {
-            result.role = msg->role;
-        }
-        
-        // Validate and set Name
-        if (!msg->name.empty()) {
-            if (result.name.empty()) {
-                result.name = msg->name;
-            } else if (result.name != msg->name) {
-                throw std::runtime_error(
-                    "Cannot concat messages with different names: '" + 
-                    result.name + "' vs '" + msg->name + "'");
-            }
-        }
-        
-        // Validate and set ToolCallID
-        if (!msg->tool_call_id.empty()) {
-            if (result.tool_call_id.empty()) {
-                result.tool_call_id = msg->tool_call_id;
-            } else if (result.tool_call_id != msg->tool_call_id) {
-                throw std::runtime_error(
-                    "Cannot concat messages with different tool_call_ids: '" + 
-                    result.tool_call_id + "' vs '" + msg->tool_call_id + "'");
-            }
-        }
-        
-        // Validate and set ToolName
-        if (!msg->tool_name.empty()) {
-            if (result.tool_name.empty()) {
-                result.tool_name = msg->tool_name;
-            } else if (result.tool_name != msg->tool_name) {
-                throw std::runtime_error(
-                    "Cannot concat messages with different tool_names: '" + 
-                    result.tool_name + "' vs '" + msg->tool_name + "'");
-            }
-        }
-        
-        // Accumulate content
-        if (!msg->content.empty()) {
-            contents.push_back(msg->content);
-            content_len += msg->content.size();
-        }
-        
-        // Accumulate reasoning content
-        if (!msg->reasoning_content.empty()) {
-            reasoning_contents.push_back(msg->reasoning_content);
-            reasoning_len += msg->reasoning_content.size();
-        }
-        
-        // Accumulate tool calls
-        if (!msg->tool_calls.empty()) {
-            tool_calls.insert(tool_calls.end(), 
-                             msg->tool_calls.begin(), 
-                             msg->tool_calls.end());
-        }
-        
-        // Accumulate extra
-        if (!msg->extra.empty()) {
-            extra_list.push_back(msg->extra);
-        }
-        
-        // Accumulate deprecated MultiContent
-        if (!msg->multi_content.empty()) {
-            multi_content_parts.insert(multi_content_parts.end(),
-                                      msg->multi_content.begin(),
-                                      msg->multi_content.end());
-        }
-        
-        // Accumulate AssistantGenMultiContent
-        if (!msg->assistant_gen_multi_content.empty()) {
-            assistant_gen_parts.insert(assistant_gen_parts.end(),
-                                      msg->assistant_gen_multi_content.begin(),
-                                      msg->assistant_gen_multi_content.end());
-        }
-        
-        // Initialize ResponseMeta if needed
-        if (msg->response_meta != nullptr && result.response_meta == nullptr) {
-            result.response_meta = std::make_shared<ResponseMeta>();
-        }
-        
-        // Merge ResponseMeta
-        if (msg->response_meta != nullptr && result.response_meta != nullptr) {
-            // Keep last valid FinishReason
-            if (!msg->response_meta->finish_reason.empty()) {
-                result.response_meta->finish_reason = msg->response_meta->finish_reason;
-            }
-            
-            // Merge Usage
-            if (msg->response_meta->usage != nullptr) {
-                if (result.response_meta->usage == nullptr) {
-                    result.response_meta->usage = std::make_shared<TokenUsage>();
-                }
-                
-                auto& ru = *result.response_meta->usage;
-                auto& mu = *msg->response_meta->usage;
-                
-                ru.prompt_tokens = std::max(ru.prompt_tokens, mu.prompt_tokens);
-                ru.completion_tokens = std::max(ru.completion_tokens, mu.completion_tokens);
-                ru.total_tokens = std::max(ru.total_tokens, mu.total_tokens);
-                ru.prompt_token_details.cached_tokens = std::max(
-                    ru.prompt_token_details.cached_tokens,
-                    mu.prompt_token_details.cached_tokens);
-            }
-            
-            // Accumulate LogProbs
-            if (msg->response_meta->logprobs != nullptr) {
-                if (result.response_meta->logprobs == nullptr) {
-                    result.response_meta->logprobs = std::make_shared<LogProbs>();
-                }
-                
-                result.response_meta->logprobs->content.insert(
-                    result.response_meta->logprobs->content.end(),
-                    msg->response_meta->logprobs->content.begin(),
-                    msg->response_meta->logprobs->content.end());
-            }
-        }
-    }
-    
-    // Build final content
-    if (!contents.empty()) {
-        std::ostringstream builder;
-        for (const auto& c : contents) {
-            builder << c;
-        }
-        result.content = builder.str();
-    }
-    
-    // Build final reasoning content
-    if (!reasoning_contents.empty()) {
-        std::ostringstream builder;
-        for (const auto& rc : reasoning_contents) {
-            builder << rc;
-        }
-        result.reasoning_content = builder.str();
+        content_len += msgs[idx]->content.size();
+        reasoning_len += msgs[idx]->reasoning_content.size();
     }
     
-    // Merge tool calls
-    if (!tool_calls.empty()) {
-        result.tool_calls = ConcatToolCalls(tool_calls);
+    MessageConcatenator concat;
+    concat.Reserve(content_len, reasoning_len);
+    for (const auto* msg : msgs) {
+        concat.Add(*msg);
     }
-    
-    // Merge extra
-    if (!extra_list.empty()) {
-        auto merged_extra = ConcatExtra(extra_list);
-        if (!merged_extra.empty()) {
-            result.extra = merged_extra;
-        }
-    }
-    
-    // Set deprecated MultiContent
-    if (!multi_content_parts.empty()) {
-        result.multi_content = multi_content_parts;
-    }
-    
-    // Merge AssistantGenMultiContent
-    if (!assistant_gen_parts.empty()) {
-        result.assistant_gen_multi_content = ConcatAssistantMultiContent(assistant_gen_parts);
-    }
-    
-    return result;
+    return concat.Finish();
 }
 
 std::vector<Message> ConcatMessageArray(
@@ -0,0 +1,384 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/schema/message_ref.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace eino {
+namespace schema {
+
+namespace {
+
+// Node-based set: element addresses are stable across rehashing
+const std::string* Intern(const std::string& s) {
+    static std::mutex mu;
+    static std::unordered_set<std::string>* pool = new std::unordered_set<std::string>();
+    std::lock_guard<std::mutex> lock(mu);
+    return &*pool->insert(s).first;
+}
+
+template<typename T>
+std::shared_ptr<const T> Share(T value) {
+    return std::make_shared<const T>(std::move(value));
+}
+
+// Empty fields point at shared singletons so default messages allocate once
+template<typename T>
+const std::shared_ptr<const T>& EmptyField() {
+    static const std::shared_ptr<const T> empty = std::make_shared<const T>();
+    return empty;
+}
+
+template<typename T>
+std::shared_ptr<const T> ShareOrEmpty(T value) {
+    return value.empty() ? EmptyField<T>() : Share(std::move(value));
+}
+
+// CopyMeta copies meta with its usage and logprobs, so the copy shares no
+// object a Message can still write through
+std::shared_ptr<ResponseMeta> CopyMeta(const std::shared_ptr<const ResponseMeta>& meta) {
+    if (!meta) {
+        return nullptr;
+    }
+    auto copy = std::make_shared<ResponseMeta>(*meta);
+    if (meta->usage) {
+        copy->usage = std::make_shared<TokenUsage>(*meta->usage);
+    }
+    if (meta->logprobs) {
+        copy->logprobs = std::make_shared<LogProbs>(*meta->logprobs);
+    }
+    return copy;
+}
+
+} // namespace
+
+// ============================================================================
+// InternedString
+// ============================================================================
+
+InternedString::InternedString() : str_(Intern(std::string())) {}
+
+InternedString::InternedString(const std::string& s) : str_(Intern(s)) {}
+
+// ============================================================================
+// MessageRef
+// ============================================================================
+
+MessageRef::MessageRef() {
+    static const std::shared_ptr<const Data> empty = [] {
+        auto data = std::make_shared<Data>();
+        data->content = EmptyField<std::string>();
+        data->reasoning_content = EmptyField<std::string>();
+        data->tool_calls = EmptyField<std::vector<ToolCall>>();
+        data->user_input_multi_content = EmptyField<std::vector<MessageInputPart>>();
+        data->assistant_gen_multi_content = EmptyField<std::vector<MessageOutputPart>>();
+        data->multi_content = EmptyField<std::vector<ChatMessagePart>>();
+        data->extra = EmptyField<std::map<std::string, json>>();
+        return std::shared_ptr<const Data>(std::move(data));
+    }();
+    data_ = empty;
+}
+
+MessageRef MessageRef::From(const Message& msg) {
+    return From(Message(msg));
+}
+
+MessageRef MessageRef::From(Message&& msg) {
+    auto data = std::make_shared<Data>();
+    data->role = msg.role;
+    data->content = ShareOrEmpty(std::move(msg.content));
+    data->reasoning_content = ShareOrEmpty(std::move(msg.reasoning_content));
+    data->tool_calls = ShareOrEmpty(std::move(msg.tool_calls));
+    data->user_input_multi_content = ShareOrEmpty(std::move(msg.user_input_multi_content));
+    data->assistant_gen_multi_content = ShareOrEmpty(std::move(msg.assistant_gen_multi_content));
+    data->multi_content = ShareOrEmpty(std::move(msg.multi_content));
+    data->tool_call_id = std::move(msg.tool_call_id);
+    data->tool_name = InternedString(msg.tool_name);
+    data->name = InternedString(msg.name);
+    data->response_meta = CopyMeta(msg.response_meta);
+    data->extra = ShareOrEmpty(std::move(msg.extra));
+    return MessageRef(std::move(data));
+}
+
+Message MessageRef::ToMessage() const {
+    Message msg;
+    msg.role = data_->role;
+    msg.content = *data_->content;
+    msg.reasoning_content = *data_->reasoning_content;
+    msg.tool_calls = *data_->tool_calls;
+    msg.user_input_multi_content = *data_->user_input_multi_content;
+    msg.assistant_gen_multi_content = *data_->assistant_gen_multi_content;
+    msg.multi_content = *data_->multi_content;
+    msg.tool_call_id = data_->tool_call_id;
+    msg.tool_name = data_->tool_name.str();
+    msg.name = data_->name.str();
+    msg.response_meta = CopyMeta(data_->response_meta);
+    msg.extra = *data_->extra;
+    return msg;
+}
+
+MessageRef::Builder MessageRef::ToBuilder() const {
+    return Builder(*this);
+}
+
+// ============================================================================
+// MessageRef::Builder
+// ============================================================================
+
+MessageRef::Builder& MessageRef::Builder::SetRole(RoleType role) {
+    data_.role = role;
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetContent(std::string content) {
+    data_.content = ShareOrEmpty(std::move(content));
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::AppendContent(const std::string& delta) {
+    if (!delta.empty()) {
+        std::string content;
+        content.reserve(data_.content->size() + delta.size());
+        content.append(*data_.content).append(delta);
+        data_.content = Share(std::move(content));
+    }
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetReasoningContent(std::string reasoning) {
+    data_.reasoning_content = ShareOrEmpty(std::move(reasoning));
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetToolCalls(std::vector<ToolCall> tool_calls) {
+    data_.tool_calls = ShareOrEmpty(std::move(tool_calls));
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetUserInputMultiContent(
+    std::vector<MessageInputPart> parts) {
+    data_.user_input_multi_content = ShareOrEmpty(std::move(parts));
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetAssistantGenMultiContent(
+    std::vector<MessageOutputPart> parts) {
+    data_.assistant_gen_multi_content = ShareOrEmpty(std::move(parts));
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetMultiContent(std::vector<ChatMessagePart> parts) {
+    data_.multi_content = ShareOrEmpty(std::move(parts));
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetToolCallID(std::string id) {
+    data_.tool_call_id = std::move(id);
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetToolName(const std::string& tool_name) {
+    data_.tool_name = InternedString(tool_name);
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetName(const std::string& name) {
+    data_.name = InternedString(name);
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetResponseMeta(
+    const std::shared_ptr<const ResponseMeta>& meta) {
+    data_.response_meta = CopyMeta(meta);
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetExtra(std::map<std::string, json> extra) {
+    data_.extra = ShareOrEmpty(std::move(extra));
+    return *this;
+}
+
+MessageRef::Builder& MessageRef::Builder::SetExtra(const std::string& key, json value) {
+    auto extra = *data_.extra;
+    extra[key] = std::move(value);
+    data_.extra = Share(std::move(extra));
+    return *this;
+}
+
+MessageRef MessageRef::Builder::Build() const {
+    return MessageRef(std::make_shared<const Data>(data_));
+}
+
+// ============================================================================
+// MessageHistory
+// ============================================================================
+
+MessageHistory MessageHistory::FromMessages(const std::vector<Message>& messages) {
+    std::vector<MessageRef> refs;
+    refs.reserve(messages.size());
+    for (const auto& msg : messages) {
+        refs.push_back(MessageRef::From(msg));
+    }
+    return MessageHistory().Append(refs);
+}
+
+MessageHistory MessageHistory::Append(const MessageRef& msg) const {
+    auto chunk = std::make_shared<Chunk>();
+    if (tail_ && tail_->items.size() < kChunkSize) {
+        // Chunks are immutable: copy the partial tail's handles
+        chunk->prev = tail_->prev;
+        chunk->base = tail_->base;
+        chunk->items.reserve(tail_->items.size() + 1);
+        chunk->items = tail_->items;
+    } else {
+        chunk->prev = tail_;
+        chunk->base = size_;
+        chunk->items.reserve(kChunkSize);
+    }
+    chunk->items.push_back(msg);
+    return MessageHistory(std::move(chunk), size_ + 1);
+}
+
+MessageHistory MessageHistory::Append(const std::vector<MessageRef>& msgs) const {
+    if (msgs.empty()) {
+        return *this;
+    }
+    std::shared_ptr<const Chunk> tail = tail_;
+    std::shared_ptr<Chunk> open;
+    if (tail && tail->items.size() < kChunkSize) {
+        open = std::make_shared<Chunk>();
+        open->prev = tail->prev;
+        open->base = tail->base;
+        open->items.reserve(kChunkSize);
+        open->items = tail->items;
+    }
+    size_t size = size_;
+    for (const auto& msg : msgs) {
+        if (!open || open->items.size() == kChunkSize) {
+            if (open) {
+                tail = open;
+            }
+            open = std::make_shared<Chunk>();
+            open->prev = tail;
+            open->base = size;
+            open->items.reserve(kChunkSize);
+        }
+        open->items.push_back(msg);
+        ++size;
+    }
+    return MessageHistory(std::move(open), size);
+}
+
+MessageHistory MessageHistory::Prefix(size_t n) const {
+    if (n > size_) {
+        throw std::out_of_range("MessageHistory::Prefix: n out of range");
+    }
+    if (n == size_) {
+        return *this;
+    }
+    if (n == 0) {
+        return MessageHistory();
+    }
+    const Chunk* chunk = ChunkAt(n - 1);
+    size_t keep = n - chunk->base;
+    if (keep == chunk->items.size()) {
+        // Full chunk: find the shared_ptr that owns it
+        std::shared_ptr<const Chunk> owner = tail_;
+        while (owner.get() != chunk) {
+            owner = owner->prev;
+        }
+        return MessageHistory(std::move(owner), n);
+    }
+    auto cut = std::make_shared<Chunk>();
+    cut->prev = chunk->prev;
+    cut->base = chunk->base;
+    cut->items.assign(chunk->items.begin(), chunk->items.begin() + keep);
+    return MessageHistory(std::move(cut), n);
+}
+
+const MessageHistory::Chunk* MessageHistory::ChunkAt(size_t i) const {
+    const Chunk* chunk = tail_.get();
+    while (chunk->base > i) {
+        chunk = chunk->prev.get();
+    }
+    return chunk;
+}
+
+const MessageRef& MessageHistory::At(size_t i) const {
+    if (i >= size_) {
+        throw std::out_of_range("MessageHistory::At: index out of range");
+    }
+    const Chunk* chunk = ChunkAt(i);
+    return chunk->items[i - chunk->base];
+}
+
+void MessageHistory::ForEach(const std::function<void(const MessageRef&)>& fn) const {
+    std::vector<const Chunk*> chunks;
+    for (const Chunk* c = tail_.get(); c; c = c->prev.get()) {
+        chunks.push_back(c);
+    }
+    for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+        for (const auto& msg : (*it)->items) {
+            fn(msg);
+        }
+    }
+}
+
+std::vector<MessageRef> MessageHistory::ToRefs() const {
+    std::vector<MessageRef> refs;
+    refs.reserve(size_);
+    ForEach([&refs](const MessageRef& msg) { refs.push_back(msg); });
+    return refs;
+}
+
+std::vector<Message> MessageHistory::ToMessages() const {
+    std::vector<Message> messages;
+    messages.reserve(size_);
+    ForEach([&messages](const MessageRef& msg) { messages.push_back(msg.ToMessage()); });
+    return messages;
+}
+
+bool MessageHistory::SharesPrefixWith(const MessageHistory& other, size_t n) const {
+    if (n > size_ || n > other.size_) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+    const Chunk* a = ChunkAt(n - 1);
+    const Chunk* b = other.ChunkAt(n - 1);
+    if (a == b) {
+        return true;
+    }
+    // Partial tails are copied on append; earlier chunks must be the same
+    if (a->base != b->base || a->prev != b->prev) {
+        return false;
+    }
+    for (size_t i = 0; i + a->base < n; ++i) {
+        if (!a->items[i].SameAs(b->items[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace schema
+} // namespace eino
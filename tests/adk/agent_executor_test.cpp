@@ -0,0 +1,254 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/agent_executor.h"
+#include "eino/adk/async_iterator.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eino::adk;
+
+namespace {
+
+AgentExecutor::Options SmallPool() {
+    AgentExecutor::Options options;
+    options.core_threads = 2;
+    options.idle_timeout = std::chrono::milliseconds(50);
+    return options;
+}
+
+} // namespace
+
+TEST(AgentExecutorTest, RunsSubmittedTasks) {
+    std::atomic<int> ran{0};
+    std::atomic<int> errors{0};
+    {
+        auto options = SmallPool();
+        options.on_task_error = [&errors](std::exception_ptr error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::runtime_error& e) {
+                EXPECT_STREQ(e.what(), "reported");
+                errors.fetch_add(1);
+            }
+        };
+        AgentExecutor executor(options);
+        for (int i = 0; i < 100; ++i) {
+            executor.Submit([&ran]() { ran.fetch_add(1); });
+        }
+        executor.Submit([]() { throw std::runtime_error("reported"); });
+    }
+    // The destructor drains the queue before the workers exit
+    EXPECT_EQ(ran.load(), 100);
+    EXPECT_EQ(errors.load(), 1);
+}
+
+TEST(AgentExecutorTest, BlockingScopeAddsWorker) {
+    AgentExecutor executor(SmallPool());
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> blocked{0};
+
+    // Both core workers wait on something outside the pool
+    for (int i = 0; i < 2; ++i) {
+        executor.Submit([&blocked, released]() {
+            AgentExecutor::BlockingScope scope;
+            blocked.fetch_add(1);
+            released.wait();
+        });
+    }
+    while (blocked.load() < 2) {
+        std::this_thread::yield();
+    }
+
+    std::promise<void> ran;
+    executor.Submit([&ran]() { ran.set_value(); });
+    EXPECT_EQ(ran.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(executor.Blocked(), 2u);
+    EXPECT_GE(executor.PeakThreads(), 3u);
+    release.set_value();
+}
+
+TEST(AgentExecutorTest, PumpForwardsWithoutHoldingThreads) {
+    AgentExecutor executor(SmallPool());
+    constexpr int kPumps = 64;
+
+    std::vector<std::shared_ptr<AsyncGenerator<int>>> sources;
+    std::atomic<int> sum{0};
+    std::atomic<int> done{0};
+    for (int i = 0; i < kPumps; ++i) {
+        auto pair = NewAsyncIteratorPair<int>();
+        sources.push_back(pair.second);
+        PumpAsync<int>(
+            pair.first,
+            [&sum](int& v) {
+                sum.fetch_add(v);
+                return true;
+            },
+            [&done]() { done.fetch_add(1); },
+            executor);
+    }
+
+    // Every pump is parked waiting for its source; none holds a worker
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_LE(executor.PeakThreads(), 2u);
+
+    for (auto& source : sources) {
+        source->Send(1);
+        source->Send(2);
+        source->Close();
+    }
+    while (done.load() < kPumps) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(sum.load(), kPumps * 3);
+    EXPECT_LE(executor.PeakThreads(), 2u);
+}
+
+TEST(AgentExecutorTest, PumpStopsWhenCallbackDeclines) {
+    AgentExecutor executor(SmallPool());
+    auto pair = NewAsyncIteratorPair<int>();
+    for (int i = 0; i < 10; ++i) {
+        pair.second->Send(i);
+    }
+
+    std::vector<int> seen;
+    std::promise<void> finished;
+    PumpAsync<int>(
+        pair.first,
+        [&seen](int& v) {
+            seen.push_back(v);
+            return v < 3;
+        },
+        [&finished]() { finished.set_value(); },
+        executor);
+
+    // on_done runs without waiting for Close
+    ASSERT_EQ(finished.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(AgentExecutorTest, PumpReportsThrowingCallback) {
+    AgentExecutor executor(SmallPool());
+    auto pair = NewAsyncIteratorPair<int>();
+    for (int i = 0; i < 5; ++i) {
+        pair.second->Send(i);
+    }
+
+    std::vector<int> seen;
+    std::string error;
+    std::promise<void> finished;
+    PumpAsync<int>(
+        pair.first,
+        [&seen](int& v) {
+            seen.push_back(v);
+            if (v == 2) {
+                throw std::runtime_error("bad value");
+            }
+            return true;
+        },
+        [&finished]() { finished.set_value(); },
+        [&error](std::exception_ptr e) {
+            try {
+                std::rethrow_exception(e);
+            } catch (const std::exception& ex) {
+                error = ex.what();
+            }
+        },
+        executor);
+
+    // The error is reported, on_done still runs and the pump stops
+    ASSERT_EQ(finished.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(error, "bad value");
+    EXPECT_EQ(seen, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(AgentExecutorTest, PumpWithoutErrorHandlerReportsToExecutor) {
+    std::promise<std::string> reported;
+    auto options = SmallPool();
+    options.on_task_error = [&reported](std::exception_ptr e) {
+        try {
+            std::rethrow_exception(e);
+        } catch (const std::exception& ex) {
+            reported.set_value(ex.what());
+        }
+    };
+    AgentExecutor executor(options);
+    auto pair = NewAsyncIteratorPair<int>();
+    pair.second->Send(1);
+
+    std::atomic<bool> done{false};
+    PumpAsync<int>(
+        pair.first,
+        [](int&) -> bool { throw std::runtime_error("lost value"); },
+        [&done]() { done.store(true); },
+        executor);
+
+    auto future = reported.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(future.get(), "lost value");
+    EXPECT_TRUE(done.load());
+}
+
+TEST(AgentExecutorTest, NestedPumpsChainLayers) {
+    AgentExecutor executor(SmallPool());
+    constexpr int kDepth = 8;
+
+    // Each layer forwards the one below it, like nested agent wrappers
+    auto source = NewAsyncIteratorPair<int>();
+    auto upstream = source.first;
+    for (int d = 0; d < kDepth; ++d) {
+        auto layer = NewAsyncIteratorPair<int>();
+        auto gen = layer.second;
+        PumpAsync<int>(
+            upstream,
+            [gen](int& v) {
+                gen->Send(v + 1);
+                return true;
+            },
+            [gen]() { gen->Close(); },
+            executor);
+        upstream = layer.first;
+    }
+
+    std::thread producer([gen = source.second]() {
+        for (int i = 0; i < 100; ++i) {
+            gen->Send(i);
+        }
+        gen->Close();
+    });
+
+    // Next from a non-worker thread: the scope inside it is a no-op
+    int v = 0;
+    int count = 0;
+    int last = -1;
+    while (upstream->Next(v)) {
+        EXPECT_EQ(v, count + kDepth);
+        last = v;
+        ++count;
+    }
+    producer.join();
+    EXPECT_EQ(count, 100);
+    EXPECT_EQ(last, 99 + kDepth);
+    EXPECT_LE(executor.PeakThreads(), 2u);
+}
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/async_iterator.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace eino::adk;
+
+namespace {
+
+AsyncQueueOptions Bounded(size_t capacity, bool single_producer) {
+    AsyncQueueOptions options;
+    options.capacity = capacity;
+    options.single_producer = single_producer;
+    return options;
+}
+
+} // namespace
+
+TEST(AsyncIteratorTest, BoundedSendWaitsForRoom) {
+    for (bool ring : {false, true}) {
+        auto pair = NewAsyncIteratorPair<int>(Bounded(2, ring));
+        auto gen = pair.second;
+        int v = 1;
+        EXPECT_TRUE(gen->TrySend(v));
+        EXPECT_TRUE(gen->TrySend(v));
+        EXPECT_FALSE(gen->TrySend(v));
+
+        std::atomic<bool> sent{false};
+        std::thread producer([gen, &sent]() {
+            gen->Send(3);
+            sent.store(true);
+            gen->Close();
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_FALSE(sent.load());
+
+        std::vector<int> got;
+        while (pair.first->Next(v)) {
+            got.push_back(v);
+        }
+        producer.join();
+        EXPECT_EQ(got, (std::vector<int>{1, 1, 3}));
+    }
+}
+
+TEST(AsyncIteratorTest, RingKeepsOrderUnderLoad) {
+    constexpr int kCount = 200000;
+    auto pair = NewAsyncIteratorPair<int>(Bounded(64, true));
+    std::thread producer([gen = pair.second]() {
+        for (int i = 0; i < kCount; ++i) {
+            gen->Send(i);
+        }
+        gen->Close();
+    });
+
+    // Alternate single and batch reads
+    int expected = 0;
+    std::vector<int> batch;
+    while (pair.first->HasNext()) {
+        int v;
+        if (expected % 2 == 0) {
+            if (!pair.first->Next(v)) {
+                break;
+            }
+            ASSERT_EQ(v, expected++);
+            continue;
+        }
+        batch.clear();
+        pair.first->NextBatch(&batch, 16, std::chrono::milliseconds(100));
+        for (int b : batch) {
+            ASSERT_EQ(b, expected++);
+        }
+    }
+    producer.join();
+    EXPECT_EQ(expected, kCount);
+}
+
+TEST(AsyncIteratorTest, NextBatchTimesOutAndEnds) {
+    auto pair = NewAsyncIteratorPair<int>();
+    std::vector<int> batch;
+    EXPECT_EQ(pair.first->NextBatch(&batch, 8, std::chrono::milliseconds(10)), 0u);
+    EXPECT_TRUE(pair.first->HasNext());
+
+    for (int i = 0; i < 5; ++i) {
+        pair.second->Send(i);
+    }
+    pair.second->Close();
+    EXPECT_EQ(pair.first->NextBatch(&batch, 3, std::chrono::milliseconds(10)), 3u);
+    EXPECT_EQ(pair.first->NextBatch(&batch, 3, std::chrono::milliseconds(10)), 2u);
+    EXPECT_EQ(pair.first->NextBatch(&batch, 3, std::chrono::milliseconds(10)), 0u);
+    EXPECT_FALSE(pair.first->HasNext());
+    EXPECT_EQ(batch, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(AsyncIteratorTest, CancelStopsProducer) {
+    auto pair = NewAsyncIteratorPair<int>(Bounded(1, false));
+    auto gen = pair.second;
+    std::promise<void> hooked;
+    gen->OnCancel([&hooked]() { hooked.set_value(); });
+
+    auto blocked = std::async(std::launch::async, [gen]() {
+        gen->Send(1);
+        return gen->Send(2);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Dropping the iterator is how a consumer usually goes away
+    pair.first.reset();
+    EXPECT_FALSE(blocked.get());
+    EXPECT_EQ(hooked.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_TRUE(gen->Cancelled());
+    EXPECT_FALSE(gen->Send(3));
+
+    bool late = false;
+    gen->OnCancel([&late]() { late = true; });
+    EXPECT_TRUE(late);
+}
+
+TEST(AsyncIteratorTest, SendAsyncParksWithoutThread) {
+    AgentExecutor::Options options;
+    options.core_threads = 1;
+    AgentExecutor executor(options);
+    auto pair = NewAsyncIteratorPair<int>(Bounded(1, true));
+    auto gen = pair.second;
+
+    // Each send chains the next from its completion
+    constexpr int kCount = 50;
+    auto next = std::make_shared<std::function<void(int)>>();
+    *next = [gen, next, &executor](int i) {
+        if (i == kCount) {
+            gen->Close();
+            *next = nullptr;
+            return;
+        }
+        gen->SendAsync(i, [next, i](bool ok) {
+            if (ok) {
+                (*next)(i + 1);
+            }
+        }, executor);
+    };
+    (*next)(0);
+
+    int v;
+    int expected = 0;
+    while (pair.first->Next(v)) {
+        EXPECT_EQ(v, expected++);
+    }
+    EXPECT_EQ(expected, kCount);
+    EXPECT_LE(executor.PeakThreads(), 1u);
+}
+
+TEST(AsyncIteratorTest, ForwardInlineKeepsOrderAcrossSplice) {
+    auto inner = NewAsyncIteratorPair<int>();
+    auto outer = NewAsyncIteratorPair<int>();
+    inner.second->Send(1);
+    inner.second->Send(2);
+    inner.second->Send(3);
+
+    std::atomic<int> done{0};
+    ForwardInline<int>(
+        inner.first, outer.second,
+        [](int& v) {
+            v *= 10;
+            return v != 20;
+        },
+        [&done, gen = outer.second]() {
+            done.fetch_add(1);
+            gen->Close();
+        });
+    inner.first.reset();
+
+    // Later sends skip the inner queue entirely
+    EXPECT_TRUE(inner.second->Send(4));
+    int v = 5;
+    EXPECT_TRUE(inner.second->TrySend(v));
+    inner.second->Close();
+    inner.second->Close();
+    EXPECT_EQ(done.load(), 1);
+
+    std::vector<int> got;
+    while (outer.first->Next(v)) {
+        got.push_back(v);
+    }
+    EXPECT_EQ(got, (std::vector<int>{10, 30, 40, 50}));
+}
+
+TEST(AsyncIteratorTest, SpliceForwardsQueuedValuesOutsideTheLock) {
+    auto inner = NewAsyncIteratorPair<int>();
+    auto outer = NewAsyncIteratorPair<int>();
+    inner.second->Send(1);
+    inner.second->Send(2);
+
+    // The transform sends into the spliced generator itself, which needs
+    // its lock; the value still arrives after the queued ones
+    auto gen = inner.second;
+    ForwardInline<int>(
+        inner.first, outer.second,
+        [gen](int& v) {
+            if (v == 1) {
+                gen->Send(3);
+            }
+            return true;
+        },
+        [out = outer.second]() { out->Close(); });
+    inner.second->Send(4);
+    inner.second->Close();
+
+    std::vector<int> got;
+    int v;
+    while (outer.first->Next(v)) {
+        got.push_back(v);
+    }
+    EXPECT_EQ(got, (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST(AsyncIteratorTest, SpliceKeepsOrderWithConcurrentSender) {
+    constexpr int kValues = 20000;
+    auto inner = NewAsyncIteratorPair<int>();
+    auto outer = NewAsyncIteratorPair<int>();
+
+    std::thread producer([gen = inner.second]() {
+        for (int i = 0; i < kValues; ++i) {
+            gen->Send(i);
+        }
+        gen->Close();
+    });
+    // Let some values queue up before splicing
+    while (!inner.first->HasNext()) {
+        std::this_thread::yield();
+    }
+    ForwardInline<int>(inner.first, outer.second, nullptr,
+                       [out = outer.second]() { out->Close(); });
+
+    std::vector<int> got;
+    int v;
+    while (outer.first->Next(v)) {
+        got.push_back(v);
+    }
+    producer.join();
+    ASSERT_EQ(got.size(), static_cast<size_t>(kValues));
+    for (int i = 0; i < kValues; ++i) {
+        ASSERT_EQ(got[i], i);
+    }
+}
+
+TEST(AsyncIteratorTest, ForwardInlineCollapsesNestedLayers) {
+    AgentExecutor::Options options;
+    options.core_threads = 1;
+    AgentExecutor executor(options);
+    constexpr int kDepth = 8;
+
+    // Splice each layer before the producer starts, as agents do
+    auto source = NewAsyncIteratorPair<int>();
+    auto upstream = source.first;
+    for (int d = 0; d < kDepth; ++d) {
+        auto layer = NewAsyncIteratorPair<int>();
+        auto gen = layer.second;
+        ForwardInline<int>(
+            upstream, gen,
+            [](int& v) {
+                ++v;
+                return true;
+            },
+            [gen]() { gen->Close(); },
+            executor);
+        upstream = layer.first;
+    }
+
+    std::thread producer([gen = source.second]() {
+        for (int i = 0; i < 1000; ++i) {
+            gen->Send(i);
+        }
+        gen->Close();
+    });
+    int v = 0;
+    int count = 0;
+    while (upstream->Next(v)) {
+        EXPECT_EQ(v, count + kDepth);
+        ++count;
+    }
+    producer.join();
+    EXPECT_EQ(count, 1000);
+    // Nothing was pumped: every hop ran inside the producer's Send
+    EXPECT_EQ(executor.PeakThreads(), 0u);
+}
+
+TEST(AsyncIteratorTest, ForwardInlineCancelReachesProducer) {
+    auto inner = NewAsyncIteratorPair<int>();
+    auto middle = NewAsyncIteratorPair<int>();
+    auto outer = NewAsyncIteratorPair<int>();
+    bool inner_cancelled = false;
+    inner.second->OnCancel([&inner_cancelled]() { inner_cancelled = true; });
+    ForwardInline<int>(inner.first, middle.second, nullptr, []() {});
+    ForwardInline<int>(middle.first, outer.second, nullptr, []() {});
+    inner.first.reset();
+    middle.first.reset();
+
+    EXPECT_TRUE(inner.second->Send(1));
+    outer.first.reset();
+    EXPECT_TRUE(inner_cancelled);
+    EXPECT_FALSE(inner.second->Send(2));
+}
+
+TEST(AsyncIteratorTest, ForwardInlineFallsBackForRing) {
+    auto inner = NewAsyncIteratorPair<int>(Bounded(4, true));
+    auto outer = NewAsyncIteratorPair<int>();
+    EXPECT_FALSE(inner.first->Splice(outer.second, nullptr, nullptr));
+    ForwardInline<int>(inner.first, outer.second, nullptr,
+                       [gen = outer.second]() { gen->Close(); });
+
+    std::thread producer([gen = inner.second]() {
+        for (int i = 0; i < 100; ++i) {
+            gen->Send(i);
+        }
+        gen->Close();
+    });
+    int v;
+    int expected = 0;
+    while (outer.first->Next(v)) {
+        EXPECT_EQ(v, expected++);
+    }
+    producer.join();
+    EXPECT_EQ(expected, 100);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/event_transform.h"
+#include "eino/adk/async_iterator.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace eino::adk;
+
+namespace {
+
+using EventPtr = std::shared_ptr<AgentEvent>;
+
+std::vector<std::string> PathOf(const EventPtr& event) {
+    std::vector<std::string> names;
+    for (const auto& step : event->run_path) {
+        names.push_back(step.agent_name);
+    }
+    return names;
+}
+
+} // namespace
+
+TEST(EventTransformTest, StampRunPathCopiesSharedEvents) {
+    auto transform = StampRunPath("child", {RunStep{"root"}, RunStep{"child"}});
+
+    auto kept = std::make_shared<AgentEvent>();
+    EventPtr event = kept;
+    ASSERT_TRUE(transform(event));
+    EXPECT_NE(event, kept);
+    EXPECT_TRUE(kept->run_path.empty());
+    EXPECT_EQ(event->agent_name, "child");
+    EXPECT_EQ(PathOf(event), (std::vector<std::string>{"root", "child"}));
+
+    // Already stamped further in: left alone
+    EventPtr nested = std::make_shared<AgentEvent>();
+    nested->agent_name = "grandchild";
+    nested->run_path = {RunStep{"grandchild"}};
+    AgentEvent* before = nested.get();
+    ASSERT_TRUE(transform(nested));
+    EXPECT_EQ(nested.get(), before);
+    EXPECT_EQ(PathOf(nested), (std::vector<std::string>{"grandchild"}));
+}
+
+TEST(EventTransformTest, ChainStopsAtFirstDrop) {
+    int observed = 0;
+    auto transform = ChainTransforms({
+        PrefixRunPath({RunStep{"outer"}}),
+        FilterEvents([](const AgentEvent& event) { return event.error_msg.empty(); }),
+        ObserveEvents([&observed](const EventPtr&) { ++observed; }),
+    });
+
+    EventPtr ok = std::make_shared<AgentEvent>();
+    ok->run_path = {RunStep{"inner"}};
+    AgentEvent* before = ok.get();
+    EXPECT_TRUE(transform(ok));
+    EXPECT_EQ(ok.get(), before);
+    EXPECT_EQ(PathOf(ok), (std::vector<std::string>{"outer", "inner"}));
+
+    EventPtr failed = std::make_shared<AgentEvent>();
+    failed->error_msg = "boom";
+    EXPECT_FALSE(transform(failed));
+    EventPtr none;
+    EXPECT_FALSE(transform(none));
+    EXPECT_EQ(observed, 1);
+}
+
+TEST(EventTransformTest, NestedLayersWriteIntoOuterQueue) {
+    // inner agent -> flow layer (stamps) -> runner layer (records)
+    auto agent = NewAsyncIteratorPair<EventPtr>();
+    auto flow = NewAsyncIteratorPair<EventPtr>();
+    auto runner = NewAsyncIteratorPair<EventPtr>();
+    ForwardInline<EventPtr>(agent.first, flow.second,
+                            StampRunPath("agent", {RunStep{"flow"}, RunStep{"agent"}}),
+                            [gen = flow.second]() { gen->Close(); });
+    std::vector<EventPtr> recorded;
+    ForwardInline<EventPtr>(flow.first, runner.second,
+                            ObserveEvents([&recorded](const EventPtr& e) { recorded.push_back(e); }),
+                            [gen = runner.second]() { gen->Close(); });
+
+    agent.second->Send(std::make_shared<AgentEvent>());
+    agent.second->Send(std::make_shared<AgentEvent>());
+    agent.second->Close();
+
+    EventPtr event;
+    int count = 0;
+    while (runner.first->Next(event)) {
+        EXPECT_EQ(event->agent_name, "agent");
+        EXPECT_EQ(PathOf(event), (std::vector<std::string>{"flow", "agent"}));
+        ++count;
+    }
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(recorded.size(), 2u);
+}
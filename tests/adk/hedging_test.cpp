@@ -0,0 +1,167 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/hedging.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace eino;
+using namespace eino::adk;
+
+namespace {
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// SleepUnlessCancelled sleeps for ms, returning early once the call has
+// its answer; true if it was cancelled
+bool SleepUnlessCancelled(const HedgeAttempt& attempt, int ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (attempt.Cancelled()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(HedgingTest, DuplicateAnswersASlowCall) {
+    HedgePolicy policy;
+    policy.initial_delay = std::chrono::milliseconds(20);
+    auto hedger = std::make_shared<Hedger>(policy);
+    auto loser_cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    auto start = std::chrono::steady_clock::now();
+    std::string got = hedger->Run<std::string>([loser_cancelled](const HedgeAttempt& a) {
+        if (a.Index() == 0) {
+            loser_cancelled->store(SleepUnlessCancelled(a, 2000));
+            return std::string("slow");
+        }
+        return std::string("fast");
+    });
+    EXPECT_EQ(got, "fast");
+    EXPECT_LT(ElapsedMs(start), 1000);
+    // The slow attempt learned it lost and gave up
+    EXPECT_TRUE(loser_cancelled->load());
+    HedgeStats stats = hedger->Stats();
+    EXPECT_EQ(stats.calls, 1u);
+    EXPECT_EQ(stats.hedges, 1u);
+    EXPECT_EQ(stats.hedge_wins, 1u);
+}
+
+TEST(HedgingTest, FirstAttemptRunsInlineAndRunWaitsForEveryAttempt) {
+    HedgePolicy policy;
+    policy.initial_delay = std::chrono::milliseconds(10);
+    auto hedger = std::make_shared<Hedger>(policy);
+    std::thread::id first_thread;
+    std::atomic<int> ended(0);
+
+    // The duplicate answers first but the slow attempt still ends before Run
+    int got = hedger->Run<int>([&](const HedgeAttempt& a) {
+        if (a.Index() == 0) {
+            first_thread = std::this_thread::get_id();
+            std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        }
+        ended.fetch_add(1);
+        return a.Index();
+    });
+    EXPECT_EQ(got, 1);
+    EXPECT_EQ(first_thread, std::this_thread::get_id());
+    EXPECT_EQ(ended.load(), 2);
+    EXPECT_EQ(hedger->Stats().hedge_wins, 1u);
+}
+
+TEST(HedgingTest, DelayFollowsObservedLatency) {
+    HedgePolicy policy;
+    policy.min_samples = 10;
+    policy.percentile = 90;
+    auto hedger = std::make_shared<Hedger>(policy);
+    EXPECT_EQ(hedger->Delay(), std::chrono::milliseconds(1000));
+
+    for (int i = 0; i < 20; ++i) {
+        int got = hedger->Run<int>([i](const HedgeAttempt&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return i;
+        });
+        EXPECT_EQ(got, i);
+    }
+    EXPECT_GE(hedger->Delay(), std::chrono::milliseconds(2));
+    EXPECT_LT(hedger->Delay(), std::chrono::milliseconds(500));
+    EXPECT_EQ(hedger->Stats().calls, 20u);
+}
+
+TEST(HedgingTest, BudgetCapsDuplicates) {
+    HedgePolicy policy;
+    policy.initial_delay = std::chrono::milliseconds(5);
+    policy.max_hedge_ratio = 0;
+    policy.budget_burst = 1;
+    auto hedger = std::make_shared<Hedger>(policy);
+    for (int i = 0; i < 3; ++i) {
+        hedger->Run<int>([](const HedgeAttempt& a) {
+            SleepUnlessCancelled(a, 30);
+            return a.Index();
+        });
+    }
+    HedgeStats stats = hedger->Stats();
+    EXPECT_EQ(stats.calls, 3u);
+    EXPECT_EQ(stats.hedges, 1u);
+    EXPECT_EQ(stats.budget_denied, 2u);
+}
+
+TEST(HedgingTest, FailsOnlyWhenEveryAttemptFails) {
+    HedgePolicy policy;
+    policy.initial_delay = std::chrono::milliseconds(10);
+    auto hedger = std::make_shared<Hedger>(policy);
+
+    // A quick failure is not hedged; retrying is the caller's business
+    EXPECT_THROW(hedger->Run<int>([](const HedgeAttempt&) -> int {
+                     throw std::runtime_error("boom");
+                 }),
+                 std::runtime_error);
+    EXPECT_EQ(hedger->Stats().hedges, 0u);
+
+    // A duplicate still answers after the first attempt fails
+    int got = hedger->Run<int>([](const HedgeAttempt& a) -> int {
+        if (a.Index() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            throw std::runtime_error("timeout");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        return 7;
+    });
+    EXPECT_EQ(got, 7);
+
+    try {
+        hedger->Run<int>([](const HedgeAttempt& a) -> int {
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            throw std::runtime_error("failed " + std::to_string(a.Index()));
+        });
+        FAIL() << "expected an error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()), "failed 0");
+    }
+    EXPECT_EQ(hedger->Stats().hedges, 2u);
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/model_rate_limiter.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eino;
+using namespace eino::adk;
+
+namespace {
+
+// Flaky fails its first `failures` calls with an HTTP status
+std::function<void(ModelRateLimiter::Permit&)> Flaky(int* calls, int failures, int status) {
+    return [calls, failures, status](ModelRateLimiter::Permit& permit) {
+        if ((*calls)++ < failures) {
+            throw ModelCallError(status, "HTTP " + std::to_string(status));
+        }
+        permit.Release(ModelCallOutcome::kSucceeded, 42);
+    };
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+} // namespace
+
+TEST(ModelRateLimiterTest, InteractiveCallsGoFirst) {
+    ModelRateLimits limits;
+    limits.max_concurrency = 1;
+    ModelRateLimiter limiter(limits);
+    auto held = limiter.Acquire(SessionLane::kBatch, 0);
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto call = [&](SessionLane lane, const std::string& name) {
+        auto permit = limiter.Acquire(lane, 0);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(name);
+        }
+        permit.Release(ModelCallOutcome::kSucceeded);
+    };
+    std::thread batch(call, SessionLane::kBatch, "batch");
+    while (limiter.Stats().queued_batch < 1) {
+        std::this_thread::yield();
+    }
+    std::thread interactive(call, SessionLane::kInteractive, "interactive");
+    while (limiter.Stats().queued_interactive < 1) {
+        std::this_thread::yield();
+    }
+
+    held.Release(ModelCallOutcome::kSucceeded);
+    batch.join();
+    interactive.join();
+    EXPECT_EQ(order, (std::vector<std::string>{"interactive", "batch"}));
+    EXPECT_EQ(limiter.Stats().admitted, 3u);
+}
+
+TEST(ModelRateLimiterTest, BucketsPaceCalls) {
+    // A burst of 5 requests, then 100/s
+    ModelRateLimits limits;
+    limits.requests_per_second = 100;
+    limits.burst_seconds = 0.05;
+    ModelRateLimiter requests(limits);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 15; ++i) {
+        requests.Acquire(SessionLane::kInteractive, 0).Release(ModelCallOutcome::kSucceeded);
+    }
+    EXPECT_GE(ElapsedMs(start), 80);
+
+    // Usage beyond the estimate is paid back before the next call
+    limits = ModelRateLimits();
+    limits.tokens_per_second = 10000;
+    limits.burst_seconds = 0.01;
+    ModelRateLimiter tokens(limits);
+    tokens.Acquire(SessionLane::kInteractive, 50).Release(ModelCallOutcome::kSucceeded, 150);
+    start = std::chrono::steady_clock::now();
+    tokens.Acquire(SessionLane::kInteractive, 10).Release(ModelCallOutcome::kSucceeded);
+    EXPECT_GE(ElapsedMs(start), 4);
+}
+
+TEST(ModelRateLimiterTest, ConcurrencyAdaptsToRateLimits) {
+    ModelRateLimits limits;
+    limits.max_concurrency = 8;
+    ModelRateLimiter limiter(limits);
+
+    // Four refusals from calls already in flight cut the limit once
+    std::vector<ModelRateLimiter::Permit> permits;
+    for (int i = 0; i < 4; ++i) {
+        permits.push_back(limiter.Acquire(SessionLane::kInteractive, 0));
+    }
+    for (auto& permit : permits) {
+        permit.Release(ModelCallOutcome::kRateLimited);
+    }
+    EXPECT_EQ(limiter.Stats().concurrency_limit, 4u);
+    EXPECT_EQ(limiter.Stats().rate_limited, 4u);
+
+    // About a window of successes adds one
+    for (int i = 0; i < 5; ++i) {
+        limiter.Acquire(SessionLane::kInteractive, 0).Release(ModelCallOutcome::kSucceeded);
+    }
+    EXPECT_EQ(limiter.Stats().concurrency_limit, 5u);
+
+    limiter.Acquire(SessionLane::kInteractive, 0).Release(ModelCallOutcome::kRateLimited);
+    EXPECT_EQ(limiter.Stats().concurrency_limit, 2u);
+    EXPECT_EQ(limiter.Stats().in_flight, 0u);
+}
+
+TEST(ModelRateLimiterTest, RetriesThroughTheLimiter) {
+    ModelCallConfig config;
+    config.limiter = ModelRateLimiter::Shared("test/retry", ModelRateLimits());
+    EXPECT_EQ(ModelRateLimiter::Shared("test/retry", ModelRateLimits()), config.limiter);
+    config.retry.max_retries = 3;
+    config.retry.backoff_func = [](int) { return std::chrono::milliseconds(1); };
+
+    int calls = 0;
+    CallWithLimits(config, 10, Flaky(&calls, 2, 429));
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(config.limiter->Stats().rate_limited, 2u);
+    EXPECT_EQ(config.limiter->Stats().admitted, 3u);
+    EXPECT_EQ(config.limiter->Stats().in_flight, 0u);
+
+    calls = 0;
+    config.retry.max_retries = 1;
+    EXPECT_THROW(CallWithLimits(config, 10, Flaky(&calls, 5, 429)),
+                 RetryExhaustedError);
+    EXPECT_EQ(calls, 2);
+
+    // Without retries the call's own error comes through
+    calls = 0;
+    config.retry.max_retries = 0;
+    EXPECT_THROW(CallWithLimits(config, 10, Flaky(&calls, 1, 400)),
+                 std::runtime_error);
+    EXPECT_EQ(config.limiter->Stats().rate_limited, 4u);
+    EXPECT_EQ(config.limiter->Stats().in_flight, 0u);
+
+    // A permit moved out of the call stays in flight until released
+    ModelRateLimiter::Permit kept;
+    CallWithLimits(config, 10, [&kept](ModelRateLimiter::Permit& permit) {
+        kept = std::move(permit);
+    });
+    EXPECT_EQ(config.limiter->Stats().in_flight, 1u);
+    kept.Release(ModelCallOutcome::kSucceeded);
+    EXPECT_EQ(config.limiter->Stats().in_flight, 0u);
+}
+
+TEST(ModelRateLimiterTest, CancelledCallStopsRetrying) {
+    ModelCallConfig config;
+    config.limiter = ModelRateLimiter::Shared("test/cancel", ModelRateLimits());
+    config.retry.max_retries = 5;
+    config.retry.backoff_func = [](int) { return std::chrono::milliseconds(1); };
+
+    // Cancelled before the first permit: the call never runs
+    int calls = 0;
+    EXPECT_THROW(CallWithLimits(config, 10, Flaky(&calls, 0, 429), [] { return true; }),
+                 std::runtime_error);
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(config.limiter->Stats().admitted, 0u);
+
+    // Cancelled after a failure: its error comes through, no retry
+    bool cancelled = false;
+    auto flaky = Flaky(&calls, 5, 429);
+    EXPECT_THROW(CallWithLimits(
+                     config, 10,
+                     [&](ModelRateLimiter::Permit& permit) {
+                         cancelled = true;
+                         flaky(permit);
+                     },
+                     [&cancelled] { return cancelled; }),
+                 std::runtime_error);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(config.limiter->Stats().admitted, 1u);
+    EXPECT_EQ(config.limiter->Stats().in_flight, 0u);
+}
+
+TEST(ModelRateLimiterTest, EstimatesAndClassifies) {
+    std::vector<schema::Message> messages = {schema::UserMessage("12345678"),
+                                             schema::AssistantMessage("1")};
+    std::vector<schema::Message*> msgs = {&messages[0], &messages[1]};
+    auto tool = std::make_shared<schema::ToolInfo>();
+    tool->name = "search";
+    tool->description = "find";
+    EXPECT_EQ(EstimateTokens(msgs, {}).first, 4 + 2 + 4 + 1);
+    EXPECT_EQ(EstimateTokens(msgs, {tool}).first, 4 + 2 + 4 + 1 + 4 + 3);
+
+    // A configured counter wins unless it fails
+    ModelCallConfig config;
+    EXPECT_EQ(CountTokens(config, messages), 11);
+    config.token_counter = [](const std::vector<schema::Message*>& counted,
+                              const std::vector<std::shared_ptr<schema::ToolInfo>>&) {
+        return std::make_pair(static_cast<int64_t>(counted.size() * 100), std::string());
+    };
+    EXPECT_EQ(CountTokens(config, messages), 200);
+    config.token_counter = [](const std::vector<schema::Message*>&,
+                              const std::vector<std::shared_ptr<schema::ToolInfo>>&) {
+        return std::make_pair(int64_t(0), std::string("no tokenizer"));
+    };
+    EXPECT_EQ(CountTokens(config, messages), 11);
+
+    EXPECT_TRUE(IsRateLimitError(ModelCallError(429, "Too Many Requests")));
+    EXPECT_FALSE(IsRateLimitError(ModelCallError(500, "upstream 429 timeout")));
+    EXPECT_FALSE(IsRateLimitError(std::runtime_error("HTTP 429")));
+    EXPECT_FALSE(IsRateLimitError(std::runtime_error("rate limit reached")));
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/prebuilt/plan_steps.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eino;
+using namespace eino::adk;
+using namespace eino::adk::prebuilt;
+
+namespace {
+
+using EventPtr = std::shared_ptr<AgentEvent>;
+
+EventPtr Reply(const std::string& content) {
+    auto msg = std::make_shared<schema::Message>(schema::AssistantMessage(content));
+    auto event = std::make_shared<AgentEvent>();
+    event->output = std::make_shared<AgentOutput>();
+    event->output->message_output = std::make_shared<MessageVariant>();
+    event->output->message_output->message = msg.get();
+    // The event keeps its message alive
+    event->output->customized_output = msg;
+    return event;
+}
+
+// FakeSteps answers each step from its own thread after a delay, and
+// tracks how many steps run at once
+class FakeSteps {
+public:
+    StepRunner Runner() {
+        return [this](size_t /*index*/, const PlanStep& step, const std::vector<ExecutedStep>& deps) {
+            int now = running_.fetch_add(1) + 1;
+            int seen = peak_.load();
+            while (now > seen && !peak_.compare_exchange_weak(seen, now)) {
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                seen_deps_.push_back(deps);
+            }
+            auto pair = NewAsyncIteratorPair<EventPtr>();
+            auto delay = std::chrono::milliseconds(delay_ms_ * static_cast<int>(step.step.size()));
+            std::thread([this, gen = pair.second, step, delay]() {
+                std::this_thread::sleep_for(delay);
+                running_.fetch_sub(1);
+                if (step.step.rfind("fail", 0) == 0) {
+                    auto event = std::make_shared<AgentEvent>();
+                    event->error_msg = "failed " + step.step;
+                    gen->Send(event);
+                } else {
+                    gen->Send(Reply("done " + step.step));
+                }
+                gen->Close();
+            }).detach();
+            return pair.first;
+        };
+    }
+
+    int delay_ms_ = 20;
+    std::atomic<int> running_{0};
+    std::atomic<int> peak_{0};
+    std::mutex mutex_;
+    std::vector<std::vector<ExecutedStep>> seen_deps_;
+};
+
+PlanStepsResult RunAll(std::vector<PlanStep> steps, StepRunner runner, size_t max_parallel,
+                       std::vector<std::string>* errors = nullptr) {
+    auto pair = NewAsyncIteratorPair<EventPtr>();
+    std::promise<PlanStepsResult> done;
+    auto gen = pair.second;
+    RunPlanSteps(std::move(steps), std::move(runner), max_parallel, gen,
+                 [&done, gen](PlanStepsResult result) {
+                     gen->Close();
+                     done.set_value(std::move(result));
+                 });
+    EventPtr event;
+    while (pair.first->Next(event)) {
+        if (errors && !event->error_msg.empty()) {
+            errors->push_back(event->error_msg);
+        }
+    }
+    return done.get_future().get();
+}
+
+std::vector<std::string> Results(const std::vector<ExecutedStep>& executed) {
+    std::vector<std::string> results;
+    for (const auto& step : executed) {
+        results.push_back(step.result);
+    }
+    return results;
+}
+
+} // namespace
+
+TEST(PlanStepsTest, JSONKeepsChainsAsStrings) {
+    std::vector<PlanStep> steps;
+    ASSERT_TRUE(PlanStepsFromJSON(R"({"steps": ["a", "b", "c"]})", &steps));
+    ASSERT_EQ(steps.size(), 3u);
+    EXPECT_TRUE(steps[0].depends_on.empty());
+    EXPECT_EQ(steps[2].depends_on, (std::vector<size_t>{1}));
+    EXPECT_EQ(PlanStepsToJSON(steps), R"({"steps":["a","b","c"]})");
+
+    const std::string wide =
+        R"({"steps":["a",{"step":"b","depends_on":[]},{"step":"c","depends_on":[0,1]}]})";
+    ASSERT_TRUE(PlanStepsFromJSON(wide, &steps));
+    EXPECT_TRUE(steps[1].depends_on.empty());
+    EXPECT_EQ(steps[2].depends_on, (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(PlanStepsToJSON(steps), wide);
+
+    // A step may only wait for steps before it
+    EXPECT_FALSE(PlanStepsFromJSON(R"({"steps":[{"step":"a","depends_on":[1]},"b"]})", &steps));
+    EXPECT_FALSE(PlanStepsFromJSON(R"({"steps":[{"depends_on":[]}]})", &steps));
+    EXPECT_FALSE(PlanStepsFromJSON(R"({"steps":[]})", &steps));
+    EXPECT_FALSE(PlanStepsFromJSON("not json", &steps));
+    EXPECT_EQ(steps.size(), 3u);
+}
+
+TEST(PlanStepsTest, FindsIndependentSteps) {
+    std::vector<PlanStep> steps;
+    ASSERT_TRUE(PlanStepsFromJSON(R"({"steps": ["a", "b", "c"]})", &steps));
+    EXPECT_FALSE(HasIndependentSteps(steps));
+
+    // Extra edges to steps already waited for keep it a chain
+    ASSERT_TRUE(PlanStepsFromJSON(R"({"steps":["a","b",{"step":"c","depends_on":[0,1]}]})",
+                                  &steps));
+    EXPECT_FALSE(HasIndependentSteps(steps));
+
+    ASSERT_TRUE(PlanStepsFromJSON(R"({"steps":["a",{"step":"b","depends_on":[]},"c"]})", &steps));
+    EXPECT_TRUE(HasIndependentSteps(steps));
+    ASSERT_TRUE(PlanStepsFromJSON(R"({"steps":["a","b",{"step":"c","depends_on":[0]}]})",
+                                  &steps));
+    EXPECT_TRUE(HasIndependentSteps(steps));
+}
+
+TEST(PlanStepsTest, RunsIndependentStepsTogether) {
+    FakeSteps fake;
+    // Longer names take longer, so the fan-out finishes in reverse order
+    std::vector<PlanStep> steps = {
+        {"aaaa", {}}, {"bbb", {}}, {"cc", {}}, {"d", {}}, {"join", {3, 0, 2, 1}}};
+    auto result = RunAll(steps, fake.Runner(), 4);
+
+    EXPECT_TRUE(result.error.empty());
+    EXPECT_EQ(fake.peak_.load(), 4);
+    EXPECT_EQ(Results(result.executed), (std::vector<std::string>{
+                                            "done aaaa", "done bbb", "done cc", "done d",
+                                            "done join"}));
+    // The join sees its dependencies in plan order
+    ASSERT_EQ(fake.seen_deps_.size(), 5u);
+    EXPECT_EQ(Results(fake.seen_deps_.back()), (std::vector<std::string>{
+                                                   "done aaaa", "done bbb", "done cc",
+                                                   "done d"}));
+}
+
+TEST(PlanStepsTest, KeepsToParallelLimit) {
+    FakeSteps fake;
+    fake.delay_ms_ = 1;
+    std::vector<PlanStep> steps;
+    for (int i = 0; i < 12; ++i) {
+        steps.push_back({"step" + std::to_string(i), {}});
+    }
+    // A chain still runs one step at a time
+    steps.push_back({"tail0", {11}});
+    steps.push_back({"tail1", {12}});
+    auto result = RunAll(steps, fake.Runner(), 3);
+
+    EXPECT_TRUE(result.error.empty());
+    EXPECT_LE(fake.peak_.load(), 3);
+    ASSERT_EQ(result.executed.size(), 14u);
+    EXPECT_EQ(result.executed[13].step, "tail1");
+    EXPECT_EQ(Results(fake.seen_deps_.back()), (std::vector<std::string>{"done tail0"}));
+}
+
+TEST(PlanStepsTest, StopsStartingAfterError) {
+    FakeSteps fake;
+    std::vector<PlanStep> steps = {{"a", {}}, {"fail", {0}}, {"after", {1}}, {"other", {0}}};
+    std::vector<std::string> errors;
+    auto result = RunAll(steps, fake.Runner(), 1, &errors);
+
+    EXPECT_EQ(result.error, "failed fail");
+    EXPECT_EQ(errors, (std::vector<std::string>{"failed fail"}));
+    EXPECT_EQ(Results(result.executed), (std::vector<std::string>{"done a"}));
+    EXPECT_EQ(fake.seen_deps_.size(), 2u);
+
+    // A dependency on a later step is refused before anything runs
+    errors.clear();
+    result = RunAll({{"a", {1}}, {"b", {}}}, fake.Runner(), 2, &errors);
+    EXPECT_FALSE(result.error.empty());
+    EXPECT_EQ(errors.size(), 1u);
+    EXPECT_TRUE(result.executed.empty());
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/middlewares/presummarizer.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eino;
+using namespace eino::adk;
+using namespace eino::adk::middlewares::summarization;
+
+namespace {
+
+using Messages = std::vector<schema::Message>;
+
+void Append(Messages* history, int n) {
+    for (int i = 0; i < n; ++i) {
+        history->emplace_back(schema::RoleType::kUser,
+                              "message " + std::to_string(history->size()));
+    }
+}
+
+// Summarizer stands in for the summary model call
+struct Summarizer {
+    std::shared_ptr<std::atomic<int>> calls = std::make_shared<std::atomic<int>>(0);
+    int delay_ms = 0;
+    bool fail = false;
+
+    SummarizeFunc Func() const {
+        auto calls = this->calls;
+        int delay = delay_ms;
+        bool fail = this->fail;
+        return [calls, delay, fail](const Messages& prefix) {
+            calls->fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+            if (fail) {
+                throw std::runtime_error("summary model unavailable");
+            }
+            return Messages{schema::Message(schema::RoleType::kUser,
+                                            "summary of " + std::to_string(prefix.size()))};
+        };
+    }
+};
+
+PreSummarizerConfig Watermarks() {
+    PreSummarizerConfig config;
+    config.prepare_messages = 6;
+    config.trigger_messages = 10;
+    return config;
+}
+
+} // namespace
+
+TEST(PreSummarizerTest, SwapsPreparedSummaryAndKeepsTheDelta) {
+    Summarizer model;
+    PreSummarizer summarizer(Watermarks(), model.Func());
+    Messages history;
+    Append(&history, 5);
+    EXPECT_EQ(summarizer.Update(history, 0).size(), 5u);
+    EXPECT_FALSE(summarizer.Pending());
+
+    Append(&history, 1);
+    EXPECT_EQ(summarizer.Update(history, 0).size(), 6u);
+    EXPECT_TRUE(summarizer.Pending());
+
+    Append(&history, 4);
+    Messages sent = summarizer.Update(history, 0);
+    ASSERT_EQ(sent.size(), 5u);
+    EXPECT_EQ(sent[0].content, "summary of 6");
+    EXPECT_EQ(sent[1].content, "message 6");
+    EXPECT_EQ(sent[4].content, "message 9");
+    EXPECT_EQ(model.calls->load(), 1);
+    EXPECT_FALSE(summarizer.Pending());
+
+    PreSummarizerStats stats = summarizer.Stats();
+    EXPECT_EQ(stats.prepared, 1u);
+    EXPECT_EQ(stats.swapped, 1u);
+    EXPECT_EQ(stats.synchronous, 0u);
+}
+
+TEST(PreSummarizerTest, TurnsBeforeTheTriggerDoNotWait) {
+    Summarizer model;
+    model.delay_ms = 200;
+    PreSummarizer summarizer(Watermarks(), model.Func());
+    Messages history;
+    Append(&history, 6);
+
+    auto start = std::chrono::steady_clock::now();
+    summarizer.Update(history, 0);
+    Append(&history, 1);
+    summarizer.Update(history, 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(150));
+
+    // Hitting the trigger early waits for the running summary
+    Append(&history, 3);
+    Messages sent = summarizer.Update(history, 0);
+    EXPECT_EQ(sent[0].content, "summary of 6");
+    EXPECT_EQ(model.calls->load(), 1);
+    EXPECT_EQ(summarizer.Stats().waited, 1u);
+}
+
+TEST(PreSummarizerTest, RewrittenHistoryIsSummarizedAgain) {
+    Summarizer model;
+    PreSummarizer summarizer(Watermarks(), model.Func());
+    Messages history;
+    Append(&history, 6);
+    summarizer.Update(history, 0);
+
+    history[2].content = "trimmed";
+    Append(&history, 4);
+    Messages sent = summarizer.Update(history, 0);
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0].content, "summary of 10");
+    PreSummarizerStats stats = summarizer.Stats();
+    EXPECT_EQ(stats.discarded, 1u);
+    EXPECT_EQ(stats.synchronous, 1u);
+}
+
+TEST(PreSummarizerTest, HistoryDifferingOnlyInPartsIsSummarizedAgain) {
+    // The part owns its url
+    auto image_part = [](const std::string& url) {
+        schema::MessageInputPart part;
+        part.type = schema::ChatMessagePartType::kImageURL;
+        part.image = std::make_shared<schema::MessageInputImage>();
+        part.image->common.url = new std::string(url);
+        return part;
+    };
+
+    Summarizer model;
+    PreSummarizer summarizer(Watermarks(), model.Func());
+    Messages history;
+    Append(&history, 6);
+    history[2].user_input_multi_content = {image_part("https://example.com/a.png")};
+    summarizer.Update(history, 0);
+
+    // Same text everywhere; only the image differs from the snapshot
+    history[2].user_input_multi_content = {image_part("https://example.com/b.png")};
+    Append(&history, 4);
+    Messages sent = summarizer.Update(history, 0);
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0].content, "summary of 10");
+    PreSummarizerStats stats = summarizer.Stats();
+    EXPECT_EQ(stats.swapped, 0u);
+    EXPECT_EQ(stats.discarded, 1u);
+    EXPECT_EQ(stats.synchronous, 1u);
+}
+
+TEST(PreSummarizerTest, TokenWatermarksAndFailures) {
+    Summarizer model;
+    model.fail = true;
+    PreSummarizerConfig config;
+    config.prepare_tokens = 100;
+    config.trigger_tokens = 200;
+    PreSummarizer summarizer(config, model.Func());
+    Messages history;
+    Append(&history, 3);
+    summarizer.Update(history, 150);
+    EXPECT_TRUE(summarizer.Pending());
+
+    // The background summary failed, so the trigger tries again and the
+    // error reaches the caller
+    EXPECT_THROW(summarizer.Update(history, 250), std::runtime_error);
+    EXPECT_EQ(model.calls->load(), 2);
+    EXPECT_EQ(summarizer.Stats().discarded, 1u);
+}
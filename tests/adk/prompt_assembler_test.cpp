@@ -0,0 +1,144 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/prompt_assembler.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace eino;
+using namespace eino::adk;
+
+namespace {
+
+schema::ToolInfo Tool(const std::string& name) {
+    schema::ToolInfo info;
+    info.name = name;
+    info.description = "the " + name + " tool";
+    return info;
+}
+
+std::vector<schema::Message> History(int turns) {
+    std::vector<schema::Message> history;
+    history.emplace_back(schema::RoleType::kSystem, "You are a helpful assistant.");
+    for (int i = 0; i < turns; ++i) {
+        history.emplace_back(schema::RoleType::kUser, "question " + std::to_string(i));
+        history.emplace_back(schema::RoleType::kAssistant, "answer " + std::to_string(i));
+    }
+    return history;
+}
+
+} // namespace
+
+TEST(PromptAssemblerTest, AppendedTurnsReuseThePrefix) {
+    PromptAssembler assembler;
+    int rewrites = 0;
+    assembler.AddRewriteListener([&rewrites](const PrefixRewrite&) { ++rewrites; });
+    std::vector<schema::ToolInfo> tools = {Tool("search")};
+
+    AssembledPrompt first = assembler.Assemble(tools, History(1));
+    EXPECT_EQ(first.reused_bytes, 0u);
+    for (int turn = 2; turn <= 4; ++turn) {
+        AssembledPrompt prompt = assembler.Assemble(tools, History(turn));
+        EXPECT_GT(prompt.ReuseRatio(), 0.5);
+        EXPECT_LT(prompt.reused_bytes, prompt.bytes);
+    }
+    EXPECT_EQ(rewrites, 0);
+
+    // The same prompt again is reused whole
+    AssembledPrompt again = assembler.Assemble(tools, History(4));
+    EXPECT_EQ(again.reused_bytes, again.bytes);
+    PromptPrefixStats stats = assembler.Stats();
+    EXPECT_EQ(stats.turns, 5u);
+    EXPECT_EQ(stats.rewrites, 0u);
+}
+
+TEST(PromptAssemblerTest, CanonicalFormIgnoresToolOrderAndResponseMeta) {
+    PromptAssembler assembler;
+    std::vector<schema::Message> history = History(1);
+    assembler.Assemble({Tool("search"), Tool("fetch")}, history);
+
+    // Usage reported on a reply is not part of what is sent next
+    history[2].response_meta = std::make_shared<schema::ResponseMeta>();
+    history[2].response_meta->finish_reason = "stop";
+    int index = 0;
+    schema::ToolCall call;
+    call.index = &index;
+    call.id = "call_1";
+    call.function.name = "search";
+    history.emplace_back(schema::RoleType::kAssistant, "", std::vector<schema::ToolCall>{call});
+
+    AssembledPrompt prompt = assembler.Assemble({Tool("fetch"), Tool("search")}, history);
+    ASSERT_EQ(prompt.tools.size(), 2u);
+    EXPECT_EQ(prompt.tools[0].name, "fetch");
+    EXPECT_EQ(prompt.messages[2].response_meta, nullptr);
+    EXPECT_EQ(prompt.messages[3].tool_calls[0].index, nullptr);
+    EXPECT_EQ(assembler.Stats().rewrites, 0u);
+}
+
+TEST(PromptAssemblerTest, ReportsRewrites) {
+    PromptAssembler assembler;
+    std::vector<PrefixRewrite> seen;
+    assembler.AddRewriteListener([&seen](const PrefixRewrite& r) { seen.push_back(r); });
+    std::vector<schema::ToolInfo> tools = {Tool("search")};
+    AssembledPrompt before = assembler.Assemble(tools, History(3));
+
+    // A summary replacing the first exchanges changes message 1 onwards
+    std::vector<schema::Message> summarized = History(0);
+    summarized.emplace_back(schema::RoleType::kUser, "summary of earlier turns");
+    summarized.emplace_back(schema::RoleType::kUser, "question 3");
+
+    PrefixRewrite predicted;
+    EXPECT_TRUE(assembler.Check(summarized, &predicted));
+    EXPECT_EQ(predicted.first_changed_message, 1u);
+    EXPECT_TRUE(seen.empty());
+
+    AssembledPrompt after = assembler.Assemble(tools, summarized);
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0].turn, 2u);
+    EXPECT_FALSE(seen[0].tools_changed);
+    EXPECT_EQ(seen[0].first_changed_message, 1u);
+    EXPECT_EQ(seen[0].lost_bytes, predicted.lost_bytes);
+    EXPECT_EQ(seen[0].lost_bytes, before.bytes - after.reused_bytes);
+
+    // Binding another tool invalidates everything after the tool list
+    assembler.Assemble({Tool("search"), Tool("zoom")}, summarized);
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_TRUE(seen[1].tools_changed);
+    EXPECT_EQ(assembler.Stats().rewrites, 2u);
+}
+
+TEST(PromptAssemblerTest, ChecksMiddlewareState) {
+    PromptAssembler assembler;
+    std::vector<schema::Message> history = History(2);
+    assembler.Assemble({}, history);
+
+    // Middlewares hold the state's messages by pointer
+    std::vector<schema::Message*> state;
+    for (auto& msg : history) {
+        state.push_back(&msg);
+    }
+    schema::Message next(schema::RoleType::kUser, "question 2");
+    state.push_back(&next);
+    PrefixRewrite rewrite;
+    EXPECT_FALSE(assembler.Check(state, &rewrite));
+
+    state.erase(state.begin() + 1, state.begin() + 3);
+    EXPECT_TRUE(assembler.Check(state, &rewrite));
+    EXPECT_EQ(rewrite.first_changed_message, 1u);
+    EXPECT_EQ(assembler.Stats().turns, 1u);
+}
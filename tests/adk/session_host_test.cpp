@@ -0,0 +1,237 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/session_host.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eino::adk;
+
+namespace {
+
+using EventPtr = std::shared_ptr<AgentEvent>;
+
+// FakeSessions stands in for a runner: every session names itself in
+// agent_name and either replies at once or waits for Release
+class FakeSessions {
+public:
+    SessionHost::Starter Starter() {
+        return [this](const SessionRequest& request) {
+            auto pair = NewAsyncIteratorPair<EventPtr>();
+            auto event = std::make_shared<AgentEvent>();
+            event->agent_name = request.tenant;
+            std::lock_guard<std::mutex> lock(mutex_);
+            started_.push_back(request.tenant);
+            pair.second->Send(event);
+            if (hold_) {
+                held_.push_back(pair.second);
+            } else {
+                pair.second->Close();
+            }
+            return pair.first;
+        };
+    }
+
+    void Hold(bool hold) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hold_ = hold;
+    }
+
+    // Release closes the sessions held so far
+    void Release() {
+        std::vector<std::shared_ptr<AsyncGenerator<EventPtr>>> held;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held.swap(held_);
+        }
+        for (auto& gen : held) {
+            gen->Close();
+        }
+    }
+
+    std::vector<std::string> Started() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return started_;
+    }
+
+private:
+    std::mutex mutex_;
+    bool hold_ = false;
+    std::vector<std::string> started_;
+    std::vector<std::shared_ptr<AsyncGenerator<EventPtr>>> held_;
+};
+
+SessionRequest Request(const std::string& tenant, SessionLane lane = SessionLane::kInteractive) {
+    SessionRequest request;
+    request.tenant = tenant;
+    request.lane = lane;
+    return request;
+}
+
+// Drain reads every event of each session and returns the error messages
+std::vector<std::string> Drain(std::vector<SessionHost::EventIterator>& sessions) {
+    std::vector<std::string> errors;
+    for (auto& iter : sessions) {
+        EventPtr event;
+        while (iter->Next(event)) {
+            if (!event->error_msg.empty()) {
+                errors.push_back(event->error_msg);
+            }
+        }
+    }
+    return errors;
+}
+
+} // namespace
+
+TEST(SessionHostTest, BoundsActiveSessions) {
+    constexpr int kSessions = 200;
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    SessionHostConfig config;
+    config.max_active = 4;
+    auto host = std::make_shared<SessionHost>(
+        [&running, &peak](const SessionRequest&) {
+            auto pair = NewAsyncIteratorPair<EventPtr>();
+            int now = running.fetch_add(1) + 1;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+            std::thread([gen = pair.second, &running]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                gen->Send(std::make_shared<AgentEvent>());
+                running.fetch_sub(1);
+                gen->Close();
+            }).detach();
+            return pair.first;
+        },
+        config);
+
+    std::vector<SessionHost::EventIterator> sessions;
+    for (int i = 0; i < kSessions; ++i) {
+        sessions.push_back(host->Submit(Request("t" + std::to_string(i % 7))));
+    }
+    EXPECT_TRUE(Drain(sessions).empty());
+
+    auto stats = host->Stats();
+    EXPECT_LE(peak.load(), 4);
+    EXPECT_EQ(stats.peak_active, 4u);
+    EXPECT_EQ(stats.admitted, static_cast<uint64_t>(kSessions));
+    EXPECT_EQ(stats.queued_interactive, 0u);
+    // The last Close reaches the host just after its events
+    while (host->Stats().completed < static_cast<uint64_t>(kSessions)) {
+        std::this_thread::yield();
+    }
+}
+
+TEST(SessionHostTest, SharesByTenantWeight) {
+    FakeSessions fake;
+    SessionHostConfig config;
+    config.max_active = 1;
+    config.tenant_weights["heavy"] = 3;
+    auto host = std::make_shared<SessionHost>(fake.Starter(), config);
+
+    // Occupy the only slot while both tenants queue up
+    fake.Hold(true);
+    std::vector<SessionHost::EventIterator> sessions;
+    sessions.push_back(host->Submit(Request("blocker")));
+    fake.Hold(false);
+    for (int i = 0; i < 12; ++i) {
+        sessions.push_back(host->Submit(Request("heavy")));
+    }
+    for (int i = 0; i < 12; ++i) {
+        sessions.push_back(host->Submit(Request("light")));
+    }
+    fake.Release();
+    EXPECT_TRUE(Drain(sessions).empty());
+
+    // heavy arrived first with all its sessions, yet light still gets one
+    // admission in every four
+    auto started = fake.Started();
+    ASSERT_EQ(started.size(), 25u);
+    std::vector<std::string> first(started.begin() + 1, started.begin() + 17);
+    EXPECT_EQ(std::count(first.begin(), first.end(), "heavy"), 12);
+    EXPECT_EQ(std::count(first.begin(), first.end(), "light"), 4);
+    for (size_t i = 0; i + 4 <= first.size(); i += 4) {
+        EXPECT_EQ(std::count(first.begin() + i, first.begin() + i + 4, "light"), 1);
+    }
+}
+
+TEST(SessionHostTest, InteractiveLaneGoesFirst) {
+    FakeSessions fake;
+    SessionHostConfig config;
+    config.max_active = 1;
+    config.interactive_burst = 2;
+    auto host = std::make_shared<SessionHost>(fake.Starter(), config);
+
+    fake.Hold(true);
+    std::vector<SessionHost::EventIterator> sessions;
+    sessions.push_back(host->Submit(Request("blocker")));
+    fake.Hold(false);
+    for (int i = 0; i < 3; ++i) {
+        sessions.push_back(host->Submit(Request("b", SessionLane::kBatch)));
+    }
+    for (int i = 0; i < 5; ++i) {
+        sessions.push_back(host->Submit(Request("i")));
+    }
+    fake.Release();
+    EXPECT_TRUE(Drain(sessions).empty());
+
+    EXPECT_EQ(fake.Started(), (std::vector<std::string>{
+                                  "blocker", "i", "i", "b", "i", "i", "b", "i", "b"}));
+}
+
+TEST(SessionHostTest, RejectsAndWithdraws) {
+    FakeSessions fake;
+    SessionHostConfig config;
+    config.max_active = 1;
+    config.max_queued = 3;
+    config.max_queued_per_tenant = 2;
+    auto host = std::make_shared<SessionHost>(fake.Starter(), config);
+
+    fake.Hold(true);
+    auto blocker = host->Submit(Request("a"));
+    fake.Hold(false);
+    auto a1 = host->Submit(Request("a"));
+    auto a2 = host->Submit(Request("a"));
+    auto a3 = host->Submit(Request("a"));  // over the tenant's limit
+    auto b1 = host->Submit(Request("b"));
+    auto b2 = host->Submit(Request("b"));  // over the host's limit
+
+    std::vector<SessionHost::EventIterator> refused = {a3, b2};
+    EXPECT_EQ(Drain(refused).size(), 2u);
+
+    // Giving up a place frees it for someone else
+    a1.reset();
+    auto c1 = host->Submit(Request("c"));
+    auto stats = host->Stats();
+    EXPECT_EQ(stats.rejected, 2u);
+    EXPECT_EQ(stats.withdrawn, 1u);
+    EXPECT_EQ(stats.queued_interactive, 3u);
+
+    fake.Release();
+    std::vector<SessionHost::EventIterator> sessions = {blocker, a2, b1, c1};
+    EXPECT_TRUE(Drain(sessions).empty());
+    // a keeps the virtual time its withdrawn session used
+    EXPECT_EQ(fake.Started(), (std::vector<std::string>{"a", "b", "c", "a"}));
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/adk/task_dispatch.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eino;
+using namespace eino::adk;
+
+namespace {
+
+using EventPtr = std::shared_ptr<AgentEvent>;
+
+EventPtr Reply(const std::string& content) {
+    auto msg = std::make_shared<schema::Message>(schema::AssistantMessage(content));
+    auto event = std::make_shared<AgentEvent>();
+    event->output = std::make_shared<AgentOutput>();
+    event->output->message_output = std::make_shared<MessageVariant>();
+    event->output->message_output->message = msg.get();
+    event->output->customized_output = msg;
+    return event;
+}
+
+std::vector<SubAgentTask> Tasks(int n) {
+    std::vector<SubAgentTask> tasks;
+    for (int i = 0; i < n; ++i) {
+        tasks.push_back({"call" + std::to_string(i), "worker", "task " + std::to_string(i)});
+    }
+    return tasks;
+}
+
+// SleepyStarter answers every task from its own thread; task 0 takes slow
+// and the rest fast
+SubAgentStarter SleepyStarter(std::atomic<int>* running, std::atomic<int>* peak,
+                              std::chrono::milliseconds slow, std::chrono::milliseconds fast) {
+    return [running, peak, slow, fast](void*, const std::shared_ptr<SubAgentContext>& context) {
+        int now = running->fetch_add(1) + 1;
+        int seen = peak->load();
+        while (now > seen && !peak->compare_exchange_weak(seen, now)) {
+        }
+        auto pair = NewAsyncIteratorPair<EventPtr>();
+        auto delay = context->Task().call_id == "call0" ? slow : fast;
+        std::thread([gen = pair.second, context, running, delay]() {
+            std::this_thread::sleep_for(delay);
+            running->fetch_sub(1);
+            gen->Send(Reply("did " + context->Task().description));
+            gen->Close();
+        }).detach();
+        return pair.first;
+    };
+}
+
+} // namespace
+
+TEST(TaskDispatchTest, StreamsResultsAsTasksFinish) {
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    TaskDispatchConfig config;
+    config.max_concurrent_tasks = 3;
+    auto results = DispatchTasks(nullptr, Tasks(8),
+                                 SleepyStarter(&running, &peak, std::chrono::milliseconds(300),
+                                               std::chrono::milliseconds(10)),
+                                 schema::MessageHistory(), config);
+
+    std::vector<SubAgentResult> got;
+    SubAgentResult result;
+    while (results->Next(result)) {
+        got.push_back(result);
+    }
+    ASSERT_EQ(got.size(), 8u);
+    EXPECT_LE(peak.load(), 3);
+    EXPECT_GE(peak.load(), 2);
+    // The slow first task does not hold back the seven behind it
+    EXPECT_EQ(got.back().index, 0u);
+    EXPECT_EQ(got.back().call_id, "call0");
+    EXPECT_EQ(got.back().result, "did task 0");
+    for (const auto& r : got) {
+        EXPECT_TRUE(r.error.empty());
+        EXPECT_EQ(r.result, "did task " + std::to_string(r.index));
+    }
+}
+
+TEST(TaskDispatchTest, ContextSharesParentHistory) {
+    std::vector<schema::Message> parent_messages;
+    for (int i = 0; i < 100; ++i) {
+        parent_messages.push_back(schema::UserMessage("turn " + std::to_string(i)));
+    }
+    auto parent = schema::MessageHistory::FromMessages(parent_messages);
+
+    for (bool inherit : {true, false}) {
+        std::vector<std::shared_ptr<SubAgentContext>> contexts;
+        std::mutex mutex;
+        TaskDispatchConfig config;
+        config.inherit_history = inherit;
+        auto results = DispatchTasks(
+            nullptr, Tasks(4),
+            [&contexts, &mutex](void*, const std::shared_ptr<SubAgentContext>& context) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    contexts.push_back(context);
+                }
+                auto pair = NewAsyncIteratorPair<EventPtr>();
+                pair.second->Close();
+                return pair.first;
+            },
+            parent, config);
+        SubAgentResult result;
+        while (results->Next(result)) {
+        }
+
+        ASSERT_EQ(contexts.size(), 4u);
+        for (auto& context : contexts) {
+            // Nothing is flattened until a sub-agent asks for messages
+            EXPECT_FALSE(context->Materialized());
+            const auto& history = context->History();
+            if (inherit) {
+                ASSERT_EQ(history.size(), 101u);
+                EXPECT_TRUE(history.SharesPrefixWith(parent, 100));
+            } else {
+                ASSERT_EQ(history.size(), 1u);
+            }
+            const auto& messages = context->Messages();
+            EXPECT_TRUE(context->Materialized());
+            ASSERT_EQ(messages.size(), history.size());
+            EXPECT_EQ(messages.back()->content, context->Task().description);
+        }
+        // Siblings do not see each other's task
+        EXPECT_FALSE(contexts[0]->History().Back().SameAs(contexts[1]->History().Back()));
+    }
+    EXPECT_EQ(parent.size(), 100u);
+}
+
+TEST(TaskDispatchTest, ReportsErrorsPerTask) {
+    auto results = DispatchTasks(
+        nullptr, Tasks(3), [](void*, const std::shared_ptr<SubAgentContext>& context) {
+            const std::string& id = context->Task().call_id;
+            if (id == "call0") {
+                return SubAgentEventIterator();
+            }
+            if (id == "call1") {
+                throw std::runtime_error("boom");
+            }
+            auto pair = NewAsyncIteratorPair<EventPtr>();
+            auto event = std::make_shared<AgentEvent>();
+            event->error_msg = "model failed";
+            pair.second->Send(event);
+            pair.second->Close();
+            return pair.first;
+        },
+        schema::MessageHistory());
+
+    std::vector<std::string> errors(3);
+    SubAgentResult result;
+    while (results->Next(result)) {
+        errors[result.index] = result.error;
+    }
+    EXPECT_EQ(errors[0], "subagent type 'worker' not found");
+    EXPECT_EQ(errors[1], "boom");
+    EXPECT_EQ(errors[2], "model failed");
+}
+
+TEST(TaskDispatchTest, DroppingResultsStopsDispatch) {
+    std::atomic<int> started{0};
+    std::atomic<int> cancelled{0};
+    std::vector<std::shared_ptr<AsyncGenerator<EventPtr>>> held;
+    std::mutex mutex;
+    TaskDispatchConfig config;
+    config.max_concurrent_tasks = 2;
+    auto results = DispatchTasks(
+        nullptr, Tasks(6),
+        [&](void*, const std::shared_ptr<SubAgentContext>&) {
+            started.fetch_add(1);
+            auto pair = NewAsyncIteratorPair<EventPtr>();
+            pair.second->OnCancel([&cancelled]() { cancelled.fetch_add(1); });
+            std::lock_guard<std::mutex> lock(mutex);
+            held.push_back(pair.second);
+            return pair.first;
+        },
+        schema::MessageHistory(), config);
+    while (started.load() < 2) {
+        std::this_thread::yield();
+    }
+
+    results.reset();
+    // A sub-agent that sends again learns nobody listens and is cancelled
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& gen : held) {
+            gen->Send(Reply("late"));
+        }
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (cancelled.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(cancelled.load(), 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(started.load(), 2);
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/compose/branch_speculation.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eino::compose;
+
+using Targets = std::vector<std::string>;
+
+namespace {
+
+ExecutionPlan::NodeSpec Spec(const std::string& name) {
+    ExecutionPlan::NodeSpec spec;
+    spec.name = name;
+    spec.caps.has_invoke = true;
+    return spec;
+}
+
+PlanEdge Edge(const std::string& from, const std::string& to) {
+    PlanEdge e;
+    e.from = from;
+    e.to = to;
+    return e;
+}
+
+// START -> src; the branch on src picks among b, c and d (branch targets
+// have no plan edges into them), and d is also fed by other
+std::shared_ptr<const ExecutionPlan> BranchPlan() {
+    return ExecutionPlan::Build(
+        {Spec("src"), Spec("other"), Spec("b"), Spec("c"), Spec("d")},
+        {Edge("__START__", "src"), Edge("__START__", "other"), Edge("other", "d"),
+         Edge("b", "__END__"), Edge("c", "__END__"), Edge("d", "__END__")});
+}
+
+Targets Names(const ExecutionPlan& plan, const std::vector<int>& ids) {
+    Targets names;
+    for (int id : ids) {
+        names.push_back(plan.Name(id));
+    }
+    return names;
+}
+
+} // namespace
+
+TEST(BranchPredictorTest, StaticHintWins) {
+    BranchSpeculation spec;
+    spec.hint = {"a", "b", "c"};
+    spec.max_targets = 2;
+    BranchPredictor predictor(spec);
+
+    predictor.Record({"c"});
+    predictor.Record({"c"});
+    EXPECT_EQ(predictor.Predict(), (Targets{"a", "b"}));
+}
+
+TEST(BranchPredictorTest, EmptyHistoryPredictsNothing) {
+    BranchPredictor predictor(BranchSpeculation{});
+    EXPECT_TRUE(predictor.Predict().empty());
+}
+
+TEST(BranchPredictorTest, PredictsMostFrequentOfLastN) {
+    BranchSpeculation spec;
+    spec.history_size = 3;
+    BranchPredictor predictor(spec);
+
+    predictor.Record({"a"});
+    predictor.Record({"a"});
+    EXPECT_EQ(predictor.Predict(), (Targets{"a"}));
+
+    // "a" ages out of the window
+    predictor.Record({"b"});
+    predictor.Record({"b"});
+    EXPECT_EQ(predictor.Predict(), (Targets{"b"}));
+}
+
+TEST(BranchPredictorTest, TiesGoToMostRecent) {
+    BranchSpeculation spec;
+    spec.max_targets = 2;
+    BranchPredictor predictor(spec);
+
+    predictor.Record({"a"});
+    predictor.Record({"b"});
+    predictor.Record({"c", "a"});
+    EXPECT_EQ(predictor.Predict(), (Targets{"a", "c"}));
+}
+
+TEST(BranchPredictorTest, ConcurrentRecordAndPredict) {
+    BranchSpeculation spec;
+    spec.history_size = 8;
+    BranchPredictor predictor(spec);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&predictor]() {
+            for (int i = 0; i < 1000; ++i) {
+                predictor.Record({"x"});
+                auto predicted = predictor.Predict();
+                ASSERT_EQ(predicted.size(), 1u);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(predictor.Predict(), (Targets{"x"}));
+}
+
+TEST(SpeculationTargetsTest, OnlyIdempotentSoleTriggerTargets) {
+    auto plan = BranchPlan();
+    std::set<std::string> idempotent = {"b", "d"};
+    auto is_idempotent = [&](int id) { return idempotent.count(plan->Name(id)) > 0; };
+
+    // c is not idempotent, d has a predecessor besides the branch
+    EXPECT_EQ(Names(*plan, SpeculationTargets(*plan, {"b", "c", "d"}, is_idempotent, {})),
+              (Targets{"b"}));
+    // Unknown nodes and END are never started
+    EXPECT_TRUE(SpeculationTargets(*plan, {"ghost", "__END__"}, is_idempotent, {}).empty());
+    // Nor are nodes that interrupt before running
+    EXPECT_TRUE(SpeculationTargets(*plan, {"b"}, is_idempotent, {"b"}).empty());
+}
+
+TEST(ResolveSpeculationTest, HitIsAdoptedNotScheduledAgain) {
+    BranchSpeculation spec;
+    spec.max_targets = 2;
+    BranchPredictor predictor(spec);
+    std::vector<size_t> cancelled;
+    int conditions = 0;
+
+    auto remaining = ResolveSpeculation(
+        {"b"},
+        [&]() { ++conditions; return Targets{"b", "c"}; },
+        [&](size_t i) { cancelled.push_back(i); },
+        &predictor);
+
+    // b already runs, so only c is left to schedule
+    EXPECT_EQ(remaining, (Targets{"c"}));
+    EXPECT_TRUE(cancelled.empty());
+    EXPECT_EQ(conditions, 1);
+    // The full outcome is recorded, hits included
+    auto predicted = predictor.Predict();
+    EXPECT_EQ(std::set<std::string>(predicted.begin(), predicted.end()),
+              (std::set<std::string>{"b", "c"}));
+}
+
+TEST(ResolveSpeculationTest, MissIsCancelled) {
+    BranchPredictor predictor(BranchSpeculation{});
+    std::vector<size_t> cancelled;
+
+    auto remaining = ResolveSpeculation(
+        {"b", "c"},
+        []() { return Targets{"c"}; },
+        [&](size_t i) { cancelled.push_back(i); },
+        &predictor);
+
+    EXPECT_TRUE(remaining.empty());
+    EXPECT_EQ(cancelled, (std::vector<size_t>{0}));
+    EXPECT_EQ(predictor.Predict(), (Targets{"c"}));
+}
+
+TEST(ResolveSpeculationTest, ConditionThrowCancelsEverything) {
+    BranchPredictor predictor(BranchSpeculation{});
+    std::vector<size_t> cancelled;
+
+    EXPECT_THROW(ResolveSpeculation(
+                     {"b", "c"},
+                     []() -> Targets { throw std::runtime_error("condition failed"); },
+                     [&](size_t i) { cancelled.push_back(i); },
+                     &predictor),
+                 std::runtime_error);
+
+    EXPECT_EQ(cancelled, (std::vector<size_t>{0, 1}));
+    // A failed evaluation is not an outcome
+    EXPECT_TRUE(predictor.Predict().empty());
+}
+
+TEST(ResolveSpeculationTest, NothingSpeculated) {
+    std::vector<size_t> cancelled;
+    auto remaining = ResolveSpeculation(
+        {}, []() { return Targets{"b"}; }, [&](size_t i) { cancelled.push_back(i); }, nullptr);
+    EXPECT_EQ(remaining, (Targets{"b"}));
+    EXPECT_TRUE(cancelled.empty());
+}
+
+// Mirrors GraphRunner::ResolveCompletedTasks: the predicted target starts
+// when the upstream is done, then the slow condition runs. A hit finishes
+// in about max(condition, target) instead of condition + target
+TEST(ResolveSpeculationTest, SlowConditionOverlapsTarget) {
+    using Clock = std::chrono::steady_clock;
+    const auto kCondition = std::chrono::milliseconds(100);
+    const auto kTarget = std::chrono::milliseconds(100);
+    auto condition = [&]() {
+        std::this_thread::sleep_for(kCondition);
+        return Targets{"b"};
+    };
+    auto run_target = [&]() { std::this_thread::sleep_for(kTarget); };
+
+    // Without speculation the target is scheduled after the condition
+    auto start = Clock::now();
+    auto remaining = ResolveSpeculation({}, condition, [](size_t) {}, nullptr);
+    ASSERT_EQ(remaining, (Targets{"b"}));
+    run_target();
+    auto sequential = Clock::now() - start;
+
+    start = Clock::now();
+    std::thread target(run_target);
+    std::vector<size_t> cancelled;
+    remaining = ResolveSpeculation(
+        {"b"}, condition, [&](size_t i) { cancelled.push_back(i); }, nullptr);
+    target.join();
+    auto speculated = Clock::now() - start;
+
+    EXPECT_TRUE(remaining.empty());
+    EXPECT_TRUE(cancelled.empty());
+    EXPECT_GE(sequential, kCondition + kTarget);
+    EXPECT_LT(speculated, sequential - kTarget / 2);
+}
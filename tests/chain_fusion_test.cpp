@@ -0,0 +1,151 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Test: Chain step fusion
+ *
+ * - FusedChainRunnable runs its steps in order and checks its keys
+ * - fused_step_callbacks gives every step its own context
+ * - Compile fuses maximal runs and records graph_node_key per step
+ * - WithNoFusion keeps a step in its own graph node
+ * - Any other node option is reported as a chain error
+ */
+
+#include "eino/compose/chain.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace eino;
+using namespace eino::compose;
+
+namespace {
+
+std::shared_ptr<Runnable<std::string, std::string>> Suffix(const std::string& suffix) {
+    return NewLambdaRunnable<std::string, std::string>(
+        [suffix](std::shared_ptr<Context>, const std::string& input,
+                 const std::vector<Option>&) {
+            return input + suffix;
+        });
+}
+
+std::shared_ptr<Chain<std::string, std::string>> ThreeStepChain(
+    const std::vector<Option>& middle_opts) {
+    auto chain = NewChain<std::string, std::string>();
+    chain->AppendLambda(Suffix("a"));
+    chain->AppendLambda(Suffix("b"), middle_opts);
+    chain->AppendLambda(Suffix("c"));
+    return chain;
+}
+
+ChainCompileOptions Fusion() {
+    ChainCompileOptions opts;
+    opts.enable_fusion = true;
+    return opts;
+}
+
+}  // namespace
+
+TEST(FusedChainRunnable, InvokesStepsInOrder) {
+    FusedChainRunnable<std::string> fused(
+        {Suffix("a"), Suffix("b"), Suffix("c")}, {"node_0", "node_1", "node_2"}, false);
+    EXPECT_EQ(fused.Invoke(Context::Background(), "x"), "xabc");
+    EXPECT_EQ(fused.GetStepKeys(), (std::vector<std::string>{"node_0", "node_1", "node_2"}));
+    EXPECT_EQ(fused.GetComponentType(), "FusedChain");
+}
+
+TEST(FusedChainRunnable, RejectsMismatchedKeys) {
+    EXPECT_THROW(FusedChainRunnable<std::string>({Suffix("a"), Suffix("b")}, {"node_0"}, false),
+                 std::invalid_argument);
+    EXPECT_THROW(FusedChainRunnable<std::string>({}, {}, false), std::invalid_argument);
+}
+
+TEST(FusedChainRunnable, StepCallbacksGiveEachStepItsOwnContext) {
+    auto caller = Context::Background();
+    std::vector<std::shared_ptr<Context>> seen;
+    auto record = NewLambdaRunnable<std::string, std::string>(
+        [&seen](std::shared_ptr<Context> ctx, const std::string& input,
+                const std::vector<Option>&) {
+            seen.push_back(ctx);
+            return input;
+        });
+
+    FusedChainRunnable<std::string> shared({record, record}, {"node_0", "node_1"}, false);
+    shared.Invoke(caller, "x");
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[0], caller);
+    EXPECT_EQ(seen[1], caller);
+
+    seen.clear();
+    FusedChainRunnable<std::string> per_step({record, record}, {"node_0", "node_1"}, true);
+    EXPECT_EQ(per_step.Invoke(caller, "x"), "x");
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_NE(seen[0], caller);
+    EXPECT_NE(seen[1], caller);
+    EXPECT_NE(seen[0], seen[1]);
+}
+
+TEST(ChainFusion, FusesMaximalRunUnderFirstKey) {
+    auto chain = ThreeStepChain({});
+    chain->Compile(Context::Background(), Fusion());
+    ASSERT_FALSE(chain->HasError()) << chain->GetError();
+
+    const auto& nodes = chain->GetNodes();
+    ASSERT_EQ(nodes.size(), 3u);
+    for (const auto& node : nodes) {
+        EXPECT_EQ(node.graph_node_key, "node_0");
+    }
+    EXPECT_EQ(chain->Invoke(Context::Background(), "x"), "xabc");
+}
+
+TEST(ChainFusion, DisabledKeepsOneGraphNodePerStep) {
+    auto chain = ThreeStepChain({});
+    chain->Compile(Context::Background());
+    ASSERT_FALSE(chain->HasError()) << chain->GetError();
+
+    const auto& nodes = chain->GetNodes();
+    ASSERT_EQ(nodes.size(), 3u);
+    for (const auto& node : nodes) {
+        EXPECT_EQ(node.graph_node_key, node.node_key);
+    }
+    EXPECT_EQ(chain->Invoke(Context::Background(), "x"), "xabc");
+}
+
+TEST(ChainFusion, NoFusionStepBreaksTheRun) {
+    auto chain = ThreeStepChain({WithNoFusion()});
+    chain->Compile(Context::Background(), Fusion());
+    ASSERT_FALSE(chain->HasError()) << chain->GetError();
+
+    // No run of two or more fusible steps is left
+    const auto& nodes = chain->GetNodes();
+    ASSERT_EQ(nodes.size(), 3u);
+    EXPECT_EQ(nodes[0].graph_node_key, "node_0");
+    EXPECT_EQ(nodes[1].graph_node_key, "node_1");
+    EXPECT_EQ(nodes[2].graph_node_key, "node_2");
+    EXPECT_EQ(chain->Invoke(Context::Background(), "x"), "xabc");
+}
+
+TEST(ChainFusion, UnsupportedNodeOptionIsAnError) {
+    Option opt;
+    opt["temperature"] = 0.5;
+    auto chain = ThreeStepChain({opt});
+    EXPECT_TRUE(chain->HasError());
+    EXPECT_EQ(chain->GetError(), "Lambda node options are not supported by Chain");
+    EXPECT_EQ(chain->GetNodes().size(), 1u);
+    EXPECT_THROW(chain->Compile(Context::Background(), Fusion()), std::runtime_error);
+}
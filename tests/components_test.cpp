@@ -19,6 +19,16 @@
 #include "eino/components/prebuilt/simple_loader.h"
 #include "eino/components/prebuilt/text_splitter.h"
 #include "eino/components/prebuilt/simple_embedder.h"
+#include "eino/components/prebuilt/cached_embedder.h"
+#include "eino/components/prebuilt/directory_loader.h"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
@@ -151,6 +161,188 @@ TEST_F(ComponentsTest, SimpleEmbedderNormalization) {
     EXPECT_NEAR(norm, 1.0, 1e-6);
 }
 
+// CountingEmbedder wraps SimpleEmbedder and counts texts it embeds
+class CountingEmbedder : public eino::components::SimpleEmbedder {
+public:
+    CountingEmbedder() : SimpleEmbedder(16) {}
+
+    std::vector<std::vector<double>> Invoke(
+        std::shared_ptr<eino::compose::Context> ctx,
+        const std::vector<std::string>& input,
+        const std::vector<eino::compose::Option>& opts = std::vector<eino::compose::Option>()) override {
+        calls++;
+        texts += input.size();
+        return SimpleEmbedder::Invoke(ctx, input, opts);
+    }
+
+    std::atomic<int> calls{0};
+    std::atomic<size_t> texts{0};
+};
+
+// Test CachedEmbedder deduplicates within and across requests
+TEST_F(ComponentsTest, CachedEmbedderDeduplicates) {
+    auto inner = std::make_shared<CountingEmbedder>();
+    eino::components::CachedEmbedderConfig config;
+    config.embedder = inner;
+    config.max_batch_delay = std::chrono::milliseconds(0);
+    auto embedder = eino::components::NewCachedEmbedder(config);
+
+    auto first = embedder->Invoke(ctx_, {"header", "body", "header"});
+    ASSERT_EQ(first.size(), 3);
+    EXPECT_EQ(first[0], first[2]);
+    EXPECT_EQ(inner->texts.load(), 2);
+
+    auto second = embedder->Invoke(ctx_, {"body", "header"});
+    EXPECT_EQ(second[0], first[1]);
+    EXPECT_EQ(inner->texts.load(), 2);
+
+    auto stats = embedder->GetStats();
+    EXPECT_EQ(stats.deduplicated, 1u);
+    EXPECT_EQ(stats.memory_hits, 2u);
+}
+
+// Test CachedEmbedder coalesces concurrent small requests into one batch
+TEST_F(ComponentsTest, CachedEmbedderCoalescesBatches) {
+    auto inner = std::make_shared<CountingEmbedder>();
+    eino::components::CachedEmbedderConfig config;
+    config.embedder = inner;
+    config.max_batch_size = 8;
+    config.max_batch_delay = std::chrono::milliseconds(50);
+    auto embedder = eino::components::NewCachedEmbedder(config);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 8; ++i) {
+        workers.emplace_back([&, i]() {
+            auto vecs = embedder->Invoke(ctx_, {"text-" + std::to_string(i)});
+            EXPECT_EQ(vecs.size(), 1);
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    EXPECT_EQ(inner->texts.load(), 8);
+    EXPECT_LT(inner->calls.load(), 8);
+}
+
+// CachedEmbedderSpillTest gives each test its own spill directory
+class CachedEmbedderSpillTest : public ComponentsTest {
+protected:
+    void SetUp() override {
+        ComponentsTest::SetUp();
+        std::string pattern = ::testing::TempDir() + "eino_spill_XXXXXX";
+        ASSERT_NE(mkdtemp(&pattern[0]), nullptr);
+        spill_dir_ = pattern;
+    }
+
+    void TearDown() override {
+        if (!spill_dir_.empty()) {
+            nftw(spill_dir_.c_str(),
+                 [](const char* path, const struct stat*, int, struct FTW*) {
+                     return remove(path);
+                 },
+                 16, FTW_DEPTH | FTW_PHYS);
+        }
+    }
+
+    std::string spill_dir_;
+};
+
+// Test CachedEmbedder spills evicted vectors to disk and reloads them
+TEST_F(CachedEmbedderSpillTest, DiskSpill) {
+    auto inner = std::make_shared<CountingEmbedder>();
+    eino::components::CachedEmbedderConfig config;
+    config.embedder = inner;
+    config.max_cache_bytes = 16 * sizeof(double);  // one vector
+    config.spill_dir = spill_dir_;
+    config.cache_namespace = "spill-test";
+    config.max_batch_delay = std::chrono::milliseconds(0);
+    auto embedder = eino::components::NewCachedEmbedder(config);
+
+    auto a = embedder->Invoke(ctx_, {"a"});
+    embedder->Invoke(ctx_, {"b"});  // evicts "a" to disk
+    auto again = embedder->Invoke(ctx_, {"a"});
+
+    EXPECT_EQ(again[0], a[0]);
+    EXPECT_EQ(inner->texts.load(), 2);
+    EXPECT_EQ(embedder->GetStats().disk_hits, 1u);
+}
+
+// Test DirectoryLoader walks recursively with glob filters and streams files
+TEST_F(ComponentsTest, DirectoryLoaderRecursiveGlob) {
+    std::string root = ::testing::TempDir() + "eino_directory_loader";
+    mkdir(root.c_str(), 0755);
+    mkdir((root + "/sub").c_str(), 0755);
+    mkdir((root + "/skip").c_str(), 0755);
+    std::ofstream(root + "/a.txt") << "alpha";
+    std::ofstream(root + "/b.md") << "beta";
+    std::ofstream(root + "/sub/c.txt") << "gamma";
+    std::ofstream(root + "/skip/d.txt") << "delta";
+
+    eino::components::DirectoryLoaderConfig config;
+    config.include_patterns = {"*.txt"};
+    config.exclude_patterns = {"skip"};
+    config.num_workers = 2;
+    eino::components::DirectoryLoader loader(config);
+
+    eino::schema::Source source;
+    source.uri = root;
+    auto reader = loader.Stream(ctx_, source);
+
+    std::set<std::string> contents;
+    std::vector<eino::schema::Document> chunk;
+    while (reader->Read(chunk)) {
+        for (const auto& doc : chunk) {
+            contents.insert(doc.page_content);
+            EXPECT_EQ(static_cast<std::string>(doc.GetMetadata("source")), doc.id);
+        }
+    }
+    EXPECT_EQ(contents, (std::set<std::string>{"alpha", "gamma"}));
+}
+
+// Test DirectoryLoader surfaces missing roots instead of returning nothing
+TEST_F(ComponentsTest, DirectoryLoaderMissingRoot) {
+    eino::components::DirectoryLoader loader;
+    eino::schema::Source source;
+    source.uri = ::testing::TempDir() + "eino_directory_loader_missing";
+    EXPECT_THROW(loader.Invoke(ctx_, source), std::runtime_error);
+}
+
+// Test DirectoryLoader walks a directory once when symlinks form a cycle
+TEST_F(ComponentsTest, DirectoryLoaderSymlinkCycle) {
+    std::string root = ::testing::TempDir() + "eino_directory_loader_cycle";
+    mkdir(root.c_str(), 0755);
+    mkdir((root + "/sub").c_str(), 0755);
+    std::ofstream(root + "/sub/a.txt") << "alpha";
+    symlink("..", (root + "/sub/up").c_str());
+
+    eino::components::DirectoryLoaderConfig config;
+    config.follow_symlinks = true;
+    eino::components::DirectoryLoader loader(config);
+
+    eino::schema::Source source;
+    source.uri = root;
+    auto docs = loader.Invoke(ctx_, source);
+    ASSERT_EQ(docs.size(), 1);
+    EXPECT_EQ(docs[0].page_content, "alpha");
+}
+
+// Test DirectoryLoader reports walk errors to on_error without fail_fast
+TEST_F(ComponentsTest, DirectoryLoaderWalkErrorReported) {
+    std::vector<std::string> failed;
+    eino::components::DirectoryLoaderConfig config;
+    config.fail_fast = false;
+    config.on_error = [&failed](const std::string& path, const std::string&) {
+        failed.push_back(path);
+    };
+    eino::components::DirectoryLoader loader(config);
+
+    eino::schema::Source source;
+    source.uri = ::testing::TempDir() + "eino_directory_loader_missing";
+    EXPECT_TRUE(loader.Invoke(ctx_, source).empty());
+    EXPECT_EQ(failed, std::vector<std::string>{source.uri});
+}
+
 // Test Document metadata
 TEST_F(ComponentsTest, DocumentMetadata) {
     eino::schema::Document doc;
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/flow/retriever/fusion.h"
+#include <gtest/gtest.h>
+
+using namespace eino::flow::retriever;
+using eino::schema::Document;
+
+namespace {
+
+std::vector<Document> Docs(const std::vector<std::string>& ids) {
+    std::vector<Document> docs;
+    for (const auto& id : ids) {
+        docs.emplace_back(id, "content of " + id);
+    }
+    return docs;
+}
+
+std::vector<std::string> Ids(const std::vector<Document>& docs) {
+    std::vector<std::string> ids;
+    for (const auto& doc : docs) {
+        ids.push_back(doc.id);
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST(FusionTest, RRFRanksSharedDocumentsFirst) {
+    std::vector<std::vector<Document>> lists = {
+        Docs({"a", "b", "c"}),
+        Docs({"c", "d", "a"}),
+    };
+    auto fused = FuseDocuments(std::move(lists), FusionOptions());
+    // a: 1/60 + 1/62, c: 1/62 + 1/60 (tie, a seen first), b: 1/61, d: 1/61
+    EXPECT_EQ(Ids(fused), (std::vector<std::string>{"a", "c", "b", "d"}));
+    EXPECT_EQ(fused[0].page_content, "content of a");
+}
+
+TEST(FusionTest, WeightedRRF) {
+    std::vector<std::vector<Document>> lists = {
+        Docs({"a", "b"}),
+        Docs({"x", "y"}),
+    };
+    FusionOptions options;
+    options.weights = {1.0, 3.0};
+    auto fused = FuseDocuments(lists, options);
+    EXPECT_EQ(Ids(fused), (std::vector<std::string>{"x", "y", "a", "b"}));
+}
+
+TEST(FusionTest, ScoreNormalized) {
+    std::vector<std::vector<Document>> lists = {Docs({"a", "b"}), Docs({"b", "c"})};
+    lists[0][0].WithScore(10.0);
+    lists[0][1].WithScore(0.0);
+    lists[1][0].WithScore(0.9);
+    lists[1][1].WithScore(0.1);
+    auto fused = FuseDocuments(lists, FusionOptions(FusionMode::kScoreNormalized));
+    // a: 1.0, b: 0.0 + 1.0, c: 0.0 -> a/b tie broken by first-seen order
+    EXPECT_EQ(Ids(fused), (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(FusionTest, MaxResultsUsesTopK) {
+    std::vector<std::vector<Document>> lists = {
+        Docs({"a", "b", "c", "d", "e"}),
+        Docs({"e", "d"}),
+    };
+    FusionOptions options;
+    options.max_results = 2;
+    auto fused = FuseDocuments(std::move(lists), options);
+    EXPECT_EQ(Ids(fused), (std::vector<std::string>{"e", "d"}));
+}
+
+TEST(FusionTest, DedupKeepsFirstOccurrence) {
+    std::vector<std::vector<Document>> lists = {Docs({"a", "b"}), Docs({"b", "c", "a"})};
+    auto fused = FuseDocuments(lists, FusionOptions(FusionMode::kDedup));
+    EXPECT_EQ(Ids(fused), (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(FusionTest, EmptyInput) {
+    std::vector<std::vector<Document>> lists;
+    EXPECT_TRUE(FuseDocuments(lists, FusionOptions()).empty());
+}
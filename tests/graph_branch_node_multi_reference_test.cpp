@@ -381,3 +381,39 @@ TEST(GraphBranchNodeMultiReferenceTest, AccessStartNodeInput) {
     EXPECT_TRUE(result.count("service"));
     EXPECT_EQ(std::any_cast<std::string>(result.at("service")), "VIP");
 }
+
+/**
+ * Test: Select over a view of node outputs matches Invoke over a copied map
+ */
+TEST(GraphBranchNodeMultiReferenceTest, SelectReadsViewedOutputsInPlace) {
+    BranchNodeConfig branch_config;
+    branch_config.AddConditionWithOperands(
+        BranchOperator::Greater,
+        OperandConfig::FromNode("node_b", {"score"}),
+        OperandConfig::FromLiteral(static_cast<int64_t>(90))
+    );
+    // A whole node output as the operand
+    branch_config.AddConditionWithOperands(
+        BranchOperator::ContainKey,
+        OperandConfig::FromNode("node_a"),
+        OperandConfig::FromLiteral(std::string("city"))
+    );
+    auto branch = BranchNode<MapType, MapType>::New(Context::Background(), branch_config);
+
+    MapType node_a = {{"age", static_cast<int64_t>(25)}, {"city", std::string("Beijing")}};
+    MapType node_b = {{"score", static_cast<int64_t>(85)}};
+    MapType copied = {{"node_a", node_a}, {"node_b", node_b}};
+    BranchInputs view = {{"node_a", &node_a}, {"node_b", &node_b}};
+
+    auto invoked = branch->Invoke(Context::Background(), copied);
+    auto selected = branch->Select(view);
+    EXPECT_EQ(std::any_cast<int64_t>(selected.at("selected")), 1);
+    EXPECT_EQ(std::any_cast<int64_t>(invoked.at("selected")), 1);
+
+    node_b["score"] = static_cast<int64_t>(95);
+    EXPECT_EQ(std::any_cast<int64_t>(branch->Select(view).at("selected")), 0);
+
+    // A missing left operand fails as it does for Invoke
+    BranchInputs missing = {{"node_a", &node_a}};
+    EXPECT_THROW(branch->Select(missing), std::runtime_error);
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Test: BranchNode operators and compiled conditions
+ *
+ * - Every operator on matching operand types
+ * - Mismatched operand types evaluate to false instead of throwing
+ * - AND/OR clauses short-circuit before later operands are resolved
+ * - Literals are normalized to int64/double/string when compiled
+ * - contain/not_contain against a literal list use the hashed IN path
+ */
+
+#include "eino/compose/branch_node.h"
+#include <gtest/gtest.h>
+#include <any>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace eino;
+using namespace eino::compose;
+
+using MapType = std::map<std::string, std::any>;
+
+namespace {
+
+bool Eval(BranchOperator op, const std::any& left, const std::any& right = std::any()) {
+    return EvaluateOperator(op, &left, &right);
+}
+
+// Select runs a node-reference BranchNode over input and returns the index
+int64_t Select(const BranchNodeConfig& config, const MapType& input) {
+    auto node = BranchNode<MapType, MapType>::New(Context::Background(), config);
+    auto output = node->Invoke(Context::Background(), input);
+    return std::any_cast<int64_t>(output.at("selected"));
+}
+
+MapType UserInput() {
+    MapType user;
+    user["age"] = static_cast<int64_t>(25);
+    user["name"] = std::string("Alice");
+    user["score"] = 85.5;
+    user["vip"] = true;
+    MapType input;
+    input["user"] = user;
+    return input;
+}
+
+} // namespace
+
+// ============================================================================
+// Operators
+// ============================================================================
+
+TEST(GraphBranchNodeOperatorsTest, Equality) {
+    EXPECT_TRUE(Eval(BranchOperator::Equal, int64_t(3), int64_t(3)));
+    EXPECT_TRUE(Eval(BranchOperator::Equal, int64_t(3), 3.0));
+    EXPECT_TRUE(Eval(BranchOperator::Equal, std::string("a"), std::string("a")));
+    EXPECT_TRUE(Eval(BranchOperator::Equal, true, true));
+    EXPECT_TRUE(Eval(BranchOperator::Equal, std::any(), std::any()));
+    EXPECT_FALSE(Eval(BranchOperator::Equal, int64_t(3), std::any()));
+    EXPECT_TRUE(Eval(BranchOperator::NotEqual, int64_t(3), int64_t(4)));
+    EXPECT_FALSE(Eval(BranchOperator::NotEqual, std::string("a"), std::string("a")));
+}
+
+TEST(GraphBranchNodeOperatorsTest, Emptiness) {
+    EXPECT_TRUE(Eval(BranchOperator::Empty, std::any()));
+    EXPECT_TRUE(Eval(BranchOperator::Empty, std::string()));
+    EXPECT_TRUE(Eval(BranchOperator::Empty, std::string("None")));
+    EXPECT_TRUE(Eval(BranchOperator::Empty, std::vector<std::any>()));
+    EXPECT_TRUE(Eval(BranchOperator::Empty, MapType()));
+    EXPECT_TRUE(Eval(BranchOperator::Empty, int64_t(0)));
+    EXPECT_TRUE(Eval(BranchOperator::Empty, false));
+    EXPECT_TRUE(Eval(BranchOperator::NotEmpty, std::string("x")));
+    EXPECT_TRUE(Eval(BranchOperator::NotEmpty, 0.5));
+}
+
+TEST(GraphBranchNodeOperatorsTest, Comparison) {
+    EXPECT_TRUE(Eval(BranchOperator::Greater, int64_t(5), int64_t(4)));
+    EXPECT_FALSE(Eval(BranchOperator::Greater, int64_t(4), int64_t(4)));
+    EXPECT_TRUE(Eval(BranchOperator::GreaterOrEqual, int64_t(4), 4.0));
+    EXPECT_TRUE(Eval(BranchOperator::Lesser, 1.5, int64_t(2)));
+    EXPECT_TRUE(Eval(BranchOperator::LesserOrEqual, int64_t(2), int64_t(2)));
+    // Large int64 values compare exactly, not through double
+    EXPECT_TRUE(Eval(BranchOperator::Greater, int64_t(9007199254740993),
+                     int64_t(9007199254740992)));
+    // Absent operands
+    EXPECT_TRUE(Eval(BranchOperator::Lesser, std::any(), int64_t(1)));
+    EXPECT_TRUE(Eval(BranchOperator::GreaterOrEqual, int64_t(1), std::any()));
+    EXPECT_FALSE(Eval(BranchOperator::Greater, int64_t(1), std::any()));
+}
+
+TEST(GraphBranchNodeOperatorsTest, Booleans) {
+    EXPECT_TRUE(Eval(BranchOperator::IsTrue, true));
+    EXPECT_FALSE(Eval(BranchOperator::IsTrue, false));
+    EXPECT_TRUE(Eval(BranchOperator::IsFalse, false));
+    EXPECT_TRUE(Eval(BranchOperator::IsFalse, std::any()));
+}
+
+TEST(GraphBranchNodeOperatorsTest, Length) {
+    std::vector<std::any> list = {int64_t(1), int64_t(2), int64_t(3)};
+    EXPECT_TRUE(Eval(BranchOperator::LengthGreater, std::string("abcd"), int64_t(3)));
+    EXPECT_TRUE(Eval(BranchOperator::LengthGreaterOrEqual, list, int64_t(3)));
+    EXPECT_TRUE(Eval(BranchOperator::LengthLesser, list, int64_t(4)));
+    EXPECT_TRUE(Eval(BranchOperator::LengthLesserOrEqual, std::string(), int64_t(0)));
+    EXPECT_TRUE(Eval(BranchOperator::LengthLesser, std::any(), int64_t(1)));
+    // The threshold must be an int64
+    EXPECT_THROW(Eval(BranchOperator::LengthGreater, list, 1.0), std::runtime_error);
+}
+
+TEST(GraphBranchNodeOperatorsTest, Contain) {
+    std::vector<std::any> list = {int64_t(1), std::string("b")};
+    EXPECT_TRUE(Eval(BranchOperator::Contain, std::string("hello"), std::string("ell")));
+    EXPECT_TRUE(Eval(BranchOperator::NotContain, std::string("hello"), std::string("x")));
+    EXPECT_TRUE(Eval(BranchOperator::Contain, list, int64_t(1)));
+    EXPECT_TRUE(Eval(BranchOperator::Contain, list, std::string("b")));
+    EXPECT_TRUE(Eval(BranchOperator::NotContain, list, int64_t(2)));
+    EXPECT_FALSE(Eval(BranchOperator::Contain, std::any(), int64_t(1)));
+}
+
+TEST(GraphBranchNodeOperatorsTest, ContainKey) {
+    MapType map = {{"k", int64_t(1)}};
+    EXPECT_TRUE(Eval(BranchOperator::ContainKey, map, std::string("k")));
+    EXPECT_FALSE(Eval(BranchOperator::ContainKey, map, std::string("x")));
+    EXPECT_TRUE(Eval(BranchOperator::NotContainKey, map, std::string("x")));
+    EXPECT_FALSE(Eval(BranchOperator::ContainKey, std::string("k"), std::string("k")));
+}
+
+// Mismatched operand types are a non-match, not an error
+TEST(GraphBranchNodeOperatorsTest, MismatchedTypesReturnFalse) {
+    EXPECT_FALSE(Eval(BranchOperator::Equal, int64_t(25), std::string("25")));
+    EXPECT_FALSE(Eval(BranchOperator::Equal, true, int64_t(1)));
+    EXPECT_FALSE(Eval(BranchOperator::Equal, std::string("true"), true));
+    EXPECT_TRUE(Eval(BranchOperator::NotEqual, int64_t(25), std::string("25")));
+    EXPECT_FALSE(Eval(BranchOperator::Greater, std::string("b"), std::string("a")));
+    EXPECT_FALSE(Eval(BranchOperator::Lesser, int64_t(1), std::string("2")));
+    EXPECT_FALSE(Eval(BranchOperator::IsTrue, int64_t(1)));
+    EXPECT_FALSE(Eval(BranchOperator::LengthGreater, int64_t(100), int64_t(1)));
+    EXPECT_FALSE(Eval(BranchOperator::Contain, int64_t(12), int64_t(1)));
+    EXPECT_FALSE(Eval(BranchOperator::Contain, std::string("hello"), int64_t(1)));
+}
+
+// ============================================================================
+// Compiled conditions
+// ============================================================================
+
+// A clause that is decided stops before later operands are resolved, so a
+// missing operand there does not throw
+TEST(GraphBranchNodeOperatorsTest, ClausesShortCircuit) {
+    SingleClauseConfig young(BranchOperator::Lesser, OperandConfig::FromNode("user", {"age"}),
+                             OperandConfig::FromLiteral(18));
+    SingleClauseConfig adult(BranchOperator::GreaterOrEqual,
+                             OperandConfig::FromNode("user", {"age"}),
+                             OperandConfig::FromLiteral(18));
+    SingleClauseConfig missing(BranchOperator::IsTrue,
+                               OperandConfig::FromNode("missing_node", {"flag"}));
+
+    BranchNodeConfig and_config;
+    and_config.AddMultiConditionWithOperands({young, missing}, ClauseRelation::AND);
+    EXPECT_EQ(Select(and_config, UserInput()), 1);
+
+    BranchNodeConfig or_config;
+    or_config.AddMultiConditionWithOperands({adult, missing}, ClauseRelation::OR);
+    EXPECT_EQ(Select(or_config, UserInput()), 0);
+
+    // A clause that reaches the missing operand still fails
+    BranchNodeConfig reached;
+    reached.AddMultiConditionWithOperands({adult, missing}, ClauseRelation::AND);
+    EXPECT_THROW(Select(reached, UserInput()), std::runtime_error);
+
+    // So does a later branch once an earlier one matched nothing
+    BranchNodeConfig later;
+    later.AddConditionWithOperands(BranchOperator::Lesser, OperandConfig::FromNode("user", {"age"}),
+                                   OperandConfig::FromLiteral(18));
+    later.AddConditionWithOperands(BranchOperator::IsTrue,
+                                   OperandConfig::FromNode("missing_node", {"flag"}));
+    EXPECT_THROW(Select(later, UserInput()), std::runtime_error);
+
+    // ... but not when the earlier branch matched
+    BranchNodeConfig earlier;
+    earlier.AddConditionWithOperands(BranchOperator::GreaterOrEqual,
+                                     OperandConfig::FromNode("user", {"age"}),
+                                     OperandConfig::FromLiteral(18));
+    earlier.AddConditionWithOperands(BranchOperator::IsTrue,
+                                     OperandConfig::FromNode("missing_node", {"flag"}));
+    EXPECT_EQ(Select(earlier, UserInput()), 0);
+}
+
+TEST(GraphBranchNodeOperatorsTest, LiteralsAreNormalized) {
+    BranchNodeConfig config;
+    config.AddConditionWithOperands(BranchOperator::Equal, OperandConfig::FromNode("user", {"age"}),
+                                    OperandConfig::FromLiteral(25));
+    config.AddConditionWithOperands(BranchOperator::Equal, OperandConfig::FromNode("user", {"age"}),
+                                    OperandConfig::FromLiteral(25L));
+    config.AddConditionWithOperands(BranchOperator::Greater,
+                                    OperandConfig::FromNode("user", {"score"}),
+                                    OperandConfig::FromLiteral(85.25f));
+    config.AddConditionWithOperands(BranchOperator::Equal,
+                                    OperandConfig::FromNode("user", {"name"}),
+                                    OperandConfig::FromLiteral("Alice"));
+
+    auto compiled = CompileBranchClauses(config, true);
+    ASSERT_EQ(compiled.size(), 4u);
+    const auto& int_literal = compiled[0].conditions[0].right.literal;
+    const auto& long_literal = compiled[1].conditions[0].right.literal;
+    const auto& float_literal = compiled[2].conditions[0].right.literal;
+    const auto& string_literal = compiled[3].conditions[0].right.literal;
+    EXPECT_EQ(int_literal.type(), typeid(int64_t));
+    EXPECT_EQ(long_literal.type(), typeid(int64_t));
+    EXPECT_EQ(float_literal.type(), typeid(double));
+    ASSERT_EQ(string_literal.type(), typeid(std::string));
+    EXPECT_EQ(std::any_cast<std::string>(string_literal), "Alice");
+
+    // Each condition matches on its own
+    for (size_t i = 0; i < compiled.size(); ++i) {
+        EXPECT_TRUE(compiled[i].Evaluate(UserInput())) << "clause " << i;
+    }
+}
+
+TEST(GraphBranchNodeOperatorsTest, ContainUsesHashedMembers) {
+    std::vector<std::any> allowed = {int64_t(7), int64_t(25), std::string("Alice")};
+    BranchNodeConfig config;
+    config.AddConditionWithOperands(BranchOperator::Contain, OperandConfig::FromLiteral(allowed),
+                                    OperandConfig::FromNode("user", {"age"}));
+    config.AddConditionWithOperands(BranchOperator::NotContain,
+                                    OperandConfig::FromLiteral(allowed),
+                                    OperandConfig::FromNode("user", {"name"}));
+    // A list from the input is scanned, not hashed
+    config.AddConditionWithOperands(BranchOperator::Contain, OperandConfig::FromNode("user", {"tags"}),
+                                    OperandConfig::FromLiteral(std::string("x")));
+
+    auto compiled = CompileBranchClauses(config, true);
+    ASSERT_EQ(compiled.size(), 3u);
+    const auto& in_ints = compiled[0].conditions[0];
+    EXPECT_TRUE(in_ints.hashed);
+    EXPECT_EQ(in_ints.int_members.size(), 2u);
+    EXPECT_EQ(in_ints.string_members.size(), 1u);
+    EXPECT_TRUE(compiled[1].conditions[0].hashed);
+    EXPECT_FALSE(compiled[2].conditions[0].hashed);
+
+    MapType input = UserInput();
+    EXPECT_TRUE(compiled[0].Evaluate(input));
+    EXPECT_FALSE(compiled[1].Evaluate(input));
+
+    auto user = std::any_cast<MapType>(input["user"]);
+    user["age"] = static_cast<int64_t>(30);
+    user["name"] = std::string("Bob");
+    input["user"] = user;
+    EXPECT_FALSE(compiled[0].Evaluate(input));
+    EXPECT_TRUE(compiled[1].Evaluate(input));
+
+    // Hashed and scanned lookups agree, through the node as well
+    EXPECT_EQ(Select(config, UserInput()), 0);
+    EXPECT_EQ(Select(config, input), 1);
+}
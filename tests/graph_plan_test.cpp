@@ -0,0 +1,108 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/compose/graph_plan.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace eino::compose;
+
+namespace {
+
+ExecutionPlan::NodeSpec Spec(const std::string& name, bool full_caps = true) {
+    ExecutionPlan::NodeSpec spec;
+    spec.name = name;
+    spec.caps.has_invoke = full_caps;
+    spec.caps.has_stream = full_caps;
+    spec.caps.has_collect = full_caps;
+    spec.caps.has_transform = full_caps;
+    return spec;
+}
+
+PlanEdge Edge(const std::string& from, const std::string& to,
+              bool control = true, bool data = true) {
+    PlanEdge e;
+    e.from = from;
+    e.to = to;
+    e.is_control_edge = control;
+    e.is_data_edge = data;
+    return e;
+}
+
+} // namespace
+
+TEST(ExecutionPlanTest, DenseIdsAndCSR) {
+    // START -> a -> {b, c} -> END, plus a control-only edge a -> d -> END
+    auto plan = ExecutionPlan::Build(
+        {Spec("a"), Spec("b"), Spec("c"), Spec("d")},
+        {Edge("__START__", "a"), Edge("a", "b"), Edge("a", "c"), Edge("a", "d", true, false),
+         Edge("b", "__END__"), Edge("c", "__END__"), Edge("d", "__END__")});
+
+    ASSERT_EQ(plan->NodeCount(), 6u);
+    EXPECT_EQ(plan->Name(plan->StartId()), "__START__");
+    EXPECT_EQ(plan->Name(plan->EndId()), "__END__");
+    EXPECT_EQ(plan->Id("missing"), ExecutionPlan::kNoNode);
+
+    int a = plan->Id("a");
+    EXPECT_EQ(plan->Names(plan->Successors(a)), (std::vector<std::string>{"b", "c", "d"}));
+    EXPECT_EQ(plan->Names(plan->DataSuccessors(a)), (std::vector<std::string>{"b", "c"}));
+    EXPECT_EQ(plan->Names(plan->Successors(plan->StartId())), std::vector<std::string>{"a"});
+
+    int end = plan->EndId();
+    EXPECT_EQ(plan->Names(plan->DataPredecessors(end)), (std::vector<std::string>{"b", "c", "d"}));
+    EXPECT_EQ(plan->Names(plan->DataPredecessors(plan->Id("d"))), std::vector<std::string>{});
+    EXPECT_EQ(plan->Names(plan->ControlPredecessors(plan->Id("d"))), std::vector<std::string>{"a"});
+}
+
+TEST(ExecutionPlanTest, PrecomputedExecutionMethods) {
+    // "t" can only transform, so its predecessor should stream
+    ExecutionPlan::NodeSpec transform_only = Spec("t", false);
+    transform_only.caps.has_transform = true;
+
+    auto plan = ExecutionPlan::Build(
+        {Spec("a"), Spec("b"), transform_only},
+        {Edge("__START__", "a"), Edge("a", "t"), Edge("t", "b"), Edge("b", "__END__")});
+
+    int a = plan->Id("a");
+    int b = plan->Id("b");
+    EXPECT_TRUE(plan->DownstreamExpectsStream(a));
+    EXPECT_FALSE(plan->DownstreamExpectsStream(b));
+    EXPECT_EQ(plan->ExecutionMethod(a, false), "Stream");
+    EXPECT_EQ(plan->ExecutionMethod(a, true), "Transform");
+    EXPECT_EQ(plan->ExecutionMethod(b, false), "Invoke");
+    EXPECT_EQ(plan->ExecutionMethod(b, true), "Collect");
+}
+
+TEST(ExecutionPlanTest, SelectExecutionMethodMatrix) {
+    NodeCapabilities all;
+    all.has_invoke = all.has_stream = all.has_collect = all.has_transform = true;
+    NodeCapabilities none;
+
+    EXPECT_STREQ(SelectExecutionMethod(true, all, true), "Transform");
+    EXPECT_STREQ(SelectExecutionMethod(true, all, false), "Collect");
+    EXPECT_STREQ(SelectExecutionMethod(false, all, true), "Stream");
+    EXPECT_STREQ(SelectExecutionMethod(false, all, false), "Invoke");
+    EXPECT_STREQ(SelectExecutionMethod(true, none, true), "Invoke");
+    EXPECT_STREQ(SelectExecutionMethod(false, none, true), "Invoke");
+}
+
+TEST(ExecutionPlanTest, RejectsUnknownNodes) {
+    EXPECT_THROW(ExecutionPlan::Build({Spec("a")}, {Edge("a", "ghost")}),
+                 std::invalid_argument);
+    EXPECT_THROW(ExecutionPlan::Build({Spec("a"), Spec("a")}, {}), std::invalid_argument);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/internal/metrics.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace eino::internal::metrics;
+
+namespace {
+
+const CounterSnapshot* FindCounter(const MetricsSnapshot& s, const std::string& name) {
+    for (const auto& c : s.counters) {
+        if (c.name == name) {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+const HistogramSnapshot* FindHistogram(const MetricsSnapshot& s, const std::string& name,
+                                       const Labels& labels = Labels()) {
+    for (const auto& h : s.histograms) {
+        if (h.name == name && h.labels == labels) {
+            return &h;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(MetricsTest, BucketBoundsCoverValues) {
+    std::vector<uint64_t> values = {0, 1, 7, 8, 9, 15, 16, 17, 100, 1000, 123456789,
+                                    uint64_t(1) << 40, ~uint64_t(0)};
+    for (uint64_t v : values) {
+        uint32_t b = BucketIndex(v);
+        ASSERT_LT(b, kNumBuckets);
+        EXPECT_LE(BucketLowerBound(b), v);
+        EXPECT_GE(BucketUpperBound(b), v);
+    }
+    // Buckets are contiguous
+    for (uint32_t b = 1; b < kNumBuckets; ++b) {
+        EXPECT_EQ(BucketLowerBound(b), BucketUpperBound(b - 1) + 1);
+    }
+}
+
+TEST(MetricsTest, CounterSumsAcrossThreads) {
+    auto counter = Registry::Global().GetCounter("test_counter_total", "test");
+    EXPECT_EQ(counter.id(), Registry::Global().GetCounter("test_counter_total", "test").id());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([counter] {
+            for (int i = 0; i < 1000; ++i) {
+                counter.Inc();
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    counter.Inc(5);
+
+    auto snapshot = Registry::Global().Snapshot();
+    auto* c = FindCounter(snapshot, "test_counter_total");
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(c->value, 4005u);
+}
+
+TEST(MetricsTest, HistogramPercentiles) {
+    auto hist = Registry::Global().GetHistogram("test_latency_ns", "test");
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        hist.Record(v);
+    }
+    auto snapshot = Registry::Global().Snapshot();
+    auto* h = FindHistogram(snapshot, "test_latency_ns");
+    ASSERT_NE(h, nullptr);
+    EXPECT_EQ(h->count, 1000u);
+    EXPECT_EQ(h->sum, 500500u);
+    EXPECT_EQ(h->max, 1000u);
+    EXPECT_NEAR(h->Percentile(50), 500, 500 * 0.125);
+    EXPECT_NEAR(h->Percentile(99), 990, 990 * 0.125);
+    EXPECT_LE(h->Percentile(100), 1000);
+}
+
+TEST(MetricsTest, FamilyLabelsAndExport) {
+    HistogramFamily family("test_node_ns", "per node", "node");
+    family.WithLabel("a").Record(10);
+    family.WithLabel("b").Record(20);
+    family.WithLabel("a").Record(30);
+
+    auto snapshot = Registry::Global().Snapshot();
+    auto* a = FindHistogram(snapshot, "test_node_ns", Labels{{"node", "a"}});
+    auto* b = FindHistogram(snapshot, "test_node_ns", Labels{{"node", "b"}});
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(a->count, 2u);
+    EXPECT_EQ(b->count, 1u);
+
+    std::string text = snapshot.ToPrometheus();
+    EXPECT_NE(text.find("# TYPE test_node_ns histogram"), std::string::npos);
+    EXPECT_NE(text.find("test_node_ns_count{node=\"a\"} 2"), std::string::npos);
+    EXPECT_NE(text.find("test_node_ns_bucket{node=\"b\",le=\"+Inf\"} 1"), std::string::npos);
+
+    std::string json = snapshot.ToJSON();
+    EXPECT_NE(json.find("\"name\":\"test_node_ns\""), std::string::npos);
+    EXPECT_NE(json.find("\"p99\":"), std::string::npos);
+}
+
+TEST(MetricsTest, PrometheusBucketLayoutIsFixed) {
+    auto histogram = Registry::Global().GetHistogram("test_layout_ns", "test");
+    histogram.Record(5);
+    histogram.Record(100);
+
+    std::string text = Registry::Global().Snapshot().ToPrometheus();
+    size_t buckets = 0;
+    for (size_t pos = text.find("test_layout_ns_bucket{"); pos != std::string::npos;
+         pos = text.find("test_layout_ns_bucket{", pos + 1)) {
+        ++buckets;
+    }
+    EXPECT_EQ(buckets, static_cast<size_t>(kExportedBuckets) + 1);
+    // Empty buckets are emitted, counts are cumulative
+    EXPECT_NE(text.find("test_layout_ns_bucket{le=\"3\"} 0"), std::string::npos);
+    EXPECT_NE(text.find("test_layout_ns_bucket{le=\"7\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("test_layout_ns_bucket{le=\"63\"} 1"), std::string::npos);
+    EXPECT_NE(text.find("test_layout_ns_bucket{le=\"127\"} 2"), std::string::npos);
+    EXPECT_NE(text.find("test_layout_ns_bucket{le=\"+Inf\"} 2"), std::string::npos);
+}
+
+TEST(MetricsTest, DisabledRecordsNothing) {
+    auto counter = Registry::Global().GetCounter("test_disabled_total", "test");
+    SetEnabled(false);
+    counter.Inc(10);
+    SetEnabled(true);
+    counter.Inc(1);
+    auto snapshot = Registry::Global().Snapshot();
+    auto* c = FindCounter(snapshot, "test_disabled_total");
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(c->value, 1u);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2024 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/internal/object_pool.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace eino::internal;
+
+namespace {
+
+struct Scratch {
+    std::vector<int> values;
+    int resets = 0;
+    bool reusable = true;
+};
+
+ObjectPool<Scratch>::Factory NewScratch() {
+    return [] { return std::unique_ptr<Scratch>(new Scratch()); };
+}
+
+bool ResetScratch(Scratch& s) {
+    s.values.clear();
+    s.resets++;
+    return s.reusable;
+}
+
+} // namespace
+
+TEST(ObjectPoolTest, ReusesReleasedObjects) {
+    ObjectPool<Scratch> pool(NewScratch(), ResetScratch);
+
+    Scratch* first = nullptr;
+    {
+        auto lease = pool.Acquire();
+        first = lease.get();
+        lease->values.assign(100, 1);
+    }
+    EXPECT_EQ(pool.IdleCount(), 1u);
+
+    auto lease = pool.Acquire();
+    EXPECT_EQ(lease.get(), first);
+    EXPECT_TRUE(lease->values.empty());
+    EXPECT_GE(lease->values.capacity(), 100u);
+    EXPECT_EQ(lease->resets, 1);
+    EXPECT_EQ(pool.CreatedCount(), 1u);
+}
+
+TEST(ObjectPoolTest, ConcurrentCheckoutsGetDistinctObjects) {
+    ObjectPool<Scratch> pool(NewScratch(), ResetScratch);
+
+    auto a = pool.Acquire();
+    auto b = pool.Acquire();
+    EXPECT_NE(a.get(), b.get());
+    EXPECT_EQ(pool.CreatedCount(), 2u);
+
+    a.Release();
+    b.Release();
+    EXPECT_EQ(pool.IdleCount(), 2u);
+
+    // Steady state: no new objects once the pool covers the peak
+    for (int i = 0; i < 10; ++i) {
+        auto c = pool.Acquire();
+        auto d = pool.Acquire();
+    }
+    EXPECT_EQ(pool.CreatedCount(), 2u);
+}
+
+TEST(ObjectPoolTest, DropsRejectedAndExcessObjects) {
+    ObjectPool<Scratch> pool(NewScratch(), ResetScratch, 1);
+
+    {
+        auto lease = pool.Acquire();
+        lease->reusable = false;
+    }
+    EXPECT_EQ(pool.IdleCount(), 0u);
+
+    {
+        auto a = pool.Acquire();
+        auto b = pool.Acquire();
+    }
+    EXPECT_EQ(pool.IdleCount(), 1u);
+}
+
+TEST(ObjectPoolTest, MovedLeaseReturnsOnce) {
+    ObjectPool<Scratch> pool(NewScratch(), ResetScratch);
+    {
+        auto a = pool.Acquire();
+        ObjectPool<Scratch>::Lease b(std::move(a));
+        EXPECT_FALSE(a);
+        EXPECT_TRUE(b);
+    }
+    EXPECT_EQ(pool.IdleCount(), 1u);
+}
+
+TEST(ObjectPoolTest, ThreadSafety) {
+    ObjectPool<Scratch> pool(NewScratch(), ResetScratch);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool]() {
+            for (int i = 0; i < 1000; ++i) {
+                auto lease = pool.Acquire();
+                EXPECT_TRUE(lease->values.empty());
+                lease->values.push_back(i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_LE(pool.CreatedCount(), 4u);
+    EXPECT_EQ(pool.IdleCount(), pool.CreatedCount());
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/schema/fast_json.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace eino::schema;
+
+namespace {
+
+int kFirstIndex = 0;
+
+Message AssistantWithCall() {
+    Message msg(RoleType::kAssistant, "let me look");
+    ToolCall call;
+    call.index = &kFirstIndex;
+    call.id = "call_1";
+    call.type = "function";
+    call.function.name = "search";
+    call.function.arguments = "{\"q\":\"eino\"}";
+    msg.tool_calls.push_back(call);
+    msg.reasoning_content = "need data";
+    msg.response_meta = std::make_shared<ResponseMeta>();
+    msg.response_meta->finish_reason = "tool_calls";
+    msg.response_meta->usage = std::make_shared<TokenUsage>();
+    msg.response_meta->usage->prompt_tokens = 12;
+    msg.response_meta->usage->prompt_token_details.cached_tokens = 8;
+    msg.response_meta->usage->total_tokens = 20;
+    msg.extra["n"] = 3;
+    msg.extra["s"] = "x";
+    return msg;
+}
+
+} // namespace
+
+TEST(FastJsonTest, MessageRoundTrip) {
+    Message msg = AssistantWithCall();
+    Message back = ParseMessage(MessageToJSON(msg));
+
+    EXPECT_EQ(back.role, RoleType::kAssistant);
+    EXPECT_EQ(back.content, msg.content);
+    EXPECT_EQ(back.reasoning_content, "need data");
+    ASSERT_EQ(back.tool_calls.size(), 1u);
+    ASSERT_NE(back.tool_calls[0].index, nullptr);
+    EXPECT_EQ(*back.tool_calls[0].index, 0);
+    EXPECT_EQ(back.tool_calls[0].id, "call_1");
+    EXPECT_EQ(back.tool_calls[0].function.name, "search");
+    EXPECT_EQ(back.tool_calls[0].function.arguments, "{\"q\":\"eino\"}");
+    ASSERT_NE(back.response_meta, nullptr);
+    EXPECT_EQ(back.response_meta->finish_reason, "tool_calls");
+    EXPECT_EQ(back.response_meta->usage->prompt_tokens, 12);
+    EXPECT_EQ(back.response_meta->usage->prompt_token_details.cached_tokens, 8);
+    EXPECT_EQ(back.response_meta->usage->total_tokens, 20);
+    EXPECT_EQ(static_cast<int>(back.extra.at("n")), 3);
+    EXPECT_EQ(static_cast<std::string>(back.extra.at("s")), "x");
+}
+
+TEST(FastJsonTest, EscapesSurviveRoundTrip) {
+    // Long enough that specials land inside and across vector blocks
+    std::string text = "plain ascii run of bytes, then \"quotes\" and \\ and\n"
+                       "tabs\there, control \x01 bytes, utf-8 \xe4\xbd\xa0\xe5\xa5\xbd";
+    for (int i = 0; i < 5; ++i) {
+        text += text;
+    }
+    Message msg(RoleType::kUser, text);
+    std::string wire = MessageToJSON(msg);
+    EXPECT_EQ(wire.find('\n'), std::string::npos);
+    EXPECT_NE(wire.find("\\u0001"), std::string::npos);
+    EXPECT_EQ(ParseMessage(wire).content, text);
+
+    Message decoded = ParseMessage(
+        R"({"role":"user","content":"a\/b \u00e9 \ud83d\ude00 \"q\""})");
+    EXPECT_EQ(decoded.content, "a/b \xc3\xa9 \xf0\x9f\x98\x80 \"q\"");
+}
+
+TEST(FastJsonTest, ReadsNlohmannOutput) {
+    // Same shape as OpenAIChatModel::BuildRequestJSON
+    using Object = std::map<std::string, json>;
+    json fn(Object{{"name", "lookup"}, {"arguments", ""}});
+    json tc(Object{{"id", "call_9"}, {"type", "function"}, {"function", fn}});
+    json msg(Object{
+        {"role", "assistant"},
+        {"content", "hi"},
+        {"tool_calls", json(std::vector<json>{tc})},
+        {"tool_call_id", "call_0"},
+        {"unknown", json(Object{{"deep", json(std::vector<json>{1, 2})}})},
+    });
+
+    Message back = ParseMessage(msg.dump());
+    EXPECT_EQ(back.role, RoleType::kAssistant);
+    EXPECT_EQ(back.content, "hi");
+    EXPECT_EQ(back.tool_call_id, "call_0");
+    ASSERT_EQ(back.tool_calls.size(), 1u);
+    EXPECT_EQ(back.tool_calls[0].index, nullptr);
+    EXPECT_EQ(back.tool_calls[0].id, "call_9");
+    EXPECT_EQ(back.tool_calls[0].function.name, "lookup");
+}
+
+TEST(FastJsonTest, NullsAndWhitespace) {
+    Message msg = ParseMessage(
+        " {\n  \"role\" : \"assistant\",\n  \"content\" : null,\n"
+        "  \"tool_calls\" : [ ] ,\"response_meta\":{\"usage\":null} } \n");
+    EXPECT_EQ(msg.content, "");
+    EXPECT_TRUE(msg.tool_calls.empty());
+    ASSERT_NE(msg.response_meta, nullptr);
+    EXPECT_EQ(msg.response_meta->usage, nullptr);
+
+    auto msgs = ParseMessages(R"([{"role":"system","content":"s"},{"role":"user","content":"u"}])");
+    ASSERT_EQ(msgs.size(), 2u);
+    EXPECT_EQ(msgs[0].role, RoleType::kSystem);
+    EXPECT_EQ(msgs[1].content, "u");
+}
+
+TEST(FastJsonTest, ToolInfoAndDocument) {
+    ToolInfo info;
+    info.name = "search";
+    info.description = "find things";
+    json schema(std::map<std::string, json>{{"type", "object"}});
+    info.params = std::make_shared<ParamsOneOf>(ParamsOneOf::FromJSONSchema(schema));
+
+    JsonWriter w;
+    WriteToolInfo(w, info);
+    JsonReader r(w.str());
+    ToolInfo back;
+    ReadToolInfo(r, &back);
+    r.ExpectEnd();
+    EXPECT_EQ(back.name, "search");
+    EXPECT_EQ(back.description, "find things");
+    ASSERT_NE(back.params, nullptr);
+    EXPECT_EQ(back.params->json_schema.dump(), "{\"type\":\"object\"}");
+
+    Document doc("d1", "page");
+    doc.WithScore(0.5).WithExtraInfo("info");
+    w.Clear();
+    WriteDocument(w, doc);
+    Document doc_back = ParseDocument(w.str());
+    EXPECT_EQ(doc_back.id, "d1");
+    EXPECT_EQ(doc_back.page_content, "page");
+    EXPECT_DOUBLE_EQ(doc_back.GetScore(), 0.5);
+    EXPECT_EQ(doc_back.GetExtraInfo(), "info");
+}
+
+TEST(FastJsonTest, MultimodalPartsRoundTrip) {
+    Message msg(RoleType::kUser, "");
+    MessageInputPart text;
+    text.text = "what is this";
+    MessageInputPart image;
+    image.type = ChatMessagePartType::kImageURL;
+    image.image = std::make_shared<MessageInputImage>();
+    image.image->common.url = new std::string("https://x/a.png");
+    image.image->common.mime_type = "image/png";
+    image.image->detail = ImageURLDetail::kHigh;
+    msg.user_input_multi_content = {text, image};
+
+    MessageOutputPart audio;
+    audio.type = ChatMessagePartType::kAudioURL;
+    audio.audio = std::make_shared<MessageOutputAudio>();
+    audio.audio->common.base64_data = new std::string("AAAA");
+    msg.assistant_gen_multi_content = {audio};
+
+    ChatMessagePart file;
+    file.type = ChatMessagePartType::kFileURL;
+    file.file_url = std::make_shared<ChatMessageFileURL>();
+    file.file_url->url = "https://x/doc.pdf";
+    file.file_url->name = "doc.pdf";
+    msg.multi_content = {file};
+
+    Message back = ParseMessage(MessageToJSON(msg));
+    ASSERT_EQ(back.user_input_multi_content.size(), 2u);
+    EXPECT_EQ(back.user_input_multi_content[0].text, "what is this");
+    const auto& back_image = back.user_input_multi_content[1];
+    EXPECT_EQ(back_image.type, ChatMessagePartType::kImageURL);
+    ASSERT_NE(back_image.image, nullptr);
+    ASSERT_NE(back_image.image->common.url, nullptr);
+    EXPECT_EQ(*back_image.image->common.url, "https://x/a.png");
+    EXPECT_EQ(back_image.image->common.base64_data, nullptr);
+    EXPECT_EQ(back_image.image->common.mime_type, "image/png");
+    EXPECT_EQ(back_image.image->detail, ImageURLDetail::kHigh);
+
+    ASSERT_EQ(back.assistant_gen_multi_content.size(), 1u);
+    ASSERT_NE(back.assistant_gen_multi_content[0].audio, nullptr);
+    ASSERT_NE(back.assistant_gen_multi_content[0].audio->common.base64_data, nullptr);
+    EXPECT_EQ(*back.assistant_gen_multi_content[0].audio->common.base64_data, "AAAA");
+
+    ASSERT_EQ(back.multi_content.size(), 1u);
+    ASSERT_NE(back.multi_content[0].file_url, nullptr);
+    EXPECT_EQ(back.multi_content[0].file_url->url, "https://x/doc.pdf");
+    EXPECT_EQ(back.multi_content[0].file_url->name, "doc.pdf");
+
+    // Messages differing only in their parts serialize differently
+    Message other = msg;
+    other.user_input_multi_content.pop_back();
+    EXPECT_NE(MessageToJSON(other), MessageToJSON(msg));
+}
+
+TEST(FastJsonTest, ToolInfoParamsWrittenAsSchema) {
+    auto query = std::make_shared<ParameterInfo>();
+    query->type = DataType::kString;
+    query->description = "search terms";
+    query->required = true;
+    auto limit = std::make_shared<ParameterInfo>();
+    limit->type = DataType::kInteger;
+    auto tags = std::make_shared<ParameterInfo>();
+    tags->type = DataType::kArray;
+    tags->elem_info = std::make_shared<ParameterInfo>();
+    tags->elem_info->type = DataType::kString;
+    tags->elem_info->enum_values = {"a", "b"};
+
+    ToolInfo info;
+    info.name = "search";
+    info.params = std::make_shared<ParamsOneOf>(
+        ParamsOneOf::FromParams({{"query", query}, {"limit", limit}, {"tags", tags}}));
+
+    JsonWriter w;
+    WriteToolInfo(w, info);
+    EXPECT_EQ(w.str(),
+              R"({"name":"search","description":"","parameters":{"type":"object","properties":{)"
+              R"("limit":{"type":"integer"},)"
+              R"("query":{"type":"string","description":"search terms"},)"
+              R"("tags":{"type":"array","items":{"type":"string","enum":["a","b"]}}},)"
+              R"("required":["query"]}})");
+}
+
+TEST(FastJsonTest, RejectsMalformedInput) {
+    EXPECT_THROW(ParseMessage(R"({"role":"user","content":"x")"), std::runtime_error);
+    EXPECT_THROW(ParseMessage(R"({"role":"user" "content":"x"})"), std::runtime_error);
+    EXPECT_THROW(ParseMessage(R"({"role":"user","content":"x",})"), std::runtime_error);
+    EXPECT_THROW(ParseMessage(R"({"role":"robot"})"), std::runtime_error);
+    EXPECT_THROW(ParseMessage(R"({"content":"\q"})"), std::runtime_error);
+    EXPECT_THROW(ParseMessage(R"({"content":"\ud83d"})"), std::runtime_error);
+    EXPECT_THROW(ParseMessage(R"({"content":"x"} extra)"), std::runtime_error);
+    EXPECT_THROW(ParseMessage(std::string("{\"content\":\"a\x01\"}")), std::runtime_error);
+}
+
+TEST(FastJsonTest, WriterReusesBuffer) {
+    Message msg = AssistantWithCall();
+    JsonWriter w;
+    WriteMessage(w, msg);
+    std::string first = w.str();
+    const char* data = w.str().data();
+
+    w.Clear();
+    WriteMessage(w, msg);
+    EXPECT_EQ(w.str(), first);
+    EXPECT_EQ(w.str().data(), data);
+
+    std::string taken = w.Take();
+    EXPECT_EQ(taken, first);
+    EXPECT_EQ(w.size(), 0u);
+}
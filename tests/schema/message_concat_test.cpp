@@ -0,0 +1,184 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/schema/message_concat.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace eino::schema;
+
+namespace {
+
+Message Chunk(const std::string& content, int prompt_tokens = 0) {
+    Message msg(RoleType::kAssistant, content);
+    if (prompt_tokens > 0) {
+        msg.response_meta = std::make_shared<ResponseMeta>();
+        msg.response_meta->usage = std::make_shared<TokenUsage>();
+        msg.response_meta->usage->prompt_tokens = prompt_tokens;
+    }
+    return msg;
+}
+
+ToolCall CallChunk(int* index, const std::string& id, const std::string& args) {
+    ToolCall call;
+    call.index = index;
+    call.id = id;
+    call.function.arguments = args;
+    return call;
+}
+
+MessageOutputPart TextPart(const std::string& text) {
+    MessageOutputPart part;
+    part.type = ChatMessagePartType::kText;
+    part.text = text;
+    return part;
+}
+
+MessageOutputPart AudioPart(const std::string& b64) {
+    MessageOutputPart part;
+    part.type = ChatMessagePartType::kAudioURL;
+    part.audio = std::make_shared<MessageOutputAudio>();
+    part.audio->common.base64_data = new std::string(b64);
+    part.audio->common.mime_type = "audio/wav";
+    return part;
+}
+
+} // namespace
+
+TEST(TextRopeTest, FlattenContinuesAfterSnapshot) {
+    TextRope rope;
+    rope.Append(std::string("ab"));
+    rope.Append(std::string("cd"));
+    EXPECT_EQ(rope.size(), 4u);
+    EXPECT_EQ(rope.Flatten(), "abcd");
+    rope.Append(std::string("ef"));
+    EXPECT_EQ(rope.Flatten(), "abcdef");
+    EXPECT_EQ(rope.Take(), "abcdef");
+    EXPECT_TRUE(rope.empty());
+}
+
+TEST(TextRopeTest, ReserveSizesBufferOnce) {
+    TextRope rope;
+    rope.Reserve(1024);
+    const char* data = rope.Flatten().data();
+    for (int i = 0; i < 64; ++i) {
+        rope.Append(std::string(16, 'x'));
+    }
+    EXPECT_EQ(rope.Flatten().data(), data);
+    EXPECT_EQ(rope.size(), 1024u);
+}
+
+TEST(MessageConcatTest, ConcatsAssistantChunks) {
+    Message a = Chunk("Hel", 10);
+    Message b = Chunk("lo", 12);
+    b.response_meta->finish_reason = "stop";
+    b.extra["k"] = "v";
+    std::vector<Message*> msgs = {&a, &b};
+
+    Message merged = ConcatMessages(msgs);
+    EXPECT_EQ(merged.role, RoleType::kAssistant);
+    EXPECT_EQ(merged.content, "Hello");
+    ASSERT_NE(merged.response_meta, nullptr);
+    EXPECT_EQ(merged.response_meta->finish_reason, "stop");
+    EXPECT_EQ(merged.response_meta->usage->prompt_tokens, 12);
+    EXPECT_EQ(merged.extra.count("k"), 1u);
+}
+
+TEST(MessageConcatTest, RejectsConflicts) {
+    Message a = Chunk("a");
+    Message b = UserMessage("b");
+    std::vector<Message*> roles = {&a, &b};
+    EXPECT_THROW(ConcatMessages(roles), std::runtime_error);
+
+    Message c = Chunk("c");
+    c.name = "x";
+    Message d = Chunk("d");
+    d.name = "y";
+    std::vector<Message*> names = {&c, &d};
+    EXPECT_THROW(ConcatMessages(names), std::runtime_error);
+
+    std::vector<Message*> with_null = {&a, nullptr};
+    EXPECT_THROW(ConcatMessages(with_null), std::runtime_error);
+    EXPECT_THROW(ConcatMessages({}), std::invalid_argument);
+}
+
+TEST(MessageConcatTest, MergesToolCallsByIndex) {
+    int zero = 0;
+    int one = 1;
+    std::vector<ToolCall> chunks = {
+        CallChunk(&one, "call_b", "{\"q\":"),
+        CallChunk(&zero, "call_a", "{}"),
+        CallChunk(nullptr, "plain", "x"),
+        CallChunk(&one, "", "1}"),
+    };
+    auto merged = ConcatToolCalls(chunks);
+    ASSERT_EQ(merged.size(), 3u);
+    EXPECT_EQ(merged[0].id, "plain");
+    EXPECT_EQ(*merged[1].index, 0);
+    EXPECT_EQ(merged[2].id, "call_b");
+    EXPECT_EQ(merged[2].function.arguments, "{\"q\":1}");
+
+    chunks.push_back(CallChunk(&one, "other", ""));
+    EXPECT_THROW(ConcatToolCalls(chunks), std::runtime_error);
+}
+
+TEST(MessageConcatTest, MergesContiguousOutputParts) {
+    std::vector<MessageOutputPart> parts = {
+        TextPart("a"), TextPart("b"), AudioPart("AA"), AudioPart("BB"), TextPart("c"),
+    };
+    auto merged = ConcatAssistantMultiContent(parts);
+    ASSERT_EQ(merged.size(), 3u);
+    EXPECT_EQ(merged[0].text, "ab");
+    ASSERT_NE(merged[1].audio, nullptr);
+    EXPECT_EQ(*merged[1].audio->common.base64_data, "AABB");
+    EXPECT_EQ(merged[1].audio->common.mime_type, "audio/wav");
+    EXPECT_EQ(merged[2].text, "c");
+}
+
+TEST(MessageConcatenatorTest, SnapshotsMidStream) {
+    MessageConcatenator concat;
+    int zero = 0;
+    std::string text;
+    for (int i = 0; i < 10; ++i) {
+        Message chunk = Chunk(std::to_string(i), i + 1);
+        chunk.tool_calls.push_back(CallChunk(&zero, i == 0 ? "call" : "", "x"));
+        chunk.assistant_gen_multi_content.push_back(TextPart("t"));
+        concat.Add(chunk);
+        text += std::to_string(i);
+
+        Message snap = concat.Snapshot();
+        EXPECT_EQ(snap.content, text);
+        EXPECT_EQ(snap.response_meta->usage->prompt_tokens, i + 1);
+        ASSERT_EQ(snap.tool_calls.size(), 1u);
+        EXPECT_EQ(snap.tool_calls[0].function.arguments, std::string(i + 1, 'x'));
+        ASSERT_EQ(snap.assistant_gen_multi_content.size(), 1u);
+        EXPECT_EQ(snap.assistant_gen_multi_content[0].text, std::string(i + 1, 't'));
+    }
+    EXPECT_EQ(concat.ChunkCount(), 10u);
+
+    // A snapshot's meta is detached from the concatenator's
+    Message snap = concat.Snapshot();
+    snap.response_meta->usage->prompt_tokens = 0;
+
+    Message full = concat.Finish();
+    EXPECT_EQ(full.content, "0123456789");
+    EXPECT_EQ(full.response_meta->usage->prompt_tokens, 10);
+    EXPECT_EQ(concat.ChunkCount(), 0u);
+    EXPECT_THROW(concat.Finish(), std::invalid_argument);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/schema/message_ref.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace eino::schema;
+
+namespace {
+
+Message Assistant(const std::string& content) {
+    Message msg(RoleType::kAssistant, content);
+    msg.name = "planner";
+    ToolCall call;
+    call.id = "call_1";
+    msg.tool_calls.push_back(call);
+    msg.extra["k"] = 1;
+    return msg;
+}
+
+} // namespace
+
+TEST(MessageRefTest, RoundTripsThroughMessage) {
+    Message msg = Assistant("hello");
+    msg.reasoning_content = "because";
+    msg.tool_call_id = "id";
+    msg.tool_name = "search";
+
+    MessageRef ref = MessageRef::From(msg);
+    Message back = ref.ToMessage();
+    EXPECT_EQ(back.role, RoleType::kAssistant);
+    EXPECT_EQ(back.content, "hello");
+    EXPECT_EQ(back.reasoning_content, "because");
+    EXPECT_EQ(back.name, "planner");
+    EXPECT_EQ(back.tool_name, "search");
+    EXPECT_EQ(back.tool_call_id, "id");
+    ASSERT_EQ(back.tool_calls.size(), 1u);
+    EXPECT_EQ(back.tool_calls[0].id, "call_1");
+    EXPECT_EQ(static_cast<int>(back.extra.at("k")), 1);
+}
+
+TEST(MessageRefTest, ResponseMetaIsCopiedInAndOut) {
+    Message msg = Assistant("hello");
+    msg.response_meta = std::make_shared<ResponseMeta>();
+    msg.response_meta->finish_reason = "stop";
+    msg.response_meta->usage = std::make_shared<TokenUsage>();
+    msg.response_meta->usage->total_tokens = 7;
+
+    MessageRef ref = MessageRef::From(msg);
+    // Writes through the source message do not reach the ref
+    msg.response_meta->finish_reason = "length";
+    msg.response_meta->usage->total_tokens = 9;
+    ASSERT_TRUE(ref.response_meta());
+    EXPECT_EQ(ref.response_meta()->finish_reason, "stop");
+    EXPECT_EQ(ref.response_meta()->usage->total_tokens, 7);
+
+    // Nor do writes through a message converted back
+    Message back = ref.ToMessage();
+    back.response_meta->usage->total_tokens = 11;
+    EXPECT_EQ(ref.response_meta()->usage->total_tokens, 7);
+    EXPECT_FALSE(MessageRef::From(Assistant("x")).response_meta());
+}
+
+TEST(MessageRefTest, CopyIsSharedAndBuilderSharesUntouchedFields) {
+    MessageRef ref = MessageRef::From(Assistant(std::string(4096, 'x')));
+    MessageRef copy = ref;
+    EXPECT_TRUE(copy.SameAs(ref));
+
+    MessageRef edited = ref.ToBuilder().SetName("critic").Build();
+    EXPECT_FALSE(edited.SameAs(ref));
+    EXPECT_EQ(&edited.content(), &ref.content());
+    EXPECT_EQ(&edited.tool_calls(), &ref.tool_calls());
+    EXPECT_EQ(edited.name(), "critic");
+    EXPECT_EQ(ref.name(), "planner");
+
+    MessageRef appended = ref.ToBuilder().AppendContent("y").Build();
+    EXPECT_EQ(appended.content().size(), 4097u);
+    EXPECT_EQ(ref.content().size(), 4096u);
+    EXPECT_EQ(&appended.extra(), &ref.extra());
+}
+
+TEST(MessageRefTest, NamesAreInterned) {
+    MessageRef a = MessageRef::From(Assistant("a"));
+    MessageRef b = MessageRef::From(Assistant("b"));
+    EXPECT_EQ(&a.name(), &b.name());
+    EXPECT_EQ(InternedString("x"), InternedString(std::string("x")));
+    EXPECT_NE(InternedString("x"), InternedString("y"));
+}
+
+TEST(MessageHistoryTest, AppendSharesEarlierTurns) {
+    MessageHistory turn1;
+    for (int i = 0; i < 40; ++i) {
+        turn1 = turn1.Append(MessageRef::From(UserMessage(std::to_string(i))));
+    }
+    MessageHistory turn2 = turn1.Append(MessageRef::From(AssistantMessage("reply")));
+
+    EXPECT_EQ(turn1.size(), 40u);
+    EXPECT_EQ(turn2.size(), 41u);
+    EXPECT_EQ(turn2.Back().content(), "reply");
+    EXPECT_EQ(turn1.Back().content(), "39");
+    EXPECT_TRUE(turn2.SharesPrefixWith(turn1, 40));
+    for (size_t i = 0; i < 40; ++i) {
+        EXPECT_TRUE(turn2.At(i).SameAs(turn1.At(i)));
+        EXPECT_EQ(turn2.At(i).content(), std::to_string(i));
+    }
+
+    // Diverging branches from the same turn keep it intact
+    MessageHistory other = turn1.Append(MessageRef::From(AssistantMessage("other")));
+    EXPECT_EQ(turn2.Back().content(), "reply");
+    EXPECT_EQ(other.Back().content(), "other");
+    EXPECT_TRUE(other.SharesPrefixWith(turn2, 40));
+    EXPECT_FALSE(other.SharesPrefixWith(turn2, 41));
+}
+
+TEST(MessageHistoryTest, BulkAppendPrefixAndConversion) {
+    std::vector<Message> msgs;
+    for (int i = 0; i < 70; ++i) {
+        msgs.push_back(UserMessage(std::to_string(i)));
+    }
+    MessageHistory history = MessageHistory::FromMessages(msgs);
+    ASSERT_EQ(history.size(), 70u);
+
+    auto back = history.ToMessages();
+    ASSERT_EQ(back.size(), 70u);
+    for (int i = 0; i < 70; ++i) {
+        EXPECT_EQ(back[i].content, std::to_string(i));
+    }
+
+    for (size_t n : {0u, 1u, 32u, 33u, 64u, 69u, 70u}) {
+        MessageHistory prefix = history.Prefix(n);
+        ASSERT_EQ(prefix.size(), n);
+        EXPECT_TRUE(prefix.SharesPrefixWith(history, n));
+        auto refs = prefix.ToRefs();
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_TRUE(refs[i].SameAs(history.At(i)));
+        }
+    }
+
+    MessageHistory rewritten = history.Prefix(50).Append(MessageRef::From(SystemMessage("s")));
+    EXPECT_EQ(rewritten.size(), 51u);
+    EXPECT_EQ(history.At(50).content(), "50");
+    EXPECT_EQ(rewritten.At(50).content(), "s");
+
+    EXPECT_THROW(history.At(70), std::out_of_range);
+    EXPECT_THROW(history.Prefix(71), std::out_of_range);
+}
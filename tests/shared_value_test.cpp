@@ -0,0 +1,102 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eino/compose/shared_value.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace eino::compose;
+
+namespace {
+
+// Counts copies and moves
+struct Tracked {
+    static int copies;
+    static int moves;
+    std::vector<int> data;
+
+    Tracked() = default;
+    explicit Tracked(size_t n) : data(n, 7) {}
+    Tracked(const Tracked& other) : data(other.data) { copies++; }
+    Tracked(Tracked&& other) noexcept : data(std::move(other.data)) { moves++; }
+
+    static void ResetCounts() { copies = moves = 0; }
+};
+
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+} // namespace
+
+TEST(SharedValueTest, TypeIdsAreDistinctAndStable) {
+    EXPECT_EQ(TypeIdOf<int>(), TypeIdOf<const int&>());
+    EXPECT_NE(TypeIdOf<int>(), TypeIdOf<long>());
+    EXPECT_NE(TypeIdOf<std::string>(), TypeIdOf<std::vector<char>>());
+}
+
+TEST(SharedValueTest, FansOutWithoutCopies) {
+    using Map = std::map<std::string, std::string>;
+    SharedValue view = SharedValue::Make(Map{{"k", "v"}});
+    const Map* original = view.Get<Map>();
+    ASSERT_NE(original, nullptr);
+    EXPECT_EQ(view.Get<std::string>(), nullptr);
+
+    std::vector<SharedValue> readers(4, view);
+    for (const auto& r : readers) {
+        EXPECT_EQ(r.Get<Map>(), original);
+    }
+    EXPECT_EQ(view.use_count(), 5);
+
+    // Adopted objects are shared in place
+    auto owned = std::make_shared<Map>(Map{{"a", "b"}});
+    const Map* before = owned.get();
+    EXPECT_EQ(SharedValue::Adopt(std::move(owned)).Get<Map>(), before);
+}
+
+TEST(SharedValueTest, ConsumeRejectsWrongType) {
+    SharedValue view = SharedValue::Make(std::string("x"));
+    EXPECT_THROW(SharedValue(view).Consume<int>(), std::runtime_error);
+    EXPECT_EQ(std::move(view).Consume<std::string>(), "x");
+}
+
+TEST(SharedValueTest, ConsumeMovesFromLastView) {
+    Tracked::ResetCounts();
+    SharedValue view = SharedValue::Make(Tracked(10));
+    SharedValue other = view;
+
+    Tracked copied = std::move(other).Consume<Tracked>();
+    EXPECT_EQ(Tracked::copies, 1);
+
+    Tracked moved = std::move(view).Consume<Tracked>();
+    EXPECT_EQ(Tracked::copies, 1);
+    EXPECT_EQ(moved.data.size(), 10u);
+    EXPECT_TRUE(view.empty());
+}
+
+TEST(SharedValueTest, ConsumeCopiesConstObjects) {
+    Tracked::ResetCounts();
+    auto value = std::make_shared<const Tracked>(10);
+    SharedValue view = SharedValue::Adopt(value);
+    value.reset();
+
+    Tracked out = std::move(view).Consume<Tracked>();
+    EXPECT_EQ(Tracked::copies, 1);
+    EXPECT_EQ(out.data.size(), 10u);
+}
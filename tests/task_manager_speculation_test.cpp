@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 CloudWeGo Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Test: TaskManager speculative tasks
+ *
+ * - A speculative task is delivered by Wait exactly once
+ * - A cancelled one is dropped whether it is still running or already done
+ * - Cancel fails once the task was delivered
+ * - A cancelled manager starts no speculation
+ *
+ * The tasks have no GraphNode, so they complete with an error; only their
+ * delivery is under test
+ */
+
+#include "eino/compose/graph_manager.h"
+#include "eino/compose/graph_run.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace eino::compose;
+
+namespace {
+
+using Tasks = std::vector<std::shared_ptr<Task>>;
+
+std::shared_ptr<Task> NewSpeculativeTask(const std::string& key) {
+    return std::make_shared<Task>(key);
+}
+
+}  // namespace
+
+TEST(TaskManagerSpeculation, DeliveredOnce) {
+    TaskManager tm(false);
+    auto task = NewSpeculativeTask("b");
+    ASSERT_TRUE(tm.Speculate(task));
+    EXPECT_TRUE(task->speculative);
+
+    Tasks completed, cancelled;
+    bool was_cancelled = false;
+    tm.Wait(completed, was_cancelled, cancelled);
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0], task);
+    EXPECT_FALSE(was_cancelled);
+
+    // Adopted: nothing else is pending for it
+    EXPECT_EQ(tm.GetPendingCount(), 0u);
+    EXPECT_TRUE(tm.AllCompleted());
+    tm.WaitAll(completed, cancelled);
+    EXPECT_TRUE(completed.empty());
+}
+
+TEST(TaskManagerSpeculation, CancelledTaskIsDropped) {
+    TaskManager tm(false);
+    auto task = NewSpeculativeTask("b");
+    ASSERT_TRUE(tm.Speculate(task));
+    EXPECT_TRUE(tm.Cancel(task));
+    // Cancelling again is a no-op
+    EXPECT_TRUE(tm.Cancel(task));
+    EXPECT_TRUE(task->discarded);
+    EXPECT_EQ(task->status, TaskStatus::Cancelled);
+    EXPECT_EQ(tm.GetPendingCount(), 0u);
+
+    // WaitAll drains the discarded run without delivering it
+    Tasks completed, cancelled;
+    tm.WaitAll(completed, cancelled);
+    EXPECT_TRUE(completed.empty());
+    EXPECT_TRUE(tm.AllCompleted());
+}
+
+TEST(TaskManagerSpeculation, CancelledNextToSubmittedTask) {
+    TaskManager tm(true);
+    auto miss = NewSpeculativeTask("b");
+    auto kept = NewSpeculativeTask("c");
+    ASSERT_TRUE(tm.Speculate(miss));
+    ASSERT_TRUE(tm.Speculate(kept));
+    ASSERT_TRUE(tm.Cancel(miss));
+
+    Tasks completed, cancelled;
+    bool was_cancelled = false;
+    tm.Wait(completed, was_cancelled, cancelled);
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0], kept);
+}
+
+TEST(TaskManagerSpeculation, CancelAfterDeliveryFails) {
+    TaskManager tm(false);
+    auto task = NewSpeculativeTask("b");
+    ASSERT_TRUE(tm.Speculate(task));
+
+    Tasks completed, cancelled;
+    bool was_cancelled = false;
+    tm.Wait(completed, was_cancelled, cancelled);
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_FALSE(tm.Cancel(task));
+    EXPECT_FALSE(task->discarded);
+}
+
+TEST(TaskManagerSpeculation, CancelledManagerStartsNothing) {
+    TaskManager tm(false);
+    tm.Cancel();
+    auto task = NewSpeculativeTask("b");
+    EXPECT_FALSE(tm.Speculate(task));
+    EXPECT_EQ(tm.GetPendingCount(), 0u);
+}